@@ -0,0 +1,233 @@
+#include "pch.h"
+#include "AssetStreamer.h"
+#include "CompressedMeshFile.h"
+#include "MappedFile.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	AssetStreamer::AssetStreamer(const Config& config) :
+		m_config{
+			std::max<uint32_t>(config.loaderThreadCount, 1),
+			std::max<uint32_t>(config.maxInFlight, 1),
+			config.uploadBytesPerFrame
+		}
+	{
+		spdlog::info("AssetStreamer: Starting {} loaders...", m_config.loaderThreadCount);
+		m_loaders.reserve(m_config.loaderThreadCount);
+		for (uint32_t i = 0; i < m_config.loaderThreadCount; ++i)
+		{
+			m_loaders.emplace_back([this]() { LoaderMain(); });
+		}
+	}
+
+	AssetStreamer::~AssetStreamer()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			m_isShuttingDown = true;
+		}
+		m_loaderCondition.notify_all();
+		for (std::thread& loader : m_loaders)
+		{
+			loader.join();
+		}
+	}
+
+	AssetStreamer::AssetHandle AssetStreamer::RequestMesh(const std::filesystem::path& path, int32_t priority)
+	{
+		AssetHandle handle{ 0 };
+		{
+			std::lock_guard<std::mutex> lock{ m_mutex };
+			handle = static_cast<AssetHandle>(m_assets.size());
+			m_assets.push_back(Asset{});
+			m_requests.push(Request{ priority, m_nextSequence++, handle, path });
+			++m_pendingCount;
+			++m_stats.requestedCount;
+		}
+		m_loaderCondition.notify_one();
+		return handle;
+	}
+
+	void AssetStreamer::Update(IMeshUploadSink& sink)
+	{
+		std::unique_lock<std::mutex> lock{ m_mutex };
+		uint64_t uploadedBytes{ 0 };
+		while (!m_decoded.empty())
+		{
+			// The first mesh always goes, so one over budget can't stall forever
+			const uint64_t meshBytes{ m_decoded.front().GetByteSize() };
+			if ((uploadedBytes > 0) && ((uploadedBytes + meshBytes) > m_config.uploadBytesPerFrame))
+			{
+				break;
+			}
+			UploadDecoded(sink, lock, uploadedBytes);
+		}
+		m_stats.lastFrameUploadedBytes = uploadedBytes;
+	}
+
+	void AssetStreamer::Flush(IMeshUploadSink& sink)
+	{
+		std::unique_lock<std::mutex> lock{ m_mutex };
+		uint64_t uploadedBytes{ 0 };
+		while (m_pendingCount > 0)
+		{
+			m_decodedCondition.wait(lock, [this]() { return !m_decoded.empty() || (m_pendingCount == 0); });
+			while (!m_decoded.empty())
+			{
+				UploadDecoded(sink, lock, uploadedBytes);
+			}
+		}
+		m_stats.lastFrameUploadedBytes = uploadedBytes;
+	}
+
+	AssetState AssetStreamer::GetState(AssetHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		return (handle < m_assets.size()) ? m_assets[handle].state : AssetState::Failed;
+	}
+
+	uint32_t AssetStreamer::GetMeshIndex(AssetHandle handle) const
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		return (handle < m_assets.size()) ? m_assets[handle].meshIndex : IMeshUploadSink::INVALID_MESH;
+	}
+
+	bool AssetStreamer::IsIdle() const
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		return m_pendingCount == 0;
+	}
+
+	AssetStreamer::Stats AssetStreamer::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock{ m_mutex };
+		return m_stats;
+	}
+#pragma endregion Public
+
+#pragma region Private
+	bool AssetStreamer::Request::operator<(const Request& other) const
+	{
+		// std::priority_queue pops the largest element: highest priority, then oldest
+		if (priority != other.priority)
+		{
+			return priority < other.priority;
+		}
+		return sequence > other.sequence;
+	}
+
+	uint64_t AssetStreamer::DecodedMesh::GetByteSize() const
+	{
+		return isCompressed ? compressedMesh.GetByteSize() : mesh.GetByteSize();
+	}
+
+	void AssetStreamer::LoaderMain()
+	{
+		while (true)
+		{
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock{ m_mutex };
+				m_loaderCondition.wait(lock, [this]()
+				{
+					return m_isShuttingDown || (!m_requests.empty() && (m_inFlightCount < m_config.maxInFlight));
+				});
+				if (m_isShuttingDown)
+				{
+					return;
+				}
+				request = m_requests.top();
+				m_requests.pop();
+				m_assets[request.handle].state = AssetState::Loading;
+				++m_inFlightCount;
+			}
+
+			// Decoding copies out of the mapping, so the file is only open while loading
+			DecodedMesh decoded{ request.handle, false, {}, {} };
+			MeshDecodeResult result{ MeshDecodeResult::NotAMesh };
+			MappedFile file;
+			const bool isOpen{ file.Open(request.path) };
+			if (isOpen)
+			{
+				decoded.isCompressed = IsCompressedMesh(file.GetData(), file.GetSize());
+				result = decoded.isCompressed ?
+					DecodeCompressedMesh(file.GetData(), file.GetSize(), decoded.compressedMesh) :
+					DecodeMesh(file.GetData(), file.GetSize(), decoded.mesh);
+				file.Close();
+			}
+
+			if (!isOpen)
+			{
+				spdlog::warn("AssetStreamer: Couldn't open '{}'.", request.path.string());
+			}
+			else if (result != MeshDecodeResult::Success)
+			{
+				spdlog::warn(
+					"AssetStreamer: Couldn't load '{}' ({}).",
+					request.path.string(),
+					GetMeshDecodeResultName(result));
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				if (isOpen && (result == MeshDecodeResult::Success))
+				{
+					m_assets[request.handle].state = AssetState::Decoded;
+					m_decoded.push_back(std::move(decoded));
+				}
+				else
+				{
+					m_assets[request.handle].state = AssetState::Failed;
+					++m_stats.failedCount;
+					--m_inFlightCount;
+					--m_pendingCount;
+				}
+			}
+			m_decodedCondition.notify_all();
+			m_loaderCondition.notify_one();
+		}
+	}
+
+	bool AssetStreamer::UploadDecoded(
+		IMeshUploadSink& sink,
+		std::unique_lock<std::mutex>& lock,
+		uint64_t& uploadedBytes)
+	{
+		DecodedMesh decoded{ std::move(m_decoded.front()) };
+		m_decoded.pop_front();
+
+		// Loaders keep running while the sink copies the mesh
+		lock.unlock();
+		const uint32_t meshIndex{
+			decoded.isCompressed ? sink.UploadCompressedMesh(decoded.compressedMesh) : sink.UploadMesh(decoded.mesh)
+		};
+		const uint64_t meshBytes{ decoded.GetByteSize() };
+		decoded.mesh = MeshData{};
+		decoded.compressedMesh = CompressedMeshData{};
+		lock.lock();
+
+		Asset& asset{ m_assets[decoded.handle] };
+		const bool isResident{ meshIndex != IMeshUploadSink::INVALID_MESH };
+		if (isResident)
+		{
+			asset.state = AssetState::Resident;
+			asset.meshIndex = meshIndex;
+			uploadedBytes += meshBytes;
+			m_stats.uploadedBytes += meshBytes;
+			++m_stats.residentCount;
+		}
+		else
+		{
+			asset.state = AssetState::Failed;
+			++m_stats.failedCount;
+		}
+		--m_inFlightCount;
+		--m_pendingCount;
+
+		// A slot in the in-flight budget just opened up
+		m_loaderCondition.notify_one();
+		return isResident;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
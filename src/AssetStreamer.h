@@ -0,0 +1,142 @@
+#pragma once
+#include "IMeshUploadSink.h"
+#include "MeshFile.h"
+#include "VertexCompression.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace HelloTriangle
+{
+	enum class AssetState
+	{
+		Queued,
+		Loading,
+		Decoded,
+		Resident,
+		Failed,
+	};
+
+	/// <summary>
+	/// AssetStreamer loads mesh files on a pool of background loader threads. Each
+	/// loader memory-maps a file, decodes and validates it, and parks the result
+	/// until the main thread hands it to an IMeshUploadSink in Update. Plain and
+	/// compressed mesh files are both accepted, told apart by their magic.
+	///  - Requests are served highest priority first, then in request order.
+	///  - At most maxInFlight requests are loading or waiting for upload at once,
+	///    which bounds the memory held by decoded meshes.
+	///  - Update uploads at most uploadBytesPerFrame (but always at least one mesh),
+	///    so a burst of finished loads is spread over several frames.
+	/// Loaders are dedicated threads rather than jobs, since they block on file I/O
+	/// that would otherwise stall the job system's frame work.
+	/// </summary>
+	class AssetStreamer
+	{
+	public:
+		using AssetHandle = uint32_t;
+
+		struct Config
+		{
+			uint32_t loaderThreadCount{ 2 };
+			uint32_t maxInFlight{ 8 };
+			uint64_t uploadBytesPerFrame{ 1024 * 1024 };
+		};
+
+		struct Stats
+		{
+			uint32_t requestedCount{ 0 };
+			uint32_t residentCount{ 0 };
+			uint32_t failedCount{ 0 };
+			uint64_t uploadedBytes{ 0 };
+			uint64_t lastFrameUploadedBytes{ 0 };
+		};
+
+		AssetStreamer(const Config& config);
+		~AssetStreamer();
+
+		AssetStreamer(const AssetStreamer&) = delete;
+		AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+		/// <summary>
+		/// Queues a mesh file for loading. Higher priorities load first.
+		/// </summary>
+		AssetHandle RequestMesh(const std::filesystem::path& path, int32_t priority = 0);
+
+		/// <summary>
+		/// Uploads decoded meshes to sink, within this frame's byte budget. Call once
+		/// per frame from the thread that owns the sink.
+		/// </summary>
+		void Update(IMeshUploadSink& sink);
+
+		/// <summary>
+		/// Blocks, uploading as meshes finish, until every request is resident or failed.
+		/// </summary>
+		void Flush(IMeshUploadSink& sink);
+
+		AssetState GetState(AssetHandle handle) const;
+
+		/// <summary>
+		/// The sink's mesh index for a resident asset, otherwise INVALID_MESH.
+		/// </summary>
+		uint32_t GetMeshIndex(AssetHandle handle) const;
+
+		/// <summary>
+		/// True once every request is resident or failed.
+		/// </summary>
+		bool IsIdle() const;
+
+		Stats GetStats() const;
+
+	private:
+		struct Request
+		{
+			int32_t priority;
+			uint64_t sequence;
+			AssetHandle handle;
+			std::filesystem::path path;
+
+			bool operator<(const Request& other) const;
+		};
+
+		struct Asset
+		{
+			AssetState state{ AssetState::Queued };
+			uint32_t meshIndex{ IMeshUploadSink::INVALID_MESH };
+		};
+
+		struct DecodedMesh
+		{
+			AssetHandle handle;
+			bool isCompressed;
+			MeshData mesh;
+			CompressedMeshData compressedMesh;
+
+			uint64_t GetByteSize() const;
+		};
+
+		const Config m_config;
+
+		mutable std::mutex m_mutex;
+		std::condition_variable m_loaderCondition;
+		std::condition_variable m_decodedCondition;
+		std::priority_queue<Request> m_requests;
+		std::deque<DecodedMesh> m_decoded;
+		std::vector<Asset> m_assets;
+		uint64_t m_nextSequence{ 0 };
+		uint32_t m_inFlightCount{ 0 };
+		uint32_t m_pendingCount{ 0 };
+		bool m_isShuttingDown{ false };
+		Stats m_stats;
+
+		std::vector<std::thread> m_loaders;
+
+		void LoaderMain();
+		bool UploadDecoded(IMeshUploadSink& sink, std::unique_lock<std::mutex>& lock, uint64_t& uploadedBytes);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,1447 @@
+#include "pch.h"
+#include "Benchmarks.h"
+#include "AssetStreamer.h"
+#include "Camera.h"
+#include "ConstantBufferRing.h"
+#include "DrawBatcher.h"
+#include "DrawSortKey.h"
+#include "DrawStateTracker.h"
+#include "HeapAllocationCounter.h"
+#include "InputEvents.h"
+#include "JobSystem.h"
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "MessageTranslator.h"
+#include "NullMeshUploadSink.h"
+#include "NullRenderBackend.h"
+#include "ParallelCommandRecorder.h"
+#include "RadixSort.h"
+#include "RenderGraph.h"
+#include "RingAllocator.h"
+#include "Simulation.h"
+#include "SimulationSnapshot.h"
+#include "SimdKernels.h"
+#include "ShaderConstants.h"
+#include "SoftwareRasterizer.h"
+#include "SpatialIndex.h"
+#include "Vertex.h"
+#include "VertexCompression.h"
+#include "VisibilityCuller.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t RANDOM_SEED{ 1234 };
+		constexpr float TICK_SECONDS{ 1.0f / 60.0f };
+		constexpr uint32_t RASTER_WIDTH{ 800 };
+		constexpr uint32_t RASTER_HEIGHT{ 600 };
+		constexpr size_t SNAPSHOT_RING_CAPACITY{ 8 };
+		constexpr uint32_t RENDER_GRAPH_PASSES{ 64 };
+		constexpr uint64_t UPLOAD_ALLOCATION_SIZE{ 256 };
+		constexpr uint32_t UPLOAD_FRAMES_IN_FLIGHT{ 2 };
+		constexpr uint64_t CONSTANT_RING_FAKE_GPU_BASE{ 0x10000 };
+		constexpr uint32_t BATCH_MATERIAL_COUNT{ 4 };
+		constexpr uint32_t BATCH_MESH_COUNT{ 4 };
+		constexpr uint32_t SORT_PASS_COUNT{ 2 };
+		constexpr uint32_t SORT_PIPELINE_COUNT{ 8 };
+		constexpr uint32_t SORT_ROOT_SIGNATURE_COUNT{ 2 };
+		constexpr uint32_t SORT_MATERIAL_COUNT{ 32 };
+		constexpr uint32_t SORT_MESH_COUNT{ 16 };
+		constexpr uint32_t STREAMING_MESH_COUNT{ 64 };
+		constexpr uint32_t STREAMING_GRID_SIZE{ 32 };
+		constexpr uint32_t STREAMING_LOADER_THREADS{ 2 };
+		constexpr float SPATIAL_CELL_SIZE{ 1.0f };
+		constexpr float SPATIAL_ENTITY_RADIUS{ 0.25f };
+		constexpr float SPATIAL_ENTITIES_PER_CELL{ 4.0f };
+		constexpr size_t SPATIAL_QUERY_COUNT{ 1024 };
+		constexpr float SPATIAL_QUERY_HALF_EXTENT{ 1.0f };
+
+		// Index sizes measured whatever the config, as for the simulation
+		constexpr std::array<uint32_t, 2> SPATIAL_SWEEP_ENTITY_COUNTS{ 100'000, 1'000'000 };
+
+		constexpr float CULLING_MIN_RADIUS{ 0.05f };
+		constexpr float CULLING_MAX_RADIUS{ 0.5f };
+		constexpr float CULLING_ENTITIES_PER_UNIT{ 8.0f };
+		constexpr uint32_t MESH_SPHERE_RINGS{ 128 };
+		constexpr uint32_t MESH_SPHERE_SEGMENTS{ 256 };
+		constexpr uint32_t RECORDING_MAX_CHUNKS{ 8 };
+		constexpr size_t RECORDING_MIN_ITEMS_PER_CHUNK{ 64 };
+
+		// Key message lParam bit 30, set on auto-repeated key downs
+		constexpr int64_t INPUT_REPEAT_BIT{ int64_t{ 1 } << 30 };
+
+		// World sizes simulated whatever the config, so entities per tick can be
+		// compared across the sizes that do and don't fit in cache
+		constexpr std::array<uint32_t, 3> SIMULATION_SWEEP_ENTITY_COUNTS{ 10'000, 100'000, 1'000'000 };
+
+		// Vertices of the hello triangle, at a 4:3 aspect ratio
+		constexpr std::array<Vertex, 3> TRIANGLE_VERTICES
+		{ {
+			{ { 0.0f, 0.25f * (4.0f / 3.0f), 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+			{ { 0.25f, -0.25f * (4.0f / 3.0f), 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+			{ { -0.25f, -0.25f * (4.0f / 3.0f), 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+		} };
+
+		/// <summary>
+		/// Structure-of-arrays points and velocities with reproducible contents.
+		/// </summary>
+		struct PointStreams
+		{
+			explicit PointStreams(size_t count) :
+				x(count), y(count), z(count), velocityX(count), velocityY(count), velocityZ(count)
+			{
+				std::mt19937 random{ RANDOM_SEED };
+				std::uniform_real_distribution<float> position{ -1.0f, 1.0f };
+				for (size_t i = 0; i < count; ++i)
+				{
+					x[i] = position(random);
+					y[i] = position(random);
+					z[i] = position(random);
+					velocityX[i] = position(random);
+					velocityY[i] = position(random);
+					velocityZ[i] = position(random);
+				}
+			}
+
+			std::vector<float> x, y, z, velocityX, velocityY, velocityZ;
+		};
+
+		// A flat gridSize x gridSize quad grid on the z = 0 plane, two triangles per quad
+		MeshData BuildGridMesh(uint32_t gridSize)
+		{
+			MeshData mesh;
+			const uint32_t rowVertices{ gridSize + 1 };
+			mesh.vertices.reserve(static_cast<size_t>(rowVertices) * rowVertices);
+			for (uint32_t y = 0; y < rowVertices; ++y)
+			{
+				for (uint32_t x = 0; x < rowVertices; ++x)
+				{
+					const float u{ static_cast<float>(x) / static_cast<float>(gridSize) };
+					const float v{ static_cast<float>(y) / static_cast<float>(gridSize) };
+					mesh.vertices.push_back(Vertex{ { u - 0.5f, v - 0.5f, 0.0f }, { u, v, 1.0f, 1.0f } });
+				}
+			}
+
+			mesh.indices.reserve(static_cast<size_t>(gridSize) * gridSize * 6);
+			for (uint32_t y = 0; y < gridSize; ++y)
+			{
+				for (uint32_t x = 0; x < gridSize; ++x)
+				{
+					// Clockwise seen from -z, the default camera's side
+					const uint16_t lowerLeft{ static_cast<uint16_t>((y * rowVertices) + x) };
+					const uint16_t lowerRight{ static_cast<uint16_t>(lowerLeft + 1) };
+					const uint16_t upperLeft{ static_cast<uint16_t>(lowerLeft + rowVertices) };
+					const uint16_t upperRight{ static_cast<uint16_t>(upperLeft + 1) };
+					mesh.indices.insert(
+						mesh.indices.end(),
+						{ lowerLeft, upperLeft, lowerRight, lowerRight, upperLeft, upperRight });
+				}
+			}
+			return mesh;
+		}
+
+		// A unit UV sphere colored by its normals, with triangles in random order as
+		// an unoptimized import might have them
+		MeshData BuildShuffledSphereMesh(uint32_t rings, uint32_t segments)
+		{
+			constexpr float PI{ 3.14159265f };
+			MeshData mesh;
+			const uint32_t ringVertices{ segments + 1 };
+			mesh.vertices.reserve(static_cast<size_t>(rings + 1) * ringVertices);
+			for (uint32_t ring = 0; ring <= rings; ++ring)
+			{
+				const float theta{ PI * static_cast<float>(ring) / static_cast<float>(rings) };
+				for (uint32_t segment = 0; segment <= segments; ++segment)
+				{
+					const float phi{ 2.0f * PI * static_cast<float>(segment) / static_cast<float>(segments) };
+					const float x{ std::sin(theta) * std::cos(phi) };
+					const float y{ std::cos(theta) };
+					const float z{ std::sin(theta) * std::sin(phi) };
+					mesh.vertices.push_back(Vertex{
+						{ x, y, z },
+						{ 0.5f + (0.5f * x), 0.5f + (0.5f * y), 0.5f + (0.5f * z), 1.0f }
+					});
+				}
+			}
+
+			std::vector<std::array<uint16_t, 3>> triangles;
+			triangles.reserve(static_cast<size_t>(rings) * segments * 2);
+			for (uint32_t ring = 0; ring < rings; ++ring)
+			{
+				for (uint32_t segment = 0; segment < segments; ++segment)
+				{
+					// Clockwise seen from outside
+					const uint16_t upperLeft{ static_cast<uint16_t>((ring * ringVertices) + segment) };
+					const uint16_t upperRight{ static_cast<uint16_t>(upperLeft + 1) };
+					const uint16_t lowerLeft{ static_cast<uint16_t>(upperLeft + ringVertices) };
+					const uint16_t lowerRight{ static_cast<uint16_t>(lowerLeft + 1) };
+					triangles.push_back({ upperLeft, upperRight, lowerLeft });
+					triangles.push_back({ lowerLeft, upperRight, lowerRight });
+				}
+			}
+
+			std::mt19937 random{ RANDOM_SEED };
+			std::shuffle(triangles.begin(), triangles.end(), random);
+			mesh.indices.reserve(triangles.size() * 3);
+			for (const std::array<uint16_t, 3>& triangle : triangles)
+			{
+				mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+			}
+			return mesh;
+		}
+
+		void PopulateWorld(World& world, const PointStreams& streams)
+		{
+			world.Reserve(streams.x.size());
+			for (size_t i = 0; i < streams.x.size(); ++i)
+			{
+				const Entity entity{ world.CreateEntity() };
+				world.SetPosition(entity, streams.x[i], streams.y[i], streams.z[i]);
+				world.SetVelocity(entity, streams.velocityX[i], streams.velocityY[i], streams.velocityZ[i]);
+			}
+		}
+
+		/// <summary>
+		/// OrderCheckingCommandListPool stands in for command lists by noting which
+		/// items each chunk recorded, then checks that submitting the chunks in index
+		/// order, as Renderer does, replays every item once and in order.
+		/// </summary>
+		class OrderCheckingCommandListPool : public ICommandListPool
+		{
+		public:
+			// ICommandListPool
+			virtual void BeginChunk(uint32_t chunk)
+			{
+				assert(chunk < RECORDING_MAX_CHUNKS);
+				m_chunks[chunk].beginCount += 1;
+			}
+
+			virtual void EndChunk(uint32_t chunk)
+			{
+				assert(chunk < RECORDING_MAX_CHUNKS);
+				m_chunks[chunk].endCount += 1;
+			}
+
+			/// <summary>
+			/// Called by the record callback, between BeginChunk and EndChunk.
+			/// </summary>
+			void RecordItems(uint32_t chunk, size_t begin, size_t end)
+			{
+				Chunk& recorded{ m_chunks[chunk] };
+				recorded.isOpen = (recorded.beginCount == (recorded.endCount + 1));
+				recorded.begin = begin;
+				recorded.end = end;
+			}
+
+			/// <summary>
+			/// Walks the chunks in submission order and returns whether they cover
+			/// [0, itemCount) in order, each begun, recorded and ended exactly once.
+			/// Resets the chunks for the next frame either way.
+			/// </summary>
+			bool Submit(uint32_t chunkCount, size_t itemCount)
+			{
+				bool isInOrder{ chunkCount <= RECORDING_MAX_CHUNKS };
+				size_t nextItem{ 0 };
+				for (uint32_t chunk = 0; isInOrder && (chunk < chunkCount); ++chunk)
+				{
+					const Chunk& recorded{ m_chunks[chunk] };
+					isInOrder = recorded.isOpen &&
+						(recorded.beginCount == 1) &&
+						(recorded.endCount == 1) &&
+						(recorded.begin == nextItem) &&
+						(recorded.end > recorded.begin);
+					nextItem = recorded.end;
+				}
+				isInOrder = isInOrder && (nextItem == itemCount);
+				m_chunks.fill(Chunk{});
+				return isInOrder;
+			}
+
+		private:
+			struct Chunk
+			{
+				uint32_t beginCount{ 0 };
+				uint32_t endCount{ 0 };
+				bool isOpen{ false };
+				size_t begin{ 0 };
+				size_t end{ 0 };
+			};
+
+			std::array<Chunk, RECORDING_MAX_CHUNKS> m_chunks{};
+		};
+
+		template<typename Function>
+		BenchmarkResult Measure(
+			std::string name,
+			uint32_t threadCount,
+			uint64_t iterations,
+			uint64_t itemsPerIteration,
+			Function&& iterate)
+		{
+			const auto start{ std::chrono::steady_clock::now() };
+			for (uint64_t i = 0; i < iterations; ++i)
+			{
+				iterate(i);
+			}
+			const std::chrono::duration<double, std::milli> elapsed{ std::chrono::steady_clock::now() - start };
+			spdlog::info(
+				"Benchmarks: {} ({} threads): {:.3f}ms.",
+				name,
+				threadCount,
+				elapsed.count());
+			return BenchmarkResult{
+				std::move(name),
+				threadCount,
+				iterations,
+				iterations * itemsPerIteration,
+				elapsed.count()
+			};
+		}
+
+		bool RunSimulationBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			JobSystem jobSystem{ JobSystem::GetDefaultWorkerCount() };
+			bool passed{ true };
+			auto measureUpdate = [&jobSystem, &config, &results, &passed](std::string name, uint32_t entityCount)
+			{
+				const PointStreams streams{ entityCount };
+				Simulation simulation{ nullptr, &jobSystem };
+				PopulateWorld(simulation.GetWorld(), streams);
+
+				// Warm up, so the first tick's one-off allocations aren't counted
+				simulation.Update(TICK_SECONDS);
+				uint64_t allocationCount{ 0 };
+				results.push_back(Measure(
+					std::move(name),
+					jobSystem.GetThreadCount(),
+					config.frameCount,
+					entityCount,
+					[&simulation, &allocationCount](uint64_t)
+					{
+						const uint64_t allocationStart{ GetHeapAllocationCount() };
+						simulation.Update(TICK_SECONDS);
+						allocationCount += GetHeapAllocationCount() - allocationStart;
+					}));
+
+				// Once warmed up, a tick only reuses storage it already has
+				if (allocationCount > 0)
+				{
+					spdlog::error(
+						"Benchmarks: {} made {} heap allocations!",
+						results.back().name,
+						allocationCount);
+					passed = false;
+				}
+			};
+
+			measureUpdate("simulation.update", config.entityCount);
+			for (const uint32_t entityCount : SIMULATION_SWEEP_ENTITY_COUNTS)
+			{
+				measureUpdate(fmt::format("simulation.update.{}_entities", entityCount), entityCount);
+			}
+			return passed;
+		}
+
+		bool RunSnapshotBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			const PointStreams streams{ config.entityCount };
+			JobSystem jobSystem{ JobSystem::GetDefaultWorkerCount() };
+			Simulation simulation{ nullptr, &jobSystem };
+			PopulateWorld(simulation.GetWorld(), streams);
+
+			// Fill the ring once so that every slot has grown to full size
+			SnapshotRing ring{ SNAPSHOT_RING_CAPACITY, config.entityCount };
+			for (size_t i = 0; i < ring.GetCapacity(); ++i)
+			{
+				simulation.SaveSnapshot(ring.Acquire(i));
+			}
+
+			results.push_back(Measure(
+				"simulation.snapshot",
+				1,
+				config.frameCount,
+				config.entityCount,
+				[&](uint64_t) { simulation.SaveSnapshot(ring.Acquire(simulation.GetTick())); }));
+
+			const size_t snapshotBytes{ simulation.GetWorld().GetByteSize() };
+			const double snapshotMilliseconds{ results.back().totalMilliseconds / std::max<double>(config.frameCount, 1.0) };
+			spdlog::info(
+				"Benchmarks: Snapshots copy {} bytes ({:.1f} per entity) in {:.3f}ms, {:.2f}GB/s.",
+				snapshotBytes,
+				static_cast<double>(snapshotBytes) / std::max<double>(config.entityCount, 1.0),
+				snapshotMilliseconds,
+				(snapshotMilliseconds > 0.0) ? (static_cast<double>(snapshotBytes) / (snapshotMilliseconds * 1e6)) : 0.0);
+
+			const SimulationSnapshot* start{ ring.Find(simulation.GetTick()) };
+			results.push_back(Measure(
+				"simulation.restore",
+				1,
+				config.frameCount,
+				config.entityCount,
+				[&](uint64_t) { simulation.RestoreSnapshot(*start); }));
+
+			// Roll back and re-simulate, on the job system and then on one thread;
+			// all three runs must land on the same state.
+			for (uint32_t tick = 0; tick < config.frameCount; ++tick)
+			{
+				simulation.Update(TICK_SECONDS);
+			}
+			const uint64_t expectedHash{ simulation.ComputeStateHash() };
+
+			simulation.RestoreSnapshot(*start);
+			for (uint32_t tick = 0; tick < config.frameCount; ++tick)
+			{
+				simulation.Update(TICK_SECONDS);
+			}
+			const uint64_t resimulatedHash{ simulation.ComputeStateHash() };
+
+			Simulation serialSimulation{ nullptr };
+			serialSimulation.RestoreSnapshot(*start);
+			for (uint32_t tick = 0; tick < config.frameCount; ++tick)
+			{
+				serialSimulation.Update(TICK_SECONDS);
+			}
+			const uint64_t serialHash{ serialSimulation.ComputeStateHash() };
+
+			if ((resimulatedHash == expectedHash) && (serialHash == expectedHash))
+			{
+				spdlog::info("Benchmarks: Re-simulation is deterministic (state hash {:016x}).", expectedHash);
+				return true;
+			}
+
+			spdlog::error(
+				"Benchmarks: Re-simulation diverged! Expected {:016x}, re-simulated {:016x}, serial {:016x}.",
+				expectedHash,
+				resimulatedHash,
+				serialHash);
+			return false;
+		}
+
+		void RunInputBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			// Presses and releases across the key range, with an auto-repeat after
+			// every press as a held key produces
+			std::vector<RawMessage> messages(config.inputEventCount);
+			for (uint32_t i = 0; i < config.inputEventCount; ++i)
+			{
+				const uint32_t phase{ i % 3 };
+				messages[i] = RawMessage{
+					.id = (phase == 2) ? RawMessageId::KEY_UP : RawMessageId::KEY_DOWN,
+					.wParam = (i / 3) % INPUT_KEY_COUNT,
+					.lParam = (phase == 1) ? INPUT_REPEAT_BIT : 0,
+				};
+			}
+
+			uint64_t translatedCount{ 0 };
+			results.push_back(Measure(
+				"input.translate",
+				1,
+				config.frameCount,
+				config.inputEventCount,
+				[&](uint64_t iteration)
+				{
+					InputEvent event{};
+					const std::chrono::nanoseconds timestamp{ static_cast<int64_t>(iteration) };
+					for (const RawMessage& message : messages)
+					{
+						translatedCount += TranslateMessageToEvent(message, timestamp, event) ? 1 : 0;
+					}
+				}));
+			spdlog::debug("Benchmarks: Translated {} input events.", translatedCount);
+
+			// One producer thread as the window proc would be, draining on this one
+			// as Simulation does; the queue is far smaller than a frame's events so
+			// both sides keep contending for it
+			auto queue{ std::make_unique<InputEventQueue>() };
+			results.push_back(Measure(
+				"input.spsc_ring",
+				2,
+				config.frameCount,
+				config.inputEventCount,
+				[&](uint64_t)
+				{
+					std::thread producer{ [&queue, &config]()
+						{
+							for (uint32_t i = 0; i < config.inputEventCount; ++i)
+							{
+								const InputEvent event{
+									.timestamp = std::chrono::nanoseconds{ i },
+									.type = InputEventType::KeyDown,
+									.key = static_cast<uint8_t>(i),
+								};
+								while (!queue->TryPush(event))
+								{
+									std::this_thread::yield();
+								}
+							}
+						} };
+
+					InputEvent event{};
+					for (uint32_t popped = 0; popped < config.inputEventCount;)
+					{
+						if (queue->TryPop(event))
+						{
+							++popped;
+						}
+						else
+						{
+							std::this_thread::yield();
+						}
+					}
+					producer.join();
+				}));
+		}
+
+		void RunSimdBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			PointStreams streams{ config.entityCount };
+			std::vector<float> transformed(static_cast<size_t>(config.entityCount) * 4);
+			float* const out[4]{
+				transformed.data(),
+				transformed.data() + config.entityCount,
+				transformed.data() + (static_cast<size_t>(config.entityCount) * 2),
+				transformed.data() + (static_cast<size_t>(config.entityCount) * 3),
+			};
+			const std::vector<float> halfExtents(config.entityCount, SPATIAL_ENTITY_RADIUS);
+			std::vector<float> bounds(static_cast<size_t>(config.entityCount) * 6);
+			float* const boundStreams[6]{
+				bounds.data(),
+				bounds.data() + config.entityCount,
+				bounds.data() + (static_cast<size_t>(config.entityCount) * 2),
+				bounds.data() + (static_cast<size_t>(config.entityCount) * 3),
+				bounds.data() + (static_cast<size_t>(config.entityCount) * 4),
+				bounds.data() + (static_cast<size_t>(config.entityCount) * 5),
+			};
+			const float matrix[16]{
+				1.0f, 0.0f, 0.0f, 0.5f,
+				0.0f, 1.0f, 0.0f, 0.25f,
+				0.0f, 0.0f, 1.0f, 0.0f,
+				0.0f, 0.0f, 0.0f, 1.0f,
+			};
+
+			// Every level up to the best one this CPU supports
+			const SimdLevel bestLevel{ DetectSimdLevel() };
+			for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+			{
+				if (static_cast<int>(level) > static_cast<int>(bestLevel))
+				{
+					break;
+				}
+				const SimdKernels& kernels{ GetSimdKernels(level) };
+				const std::string levelName{ GetSimdLevelName(level) };
+
+				results.push_back(Measure(
+					"simd.integrate." + levelName,
+					1,
+					config.frameCount,
+					config.entityCount,
+					[&](uint64_t)
+					{
+						kernels.IntegratePositions(
+							config.entityCount,
+							streams.x.data(),
+							streams.y.data(),
+							streams.z.data(),
+							streams.velocityX.data(),
+							streams.velocityY.data(),
+							streams.velocityZ.data(),
+							TICK_SECONDS);
+					}));
+
+				results.push_back(Measure(
+					"simd.transform." + levelName,
+					1,
+					config.frameCount,
+					config.entityCount,
+					[&](uint64_t)
+					{
+						kernels.TransformPoints(
+							config.entityCount,
+							matrix,
+							streams.x.data(),
+							streams.y.data(),
+							streams.z.data(),
+							out);
+					}));
+
+				results.push_back(Measure(
+					"simd.update_aabbs." + levelName,
+					1,
+					config.frameCount,
+					config.entityCount,
+					[&](uint64_t)
+					{
+						kernels.UpdateAabbs(
+							config.entityCount,
+							streams.x.data(),
+							streams.y.data(),
+							streams.z.data(),
+							halfExtents.data(),
+							halfExtents.data(),
+							halfExtents.data(),
+							boundStreams);
+					}));
+			}
+		}
+
+		bool RunJobSystemBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			PointStreams streams{ config.entityCount };
+			const SimdKernels& kernels{ GetSimdKernels(DetectSimdLevel()) };
+			// Total thread counts, the calling thread included: doubling, and the
+			// hardware's count. Counts past the hardware's show what oversubscribing
+			// costs.
+			std::vector<uint32_t> threadCounts{ 1, 2, 4, 8, std::max(std::thread::hardware_concurrency(), 1u) };
+			std::sort(threadCounts.begin(), threadCounts.end());
+			threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+			const auto integrate = [&kernels, &streams](size_t begin, size_t end)
+			{
+				kernels.IntegratePositions(
+					end - begin,
+					streams.x.data() + begin,
+					streams.y.data() + begin,
+					streams.z.data() + begin,
+					streams.velocityX.data() + begin,
+					streams.velocityY.data() + begin,
+					streams.velocityZ.data() + begin,
+					TICK_SECONDS);
+			};
+
+			bool passed{ true };
+			double singleThreadMilliseconds{ 0.0 };
+			for (uint32_t threadCount : threadCounts)
+			{
+				JobSystem jobSystem{ threadCount - 1 };
+
+				// Once the job pool and deques have grown, ParallelFor mustn't allocate
+				jobSystem.ParallelFor(config.entityCount, 4096, integrate);
+
+				uint64_t allocationCount{ 0 };
+				BenchmarkResult result{ Measure(
+					"jobs.parallel_for",
+					jobSystem.GetThreadCount(),
+					config.frameCount,
+					config.entityCount,
+					[&](uint64_t)
+					{
+						const uint64_t allocationStart{ GetHeapAllocationCount() };
+						jobSystem.ParallelFor(config.entityCount, 4096, integrate);
+						allocationCount += GetHeapAllocationCount() - allocationStart;
+					}) };
+
+				// Relative to the first, single-threaded run; counters are integers, so
+				// in percent
+				if (threadCount == 1)
+				{
+					singleThreadMilliseconds = result.totalMilliseconds;
+				}
+				const double speedup{ singleThreadMilliseconds / std::max(result.totalMilliseconds, 1e-9) };
+				result.counters = {
+					{ "speedupPercent", static_cast<uint64_t>(std::llround(speedup * 100.0)) },
+				};
+				spdlog::info("Benchmarks: jobs.parallel_for on {} threads is {:.2f}x one thread.", threadCount, speedup);
+				results.push_back(std::move(result));
+
+				if (allocationCount > 0)
+				{
+					spdlog::error(
+						"Benchmarks: jobs.parallel_for ({} threads) made {} heap allocations!",
+						threadCount,
+						allocationCount);
+					passed = false;
+				}
+			}
+			return passed;
+		}
+
+		void RunSpatialIndexBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			JobSystem jobSystem{ JobSystem::GetDefaultWorkerCount() };
+			const SimdKernels& kernels{ GetSimdKernels(DetectSimdLevel()) };
+			auto measureIndex = [&jobSystem, &kernels, &config, &results](const std::string& suffix, uint32_t entityCount)
+			{
+				// Spread entities over a cube sized for a few per cell; every other one moves
+				const float extent{
+					std::cbrt(static_cast<float>(entityCount) / SPATIAL_ENTITIES_PER_CELL) * SPATIAL_CELL_SIZE
+				};
+				std::mt19937 random{ RANDOM_SEED };
+				std::uniform_real_distribution<float> position{ 0.0f, extent };
+				std::uniform_real_distribution<float> velocity{ -1.0f, 1.0f };
+				World world;
+				world.Reserve(entityCount);
+				for (uint32_t i = 0; i < entityCount; ++i)
+				{
+					const Entity entity{ world.CreateEntity() };
+					world.SetPosition(entity, position(random), position(random), position(random));
+					if ((i % 2) == 0)
+					{
+						world.SetVelocity(entity, velocity(random), velocity(random), velocity(random));
+					}
+				}
+
+				SpatialIndex index{ SpatialIndex::Config{ SPATIAL_CELL_SIZE, SPATIAL_ENTITY_RADIUS, true } };
+				index.Sync(world);
+
+				results.push_back(Measure(
+					"spatial.integrate_sync" + suffix,
+					1,
+					config.frameCount,
+					entityCount,
+					[&](uint64_t)
+					{
+						const MovingView moving{ world.GetMovingView() };
+						kernels.IntegratePositions(
+							moving.count,
+							moving.positionX,
+							moving.positionY,
+							moving.positionZ,
+							moving.velocityX,
+							moving.velocityY,
+							moving.velocityZ,
+							TICK_SECONDS);
+						index.Sync(world);
+					}));
+
+				results.push_back(Measure(
+					"spatial.rebuild" + suffix,
+					1,
+					config.frameCount,
+					entityCount,
+					[&](uint64_t)
+					{
+						index.Invalidate();
+						index.Sync(world);
+					}));
+
+				std::vector<Aabb> boxes(SPATIAL_QUERY_COUNT);
+				for (Aabb& box : boxes)
+				{
+					for (size_t axis = 0; axis < 3; ++axis)
+					{
+						const float center{ position(random) };
+						box.min[axis] = center - SPATIAL_QUERY_HALF_EXTENT;
+						box.max[axis] = center + SPATIAL_QUERY_HALF_EXTENT;
+					}
+				}
+				SpatialQueryResults queryResults;
+				results.push_back(Measure(
+					"spatial.query_aabb" + suffix,
+					jobSystem.GetThreadCount(),
+					config.frameCount,
+					SPATIAL_QUERY_COUNT,
+					[&](uint64_t) { index.QueryAabbs(boxes.data(), boxes.size(), queryResults, &jobSystem); }));
+
+				// Look across the cube from one face
+				Camera camera;
+				camera.SetLookAt(
+					{ extent * 0.5f, extent * 0.5f, -1.0f },
+					{ extent * 0.5f, extent * 0.5f, extent },
+					{ 0.0f, 1.0f, 0.0f });
+				camera.SetPerspective(1.0f, 4.0f / 3.0f, 0.1f, extent + 1.0f);
+				const Frustum frustum{ Frustum::FromViewProjection(camera.GetViewProjection().data()) };
+				std::vector<uint32_t> visible;
+				visible.reserve(entityCount);
+				results.push_back(Measure(
+					"spatial.query_frustum" + suffix,
+					1,
+					config.frameCount,
+					entityCount,
+					[&](uint64_t)
+					{
+						visible.clear();
+						index.QueryFrustum(frustum, visible);
+					}));
+
+				const SpatialIndex::Stats stats{ index.GetStats() };
+				spdlog::info(
+					"Benchmarks: Spatial index holds {} moving entities in {} cells and {} static in {} BVH nodes; {} of {} visible.",
+					stats.dynamicCount,
+					stats.cellCount,
+					stats.staticCount,
+					stats.bvhNodeCount,
+					visible.size(),
+					entityCount);
+			};
+
+			measureIndex("", config.entityCount);
+			for (const uint32_t entityCount : SPATIAL_SWEEP_ENTITY_COUNTS)
+			{
+				measureIndex(fmt::format(".{}_entities", entityCount), entityCount);
+			}
+		}
+
+		void RunCullingBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			// Spheres of mixed sizes in a cube, seen from outside one face with a
+			// narrower field of view than the cube, so part of it is off screen
+			const float extent{ std::cbrt(static_cast<float>(config.entityCount) / CULLING_ENTITIES_PER_UNIT) * 0.5f };
+			std::mt19937 random{ RANDOM_SEED };
+			std::uniform_real_distribution<float> position{ -extent, extent };
+			std::uniform_real_distribution<float> size{ CULLING_MIN_RADIUS, CULLING_MAX_RADIUS };
+			std::vector<float> x(config.entityCount);
+			std::vector<float> y(config.entityCount);
+			std::vector<float> z(config.entityCount);
+			std::vector<float> radius(config.entityCount);
+			for (uint32_t i = 0; i < config.entityCount; ++i)
+			{
+				x[i] = position(random);
+				y[i] = position(random);
+				z[i] = position(random);
+				radius[i] = size(random);
+			}
+
+			Camera camera;
+			camera.SetLookAt({ 0.0f, 0.0f, -3.0f * extent }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+			camera.SetPerspective(0.6f, 4.0f / 3.0f, 0.1f, 5.0f * extent);
+			const float* viewProjection{ camera.GetViewProjection().data() };
+
+			// Two walls just in front of the cube, hiding two of its four quadrants
+			const MeshData wall{ BuildGridMesh(1) };
+			const InstanceData walls[2]{
+				{ { -0.5f * extent, -0.5f * extent, -1.1f * extent, extent }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+				{ { 0.5f * extent, 0.5f * extent, -1.1f * extent, extent }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+			};
+
+			std::vector<uint32_t> visible;
+			visible.reserve(config.entityCount);
+			const SimdLevel bestLevel{ DetectSimdLevel() };
+			for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+			{
+				if (static_cast<int>(level) > static_cast<int>(bestLevel))
+				{
+					break;
+				}
+				VisibilityCuller culler{ VisibilityCuller::Config{ false, 0, 0, level } };
+				results.push_back(Measure(
+					std::string{ "culling.frustum." } + GetSimdLevelName(level),
+					1,
+					config.frameCount,
+					config.entityCount,
+					[&](uint64_t)
+					{
+						culler.BeginFrame(viewProjection);
+						visible.clear();
+						culler.Cull(config.entityCount, x.data(), y.data(), z.data(), radius.data(), 0.0f, visible);
+					}));
+			}
+
+			// Occluders are rasterized every frame, as they would be for a moving camera
+			VisibilityCuller culler{ VisibilityCuller::Config{ true } };
+			results.push_back(Measure(
+				"culling.occlusion",
+				1,
+				config.frameCount,
+				config.entityCount,
+				[&](uint64_t)
+				{
+					culler.BeginFrame(viewProjection);
+					for (const InstanceData& instance : walls)
+					{
+						culler.AddOccluder(wall, instance);
+					}
+					visible.clear();
+					culler.Cull(config.entityCount, x.data(), y.data(), z.data(), radius.data(), 0.0f, visible);
+				}));
+
+			const VisibilityCuller::Stats& stats{ culler.GetStats() };
+			const uint64_t frames{ std::max<uint64_t>(config.frameCount, 1) };
+			spdlog::info(
+				"Benchmarks: Culling per frame: {} tested, {} outside the frustum, {} occluded, {} visible.",
+				stats.tested / frames,
+				stats.frustumCulled / frames,
+				stats.occlusionCulled / frames,
+				stats.visible / frames);
+		}
+
+		bool RunRasterizerBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			std::vector<InstanceData> instances(config.drawCount);
+			std::mt19937 random{ RANDOM_SEED };
+			std::uniform_real_distribution<float> position{ -1.0f, 1.0f };
+			for (InstanceData& instance : instances)
+			{
+				instance = InstanceData{
+					{ position(random), position(random), 0.0f, 0.1f },
+					{ 1.0f, 1.0f, 1.0f, 1.0f }
+				};
+			}
+
+			JobSystem jobSystem{ JobSystem::GetDefaultWorkerCount() };
+			SoftwareRasterizer rasterizer{ RASTER_WIDTH, RASTER_HEIGHT, &jobSystem };
+			const float clearColor[4]{ 0.0f, 0.2f, 0.4f, 1.0f };
+			BenchmarkResult result{ Measure(
+				"raster.draw_instanced",
+				jobSystem.GetThreadCount(),
+				config.frameCount,
+				config.drawCount,
+				[&](uint64_t)
+				{
+					rasterizer.Clear(clearColor);
+					rasterizer.DrawInstanced(
+						TRIANGLE_VERTICES.data(),
+						static_cast<uint32_t>(TRIANGLE_VERTICES.size()),
+						instances.data(),
+						static_cast<uint32_t>(instances.size()));
+					rasterizer.Flush();
+				}) };
+			results.push_back(result);
+
+			// Same run, reported as fill rate
+			result.name = "raster.pixels_shaded";
+			result.items = rasterizer.GetStats().pixelsShaded;
+			results.push_back(std::move(result));
+
+			if (config.rasterImagePath.empty())
+			{
+				return true;
+			}
+			if (!rasterizer.WriteImage(config.rasterImagePath))
+			{
+				return false;
+			}
+			spdlog::info("Benchmarks: Wrote the rasterized frame to {}.", config.rasterImagePath);
+			return true;
+		}
+
+		bool RunRenderGraphBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			RenderGraph graph;
+			NullRenderBackend backend;
+			BenchmarkResult result{ Measure(
+				"render_graph.compile_execute",
+				1,
+				config.frameCount,
+				RENDER_GRAPH_PASSES,
+				[&](uint64_t)
+				{
+					graph.Reset();
+					backend.Clear();
+
+					// A chain of passes, each reading the previous pass's transient target
+					const RenderResourceHandle backBuffer{ graph.ImportResource(
+						"BackBuffer",
+						ResourceState::Present,
+						ResourceState::Present) };
+					RenderResourceHandle previous{ INVALID_RENDER_RESOURCE };
+					for (uint32_t i = 0; i < RENDER_GRAPH_PASSES; ++i)
+					{
+						const uint32_t pass{ graph.AddPass("Pass", []() {}) };
+						if (previous != INVALID_RENDER_RESOURCE)
+						{
+							graph.Read(pass, previous, ResourceState::ShaderRead);
+						}
+						if (i + 1 < RENDER_GRAPH_PASSES)
+						{
+							previous = graph.CreateTransient("Target", 1024 * 1024, 65536);
+							graph.Write(pass, previous, ResourceState::RenderTarget);
+						}
+						else
+						{
+							graph.Write(pass, backBuffer, ResourceState::RenderTarget);
+						}
+					}
+
+					// A debug view that nothing reads, for the graph to cull
+					const uint32_t debugPass{ graph.AddPass("Debug", []() {}) };
+					graph.Read(debugPass, previous, ResourceState::ShaderRead);
+					graph.Write(debugPass, graph.CreateTransient("Debug", 1024 * 1024, 65536), ResourceState::RenderTarget);
+
+					graph.Compile();
+					graph.Execute(backend);
+				}) };
+
+			const RenderGraphStats& stats{ graph.GetStats() };
+			result.counters = {
+				{ "declaredPasses", stats.declaredPassCount },
+				{ "culledPasses", stats.culledPassCount },
+				{ "barriers", stats.barrierCount },
+				{ "transientBytes", stats.transientBytes },
+				{ "aliasedHeapBytes", stats.aliasedHeapBytes },
+			};
+			results.push_back(std::move(result));
+			spdlog::info(
+				"Benchmarks: Render graph kept {} of {} passes with {} barriers, aliasing {} transient bytes into {}.",
+				stats.declaredPassCount - stats.culledPassCount,
+				stats.declaredPassCount,
+				stats.barrierCount,
+				stats.transientBytes,
+				stats.aliasedHeapBytes);
+
+			if ((backend.GetPassCount() != (stats.declaredPassCount - stats.culledPassCount)) ||
+				(backend.GetBarrierCount() != stats.barrierCount))
+			{
+				spdlog::error(
+					"Benchmarks: Render graph executed {} passes and {} barriers, but compiled {} and {}!",
+					backend.GetPassCount(),
+					backend.GetBarrierCount(),
+					stats.declaredPassCount - stats.culledPassCount,
+					stats.barrierCount);
+				return false;
+			}
+			return true;
+		}
+
+		void RunUploadRingBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			// Room for every frame in flight plus the one being written, as the
+			// renderer sizes its per-frame upload buffers
+			RingAllocator ring{
+				(UPLOAD_FRAMES_IN_FLIGHT + 1) * static_cast<uint64_t>(config.drawCount) * UPLOAD_ALLOCATION_SIZE
+			};
+			uint64_t failedAllocations{ 0 };
+			results.push_back(Measure(
+				"upload_ring.allocate",
+				1,
+				config.frameCount,
+				config.drawCount,
+				[&](uint64_t frame)
+				{
+					// Pretend the GPU runs exactly UPLOAD_FRAMES_IN_FLIGHT frames behind
+					if (frame >= UPLOAD_FRAMES_IN_FLIGHT)
+					{
+						ring.Retire(frame - UPLOAD_FRAMES_IN_FLIGHT + 1);
+					}
+					for (uint32_t i = 0; i < config.drawCount; ++i)
+					{
+						if (ring.Allocate(UPLOAD_ALLOCATION_SIZE, UPLOAD_ALLOCATION_SIZE) == RingAllocator::INVALID_OFFSET)
+						{
+							++failedAllocations;
+						}
+					}
+					ring.FinishBatch(frame + 1);
+				}));
+
+			if (failedAllocations > 0)
+			{
+				spdlog::warn("Benchmarks: {} upload ring allocations failed; the ring is too small for this config.", failedAllocations);
+			}
+		}
+
+		void RunConstantRingBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			// A heap buffer stands in for the mapped upload heap, with a made-up GPU
+			// base address; one frame's constants plus one CBV per draw each frame.
+			const uint64_t frameBytes{
+				ConstantBufferRing::AlignSize(sizeof(FrameConstants)) * (static_cast<uint64_t>(config.drawCount) + 1)
+			};
+			const uint64_t capacity{ (UPLOAD_FRAMES_IN_FLIGHT + 1) * frameBytes };
+			std::vector<uint8_t> storage(capacity + ConstantBufferRing::CONSTANT_BUFFER_ALIGNMENT);
+			void* base{ storage.data() };
+			size_t space{ storage.size() };
+			std::align(ConstantBufferRing::CONSTANT_BUFFER_ALIGNMENT, capacity, base, space);
+			ConstantBufferRing ring{ static_cast<uint8_t*>(base), CONSTANT_RING_FAKE_GPU_BASE, capacity };
+
+			Camera camera;
+			camera.SetPerspective(1.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+			results.push_back(Measure(
+				"constant_ring.push",
+				1,
+				config.frameCount,
+				config.drawCount + 1ull,
+				[&](uint64_t frame)
+				{
+					if (frame >= UPLOAD_FRAMES_IN_FLIGHT)
+					{
+						ring.Retire(frame - UPLOAD_FRAMES_IN_FLIGHT + 1);
+					}
+
+					// Move the camera every frame so the view-projection is rebuilt
+					const float angle{ static_cast<float>(frame) * 0.01f };
+					camera.SetLookAt(
+						{ std::sin(angle) * 2.0f, 0.0f, -std::cos(angle) * 2.0f },
+						{ 0.0f, 0.0f, 0.0f },
+						{ 0.0f, 1.0f, 0.0f });
+					FrameConstants constants{};
+					const Camera::Matrix& viewProjection{ camera.GetViewProjection() };
+					std::copy(viewProjection.begin(), viewProjection.end(), constants.viewProjection);
+					ring.Push(constants);
+
+					for (uint32_t i = 0; i < config.drawCount; ++i)
+					{
+						constants.viewProjection[3] = static_cast<float>(i);
+						ring.Push(constants);
+					}
+					ring.FinishFrame(frame + 1);
+				}));
+
+			if (ring.GetFailedAllocationCount() > 0)
+			{
+				spdlog::warn("Benchmarks: {} constant ring allocations failed; the ring is too small for this config.", ring.GetFailedAllocationCount());
+			}
+		}
+
+		void RunAssetStreamingBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			const std::filesystem::path directory{
+				std::filesystem::temp_directory_path() / "HelloTriangleBenchmarkMeshes"
+			};
+			std::error_code error;
+			std::filesystem::create_directories(directory, error);
+
+			const MeshData grid{ BuildGridMesh(STREAMING_GRID_SIZE) };
+			std::vector<std::filesystem::path> paths;
+			for (uint32_t i = 0; i < STREAMING_MESH_COUNT; ++i)
+			{
+				paths.push_back(directory / ("Mesh" + std::to_string(i) + ".mesh"));
+				if (!WriteMeshFile(paths.back(), grid))
+				{
+					spdlog::warn("Benchmarks: Skipping asset streaming, couldn't write test meshes.");
+					std::filesystem::remove_all(directory, error);
+					return;
+				}
+			}
+
+			AssetStreamer::Config streamerConfig;
+			streamerConfig.loaderThreadCount = STREAMING_LOADER_THREADS;
+			AssetStreamer streamer{ streamerConfig };
+			NullMeshUploadSink sink;
+			results.push_back(Measure(
+				"asset_streamer.load",
+				STREAMING_LOADER_THREADS,
+				config.frameCount,
+				STREAMING_MESH_COUNT,
+				[&](uint64_t)
+				{
+					for (uint32_t i = 0; i < STREAMING_MESH_COUNT; ++i)
+					{
+						streamer.RequestMesh(paths[i], static_cast<int32_t>(i % 4));
+					}
+					streamer.Flush(sink);
+				}));
+
+			const AssetStreamer::Stats stats{ streamer.GetStats() };
+			if (stats.failedCount > 0)
+			{
+				spdlog::warn("Benchmarks: {} streamed meshes failed to load.", stats.failedCount);
+			}
+			std::filesystem::remove_all(directory, error);
+		}
+
+		void RunDrawBatcherBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			std::mt19937 random{ RANDOM_SEED };
+			std::uniform_int_distribution<uint32_t> material{ 0, BATCH_MATERIAL_COUNT - 1 };
+			std::uniform_int_distribution<uint32_t> mesh{ 0, BATCH_MESH_COUNT - 1 };
+			std::vector<std::pair<uint32_t, uint32_t>> keys(config.drawCount);
+			for (auto& key : keys)
+			{
+				key = { material(random), mesh(random) };
+			}
+
+			DrawBatcher batcher;
+			batcher.Reserve(config.drawCount);
+			DrawBatchingTotals totals;
+			const InstanceData instance{ { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } };
+			BenchmarkResult result{ Measure(
+				"draw_batcher.build",
+				1,
+				config.frameCount,
+				config.drawCount,
+				[&](uint64_t)
+				{
+					batcher.Reset();
+					for (const auto& [materialId, meshId] : keys)
+					{
+						batcher.Submit(materialId, meshId, instance);
+					}
+					batcher.Build();
+					totals.Add(batcher.GetStats());
+				}) };
+
+			const uint64_t frameCount{ std::max<uint64_t>(totals.frameCount, 1) };
+			const uint64_t buildNanoseconds{ static_cast<uint64_t>(totals.buildTime.count()) / frameCount };
+			result.counters = {
+				{ "submittedDraws", totals.submittedCount / frameCount },
+				{ "batches", totals.batchCount / frameCount },
+				{ "buildNanoseconds", buildNanoseconds },
+				{ "maxBuildNanoseconds", static_cast<uint64_t>(totals.maxBuildTime.count()) },
+			};
+			results.push_back(std::move(result));
+			spdlog::info(
+				"Benchmarks: Batching merged {} draws into {} draw calls per frame in {:.3f}ms.",
+				totals.submittedCount / frameCount,
+				totals.batchCount / frameCount,
+				static_cast<double>(buildNanoseconds) / 1e6);
+		}
+
+		// Feeds the state a renderer would set for draw through tracker, the way
+		// D3D12StateTrackingCommandList does
+		void TrackDrawState(DrawStateTracker& tracker, const DrawKey& draw)
+		{
+			tracker.Update(DrawStateTracker::PIPELINE_SLOT, draw.pipeline);
+			tracker.Update(DrawStateTracker::ROOT_SIGNATURE_SLOT, draw.rootSignature);
+			tracker.Update(DrawStateTracker::FIRST_ROOT_PARAMETER_SLOT, draw.pass);
+			tracker.Update(DrawStateTracker::FIRST_ROOT_PARAMETER_SLOT + 1, draw.material);
+			tracker.Update(DrawStateTracker::FIRST_VERTEX_BUFFER_SLOT, draw.mesh);
+			tracker.Update(DrawStateTracker::INDEX_BUFFER_SLOT, draw.mesh);
+		}
+
+		bool RunDrawSortBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			std::mt19937 random{ RANDOM_SEED };
+			std::uniform_int_distribution<uint32_t> pass{ 0, SORT_PASS_COUNT - 1 };
+			std::uniform_int_distribution<uint32_t> pipeline{ 0, SORT_PIPELINE_COUNT - 1 };
+			std::uniform_int_distribution<uint32_t> rootSignature{ 0, SORT_ROOT_SIGNATURE_COUNT - 1 };
+			std::uniform_int_distribution<uint32_t> material{ 0, SORT_MATERIAL_COUNT - 1 };
+			std::uniform_int_distribution<uint32_t> mesh{ 0, SORT_MESH_COUNT - 1 };
+			std::uniform_real_distribution<float> depth{ 0.0f, 1.0f };
+			std::vector<DrawKey> draws(config.drawCount);
+			std::vector<RadixSortEntry> submitted(config.drawCount);
+			for (size_t i = 0; i < draws.size(); ++i)
+			{
+				draws[i] = DrawKey{
+					.pass = pass(random),
+					.pipeline = pipeline(random),
+					.rootSignature = rootSignature(random),
+					.material = material(random),
+					.mesh = mesh(random),
+					.depth = depth(random),
+				};
+				submitted[i] = RadixSortEntry{ DrawSortKey::Encode(draws[i]), static_cast<uint32_t>(i) };
+			}
+
+			std::vector<RadixSortEntry> entries;
+			std::vector<RadixSortEntry> scratch;
+			entries.reserve(config.drawCount);
+			scratch.reserve(config.drawCount);
+			results.push_back(Measure(
+				"draw_sort.radix",
+				1,
+				config.frameCount,
+				config.drawCount,
+				[&](uint64_t)
+				{
+					entries.assign(submitted.begin(), submitted.end());
+					RadixSort(entries, scratch);
+				}));
+
+			const std::vector<RadixSortEntry> radixSorted{ entries };
+			results.push_back(Measure(
+				"draw_sort.std_stable_sort",
+				1,
+				config.frameCount,
+				config.drawCount,
+				[&](uint64_t)
+				{
+					entries.assign(submitted.begin(), submitted.end());
+					std::stable_sort(entries.begin(), entries.end(),
+						[](const RadixSortEntry& a, const RadixSortEntry& b)
+						{
+							return a.key < b.key;
+						});
+				}));
+
+			// Both sorts are stable, so they must agree on payloads as well as keys
+			const bool isSortMatched{ std::equal(
+				radixSorted.begin(), radixSorted.end(), entries.begin(), entries.end(),
+				[](const RadixSortEntry& a, const RadixSortEntry& b)
+				{
+					return (a.key == b.key) && (a.value == b.value);
+				}) };
+			if (!isSortMatched)
+			{
+				spdlog::error("Benchmarks: Radix sort order differs from std::stable_sort!");
+			}
+
+			// entries is left sorted by the last run
+			DrawStateTracker tracker;
+			results.push_back(Measure(
+				"draw_state.filter",
+				1,
+				config.frameCount,
+				config.drawCount,
+				[&](uint64_t)
+				{
+					tracker.Reset();
+					for (const RadixSortEntry& entry : entries)
+					{
+						TrackDrawState(tracker, draws[entry.value]);
+					}
+				}));
+
+			DrawStateTracker sortedTracker;
+			DrawStateTracker unsortedTracker;
+			for (size_t i = 0; i < draws.size(); ++i)
+			{
+				TrackDrawState(sortedTracker, draws[entries[i].value]);
+				TrackDrawState(unsortedTracker, draws[i]);
+			}
+			spdlog::info(
+				"Benchmarks: Draw state per frame: {} changes avoided of {} when sorted, {} in submission order.",
+				sortedTracker.GetStats().avoidedCount,
+				sortedTracker.GetStats().issuedCount + sortedTracker.GetStats().avoidedCount,
+				unsortedTracker.GetStats().avoidedCount);
+			return isSortMatched;
+		}
+
+		void RunMeshOptimizerBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			MeshData mesh{ BuildShuffledSphereMesh(MESH_SPHERE_RINGS, MESH_SPHERE_SEGMENTS) };
+			const std::vector<uint16_t> shuffledIndices{ mesh.indices };
+			const size_t triangleCount{ mesh.indices.size() / 3 };
+
+			results.push_back(Measure(
+				"mesh_optimizer.vertex_cache",
+				1,
+				config.frameCount,
+				triangleCount,
+				[&](uint64_t)
+				{
+					mesh.indices = shuffledIndices;
+					OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+				}));
+			const std::vector<uint16_t> cacheOptimizedIndices{ mesh.indices };
+
+			results.push_back(Measure(
+				"mesh_optimizer.overdraw",
+				1,
+				config.frameCount,
+				triangleCount,
+				[&](uint64_t)
+				{
+					mesh.indices = cacheOptimizedIndices;
+					OptimizeOverdraw(mesh.indices, mesh.vertices);
+				}));
+			OptimizeVertexFetch(mesh);
+
+			CompressedMeshData compressed;
+			results.push_back(Measure(
+				"mesh_optimizer.compress",
+				1,
+				config.frameCount,
+				mesh.vertices.size(),
+				[&](uint64_t)
+				{
+					compressed = CompressMesh(mesh);
+				}));
+
+			spdlog::info(
+				"Benchmarks: Mesh ACMR {:.3f} shuffled, {:.3f} cache optimized, {:.3f} overdraw optimized.",
+				AnalyzeVertexCache(shuffledIndices, mesh.vertices.size()).acmr,
+				AnalyzeVertexCache(cacheOptimizedIndices, mesh.vertices.size()).acmr,
+				AnalyzeVertexCache(mesh.indices, mesh.vertices.size()).acmr);
+
+			const VertexCompressionError error{ MeasureVertexCompressionError(mesh, compressed) };
+			const VertexCompressionError bound{ GetVertexCompressionErrorBound(compressed.quantization) };
+			const size_t indexStreamByteSize{ EncodeIndexStream(compressed.indices).size() };
+			spdlog::info(
+				"Benchmarks: Mesh compressed from {} to {} bytes ({} to {} of vertices, {} to {} of indices); error position {:.3g} (bound {:.3g}), color {:.3g} (bound {:.3g}).",
+				mesh.GetByteSize(),
+				(compressed.vertices.size() * sizeof(CompressedVertex)) + indexStreamByteSize,
+				mesh.vertices.size() * sizeof(Vertex),
+				compressed.vertices.size() * sizeof(CompressedVertex),
+				mesh.indices.size() * sizeof(uint16_t),
+				indexStreamByteSize,
+				error.position,
+				bound.position,
+				error.color,
+				bound.color);
+		}
+
+		bool RunCommandRecordingBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+		{
+			JobSystem jobSystem{ JobSystem::GetDefaultWorkerCount() };
+			ParallelCommandRecorder recorder{
+				&jobSystem,
+				std::min(jobSystem.GetThreadCount(), RECORDING_MAX_CHUNKS),
+				RECORDING_MIN_ITEMS_PER_CHUNK
+			};
+			OrderCheckingCommandListPool pool;
+			uint64_t outOfOrderFrames{ 0 };
+			results.push_back(Measure(
+				"command_recorder.record",
+				jobSystem.GetThreadCount(),
+				config.frameCount,
+				config.drawCount,
+				[&](uint64_t)
+				{
+					const uint32_t chunkCount{ recorder.Record(pool, config.drawCount, [&pool](uint32_t chunk, size_t begin, size_t end)
+					{
+						pool.RecordItems(chunk, begin, end);
+					}) };
+					outOfOrderFrames += pool.Submit(chunkCount, config.drawCount) ? 0 : 1;
+				}));
+
+			if (outOfOrderFrames > 0)
+			{
+				spdlog::error(
+					"Benchmarks: Chunk submission order didn't match draw order in {} of {} frames!",
+					outOfOrderFrames,
+					config.frameCount);
+				return false;
+			}
+			return true;
+		}
+	}
+
+	bool RunBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results)
+	{
+		spdlog::info(
+			"Benchmarks: Running with {} entities, {} draws, {} frames...",
+			config.entityCount,
+			config.drawCount,
+			config.frameCount);
+
+		results.clear();
+		bool passed{ true };
+		passed &= RunSimulationBenchmarks(config, results);
+		passed &= RunSnapshotBenchmarks(config, results);
+		RunInputBenchmarks(config, results);
+		RunSimdBenchmarks(config, results);
+		passed &= RunJobSystemBenchmarks(config, results);
+		RunSpatialIndexBenchmarks(config, results);
+		RunCullingBenchmarks(config, results);
+		passed &= RunRasterizerBenchmarks(config, results);
+		passed &= RunRenderGraphBenchmarks(config, results);
+		RunUploadRingBenchmarks(config, results);
+		RunConstantRingBenchmarks(config, results);
+		RunAssetStreamingBenchmarks(config, results);
+		RunMeshOptimizerBenchmarks(config, results);
+		RunDrawBatcherBenchmarks(config, results);
+		passed &= RunDrawSortBenchmarks(config, results);
+		passed &= RunCommandRecordingBenchmarks(config, results);
+		return passed;
+	}
+
+	void WriteBenchmarkResults(
+		std::ostream& stream,
+		const BenchmarkConfig& config,
+		const std::vector<BenchmarkResult>& results)
+	{
+		stream << "{\"config\":{\"entityCount\":" << config.entityCount
+			<< ",\"drawCount\":" << config.drawCount
+			<< ",\"frameCount\":" << config.frameCount
+			<< ",\"inputEventCount\":" << config.inputEventCount << "},\n\"results\":[";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const BenchmarkResult& result{ results[i] };
+			const double seconds{ result.totalMilliseconds / 1000.0 };
+			stream << ((i == 0) ? "\n" : ",\n")
+				<< "{\"name\":\"" << result.name << "\""
+				<< ",\"threads\":" << result.threadCount
+				<< ",\"iterations\":" << result.iterations
+				<< ",\"items\":" << result.items
+				<< ",\"totalMilliseconds\":" << result.totalMilliseconds
+				<< ",\"itemsPerSecond\":" << ((seconds > 0.0) ? (static_cast<double>(result.items) / seconds) : 0.0);
+			if (!result.counters.empty())
+			{
+				stream << ",\"counters\":{";
+				for (size_t c = 0; c < result.counters.size(); ++c)
+				{
+					stream << ((c == 0) ? "" : ",")
+						<< "\"" << result.counters[c].name << "\":" << result.counters[c].value;
+				}
+				stream << "}";
+			}
+			stream << "}";
+		}
+		stream << "\n]}\n";
+	}
+}
\ No newline at end of file
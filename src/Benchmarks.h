@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// BenchmarkConfig sizes every scenario. Scenario inputs are generated from
+	/// fixed seeds, so a given config always measures the same work. If
+	/// rasterImagePath is set, the software rasterizer's last frame is written
+	/// there as a PPM image.
+	/// </summary>
+	struct BenchmarkConfig
+	{
+		uint32_t entityCount{ 100'000 };
+		uint32_t drawCount{ 10'000 };
+		uint32_t frameCount{ 100 };
+		// Input events translated and queued per iteration by the input scenarios
+		uint32_t inputEventCount{ 10'000 };
+		std::string rasterImagePath;
+	};
+
+	/// <summary>
+	/// BenchmarkCounter is a scenario-specific figure reported alongside the
+	/// timing, such as how many passes a render graph culled.
+	/// </summary>
+	struct BenchmarkCounter
+	{
+		std::string name;
+		uint64_t value;
+	};
+
+	struct BenchmarkResult
+	{
+		std::string name;
+		uint32_t threadCount;
+		uint64_t iterations;
+		uint64_t items;
+		double totalMilliseconds;
+		std::vector<BenchmarkCounter> counters{};
+	};
+
+	/// <summary>
+	/// Runs the CPU-side scenarios that don't need a window or a GPU: simulation
+	/// ticks, input translation and queueing, SIMD kernels per supported
+	/// instruction set, job system scaling, software rasterization, render graph
+	/// compilation, upload ring allocation, draw batching and command recording
+	/// partitioning. Returns false if a scenario's correctness check failed, such
+	/// as re-simulation from a snapshot diverging, or the raster image couldn't be
+	/// written; results are filled in either way.
+	/// </summary>
+	bool RunBenchmarks(const BenchmarkConfig& config, std::vector<BenchmarkResult>& results);
+
+	/// <summary>
+	/// Writes results as a single JSON document, one result per line, so runs
+	/// from different commits can be diffed directly. Counters are written as an
+	/// object on results that have any.
+	/// </summary>
+	void WriteBenchmarkResults(
+		std::ostream& stream,
+		const BenchmarkConfig& config,
+		const std::vector<BenchmarkResult>& results);
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "pch.h"
+#include "BlobArchive.h"
+#include "Hash.h"
+
+#include <fstream>
+
+namespace HelloTriangle
+{
+#pragma region Public
+	BlobArchive::BlobArchive(
+		uint32_t maxUnusedSessions
+	) :
+		m_maxUnusedSessions{ std::max<uint32_t>(maxUnusedSessions, 1) }
+	{ }
+
+	bool BlobArchive::Load(const std::filesystem::path& path)
+	{
+		Clear();
+
+		std::ifstream file{ path, std::ios::binary };
+		if (!file)
+		{
+			return false;
+		}
+		const std::vector<uint8_t> contents{
+			std::istreambuf_iterator<char>{ file },
+			std::istreambuf_iterator<char>{}
+		};
+
+		Header header{};
+		if (contents.size() < sizeof(Header))
+		{
+			spdlog::warn("BlobArchive: '{}' is truncated, ignoring.", path.string());
+			return false;
+		}
+		memcpy(&header, contents.data(), sizeof(Header));
+		if ((header.magic != MAGIC) || (header.version != VERSION))
+		{
+			spdlog::warn("BlobArchive: '{}' has an unknown format, ignoring.", path.string());
+			return false;
+		}
+
+		const uint64_t tableEnd{
+			sizeof(Header) + (static_cast<uint64_t>(header.entryCount) * sizeof(EntryRecord))
+		};
+		if (tableEnd > contents.size())
+		{
+			spdlog::warn("BlobArchive: '{}' is truncated, ignoring.", path.string());
+			return false;
+		}
+
+		std::unordered_map<uint64_t, Entry> entries;
+		for (uint32_t i = 0; i < header.entryCount; ++i)
+		{
+			EntryRecord record{};
+			memcpy(
+				&record,
+				contents.data() + sizeof(Header) + (static_cast<size_t>(i) * sizeof(EntryRecord)),
+				sizeof(EntryRecord));
+			if ((record.offset < tableEnd) ||
+				(record.size > contents.size()) ||
+				(record.offset > (contents.size() - record.size)))
+			{
+				spdlog::warn("BlobArchive: '{}' has an out-of-range entry, ignoring.", path.string());
+				return false;
+			}
+
+			const uint8_t* blob{ contents.data() + record.offset };
+			if (HashBytes(blob, record.size) != record.checksum)
+			{
+				spdlog::warn("BlobArchive: '{}' failed checksum validation, ignoring.", path.string());
+				return false;
+			}
+			entries.emplace(record.key, Entry{
+				.blob = std::vector<uint8_t>{ blob, blob + record.size },
+				.lastUsedSession = record.lastUsedSession,
+			});
+		}
+
+		m_entries = std::move(entries);
+		m_session = header.session;
+		m_isDirty = false;
+		return true;
+	}
+
+	bool BlobArchive::Save(const std::filesystem::path& path)
+	{
+		EvictUnused();
+
+		const Header header
+		{
+			.magic = MAGIC,
+			.version = VERSION,
+			.entryCount = static_cast<uint32_t>(m_entries.size()),
+			.reserved = 0,
+			.session = m_session + 1,
+		};
+
+		std::vector<EntryRecord> records;
+		records.reserve(m_entries.size());
+		uint64_t offset{ sizeof(Header) + (m_entries.size() * sizeof(EntryRecord)) };
+		for (const auto& [key, entry] : m_entries)
+		{
+			records.push_back(EntryRecord{
+				.key = key,
+				.offset = offset,
+				.size = entry.blob.size(),
+				.checksum = HashBytes(entry.blob.data(), entry.blob.size()),
+				.lastUsedSession = entry.lastUsedSession,
+			});
+			offset += entry.blob.size();
+		}
+
+		// Write to a temporary file and swap it in, so a crash mid-write can't leave
+		// a half-written archive behind.
+		std::filesystem::path temporaryPath{ path };
+		temporaryPath += ".tmp";
+		{
+			std::ofstream file{ temporaryPath, std::ios::binary | std::ios::trunc };
+			if (!file)
+			{
+				spdlog::warn("BlobArchive: Could not open '{}' for writing.", temporaryPath.string());
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+			file.write(
+				reinterpret_cast<const char*>(records.data()),
+				records.size() * sizeof(EntryRecord));
+			for (const EntryRecord& record : records)
+			{
+				const std::vector<uint8_t>& blob{ m_entries.at(record.key).blob };
+				file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+			}
+			if (!file.good())
+			{
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporaryPath, path, error);
+		if (error)
+		{
+			spdlog::warn("BlobArchive: Could not replace '{}': {}", path.string(), error.message());
+			return false;
+		}
+
+		// Later uses belong to the next session
+		++m_session;
+		m_isDirty = false;
+		return true;
+	}
+
+	const std::vector<uint8_t>* BlobArchive::Find(uint64_t key)
+	{
+		const auto entry{ m_entries.find(key) };
+		if (entry == m_entries.end())
+		{
+			return nullptr;
+		}
+		entry->second.lastUsedSession = m_session;
+		return &entry->second.blob;
+	}
+
+	void BlobArchive::Set(uint64_t key, const void* data, size_t size)
+	{
+		const uint8_t* bytes{ static_cast<const uint8_t*>(data) };
+		Entry& entry{ m_entries[key] };
+		entry.blob.assign(bytes, bytes + size);
+		entry.lastUsedSession = m_session;
+		m_isDirty = true;
+	}
+
+	void BlobArchive::Erase(uint64_t key)
+	{
+		if (m_entries.erase(key) > 0)
+		{
+			m_isDirty = true;
+		}
+	}
+
+	void BlobArchive::Clear()
+	{
+		m_entries.clear();
+		m_session = 0;
+		m_isDirty = false;
+	}
+
+	size_t BlobArchive::GetEntryCount() const
+	{
+		return m_entries.size();
+	}
+
+	bool BlobArchive::IsDirty() const
+	{
+		return m_isDirty;
+	}
+#pragma endregion Public
+
+#pragma region Private
+	void BlobArchive::EvictUnused()
+	{
+		const size_t entryCount{ m_entries.size() };
+		std::erase_if(m_entries, [this](const auto& entry)
+			{
+				return (m_session - entry.second.lastUsedSession) >= m_maxUnusedSessions;
+			});
+		if (m_entries.size() != entryCount)
+		{
+			spdlog::info(
+				"BlobArchive: Evicted {} entries unused for {} sessions.",
+				entryCount - m_entries.size(),
+				m_maxUnusedSessions);
+		}
+	}
+#pragma endregion Private
+}
\ No newline at end of file
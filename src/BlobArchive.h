@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// BlobArchive is a flat file of binary blobs keyed by 64-bit content hashes, used
+	/// to persist compiled shader bytecode and pipeline state between launches.
+	/// Every blob is stored with a checksum; a file that fails validation is ignored
+	/// as a whole, so a corrupt cache only ever costs a rebuild.
+	///
+	/// Keys are content hashes, so an edited shader leaves its old entries behind
+	/// for good. Each save counts as a session, and entries that no session has
+	/// found or set for maxUnusedSessions sessions are evicted when saving.
+	/// </summary>
+	class BlobArchive
+	{
+	public:
+		static constexpr uint32_t MAGIC{ 0x41425448 }; // 'HTBA'
+		static constexpr uint32_t VERSION{ 2 };
+		static constexpr uint32_t DEFAULT_MAX_UNUSED_SESSIONS{ 8 };
+
+		BlobArchive(uint32_t maxUnusedSessions = DEFAULT_MAX_UNUSED_SESSIONS);
+
+		bool Load(const std::filesystem::path& path);
+		bool Save(const std::filesystem::path& path);
+
+		/// <summary>
+		/// Returns the blob stored under key, if any, and marks it as used this
+		/// session.
+		/// </summary>
+		const std::vector<uint8_t>* Find(uint64_t key);
+		void Set(uint64_t key, const void* data, size_t size);
+		void Erase(uint64_t key);
+		void Clear();
+
+		size_t GetEntryCount() const;
+		bool IsDirty() const;
+
+	private:
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t entryCount;
+			uint32_t reserved;
+			uint64_t session;
+		};
+
+		struct EntryRecord
+		{
+			uint64_t key;
+			uint64_t offset;
+			uint64_t size;
+			uint64_t checksum;
+			uint64_t lastUsedSession;
+		};
+
+		struct Entry
+		{
+			std::vector<uint8_t> blob;
+			uint64_t lastUsedSession{ 0 };
+		};
+
+		const uint32_t m_maxUnusedSessions;
+		std::unordered_map<uint64_t, Entry> m_entries;
+
+		// Sessions saved before this one; entries used now are stamped with it
+		uint64_t m_session{ 0 };
+		bool m_isDirty{ false };
+
+		void EvictUnused();
+	};
+}
\ No newline at end of file
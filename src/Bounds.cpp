@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "Bounds.h"
+
+#include <cmath>
+
+namespace HelloTriangle
+{
+	Frustum Frustum::FromViewProjection(const float matrix[16])
+	{
+		// Gribb/Hartmann: each clip-space bound (-w <= x <= w, 0 <= z <= w, ...) is
+		// a combination of the matrix rows.
+		const float* row0{ matrix };
+		const float* row1{ matrix + 4 };
+		const float* row2{ matrix + 8 };
+		const float* row3{ matrix + 12 };
+
+		Frustum frustum{};
+		for (size_t i = 0; i < 4; ++i)
+		{
+			frustum.planes[LEFT_PLANE][i] = row3[i] + row0[i];
+			frustum.planes[RIGHT_PLANE][i] = row3[i] - row0[i];
+			frustum.planes[BOTTOM_PLANE][i] = row3[i] + row1[i];
+			frustum.planes[TOP_PLANE][i] = row3[i] - row1[i];
+			frustum.planes[NEAR_PLANE][i] = row2[i];
+			frustum.planes[FAR_PLANE][i] = row3[i] - row2[i];
+		}
+
+		for (auto& plane : frustum.planes)
+		{
+			const float length{ std::sqrt((plane[0] * plane[0]) + (plane[1] * plane[1]) + (plane[2] * plane[2])) };
+			if (length > 0.0f)
+			{
+				for (float& value : plane)
+				{
+					value /= length;
+				}
+			}
+		}
+		return frustum;
+	}
+
+	bool Frustum::ContainsSphere(float x, float y, float z, float radius) const
+	{
+		for (const auto& plane : planes)
+		{
+			if (((plane[0] * x) + (plane[1] * y) + (plane[2] * z) + plane[3]) < -radius)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	Containment Frustum::TestAabb(const Aabb& box) const
+	{
+		Containment result{ Containment::Inside };
+		for (const auto& plane : planes)
+		{
+			// The corners furthest along and against the plane normal
+			float inside{ plane[3] };
+			float outside{ plane[3] };
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const bool isPositive{ plane[axis] >= 0.0f };
+				inside += plane[axis] * (isPositive ? box.max[axis] : box.min[axis]);
+				outside += plane[axis] * (isPositive ? box.min[axis] : box.max[axis]);
+			}
+
+			if (inside < 0.0f)
+			{
+				return Containment::Outside;
+			}
+			if (outside < 0.0f)
+			{
+				result = Containment::Intersects;
+			}
+		}
+		return result;
+	}
+
+	bool SphereIntersectsAabb(float x, float y, float z, float radius, const Aabb& box)
+	{
+		const float center[3]{ x, y, z };
+		float distanceSquared{ 0.0f };
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			const float clamped{ std::clamp(center[axis], box.min[axis], box.max[axis]) };
+			const float delta{ center[axis] - clamped };
+			distanceSquared += delta * delta;
+		}
+		return distanceSquared <= (radius * radius);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Aabb is an axis-aligned box given by its min and max corners.
+	/// </summary>
+	struct Aabb
+	{
+		float min[3];
+		float max[3];
+	};
+
+	enum class Containment
+	{
+		Outside,
+		Intersects,
+		Inside,
+	};
+
+	/// <summary>
+	/// Frustum is six inward-facing planes (a, b, c, d), normalized so that
+	/// a*x + b*y + c*z + d is the signed distance from the plane. A point is inside
+	/// when every distance is non-negative.
+	/// </summary>
+	struct Frustum
+	{
+		enum Plane
+		{
+			LEFT_PLANE,
+			RIGHT_PLANE,
+			BOTTOM_PLANE,
+			TOP_PLANE,
+			NEAR_PLANE,
+			FAR_PLANE,
+			PLANE_COUNT,
+		};
+
+		std::array<std::array<float, 4>, PLANE_COUNT> planes;
+
+		/// <summary>
+		/// Extracts the planes of a row-major view-projection matrix that transforms
+		/// column vectors into D3D clip space (0 <= z <= w), such as Camera's.
+		/// </summary>
+		static Frustum FromViewProjection(const float matrix[16]);
+
+		bool ContainsSphere(float x, float y, float z, float radius) const;
+		Containment TestAabb(const Aabb& box) const;
+	};
+
+	/// <summary>
+	/// True if the sphere touches the box.
+	/// </summary>
+	bool SphereIntersectsAabb(float x, float y, float z, float radius, const Aabb& box);
+}
\ No newline at end of file
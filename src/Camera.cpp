@@ -0,0 +1,120 @@
+#include "pch.h"
+#include "Camera.h"
+
+#include <cmath>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		Camera::Vector Subtract(const Camera::Vector& a, const Camera::Vector& b)
+		{
+			return { a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+		}
+
+		Camera::Vector Cross(const Camera::Vector& a, const Camera::Vector& b)
+		{
+			return
+			{
+				(a[1] * b[2]) - (a[2] * b[1]),
+				(a[2] * b[0]) - (a[0] * b[2]),
+				(a[0] * b[1]) - (a[1] * b[0]),
+			};
+		}
+
+		float Dot(const Camera::Vector& a, const Camera::Vector& b)
+		{
+			return (a[0] * b[0]) + (a[1] * b[1]) + (a[2] * b[2]);
+		}
+
+		Camera::Vector Normalize(const Camera::Vector& v)
+		{
+			const float length{ std::sqrt(Dot(v, v)) };
+			if (length <= 0.0f)
+			{
+				return v;
+			}
+			return { v[0] / length, v[1] / length, v[2] / length };
+		}
+
+		Camera::Matrix Multiply(const Camera::Matrix& a, const Camera::Matrix& b)
+		{
+			Camera::Matrix result{};
+			for (size_t row = 0; row < 4; ++row)
+			{
+				for (size_t column = 0; column < 4; ++column)
+				{
+					float sum{ 0.0f };
+					for (size_t i = 0; i < 4; ++i)
+					{
+						sum += a[(row * 4) + i] * b[(i * 4) + column];
+					}
+					result[(row * 4) + column] = sum;
+				}
+			}
+			return result;
+		}
+	}
+
+#pragma region Public
+	void Camera::SetLookAt(const Vector& position, const Vector& target, const Vector& up)
+	{
+		// Rows are the camera's basis vectors, so the view matrix rotates world
+		// space into camera space after translating the eye to the origin.
+		const Vector zAxis{ Normalize(Subtract(target, position)) };
+		const Vector xAxis{ Normalize(Cross(up, zAxis)) };
+		const Vector yAxis{ Cross(zAxis, xAxis) };
+
+		m_position = position;
+		m_view =
+		{
+			xAxis[0], xAxis[1], xAxis[2], -Dot(xAxis, position),
+			yAxis[0], yAxis[1], yAxis[2], -Dot(yAxis, position),
+			zAxis[0], zAxis[1], zAxis[2], -Dot(zAxis, position),
+			0.0f, 0.0f, 0.0f, 1.0f,
+		};
+		m_dirty = true;
+	}
+
+	void Camera::SetPerspective(float verticalFieldOfView, float aspectRatio, float nearPlane, float farPlane)
+	{
+		const float yScale{ 1.0f / std::tan(verticalFieldOfView * 0.5f) };
+		const float xScale{ yScale / aspectRatio };
+		const float depthScale{ farPlane / (farPlane - nearPlane) };
+
+		m_projection =
+		{
+			xScale, 0.0f, 0.0f, 0.0f,
+			0.0f, yScale, 0.0f, 0.0f,
+			0.0f, 0.0f, depthScale, -nearPlane * depthScale,
+			0.0f, 0.0f, 1.0f, 0.0f,
+		};
+		m_dirty = true;
+	}
+
+	const Camera::Vector& Camera::GetPosition() const
+	{
+		return m_position;
+	}
+
+	const Camera::Matrix& Camera::GetView() const
+	{
+		return m_view;
+	}
+
+	const Camera::Matrix& Camera::GetProjection() const
+	{
+		return m_projection;
+	}
+
+	const Camera::Matrix& Camera::GetViewProjection()
+	{
+		if (m_dirty)
+		{
+			m_viewProjection = Multiply(m_projection, m_view);
+			m_dirty = false;
+		}
+		return m_viewProjection;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Camera is a left-handed perspective camera with D3D's [0, 1] depth range.
+	/// Matrices are row-major and transform column vectors (clip = matrix * point),
+	/// the same convention SimdKernels::TransformPoints uses.
+	/// </summary>
+	class Camera
+	{
+	public:
+		using Matrix = std::array<float, 16>;
+		using Vector = std::array<float, 3>;
+
+		void SetLookAt(const Vector& position, const Vector& target, const Vector& up);
+
+		/// <summary>
+		/// verticalFieldOfView is in radians.
+		/// </summary>
+		void SetPerspective(float verticalFieldOfView, float aspectRatio, float nearPlane, float farPlane);
+
+		const Vector& GetPosition() const;
+		const Matrix& GetView() const;
+		const Matrix& GetProjection() const;
+
+		/// <summary>
+		/// Projection * view, recomputed only after the camera changes.
+		/// </summary>
+		const Matrix& GetViewProjection();
+
+	private:
+		static constexpr Matrix IDENTITY
+		{
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f,
+		};
+
+		Vector m_position{ 0.0f, 0.0f, 0.0f };
+		Matrix m_view{ IDENTITY };
+		Matrix m_projection{ IDENTITY };
+		Matrix m_viewProjection{ IDENTITY };
+		bool m_dirty{ false };
+	};
+}
\ No newline at end of file
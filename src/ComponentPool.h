@@ -0,0 +1,192 @@
+#pragma once
+#include "Hash.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Entity is a generational handle into the World. The index addresses the sparse
+	/// arrays of each component pool; the generation detects stale handles.
+	/// </summary>
+	struct Entity
+	{
+		uint32_t index{ std::numeric_limits<uint32_t>::max() };
+		uint32_t generation{ 0 };
+
+		bool operator==(const Entity&) const = default;
+	};
+
+	/// <summary>
+	/// ComponentPool is a sparse set that stores its components as structure-of-arrays:
+	/// one contiguous float stream per field, all kept in the same dense order.
+	/// Removal swaps with the last element so the dense streams never have holes.
+	/// </summary>
+	template<size_t NumFields>
+	class ComponentPool
+	{
+	public:
+		static constexpr uint32_t INVALID_INDEX{ std::numeric_limits<uint32_t>::max() };
+
+		void Reserve(size_t capacity)
+		{
+			m_entities.reserve(capacity);
+			for (auto& field : m_fields)
+			{
+				field.reserve(capacity);
+			}
+		}
+
+		uint32_t Add(Entity entity, const std::array<float, NumFields>& values)
+		{
+			if (entity.index >= m_sparse.size())
+			{
+				m_sparse.resize(entity.index + 1, INVALID_INDEX);
+			}
+
+			uint32_t denseIndex{ m_sparse[entity.index] };
+			assert((denseIndex == INVALID_INDEX) || (m_entities[denseIndex] == entity));
+			if (denseIndex == INVALID_INDEX)
+			{
+				denseIndex = static_cast<uint32_t>(m_entities.size());
+				m_sparse[entity.index] = denseIndex;
+				m_entities.push_back(entity);
+				for (size_t f = 0; f < NumFields; ++f)
+				{
+					m_fields[f].push_back(values[f]);
+				}
+			}
+			else
+			{
+				for (size_t f = 0; f < NumFields; ++f)
+				{
+					m_fields[f][denseIndex] = values[f];
+				}
+			}
+			return denseIndex;
+		}
+
+		void Remove(Entity entity)
+		{
+			const uint32_t denseIndex{ IndexOf(entity) };
+			if (denseIndex == INVALID_INDEX)
+			{
+				return;
+			}
+
+			const uint32_t lastIndex{ static_cast<uint32_t>(m_entities.size() - 1) };
+			Swap(denseIndex, lastIndex);
+			m_sparse[entity.index] = INVALID_INDEX;
+			m_entities.pop_back();
+			for (auto& field : m_fields)
+			{
+				field.pop_back();
+			}
+		}
+
+		bool Contains(Entity entity) const
+		{
+			return (IndexOf(entity) != INVALID_INDEX);
+		}
+
+		/// <summary>
+		/// Dense index of entity's component, or INVALID_INDEX if it has none. A
+		/// stale handle, whose slot has since been reused, has none either.
+		/// </summary>
+		uint32_t IndexOf(Entity entity) const
+		{
+			const uint32_t denseIndex{ IndexOfSlot(entity.index) };
+			if ((denseIndex == INVALID_INDEX) || (m_entities[denseIndex].generation != entity.generation))
+			{
+				return INVALID_INDEX;
+			}
+			return denseIndex;
+		}
+
+		/// <summary>
+		/// Dense index of the component of whichever entity currently holds the slot
+		/// entityIndex, for callers that only track slots.
+		/// </summary>
+		uint32_t IndexOfSlot(uint32_t entityIndex) const
+		{
+			if (entityIndex >= m_sparse.size())
+			{
+				return INVALID_INDEX;
+			}
+			return m_sparse[entityIndex];
+		}
+
+		/// <summary>
+		/// Swaps two dense slots, keeping the sparse lookup consistent.
+		/// </summary>
+		void Swap(uint32_t a, uint32_t b)
+		{
+			if (a == b)
+			{
+				return;
+			}
+			std::swap(m_entities[a], m_entities[b]);
+			m_sparse[m_entities[a].index] = a;
+			m_sparse[m_entities[b].index] = b;
+			for (auto& field : m_fields)
+			{
+				std::swap(field[a], field[b]);
+			}
+		}
+
+		size_t Size() const
+		{
+			return m_entities.size();
+		}
+
+		const Entity* Entities() const
+		{
+			return m_entities.data();
+		}
+
+		float* Field(size_t field)
+		{
+			return m_fields[field].data();
+		}
+
+		const float* Field(size_t field) const
+		{
+			return m_fields[field].data();
+		}
+
+		/// <summary>
+		/// Bytes of live component state, the amount copying the pool moves.
+		/// </summary>
+		size_t GetByteSize() const
+		{
+			return (m_sparse.size() * sizeof(uint32_t)) +
+				(m_entities.size() * (sizeof(Entity) + (NumFields * sizeof(float))));
+		}
+
+		/// <summary>
+		/// Hashes the dense entities and field streams. The sparse array is fully
+		/// determined by the dense entities, so it is skipped.
+		/// </summary>
+		uint64_t ComputeHash(uint64_t seed = HASH_SEED) const
+		{
+			uint64_t hash{ HashValue(m_entities.size(), seed) };
+			hash = HashBytes(m_entities.data(), m_entities.size() * sizeof(Entity), hash);
+			for (const auto& field : m_fields)
+			{
+				hash = HashBytes(field.data(), field.size() * sizeof(float), hash);
+			}
+			return hash;
+		}
+
+	private:
+		std::vector<uint32_t> m_sparse;
+		std::vector<Entity> m_entities;
+		std::array<std::vector<float>, NumFields> m_fields;
+	};
+}
\ No newline at end of file
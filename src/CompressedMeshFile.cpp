@@ -0,0 +1,129 @@
+#include "pch.h"
+#include "CompressedMeshFile.h"
+
+#include <cmath>
+#include <fstream>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		template<typename T>
+		void AppendValue(std::vector<uint8_t>& bytes, T value)
+		{
+			const uint8_t* data{ reinterpret_cast<const uint8_t*>(&value) };
+			bytes.insert(bytes.end(), data, data + sizeof(T));
+		}
+
+		template<typename T>
+		T ReadValue(const uint8_t* data)
+		{
+			T value{};
+			memcpy(&value, data, sizeof(T));
+			return value;
+		}
+	}
+
+	bool IsCompressedMesh(const uint8_t* data, size_t size)
+	{
+		return (size >= sizeof(uint32_t)) && (ReadValue<uint32_t>(data) == CompressedMeshFileFormat::MAGIC);
+	}
+
+	MeshDecodeResult DecodeCompressedMesh(const uint8_t* data, size_t size, CompressedMeshData& mesh)
+	{
+		mesh.vertices.clear();
+		mesh.indices.clear();
+		mesh.quantization = VertexQuantization{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+
+		if ((size < CompressedMeshFileFormat::HEADER_SIZE) || !IsCompressedMesh(data, size))
+		{
+			return MeshDecodeResult::NotAMesh;
+		}
+		if (ReadValue<uint32_t>(data + 4) != CompressedMeshFileFormat::VERSION)
+		{
+			return MeshDecodeResult::UnsupportedVersion;
+		}
+
+		const uint32_t vertexCount{ ReadValue<uint32_t>(data + 8) };
+		const uint32_t indexCount{ ReadValue<uint32_t>(data + 12) };
+		if ((vertexCount > MeshFileFormat::MAX_VERTICES) || (indexCount > MeshFileFormat::MAX_INDICES))
+		{
+			return MeshDecodeResult::TooLarge;
+		}
+
+		// Counts are bounded above, so these can't overflow
+		const size_t vertexBytes{ static_cast<size_t>(vertexCount) * sizeof(CompressedVertex) };
+		const size_t indexBytes{ ReadValue<uint32_t>(data + 16) };
+		if (size < (CompressedMeshFileFormat::HEADER_SIZE + vertexBytes + indexBytes))
+		{
+			return MeshDecodeResult::Truncated;
+		}
+
+		VertexQuantization quantization{};
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			quantization.offset[axis] = ReadValue<float>(data + 20 + (axis * sizeof(float)));
+			quantization.scale[axis] = ReadValue<float>(data + 32 + (axis * sizeof(float)));
+			if (!std::isfinite(quantization.offset[axis]) ||
+				!std::isfinite(quantization.scale[axis]) ||
+				(quantization.scale[axis] < 0.0f))
+			{
+				return MeshDecodeResult::InvalidQuantization;
+			}
+		}
+
+		const uint8_t* vertexData{ data + CompressedMeshFileFormat::HEADER_SIZE };
+		const uint8_t* indexData{ vertexData + vertexBytes };
+		if (!DecodeIndexStream(indexData, indexBytes, indexCount, mesh.indices) ||
+			((indexCount % 3) != 0) ||
+			std::any_of(mesh.indices.begin(), mesh.indices.end(), [vertexCount](uint16_t index) { return index >= vertexCount; }))
+		{
+			mesh.indices.clear();
+			return MeshDecodeResult::InvalidIndices;
+		}
+
+		mesh.vertices.resize(vertexCount);
+		memcpy(mesh.vertices.data(), vertexData, vertexBytes);
+		mesh.quantization = quantization;
+		return MeshDecodeResult::Success;
+	}
+
+	std::vector<uint8_t> EncodeCompressedMesh(const CompressedMeshData& mesh)
+	{
+		const std::vector<uint8_t> indexStream{ EncodeIndexStream(mesh.indices) };
+		std::vector<uint8_t> bytes;
+		bytes.reserve(
+			CompressedMeshFileFormat::HEADER_SIZE + (mesh.vertices.size() * sizeof(CompressedVertex)) + indexStream.size());
+		AppendValue(bytes, CompressedMeshFileFormat::MAGIC);
+		AppendValue(bytes, CompressedMeshFileFormat::VERSION);
+		AppendValue(bytes, static_cast<uint32_t>(mesh.vertices.size()));
+		AppendValue(bytes, static_cast<uint32_t>(mesh.indices.size()));
+		AppendValue(bytes, static_cast<uint32_t>(indexStream.size()));
+		for (const float offset : mesh.quantization.offset)
+		{
+			AppendValue(bytes, offset);
+		}
+		for (const float scale : mesh.quantization.scale)
+		{
+			AppendValue(bytes, scale);
+		}
+
+		const uint8_t* vertexData{ reinterpret_cast<const uint8_t*>(mesh.vertices.data()) };
+		bytes.insert(bytes.end(), vertexData, vertexData + (mesh.vertices.size() * sizeof(CompressedVertex)));
+		bytes.insert(bytes.end(), indexStream.begin(), indexStream.end());
+		return bytes;
+	}
+
+	bool WriteCompressedMeshFile(const std::filesystem::path& path, const CompressedMeshData& mesh)
+	{
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		if (!file)
+		{
+			spdlog::warn("WriteCompressedMeshFile: Couldn't open '{}'.", path.string());
+			return false;
+		}
+		const std::vector<uint8_t> bytes{ EncodeCompressedMesh(mesh) };
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return file.good();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include "MeshFile.h"
+#include "VertexCompression.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Compressed mesh files are what the mesh processor writes. A 44-byte header
+	/// (magic, version, vertex count, index count, index stream size in bytes,
+	/// then the VertexQuantization's offset and scale as floats) is followed by
+	/// the vertices as tightly packed CompressedVertex structs and then the
+	/// triangle-list indices as EncodeIndexStream wrote them. All values are
+	/// little-endian. The counts have MeshFileFormat's limits.
+	/// </summary>
+	namespace CompressedMeshFileFormat
+	{
+		constexpr uint32_t MAGIC{ 0x434D5448 }; // 'HTMC'
+		constexpr uint32_t VERSION{ 3 };
+		constexpr size_t HEADER_SIZE{ 44 };
+	}
+
+	/// <summary>
+	/// True if data starts like a compressed mesh file rather than a plain one.
+	/// </summary>
+	bool IsCompressedMesh(const uint8_t* data, size_t size);
+
+	/// <summary>
+	/// Decodes and validates a compressed mesh file held in memory. Besides
+	/// DecodeMesh's index checks, the index stream must decode to exactly its size
+	/// and the quantization must be finite with no negative scale; on failure mesh
+	/// is left empty.
+	/// </summary>
+	MeshDecodeResult DecodeCompressedMesh(const uint8_t* data, size_t size, CompressedMeshData& mesh);
+
+	std::vector<uint8_t> EncodeCompressedMesh(const CompressedMeshData& mesh);
+	bool WriteCompressedMeshFile(const std::filesystem::path& path, const CompressedMeshData& mesh);
+}
\ No newline at end of file
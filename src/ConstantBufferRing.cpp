@@ -0,0 +1,53 @@
+#include "pch.h"
+#include "ConstantBufferRing.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	ConstantBufferRing::ConstantBufferRing(uint8_t* cpuBase, uint64_t gpuBase, uint64_t capacity) :
+		m_cpuBase{ cpuBase },
+		m_gpuBase{ gpuBase },
+		m_ring{ capacity & ~(CONSTANT_BUFFER_ALIGNMENT - 1) }
+	{
+		assert((reinterpret_cast<uintptr_t>(cpuBase) % CONSTANT_BUFFER_ALIGNMENT) == 0);
+		assert((gpuBase % CONSTANT_BUFFER_ALIGNMENT) == 0);
+	}
+
+	ConstantBufferRing::Allocation ConstantBufferRing::Allocate(uint64_t size)
+	{
+		const uint64_t alignedSize{ AlignSize(size) };
+		const uint64_t offset{ m_ring.Allocate(alignedSize, CONSTANT_BUFFER_ALIGNMENT) };
+		if (offset == RingAllocator::INVALID_OFFSET)
+		{
+			++m_failedAllocationCount;
+			return Allocation{ nullptr, 0, 0 };
+		}
+		return Allocation{ m_cpuBase + offset, m_gpuBase + offset, alignedSize };
+	}
+
+	void ConstantBufferRing::FinishFrame(uint64_t fenceValue)
+	{
+		m_ring.FinishBatch(fenceValue);
+	}
+
+	void ConstantBufferRing::Retire(uint64_t completedFenceValue)
+	{
+		m_ring.Retire(completedFenceValue);
+	}
+
+	uint64_t ConstantBufferRing::GetCapacity() const
+	{
+		return m_ring.GetCapacity();
+	}
+
+	uint64_t ConstantBufferRing::GetUsedBytes() const
+	{
+		return m_ring.GetUsedBytes();
+	}
+
+	uint64_t ConstantBufferRing::GetFailedAllocationCount() const
+	{
+		return m_failedAllocationCount;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include "RingAllocator.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// ConstantBufferRing streams per-frame constants through a persistently mapped
+	/// buffer. Every allocation is padded to CONSTANT_BUFFER_ALIGNMENT, the placement
+	/// D3D12 requires for constant buffer views, and stays reserved until the fence
+	/// value of the frame that wrote it completes. It only deals in CPU pointers and
+	/// GPU virtual addresses, so the packing runs without a device.
+	/// </summary>
+	class ConstantBufferRing
+	{
+	public:
+		static constexpr uint64_t CONSTANT_BUFFER_ALIGNMENT{ 256 };
+
+		struct Allocation
+		{
+			uint8_t* cpuAddress;
+			uint64_t gpuAddress;
+			uint64_t size;
+		};
+
+		/// <summary>
+		/// cpuBase and gpuBase address the same mapped buffer of capacity bytes. Both
+		/// must be CONSTANT_BUFFER_ALIGNMENT aligned.
+		/// </summary>
+		ConstantBufferRing(uint8_t* cpuBase, uint64_t gpuBase, uint64_t capacity);
+
+		static constexpr uint64_t AlignSize(uint64_t size)
+		{
+			return (size + CONSTANT_BUFFER_ALIGNMENT - 1) & ~(CONSTANT_BUFFER_ALIGNMENT - 1);
+		}
+
+		/// <summary>
+		/// Reserves size bytes rounded up to the alignment. Returns an allocation with
+		/// a null cpuAddress if the ring is full until more frames retire.
+		/// </summary>
+		Allocation Allocate(uint64_t size);
+
+		/// <summary>
+		/// Copies constants into a new allocation.
+		/// </summary>
+		template<typename T>
+		Allocation Push(const T& constants)
+		{
+			const Allocation allocation{ Allocate(sizeof(T)) };
+			if (allocation.cpuAddress)
+			{
+				memcpy(allocation.cpuAddress, &constants, sizeof(T));
+			}
+			return allocation;
+		}
+
+		/// <summary>
+		/// Closes the current frame's allocations against fenceValue.
+		/// </summary>
+		void FinishFrame(uint64_t fenceValue);
+
+		/// <summary>
+		/// Reclaims frames whose fence value is at or below completedFenceValue.
+		/// </summary>
+		void Retire(uint64_t completedFenceValue);
+
+		uint64_t GetCapacity() const;
+		uint64_t GetUsedBytes() const;
+		uint64_t GetFailedAllocationCount() const;
+
+	private:
+		uint8_t* const m_cpuBase;
+		const uint64_t m_gpuBase;
+		RingAllocator m_ring;
+		uint64_t m_failedAllocationCount{ 0 };
+	};
+}
\ No newline at end of file
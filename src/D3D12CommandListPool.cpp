@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "D3D12CommandListPool.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	D3D12CommandListPool::D3D12CommandListPool(
+		ID3D12Device* device,
+		uint32_t framesInFlight,
+		uint32_t chunkCount
+	) :
+		m_chunkCount{ chunkCount }
+	{
+		m_commandAllocators.resize(static_cast<size_t>(framesInFlight) * chunkCount);
+		for (auto& commandAllocator : m_commandAllocators)
+		{
+			ThrowIfFailed(device->CreateCommandAllocator(
+				D3D12_COMMAND_LIST_TYPE_DIRECT,
+				IID_PPV_ARGS(&commandAllocator)
+			));
+		}
+
+		m_commandLists.resize(chunkCount);
+		for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			ThrowIfFailed(device->CreateCommandList(
+				0,
+				D3D12_COMMAND_LIST_TYPE_DIRECT,
+				m_commandAllocators[chunk].Get(),
+				nullptr,
+				IID_PPV_ARGS(&m_commandLists[chunk])
+			));
+			ThrowIfFailed(m_commandLists[chunk]->Close());
+		}
+	}
+
+	void D3D12CommandListPool::SetFrameContext(uint32_t frameContext, ID3D12PipelineState* initialState)
+	{
+		m_frameContext = frameContext;
+		m_initialState = initialState;
+	}
+
+	uint32_t D3D12CommandListPool::GetChunkCount() const
+	{
+		return m_chunkCount;
+	}
+
+	ID3D12GraphicsCommandList* D3D12CommandListPool::GetCommandList(uint32_t chunk) const
+	{
+		return m_commandLists[chunk].Get();
+	}
+
+	void D3D12CommandListPool::BeginChunk(uint32_t chunk)
+	{
+		ID3D12CommandAllocator* commandAllocator{
+			m_commandAllocators[(static_cast<size_t>(m_frameContext) * m_chunkCount) + chunk].Get()
+		};
+		ThrowIfFailed(commandAllocator->Reset());
+		ThrowIfFailed(m_commandLists[chunk]->Reset(commandAllocator, m_initialState));
+	}
+
+	void D3D12CommandListPool::EndChunk(uint32_t chunk)
+	{
+		ThrowIfFailed(m_commandLists[chunk]->Close());
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#include "pch.h"
+#include "ParallelCommandRecorder.h"
+
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// D3D12CommandListPool owns one direct command list per recording chunk, and one
+	/// allocator per chunk per frame in flight so a chunk's allocator is only reset
+	/// once the GPU has retired that frame context.
+	/// </summary>
+	class D3D12CommandListPool : public ICommandListPool
+	{
+	public:
+		D3D12CommandListPool(ID3D12Device* device, uint32_t framesInFlight, uint32_t chunkCount);
+
+		/// <summary>
+		/// Selects the allocators used by subsequent chunks. Must not be called while
+		/// chunks are recording.
+		/// </summary>
+		void SetFrameContext(uint32_t frameContext, ID3D12PipelineState* initialState);
+		uint32_t GetChunkCount() const;
+		ID3D12GraphicsCommandList* GetCommandList(uint32_t chunk) const;
+
+		// ICommandListPool
+		virtual void BeginChunk(uint32_t chunk);
+		virtual void EndChunk(uint32_t chunk);
+
+	private:
+		const uint32_t m_chunkCount;
+		uint32_t m_frameContext{ 0 };
+		ID3D12PipelineState* m_initialState{ nullptr };
+		std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> m_commandAllocators;
+		std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>> m_commandLists;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "D3D12DescriptorHeap.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	D3D12DescriptorHeap::D3D12DescriptorHeap(
+		ID3D12Device* device,
+		D3D12_DESCRIPTOR_HEAP_TYPE type,
+		uint32_t persistentCapacity,
+		uint32_t transientCapacity,
+		bool isShaderVisible
+	) :
+		m_allocator{ persistentCapacity, transientCapacity }
+	{
+		D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
+		heapDesc.NumDescriptors = m_allocator.GetCapacity();
+		heapDesc.Type = type;
+		heapDesc.Flags = isShaderVisible ?
+			D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE :
+			D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+		ThrowIfFailed(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_heap)));
+
+		m_descriptorSize = device->GetDescriptorHandleIncrementSize(type);
+		m_cpuStart = m_heap->GetCPUDescriptorHandleForHeapStart();
+		if (isShaderVisible)
+		{
+			m_gpuStart = m_heap->GetGPUDescriptorHandleForHeapStart();
+		}
+	}
+
+	DescriptorAllocator& D3D12DescriptorHeap::GetAllocator()
+	{
+		return m_allocator;
+	}
+
+	ID3D12DescriptorHeap* D3D12DescriptorHeap::GetHeap() const
+	{
+		return m_heap.Get();
+	}
+
+	D3D12_CPU_DESCRIPTOR_HANDLE D3D12DescriptorHeap::GetCpuHandle(uint32_t index) const
+	{
+		return CD3DX12_CPU_DESCRIPTOR_HANDLE{ m_cpuStart, static_cast<int32_t>(index), m_descriptorSize };
+	}
+
+	D3D12_GPU_DESCRIPTOR_HANDLE D3D12DescriptorHeap::GetGpuHandle(uint32_t index) const
+	{
+		return CD3DX12_GPU_DESCRIPTOR_HANDLE{ m_gpuStart, static_cast<int32_t>(index), m_descriptorSize };
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#include "pch.h"
+#include "DescriptorAllocator.h"
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// D3D12DescriptorHeap pairs an ID3D12DescriptorHeap with a DescriptorAllocator
+	/// and turns the allocator's slot indices into CPU and GPU descriptor handles.
+	/// </summary>
+	class D3D12DescriptorHeap
+	{
+	public:
+		D3D12DescriptorHeap(
+			ID3D12Device* device,
+			D3D12_DESCRIPTOR_HEAP_TYPE type,
+			uint32_t persistentCapacity,
+			uint32_t transientCapacity,
+			bool isShaderVisible);
+
+		DescriptorAllocator& GetAllocator();
+		ID3D12DescriptorHeap* GetHeap() const;
+		D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32_t index) const;
+
+		/// <summary>
+		/// Only valid for shader-visible heaps.
+		/// </summary>
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t index) const;
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_heap;
+		DescriptorAllocator m_allocator;
+		D3D12_CPU_DESCRIPTOR_HANDLE m_cpuStart{};
+		D3D12_GPU_DESCRIPTOR_HANDLE m_gpuStart{};
+		uint32_t m_descriptorSize{ 0 };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "D3D12Fence.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	D3D12Fence::D3D12Fence(
+		ID3D12Device* device,
+		ID3D12CommandQueue* commandQueue
+	) :
+		m_commandQueue{ commandQueue }
+	{
+		ThrowIfFailed(device->CreateFence(
+			0,
+			D3D12_FENCE_FLAG_NONE,
+			IID_PPV_ARGS(&m_fence)
+		));
+
+		// Create an event handle for frame synchronization
+		m_fenceEvent = CreateEventW(nullptr, false, false, nullptr);
+		if (m_fenceEvent == nullptr)
+		{
+			ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+		}
+	}
+
+	D3D12Fence::~D3D12Fence()
+	{
+		if (m_fenceEvent != nullptr)
+		{
+			CloseHandle(m_fenceEvent);
+		}
+	}
+
+	void D3D12Fence::QueueWait(ID3D12CommandQueue* queue, uint64_t value)
+	{
+		ThrowIfFailed(queue->Wait(m_fence.Get(), value));
+	}
+
+	uint64_t D3D12Fence::GetCompletedValue()
+	{
+		return m_fence->GetCompletedValue();
+	}
+
+	void D3D12Fence::Signal(uint64_t value)
+	{
+		ThrowIfFailed(m_commandQueue->Signal(m_fence.Get(), value));
+	}
+
+	void D3D12Fence::Wait(uint64_t value)
+	{
+		if (m_fence->GetCompletedValue() < value)
+		{
+			ThrowIfFailed(m_fence->SetEventOnCompletion(value, m_fenceEvent));
+			WaitForSingleObject(m_fenceEvent, INFINITE);
+		}
+	}
+#pragma endregion Public
+}
\ No newline at end of file
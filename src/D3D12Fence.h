@@ -0,0 +1,34 @@
+#pragma once
+#include "pch.h"
+#include "IFence.h"
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// D3D12Fence implements IFence with an ID3D12Fence signaled on a command queue.
+	/// </summary>
+	class D3D12Fence : public IFence
+	{
+	public:
+		D3D12Fence(ID3D12Device* device, ID3D12CommandQueue* commandQueue);
+		~D3D12Fence();
+
+		D3D12Fence(const D3D12Fence&) = delete;
+		D3D12Fence& operator=(const D3D12Fence&) = delete;
+
+		/// <summary>
+		/// Makes another queue wait, on the GPU, until this fence reaches value.
+		/// </summary>
+		void QueueWait(ID3D12CommandQueue* queue, uint64_t value);
+
+		// IFence
+		virtual uint64_t GetCompletedValue();
+		virtual void Signal(uint64_t value);
+		virtual void Wait(uint64_t value);
+
+	private:
+		Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_commandQueue;
+		Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
+		HANDLE m_fenceEvent{ nullptr };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "pch.h"
+#include "D3D12MeshStore.h"
+#include "MeshFile.h"
+#include "VertexCompression.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	D3D12MeshStore::D3D12MeshStore(UploadManager* uploadManager) :
+		m_uploadManager{ uploadManager }
+	{ }
+
+	void D3D12MeshStore::Flush(ID3D12CommandQueue* queue)
+	{
+		if (!m_hasPendingUploads)
+		{
+			return;
+		}
+		m_uploadManager->Submit();
+		m_uploadManager->QueueWait(queue);
+		m_hasPendingUploads = false;
+	}
+
+	const D3D12MeshStore::Mesh* D3D12MeshStore::GetMesh(uint32_t meshIndex) const
+	{
+		return (meshIndex < m_meshes.size()) ? &m_meshes[meshIndex] : nullptr;
+	}
+
+	uint32_t D3D12MeshStore::GetMeshCount() const
+	{
+		return static_cast<uint32_t>(m_meshes.size());
+	}
+
+	uint32_t D3D12MeshStore::UploadMesh(const MeshData& mesh)
+	{
+		if (mesh.vertices.empty() || mesh.indices.empty() || IsFull())
+		{
+			return INVALID_MESH;
+		}
+
+		Mesh& stored{ AddMesh(mesh.vertices.data(), mesh.vertices.size(), sizeof(Vertex), mesh.indices) };
+		stored.isCompressed = false;
+		stored.meshConstants = MeshConstants{ { 0.0f, 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 0.0f } };
+		return static_cast<uint32_t>(m_meshes.size() - 1);
+	}
+
+	uint32_t D3D12MeshStore::UploadCompressedMesh(const CompressedMeshData& mesh)
+	{
+		if (mesh.vertices.empty() || mesh.indices.empty() || IsFull())
+		{
+			return INVALID_MESH;
+		}
+
+		Mesh& stored{ AddMesh(mesh.vertices.data(), mesh.vertices.size(), sizeof(CompressedVertex), mesh.indices) };
+		stored.isCompressed = true;
+		const VertexQuantization& quantization{ mesh.quantization };
+		stored.meshConstants = MeshConstants{
+			{ quantization.offset[0], quantization.offset[1], quantization.offset[2], 0.0f },
+			{ quantization.scale[0], quantization.scale[1], quantization.scale[2], 0.0f }
+		};
+		return static_cast<uint32_t>(m_meshes.size() - 1);
+	}
+#pragma endregion Public
+
+#pragma region Private
+	bool D3D12MeshStore::IsFull() const
+	{
+		if (m_meshes.size() < DrawSortKey::MAX_MESH_COUNT)
+		{
+			return false;
+		}
+		spdlog::error("D3D12MeshStore: Can't hold more than {} meshes.", DrawSortKey::MAX_MESH_COUNT);
+		return true;
+	}
+
+	D3D12MeshStore::Mesh& D3D12MeshStore::AddMesh(
+		const void* vertices,
+		size_t vertexCount,
+		uint32_t vertexStride,
+		const std::vector<uint16_t>& indices)
+	{
+		const uint32_t vertexBufferSize{ static_cast<uint32_t>(vertexCount * vertexStride) };
+		const uint32_t indexBufferSize{ static_cast<uint32_t>(indices.size() * sizeof(uint16_t)) };
+
+		// Static geometry lives in DEFAULT heaps; the upload manager stages it
+		// and copies it over on the copy queue.
+		Mesh& stored{ m_meshes.emplace_back() };
+		stored.vertexBuffer = m_uploadManager->CreateBuffer(vertices, vertexBufferSize);
+		stored.indexBuffer = m_uploadManager->CreateBuffer(indices.data(), indexBufferSize);
+
+		stored.vertexBufferView.BufferLocation = stored.vertexBuffer->GetGPUVirtualAddress();
+		stored.vertexBufferView.StrideInBytes = vertexStride;
+		stored.vertexBufferView.SizeInBytes = vertexBufferSize;
+
+		stored.indexBufferView.BufferLocation = stored.indexBuffer->GetGPUVirtualAddress();
+		stored.indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+		stored.indexBufferView.SizeInBytes = indexBufferSize;
+		stored.indexCount = static_cast<uint32_t>(indices.size());
+
+		m_hasPendingUploads = true;
+		return stored;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
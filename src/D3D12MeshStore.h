@@ -0,0 +1,64 @@
+#pragma once
+#include "pch.h"
+#include "DrawSortKey.h"
+#include "IMeshUploadSink.h"
+#include "ShaderConstants.h"
+#include "UploadManager.h"
+
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// D3D12MeshStore owns the vertex and index buffers of every loaded mesh. Meshes
+	/// are copied in through the UploadManager; Flush submits the copies and makes
+	/// the direct queue wait for them, so a mesh can be drawn in the same frame it
+	/// was uploaded. Mesh indices are stable and meshes live as long as the store,
+	/// which holds at most DrawSortKey::MAX_MESH_COUNT so every index fits a draw
+	/// sort key.
+	/// Compressed meshes use COMPRESSED_VERTEX_LAYOUT and need the compressed
+	/// pipeline, with meshConstants set.
+	/// </summary>
+	class D3D12MeshStore : public IMeshUploadSink
+	{
+	public:
+		struct Mesh
+		{
+			Microsoft::WRL::ComPtr<ID3D12Resource> vertexBuffer;
+			Microsoft::WRL::ComPtr<ID3D12Resource> indexBuffer;
+			D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
+			D3D12_INDEX_BUFFER_VIEW indexBufferView;
+			uint32_t indexCount;
+			bool isCompressed;
+			MeshConstants meshConstants;
+		};
+
+		D3D12MeshStore(UploadManager* uploadManager);
+
+		D3D12MeshStore(const D3D12MeshStore&) = delete;
+		D3D12MeshStore& operator=(const D3D12MeshStore&) = delete;
+
+		/// <summary>
+		/// Submits copies queued since the last call, and has queue wait for them.
+		/// </summary>
+		void Flush(ID3D12CommandQueue* queue);
+
+		/// <summary>
+		/// Returns nullptr for an unknown mesh index.
+		/// </summary>
+		const Mesh* GetMesh(uint32_t meshIndex) const;
+		uint32_t GetMeshCount() const;
+
+		// IMeshUploadSink
+		virtual uint32_t UploadMesh(const MeshData& mesh);
+		virtual uint32_t UploadCompressedMesh(const CompressedMeshData& mesh);
+
+	private:
+		UploadManager* const m_uploadManager;
+		std::vector<Mesh> m_meshes;
+		bool m_hasPendingUploads{ false };
+
+		bool IsFull() const;
+		Mesh& AddMesh(const void* vertices, size_t vertexCount, uint32_t vertexStride, const std::vector<uint16_t>& indices);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "pch.h"
+#include "D3D12PipelineStateHash.h"
+#include "Hash.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		uint64_t HashShader(const D3D12_SHADER_BYTECODE& shader, uint64_t hash)
+		{
+			hash = HashValue(static_cast<uint64_t>(shader.BytecodeLength), hash);
+			return HashBytes(shader.pShaderBytecode, shader.BytecodeLength, hash);
+		}
+
+		uint64_t HashStencilOp(const D3D12_DEPTH_STENCILOP_DESC& op, uint64_t hash)
+		{
+			hash = HashValue(op.StencilFailOp, hash);
+			hash = HashValue(op.StencilDepthFailOp, hash);
+			hash = HashValue(op.StencilPassOp, hash);
+			return HashValue(op.StencilFunc, hash);
+		}
+	}
+
+	uint64_t HashPipelineStateDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash)
+	{
+		uint64_t hash{ HashValue(rootSignatureHash) };
+		hash = HashShader(desc.VS, hash);
+		hash = HashShader(desc.PS, hash);
+		hash = HashShader(desc.DS, hash);
+		hash = HashShader(desc.HS, hash);
+		hash = HashShader(desc.GS, hash);
+
+		const D3D12_STREAM_OUTPUT_DESC& streamOutput{ desc.StreamOutput };
+		hash = HashValue(streamOutput.NumEntries, hash);
+		for (uint32_t i = 0; i < streamOutput.NumEntries; ++i)
+		{
+			const D3D12_SO_DECLARATION_ENTRY& entry{ streamOutput.pSODeclaration[i] };
+			hash = HashValue(entry.Stream, hash);
+			hash = HashString(entry.SemanticName ? entry.SemanticName : "", hash);
+			hash = HashValue(entry.SemanticIndex, hash);
+			hash = HashValue(entry.StartComponent, hash);
+			hash = HashValue(entry.ComponentCount, hash);
+			hash = HashValue(entry.OutputSlot, hash);
+		}
+		hash = HashValue(streamOutput.NumStrides, hash);
+		for (uint32_t i = 0; i < streamOutput.NumStrides; ++i)
+		{
+			hash = HashValue(streamOutput.pBufferStrides[i], hash);
+		}
+		hash = HashValue(streamOutput.RasterizedStream, hash);
+
+		const D3D12_BLEND_DESC& blend{ desc.BlendState };
+		hash = HashValue(blend.AlphaToCoverageEnable, hash);
+		hash = HashValue(blend.IndependentBlendEnable, hash);
+		for (const D3D12_RENDER_TARGET_BLEND_DESC& target : blend.RenderTarget)
+		{
+			hash = HashValue(target.BlendEnable, hash);
+			hash = HashValue(target.LogicOpEnable, hash);
+			hash = HashValue(target.SrcBlend, hash);
+			hash = HashValue(target.DestBlend, hash);
+			hash = HashValue(target.BlendOp, hash);
+			hash = HashValue(target.SrcBlendAlpha, hash);
+			hash = HashValue(target.DestBlendAlpha, hash);
+			hash = HashValue(target.BlendOpAlpha, hash);
+			hash = HashValue(target.LogicOp, hash);
+			hash = HashValue(target.RenderTargetWriteMask, hash);
+		}
+		hash = HashValue(desc.SampleMask, hash);
+
+		const D3D12_RASTERIZER_DESC& rasterizer{ desc.RasterizerState };
+		hash = HashValue(rasterizer.FillMode, hash);
+		hash = HashValue(rasterizer.CullMode, hash);
+		hash = HashValue(rasterizer.FrontCounterClockwise, hash);
+		hash = HashValue(rasterizer.DepthBias, hash);
+		hash = HashValue(rasterizer.DepthBiasClamp, hash);
+		hash = HashValue(rasterizer.SlopeScaledDepthBias, hash);
+		hash = HashValue(rasterizer.DepthClipEnable, hash);
+		hash = HashValue(rasterizer.MultisampleEnable, hash);
+		hash = HashValue(rasterizer.AntialiasedLineEnable, hash);
+		hash = HashValue(rasterizer.ForcedSampleCount, hash);
+		hash = HashValue(rasterizer.ConservativeRaster, hash);
+
+		const D3D12_DEPTH_STENCIL_DESC& depthStencil{ desc.DepthStencilState };
+		hash = HashValue(depthStencil.DepthEnable, hash);
+		hash = HashValue(depthStencil.DepthWriteMask, hash);
+		hash = HashValue(depthStencil.DepthFunc, hash);
+		hash = HashValue(depthStencil.StencilEnable, hash);
+		hash = HashValue(depthStencil.StencilReadMask, hash);
+		hash = HashValue(depthStencil.StencilWriteMask, hash);
+		hash = HashStencilOp(depthStencil.FrontFace, hash);
+		hash = HashStencilOp(depthStencil.BackFace, hash);
+
+		hash = HashValue(desc.InputLayout.NumElements, hash);
+		for (uint32_t i = 0; i < desc.InputLayout.NumElements; ++i)
+		{
+			const D3D12_INPUT_ELEMENT_DESC& element{ desc.InputLayout.pInputElementDescs[i] };
+			hash = HashString(element.SemanticName, hash);
+			hash = HashValue(element.SemanticIndex, hash);
+			hash = HashValue(element.Format, hash);
+			hash = HashValue(element.InputSlot, hash);
+			hash = HashValue(element.AlignedByteOffset, hash);
+			hash = HashValue(element.InputSlotClass, hash);
+			hash = HashValue(element.InstanceDataStepRate, hash);
+		}
+
+		hash = HashValue(desc.IBStripCutValue, hash);
+		hash = HashValue(desc.PrimitiveTopologyType, hash);
+
+		// Formats past NumRenderTargets are ignored by D3D12, so they don't count
+		hash = HashValue(desc.NumRenderTargets, hash);
+		for (uint32_t i = 0; (i < desc.NumRenderTargets) && (i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT); ++i)
+		{
+			hash = HashValue(desc.RTVFormats[i], hash);
+		}
+		hash = HashValue(desc.DSVFormat, hash);
+		hash = HashValue(desc.SampleDesc.Count, hash);
+		hash = HashValue(desc.SampleDesc.Quality, hash);
+		hash = HashValue(desc.NodeMask, hash);
+		return HashValue(desc.Flags, hash);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include "pch.h"
+
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Hashes everything in desc that affects the pipeline it describes, field by
+	/// field so struct padding never leaks in: shader bytecode and input layout by
+	/// contents rather than by pointer, then the fixed-function state. The root
+	/// signature is passed as the hash of its serialized form, which desc only
+	/// points to.
+	/// </summary>
+	uint64_t HashPipelineStateDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "pch.h"
+#include "D3D12RenderBackend.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// Event metadata value PIX reads as a null-terminated ANSI string
+		constexpr UINT PIX_EVENT_ANSI_VERSION{ 1 };
+	}
+
+#pragma region Public
+	void D3D12RenderBackend::SetCommandList(ID3D12GraphicsCommandList* commandList)
+	{
+		if (commandList == m_commandList)
+		{
+			return;
+		}
+		if (m_isInPass && m_commandList)
+		{
+			m_commandList->EndEvent();
+		}
+		m_commandList = commandList;
+		if (m_isInPass && m_commandList)
+		{
+			BeginEvent();
+		}
+	}
+
+	void D3D12RenderBackend::BindResource(RenderResourceHandle handle, ID3D12Resource* resource)
+	{
+		if (handle >= m_resources.size())
+		{
+			m_resources.resize(handle + 1, nullptr);
+		}
+		m_resources[handle] = resource;
+	}
+
+	void D3D12RenderBackend::ClearBindings()
+	{
+		m_resources.clear();
+	}
+
+	void D3D12RenderBackend::BeginPass(const std::string& name)
+	{
+		// Kept for SetCommandList to begin the event again on another list;
+		// assigning reuses the string's capacity
+		m_passName.assign(name);
+		m_isInPass = true;
+		if (m_commandList)
+		{
+			BeginEvent();
+		}
+	}
+
+	void D3D12RenderBackend::ResourceBarrier(
+		RenderResourceHandle resource,
+		ResourceState before,
+		ResourceState after)
+	{
+		if ((resource >= m_resources.size()) || (m_resources[resource] == nullptr))
+		{
+			spdlog::warn("D3D12RenderBackend: Barrier on unbound resource {}.", resource);
+			return;
+		}
+
+		CD3DX12_RESOURCE_BARRIER barrier{
+			CD3DX12_RESOURCE_BARRIER::Transition(
+				m_resources[resource],
+				ToD3D12State(before),
+				ToD3D12State(after)
+			)
+		};
+		m_commandList->ResourceBarrier(1, &barrier);
+	}
+
+	void D3D12RenderBackend::EndPass()
+	{
+		if (m_commandList)
+		{
+			m_commandList->EndEvent();
+		}
+		m_isInPass = false;
+	}
+
+	D3D12_RESOURCE_STATES D3D12RenderBackend::ToD3D12State(ResourceState state)
+	{
+		switch (state)
+		{
+		case ResourceState::RenderTarget:
+			return D3D12_RESOURCE_STATE_RENDER_TARGET;
+		case ResourceState::DepthWrite:
+			return D3D12_RESOURCE_STATE_DEPTH_WRITE;
+		case ResourceState::ShaderRead:
+			return (D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE |
+				D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+		case ResourceState::UnorderedAccess:
+			return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+		case ResourceState::CopySource:
+			return D3D12_RESOURCE_STATE_COPY_SOURCE;
+		case ResourceState::CopyDest:
+			return D3D12_RESOURCE_STATE_COPY_DEST;
+		case ResourceState::Present:
+		case ResourceState::Undefined:
+		default:
+			return D3D12_RESOURCE_STATE_COMMON;
+		}
+	}
+#pragma endregion Public
+
+#pragma region Private
+	void D3D12RenderBackend::BeginEvent()
+	{
+		// Marks the pass for PIX and other GPU captures. This is the encoding
+		// PIXBeginEvent falls back to for plain strings, so no WinPixEventRuntime
+		// dependency is needed; the size includes the terminator.
+		m_commandList->BeginEvent(
+			PIX_EVENT_ANSI_VERSION,
+			m_passName.c_str(),
+			static_cast<UINT>(m_passName.size() + 1));
+	}
+#pragma endregion Private
+}
\ No newline at end of file
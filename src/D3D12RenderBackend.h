@@ -0,0 +1,45 @@
+#pragma once
+#include "pch.h"
+#include "RenderGraph.h"
+
+#include <string>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// D3D12RenderBackend translates a RenderGraph's command stream onto a D3D12
+	/// command list. Graph resources must be bound to D3D12 resources before Execute.
+	/// </summary>
+	class D3D12RenderBackend : public IRenderBackend
+	{
+	public:
+		/// <summary>
+		/// Records into commandList from now on. If a pass is open, its PIX event
+		/// is ended on the old list and begun again on the new one, so each list's
+		/// events stay balanced; pass nullptr to end it before closing the old list
+		/// and the new list's event begins when it is set.
+		/// </summary>
+		void SetCommandList(ID3D12GraphicsCommandList* commandList);
+		void BindResource(RenderResourceHandle handle, ID3D12Resource* resource);
+		void ClearBindings();
+
+		// IRenderBackend
+		virtual void BeginPass(const std::string& name);
+		virtual void ResourceBarrier(
+			RenderResourceHandle resource,
+			ResourceState before,
+			ResourceState after);
+		virtual void EndPass();
+
+		static D3D12_RESOURCE_STATES ToD3D12State(ResourceState state);
+
+	private:
+		void BeginEvent();
+
+		ID3D12GraphicsCommandList* m_commandList{ nullptr };
+		bool m_isInPass{ false };
+		std::string m_passName;
+		std::vector<ID3D12Resource*> m_resources;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "D3D12StateTrackingCommandList.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	D3D12StateTrackingCommandList::D3D12StateTrackingCommandList(ID3D12GraphicsCommandList* commandList) :
+		m_commandList{ commandList }
+	{ }
+
+	void D3D12StateTrackingCommandList::SetPipelineState(ID3D12PipelineState* pipelineState)
+	{
+		if (m_tracker.Update(DrawStateTracker::PIPELINE_SLOT, pipelineState))
+		{
+			m_commandList->SetPipelineState(pipelineState);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::SetGraphicsRootSignature(ID3D12RootSignature* rootSignature)
+	{
+		if (m_tracker.Update(DrawStateTracker::ROOT_SIGNATURE_SLOT, rootSignature))
+		{
+			m_commandList->SetGraphicsRootSignature(rootSignature);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::SetGraphicsRootConstantBufferView(
+		uint32_t parameter,
+		D3D12_GPU_VIRTUAL_ADDRESS address)
+	{
+		if (m_tracker.Update(DrawStateTracker::FIRST_ROOT_PARAMETER_SLOT + parameter, address))
+		{
+			m_commandList->SetGraphicsRootConstantBufferView(parameter, address);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::SetGraphicsRoot32BitConstants(
+		uint32_t parameter,
+		uint32_t count,
+		const void* data,
+		uint32_t offset)
+	{
+		const uint32_t slot{ DrawStateTracker::FIRST_ROOT_PARAMETER_SLOT + parameter };
+		if (offset != 0)
+		{
+			// A partial update; the parameter's full value is no longer known
+			m_tracker.SetUntracked(slot);
+			m_commandList->SetGraphicsRoot32BitConstants(parameter, count, data, offset);
+			return;
+		}
+		if (m_tracker.Update(slot, data, count * sizeof(uint32_t)))
+		{
+			m_commandList->SetGraphicsRoot32BitConstants(parameter, count, data, offset);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::RSSetViewport(const D3D12_VIEWPORT& viewport)
+	{
+		if (m_tracker.Update(DrawStateTracker::VIEWPORT_SLOT, viewport))
+		{
+			m_commandList->RSSetViewports(1, &viewport);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::RSSetScissorRect(const D3D12_RECT& scissorRect)
+	{
+		if (m_tracker.Update(DrawStateTracker::SCISSOR_SLOT, scissorRect))
+		{
+			m_commandList->RSSetScissorRects(1, &scissorRect);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget)
+	{
+		if (m_tracker.Update(DrawStateTracker::RENDER_TARGET_SLOT, renderTarget.ptr))
+		{
+			m_commandList->OMSetRenderTargets(1, &renderTarget, false, nullptr);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+	{
+		if (m_tracker.Update(DrawStateTracker::TOPOLOGY_SLOT, topology))
+		{
+			m_commandList->IASetPrimitiveTopology(topology);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::IASetVertexBuffer(uint32_t slot, const D3D12_VERTEX_BUFFER_VIEW& view)
+	{
+		if (m_tracker.Update(DrawStateTracker::FIRST_VERTEX_BUFFER_SLOT + slot, view))
+		{
+			m_commandList->IASetVertexBuffers(slot, 1, &view);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view)
+	{
+		if (m_tracker.Update(DrawStateTracker::INDEX_BUFFER_SLOT, view))
+		{
+			m_commandList->IASetIndexBuffer(&view);
+		}
+	}
+
+	void D3D12StateTrackingCommandList::DrawIndexedInstanced(
+		uint32_t indexCount,
+		uint32_t instanceCount,
+		uint32_t startIndex,
+		int32_t baseVertex,
+		uint32_t startInstance)
+	{
+		m_commandList->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+	}
+
+	void D3D12StateTrackingCommandList::Invalidate()
+	{
+		m_tracker.Reset();
+	}
+
+	ID3D12GraphicsCommandList* D3D12StateTrackingCommandList::Get() const
+	{
+		return m_commandList;
+	}
+
+	const DrawStateTracker::Stats& D3D12StateTrackingCommandList::GetStats() const
+	{
+		return m_tracker.GetStats();
+	}
+#pragma endregion Public
+}
\ No newline at end of file
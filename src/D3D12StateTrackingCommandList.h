@@ -0,0 +1,53 @@
+#pragma once
+#include "pch.h"
+#include "DrawStateTracker.h"
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// D3D12StateTrackingCommandList forwards draw-state calls to a graphics command
+	/// list, dropping the ones that would set what is already set. Only the calls the
+	/// renderer uses are wrapped; anything else goes through Get(), and must be
+	/// followed by Invalidate() if it changes tracked state.
+	/// </summary>
+	class D3D12StateTrackingCommandList
+	{
+	public:
+		D3D12StateTrackingCommandList(ID3D12GraphicsCommandList* commandList);
+
+		void SetPipelineState(ID3D12PipelineState* pipelineState);
+		void SetGraphicsRootSignature(ID3D12RootSignature* rootSignature);
+		void SetGraphicsRootConstantBufferView(uint32_t parameter, D3D12_GPU_VIRTUAL_ADDRESS address);
+
+		/// <summary>
+		/// Tracks whole parameters only: calls with a non-zero offset are always issued.
+		/// </summary>
+		void SetGraphicsRoot32BitConstants(uint32_t parameter, uint32_t count, const void* data, uint32_t offset);
+
+		void RSSetViewport(const D3D12_VIEWPORT& viewport);
+		void RSSetScissorRect(const D3D12_RECT& scissorRect);
+		void OMSetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget);
+		void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology);
+		void IASetVertexBuffer(uint32_t slot, const D3D12_VERTEX_BUFFER_VIEW& view);
+		void IASetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& view);
+
+		void DrawIndexedInstanced(
+			uint32_t indexCount,
+			uint32_t instanceCount,
+			uint32_t startIndex,
+			int32_t baseVertex,
+			uint32_t startInstance);
+
+		/// <summary>
+		/// Forgets tracked state, so every following call is issued.
+		/// </summary>
+		void Invalidate();
+
+		ID3D12GraphicsCommandList* Get() const;
+		const DrawStateTracker::Stats& GetStats() const;
+
+	private:
+		ID3D12GraphicsCommandList* const m_commandList;
+		DrawStateTracker m_tracker;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "D3D12VertexLayout.h"
+
+namespace HelloTriangle
+{
+	DXGI_FORMAT GetDxgiFormat(VertexFormat format)
+	{
+		switch (format)
+		{
+		case VertexFormat::Float32x3:
+			return DXGI_FORMAT_R32G32B32_FLOAT;
+		case VertexFormat::Float32x4:
+			return DXGI_FORMAT_R32G32B32A32_FLOAT;
+		case VertexFormat::Snorm16x1:
+			return DXGI_FORMAT_R16_SNORM;
+		case VertexFormat::Snorm16x2:
+			return DXGI_FORMAT_R16G16_SNORM;
+		case VertexFormat::Snorm16x4:
+			return DXGI_FORMAT_R16G16B16A16_SNORM;
+		case VertexFormat::Unorm8x4:
+			return DXGI_FORMAT_R8G8B8A8_UNORM;
+		}
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	void AppendD3D12InputElements(
+		const VertexAttribute* attributes,
+		size_t attributeCount,
+		uint32_t inputSlot,
+		std::vector<D3D12_INPUT_ELEMENT_DESC>& elements)
+	{
+		for (size_t i = 0; i < attributeCount; ++i)
+		{
+			const VertexAttribute& attribute{ attributes[i] };
+			elements.push_back(D3D12_INPUT_ELEMENT_DESC{
+				attribute.semantic,
+				attribute.semanticIndex,
+				GetDxgiFormat(attribute.format),
+				inputSlot,
+				attribute.offset,
+				D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+				0
+			});
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+#include "pch.h"
+#include "VertexCompression.h"
+
+#include <vector>
+
+namespace HelloTriangle
+{
+	DXGI_FORMAT GetDxgiFormat(VertexFormat format);
+
+	/// <summary>
+	/// Appends one per-vertex D3D12 input element per attribute, reading from
+	/// inputSlot. The semantic names are not copied, so they must outlive the
+	/// elements; the layouts in VertexCompression.h point at string literals.
+	/// </summary>
+	void AppendD3D12InputElements(
+		const VertexAttribute* attributes,
+		size_t attributeCount,
+		uint32_t inputSlot,
+		std::vector<D3D12_INPUT_ELEMENT_DESC>& elements);
+}
\ No newline at end of file
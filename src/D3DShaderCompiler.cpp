@@ -0,0 +1,92 @@
+#include "pch.h"
+#include "D3DShaderCompiler.h"
+#include "BlobArchive.h"
+
+#include <fstream>
+
+namespace HelloTriangle
+{
+	uint32_t GetShaderCompileFlags()
+	{
+		uint32_t compileFlags{ 0 };
+#ifdef _DEBUG
+		compileFlags |= (D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION);
+#endif
+		return compileFlags;
+	}
+
+	MWRL::ComPtr<ID3DBlob> CompileShader(
+		std::string_view source,
+		const std::filesystem::path& sourcePath,
+		const ShaderEntryPoint& entryPoint,
+		uint32_t compileFlags)
+	{
+		spdlog::info("D3DShaderCompiler: Compiling {} ({})...", entryPoint.name, entryPoint.target);
+		const std::string sourceName{ sourcePath.string() };
+		MWRL::ComPtr<ID3DBlob> bytecode;
+		MWRL::ComPtr<ID3DBlob> errors;
+		const HRESULT result{ D3DCompile(
+			source.data(),
+			source.size(),
+			sourceName.c_str(),
+			nullptr,
+			D3D_COMPILE_STANDARD_FILE_INCLUDE,
+			entryPoint.name,
+			entryPoint.target,
+			compileFlags,
+			0,
+			&bytecode,
+			&errors
+		) };
+		if (errors)
+		{
+			spdlog::error("D3DShaderCompiler: {}", static_cast<const char*>(errors->GetBufferPointer()));
+		}
+		ThrowIfFailed(result);
+		return bytecode;
+	}
+
+	bool CompileShaderArchive(const std::filesystem::path& sourcePath, const std::filesystem::path& archivePath)
+	{
+		std::ifstream file{ sourcePath, std::ios::binary };
+		if (!file)
+		{
+			spdlog::error("D3DShaderCompiler: Could not open shader source '{}'.", sourcePath.string());
+			return false;
+		}
+		const std::string source{
+			std::istreambuf_iterator<char>{ file },
+			std::istreambuf_iterator<char>{}
+		};
+
+		const uint32_t compileFlags{ GetShaderCompileFlags() };
+		BlobArchive archive;
+		for (const ShaderEntryPoint& entryPoint : SHADER_ENTRY_POINTS)
+		{
+			try
+			{
+				const MWRL::ComPtr<ID3DBlob> bytecode{ CompileShader(source, sourcePath, entryPoint, compileFlags) };
+				archive.Set(
+					ComputeShaderKey(source, sourcePath, entryPoint, compileFlags),
+					bytecode->GetBufferPointer(),
+					bytecode->GetBufferSize());
+			}
+			catch (const std::exception&)
+			{
+				spdlog::error("D3DShaderCompiler: Failed to compile {} ({}).", entryPoint.name, entryPoint.target);
+				return false;
+			}
+		}
+
+		if (!archive.Save(archivePath))
+		{
+			spdlog::error("D3DShaderCompiler: Could not write shader archive '{}'.", archivePath.string());
+			return false;
+		}
+		spdlog::info(
+			"D3DShaderCompiler: Wrote {} shaders to {}.",
+			archive.GetEntryCount(),
+			archivePath.string());
+		return true;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "pch.h"
+#include "ShaderSource.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Flags every shader is compiled with in this build configuration. The build
+	/// step and the renderer must agree on them for archived bytecode to be found.
+	/// </summary>
+	uint32_t GetShaderCompileFlags();
+
+	/// <summary>
+	/// Compiles one entry point of source with D3DCompile, logging any errors and
+	/// throwing if compilation fails.
+	/// </summary>
+	MWRL::ComPtr<ID3DBlob> CompileShader(
+		std::string_view source,
+		const std::filesystem::path& sourcePath,
+		const ShaderEntryPoint& entryPoint,
+		uint32_t compileFlags);
+
+	/// <summary>
+	/// Compiles every entry point in SHADER_ENTRY_POINTS from sourcePath with this
+	/// configuration's flags and writes them to a new BlobArchive at archivePath,
+	/// keyed as the renderer looks them up. Run at build time, so that launching
+	/// never has to wait for the compiler.
+	/// </summary>
+	bool CompileShaderArchive(const std::filesystem::path& sourcePath, const std::filesystem::path& archivePath);
+}
@@ -0,0 +1,176 @@
+#include "pch.h"
+#include "DescriptorAllocator.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	DescriptorAllocator::DescriptorAllocator(
+		uint32_t persistentCapacity,
+		uint32_t transientCapacity
+	) :
+		m_persistentCapacity{ persistentCapacity },
+		m_transientCapacity{ transientCapacity },
+		m_transientRing{ transientCapacity }
+	{
+		if (persistentCapacity > 0)
+		{
+			m_freeRanges.push_back(FreeRange{ 0, persistentCapacity });
+			m_persistentFreeCount = persistentCapacity;
+		}
+	}
+
+	uint32_t DescriptorAllocator::AllocatePersistent(uint32_t count)
+	{
+		if (count == 0)
+		{
+			return INVALID_INDEX;
+		}
+
+		for (auto range = m_freeRanges.begin(); range != m_freeRanges.end(); ++range)
+		{
+			if (range->count < count)
+			{
+				continue;
+			}
+
+			const uint32_t index{ range->index };
+			range->index += count;
+			range->count -= count;
+			if (range->count == 0)
+			{
+				m_freeRanges.erase(range);
+			}
+			m_persistentFreeCount -= count;
+			return index;
+		}
+		return INVALID_INDEX;
+	}
+
+	void DescriptorAllocator::FreePersistent(uint32_t index, uint32_t count, uint64_t fenceValue)
+	{
+		if ((count == 0) || (index >= m_persistentCapacity) || (count > (m_persistentCapacity - index)))
+		{
+			spdlog::warn("DescriptorAllocator: Ignoring free of out-of-range slots {}+{}.", index, count);
+			return;
+		}
+		if (IsFreeOrPending(index, count))
+		{
+			spdlog::error("DescriptorAllocator: Ignoring double free of slots {}+{}.", index, count);
+			return;
+		}
+		m_pendingFrees.push_back(PendingFree{ fenceValue, index, count });
+		m_pendingFreeCount += count;
+	}
+
+	uint32_t DescriptorAllocator::AllocateTransient(uint32_t count)
+	{
+		if (count == 0)
+		{
+			return INVALID_INDEX;
+		}
+		const uint64_t offset{ m_transientRing.Allocate(count, 1) };
+		if (offset == RingAllocator::INVALID_OFFSET)
+		{
+			return INVALID_INDEX;
+		}
+		return m_persistentCapacity + static_cast<uint32_t>(offset);
+	}
+
+	void DescriptorAllocator::FinishFrame(uint64_t fenceValue)
+	{
+		m_transientRing.FinishBatch(fenceValue);
+	}
+
+	void DescriptorAllocator::Retire(uint64_t completedFenceValue)
+	{
+		while (!m_pendingFrees.empty() && (m_pendingFrees.front().fenceValue <= completedFenceValue))
+		{
+			const PendingFree pending{ m_pendingFrees.front() };
+			m_pendingFrees.pop_front();
+			m_pendingFreeCount -= pending.count;
+			Release(pending.index, pending.count);
+		}
+		m_transientRing.Retire(completedFenceValue);
+	}
+
+	uint32_t DescriptorAllocator::GetCapacity() const
+	{
+		return m_persistentCapacity + m_transientCapacity;
+	}
+
+	uint32_t DescriptorAllocator::GetPersistentCapacity() const
+	{
+		return m_persistentCapacity;
+	}
+
+	uint32_t DescriptorAllocator::GetPersistentFreeCount() const
+	{
+		return m_persistentFreeCount;
+	}
+
+	uint32_t DescriptorAllocator::GetPendingFreeCount() const
+	{
+		return m_pendingFreeCount;
+	}
+
+	uint32_t DescriptorAllocator::GetTransientUsedCount() const
+	{
+		return static_cast<uint32_t>(m_transientRing.GetUsedBytes());
+	}
+#pragma endregion Public
+
+#pragma region Private
+	bool DescriptorAllocator::IsFreeOrPending(uint32_t index, uint32_t count) const
+	{
+		// The ranges are sorted and disjoint, so only the last one starting before
+		// end can overlap
+		const uint32_t end{ index + count };
+		auto after{ std::lower_bound(
+			m_freeRanges.begin(),
+			m_freeRanges.end(),
+			end,
+			[](const FreeRange& range, uint32_t value) { return range.index < value; }) };
+		if ((after != m_freeRanges.begin()) && ((std::prev(after)->index + std::prev(after)->count) > index))
+		{
+			return true;
+		}
+
+		for (const PendingFree& pending : m_pendingFrees)
+		{
+			if ((pending.index < end) && (index < (pending.index + pending.count)))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void DescriptorAllocator::Release(uint32_t index, uint32_t count)
+	{
+		// Insert in index order, then merge with the neighbours it touches
+		auto next{ std::lower_bound(
+			m_freeRanges.begin(),
+			m_freeRanges.end(),
+			index,
+			[](const FreeRange& range, uint32_t value) { return range.index < value; }) };
+		auto inserted{ m_freeRanges.insert(next, FreeRange{ index, count }) };
+		m_persistentFreeCount += count;
+
+		auto following{ std::next(inserted) };
+		if ((following != m_freeRanges.end()) && ((inserted->index + inserted->count) == following->index))
+		{
+			inserted->count += following->count;
+			inserted = std::prev(m_freeRanges.erase(following));
+		}
+		if (inserted != m_freeRanges.begin())
+		{
+			auto previous{ std::prev(inserted) };
+			if ((previous->index + previous->count) == inserted->index)
+			{
+				previous->count += inserted->count;
+				m_freeRanges.erase(inserted);
+			}
+		}
+	}
+#pragma endregion Private
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+#include "RingAllocator.h"
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// DescriptorAllocator hands out slots in a descriptor heap without knowing
+	/// anything about the graphics API. The heap is split into two regions:
+	///  - persistent slots at the front, for long-lived views, managed with a
+	///    coalescing first-fit free list
+	///  - transient slots behind them, a per-frame ring for descriptor tables that
+	///    only live until the frame that used them retires
+	/// Frees are deferred until the fence value passed with them completes, since
+	/// the GPU may still read a descriptor after the CPU stops using it.
+	/// </summary>
+	class DescriptorAllocator
+	{
+	public:
+		static constexpr uint32_t INVALID_INDEX{ std::numeric_limits<uint32_t>::max() };
+
+		DescriptorAllocator(uint32_t persistentCapacity, uint32_t transientCapacity);
+
+		/// <summary>
+		/// Returns the first of count contiguous persistent slots, or INVALID_INDEX.
+		/// </summary>
+		uint32_t AllocatePersistent(uint32_t count);
+
+		/// <summary>
+		/// Releases persistent slots once fenceValue completes. Fence values must not
+		/// decrease between calls; zero frees immediately on the next Retire. Slots
+		/// that are already free, or already waiting to be, are rejected.
+		/// </summary>
+		void FreePersistent(uint32_t index, uint32_t count, uint64_t fenceValue);
+
+		/// <summary>
+		/// Returns the first of count contiguous transient slots for the current frame,
+		/// or INVALID_INDEX if the ring is full.
+		/// </summary>
+		uint32_t AllocateTransient(uint32_t count);
+
+		/// <summary>
+		/// Closes the current frame's transient allocations against fenceValue.
+		/// </summary>
+		void FinishFrame(uint64_t fenceValue);
+
+		/// <summary>
+		/// Reclaims deferred frees and transient slots up to completedFenceValue.
+		/// </summary>
+		void Retire(uint64_t completedFenceValue);
+
+		uint32_t GetCapacity() const;
+		uint32_t GetPersistentCapacity() const;
+		uint32_t GetPersistentFreeCount() const;
+		uint32_t GetPendingFreeCount() const;
+		uint32_t GetTransientUsedCount() const;
+
+	private:
+		struct FreeRange
+		{
+			uint32_t index;
+			uint32_t count;
+		};
+
+		struct PendingFree
+		{
+			uint64_t fenceValue;
+			uint32_t index;
+			uint32_t count;
+		};
+
+		const uint32_t m_persistentCapacity;
+		const uint32_t m_transientCapacity;
+
+		// Sorted by index, with no two ranges adjacent
+		std::vector<FreeRange> m_freeRanges;
+		std::deque<PendingFree> m_pendingFrees;
+		uint32_t m_persistentFreeCount{ 0 };
+		uint32_t m_pendingFreeCount{ 0 };
+
+		RingAllocator m_transientRing;
+
+		bool IsFreeOrPending(uint32_t index, uint32_t count) const;
+		void Release(uint32_t index, uint32_t count);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "pch.h"
+#include "DrawBatcher.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	void DrawBatcher::Reserve(size_t instanceCount)
+	{
+		m_submittedInstances.reserve(instanceCount);
+		m_sortEntries.reserve(instanceCount);
+		m_sortScratch.reserve(instanceCount);
+		m_instances.reserve(instanceCount);
+	}
+
+	bool DrawBatcher::Submit(const DrawKey& key, const InstanceData& instance)
+	{
+		if (!DrawSortKey::IsEncodable(key))
+		{
+			++m_rejectedCount;
+			return false;
+		}
+
+		m_sortEntries.push_back(RadixSortEntry{
+			DrawSortKey::Encode(key),
+			static_cast<uint32_t>(m_submittedInstances.size())
+		});
+		m_submittedInstances.push_back(instance);
+		return true;
+	}
+
+	bool DrawBatcher::Submit(uint32_t material, uint32_t mesh, const InstanceData& instance)
+	{
+		return Submit(DrawKey{ .material = material, .mesh = mesh }, instance);
+	}
+
+	void DrawBatcher::Build()
+	{
+		const auto buildStart{ std::chrono::steady_clock::now() };
+
+		// Stable, so instances at equal depth keep their submission order
+		RadixSort(m_sortEntries, m_sortScratch);
+
+		m_instances.clear();
+		m_batches.clear();
+		uint64_t batchStateKey{ 0 };
+		for (const RadixSortEntry& entry : m_sortEntries)
+		{
+			const uint64_t stateKey{ DrawSortKey::GetStateKey(entry.key) };
+			if (m_batches.empty() || (stateKey != batchStateKey))
+			{
+				const DrawKey key{ DrawSortKey::Decode(entry.key) };
+				m_batches.push_back(DrawBatch{
+					.pass = key.pass,
+					.pipeline = key.pipeline,
+					.rootSignature = key.rootSignature,
+					.material = key.material,
+					.mesh = key.mesh,
+					.firstInstance = static_cast<uint32_t>(m_instances.size()),
+					.instanceCount = 0,
+				});
+				batchStateKey = stateKey;
+			}
+			++m_batches.back().instanceCount;
+			m_instances.push_back(m_submittedInstances[entry.value]);
+		}
+
+		m_stats.submittedCount = static_cast<uint32_t>(m_sortEntries.size());
+		m_stats.batchCount = static_cast<uint32_t>(m_batches.size());
+		m_stats.rejectedCount = m_rejectedCount;
+		m_stats.buildTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - buildStart);
+	}
+
+	void DrawBatcher::Reset()
+	{
+		m_submittedInstances.clear();
+		m_sortEntries.clear();
+		m_instances.clear();
+		m_batches.clear();
+		m_rejectedCount = 0;
+	}
+
+	const std::vector<DrawBatch>& DrawBatcher::GetBatches() const
+	{
+		return m_batches;
+	}
+
+	const std::vector<InstanceData>& DrawBatcher::GetInstances() const
+	{
+		return m_instances;
+	}
+
+	const DrawBatcher::Stats& DrawBatcher::GetStats() const
+	{
+		return m_stats;
+	}
+
+	void DrawBatchingTotals::Add(const DrawBatcher::Stats& stats)
+	{
+		++frameCount;
+		submittedCount += stats.submittedCount;
+		batchCount += stats.batchCount;
+		rejectedCount += stats.rejectedCount;
+		buildTime += stats.buildTime;
+		maxBuildTime = std::max(maxBuildTime, stats.buildTime);
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+#include "DrawSortKey.h"
+#include "RadixSort.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// InstanceData is the per-instance vertex stream consumed by VSMain: a position
+	/// offset with a uniform scale in w, and a color multiplier.
+	/// </summary>
+	struct InstanceData
+	{
+		float positionScale[4];
+		float color[4];
+	};
+	static_assert(sizeof(InstanceData) == 32, "InstanceData must match the D3D12 input layout");
+
+	/// <summary>
+	/// DrawBatch is one instanced draw: every instance of a mesh that shares a pass,
+	/// pipeline, root signature and material.
+	/// </summary>
+	struct DrawBatch
+	{
+		uint32_t pass;
+		uint32_t pipeline;
+		uint32_t rootSignature;
+		uint32_t material;
+		uint32_t mesh;
+		uint32_t firstInstance;
+		uint32_t instanceCount;
+	};
+
+	/// <summary>
+	/// DrawBatcher collects per-object draw submissions for a frame and turns them into
+	/// as few instanced draws as possible: submissions are radix sorted by their draw
+	/// sort key, so state changes are rare and depth orders instances within a batch,
+	/// and each run of equal state becomes one batch over a contiguous range of a
+	/// packed instance array.
+	/// </summary>
+	class DrawBatcher
+	{
+	public:
+		struct Stats
+		{
+			uint32_t submittedCount{ 0 };
+			uint32_t batchCount{ 0 };
+			std::chrono::nanoseconds buildTime{ 0 };
+
+			// Submissions dropped because a field didn't fit its sort key bits
+			uint32_t rejectedCount{ 0 };
+		};
+
+		void Reserve(size_t instanceCount);
+
+		/// <summary>
+		/// Returns false and drops the draw if key isn't encodable, rather than let
+		/// it alias another draw's state and be drawn with the wrong mesh or material.
+		/// </summary>
+		bool Submit(const DrawKey& key, const InstanceData& instance);
+
+		/// <summary>
+		/// Submits to the first pass, pipeline and root signature at depth 0.
+		/// </summary>
+		bool Submit(uint32_t material, uint32_t mesh, const InstanceData& instance);
+
+		/// <summary>
+		/// Sorts this frame's submissions and builds batches and instance data.
+		/// </summary>
+		void Build();
+
+		/// <summary>
+		/// Clears submissions for the next frame, keeping allocated capacity.
+		/// </summary>
+		void Reset();
+
+		const std::vector<DrawBatch>& GetBatches() const;
+		const std::vector<InstanceData>& GetInstances() const;
+		const Stats& GetStats() const;
+
+	private:
+		std::vector<InstanceData> m_submittedInstances;
+		std::vector<RadixSortEntry> m_sortEntries;
+		std::vector<RadixSortEntry> m_sortScratch;
+		std::vector<InstanceData> m_instances;
+		std::vector<DrawBatch> m_batches;
+		uint32_t m_rejectedCount{ 0 };
+		Stats m_stats;
+	};
+
+	/// <summary>
+	/// DrawBatchingTotals sums DrawBatcher::Stats over many frames, for reporting
+	/// draw calls and batching time per frame.
+	/// </summary>
+	struct DrawBatchingTotals
+	{
+		uint64_t frameCount{ 0 };
+		uint64_t submittedCount{ 0 };
+		uint64_t batchCount{ 0 };
+		uint64_t rejectedCount{ 0 };
+		std::chrono::nanoseconds buildTime{ 0 };
+		std::chrono::nanoseconds maxBuildTime{ 0 };
+
+		void Add(const DrawBatcher::Stats& stats);
+	};
+}
\ No newline at end of file
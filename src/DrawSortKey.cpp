@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "DrawSortKey.h"
+
+#include <cmath>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint64_t FieldMask(uint32_t bits)
+		{
+			return (1ull << bits) - 1;
+		}
+
+		constexpr uint32_t ExtractField(uint64_t sortKey, uint32_t shift, uint32_t bits)
+		{
+			return static_cast<uint32_t>((sortKey >> shift) & FieldMask(bits));
+		}
+	}
+
+	namespace DrawSortKey
+	{
+		uint64_t Encode(const DrawKey& key)
+		{
+			assert(IsEncodable(key));
+
+			// Negated comparison so NaN clamps to the front too
+			const float depth{ !(key.depth > 0.0f) ? 0.0f : std::min(key.depth, 1.0f) };
+			const uint64_t quantizedDepth{
+				static_cast<uint64_t>(std::lrint(depth * static_cast<float>(FieldMask(DEPTH_BITS))))
+			};
+
+			return ((static_cast<uint64_t>(key.pass) & FieldMask(PASS_BITS)) << PASS_SHIFT) |
+				((static_cast<uint64_t>(key.pipeline) & FieldMask(PIPELINE_BITS)) << PIPELINE_SHIFT) |
+				((static_cast<uint64_t>(key.rootSignature) & FieldMask(ROOT_SIGNATURE_BITS)) << ROOT_SIGNATURE_SHIFT) |
+				((static_cast<uint64_t>(key.material) & FieldMask(MATERIAL_BITS)) << MATERIAL_SHIFT) |
+				((static_cast<uint64_t>(key.mesh) & FieldMask(MESH_BITS)) << MESH_SHIFT) |
+				quantizedDepth;
+		}
+
+		DrawKey Decode(uint64_t sortKey)
+		{
+			return DrawKey{
+				.pass = ExtractField(sortKey, PASS_SHIFT, PASS_BITS),
+				.pipeline = ExtractField(sortKey, PIPELINE_SHIFT, PIPELINE_BITS),
+				.rootSignature = ExtractField(sortKey, ROOT_SIGNATURE_SHIFT, ROOT_SIGNATURE_BITS),
+				.material = ExtractField(sortKey, MATERIAL_SHIFT, MATERIAL_BITS),
+				.mesh = ExtractField(sortKey, MESH_SHIFT, MESH_BITS),
+				.depth = static_cast<float>(ExtractField(sortKey, 0, DEPTH_BITS)) /
+					static_cast<float>(FieldMask(DEPTH_BITS)),
+			};
+		}
+	}
+}
\ No newline at end of file
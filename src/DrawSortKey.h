@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// DrawKey is the state a draw needs, from most to least expensive to change.
+	/// depth is a normalized view depth in [0, 1]; smaller sorts first, so opaque
+	/// draws with the same state go front to back.
+	/// </summary>
+	struct DrawKey
+	{
+		uint32_t pass{ 0 };
+		uint32_t pipeline{ 0 };
+		uint32_t rootSignature{ 0 };
+		uint32_t material{ 0 };
+		uint32_t mesh{ 0 };
+		float depth{ 0.0f };
+	};
+
+	/// <summary>
+	/// Draw sort keys pack a DrawKey into 64 bits, most significant field first, so
+	/// sorting the keys groups draws by state and orders each group by depth. Every
+	/// field but depth must fit its bit count: a truncated field would alias another
+	/// draw's state, so callers check IsEncodable first.
+	/// </summary>
+	namespace DrawSortKey
+	{
+		constexpr uint32_t DEPTH_BITS{ 18 };
+		constexpr uint32_t MESH_BITS{ 16 };
+		constexpr uint32_t MATERIAL_BITS{ 12 };
+		constexpr uint32_t ROOT_SIGNATURE_BITS{ 4 };
+		constexpr uint32_t PIPELINE_BITS{ 10 };
+		constexpr uint32_t PASS_BITS{ 4 };
+		static_assert(
+			DEPTH_BITS + MESH_BITS + MATERIAL_BITS + ROOT_SIGNATURE_BITS + PIPELINE_BITS + PASS_BITS == 64,
+			"Draw sort key fields must fill 64 bits");
+
+		constexpr uint32_t MESH_SHIFT{ DEPTH_BITS };
+		constexpr uint32_t MATERIAL_SHIFT{ MESH_SHIFT + MESH_BITS };
+		constexpr uint32_t ROOT_SIGNATURE_SHIFT{ MATERIAL_SHIFT + MATERIAL_BITS };
+		constexpr uint32_t PIPELINE_SHIFT{ ROOT_SIGNATURE_SHIFT + ROOT_SIGNATURE_BITS };
+		constexpr uint32_t PASS_SHIFT{ PIPELINE_SHIFT + PIPELINE_BITS };
+
+		constexpr uint32_t MAX_MESH_COUNT{ 1u << MESH_BITS };
+		constexpr uint32_t MAX_MATERIAL_COUNT{ 1u << MATERIAL_BITS };
+
+		constexpr bool IsEncodable(const DrawKey& key)
+		{
+			return (key.pass < (1u << PASS_BITS)) &&
+				(key.pipeline < (1u << PIPELINE_BITS)) &&
+				(key.rootSignature < (1u << ROOT_SIGNATURE_BITS)) &&
+				(key.material < MAX_MATERIAL_COUNT) &&
+				(key.mesh < MAX_MESH_COUNT);
+		}
+
+		/// <summary>
+		/// key must be encodable; depth is clamped to [0, 1] and quantized.
+		/// </summary>
+		uint64_t Encode(const DrawKey& key);
+
+		/// <summary>
+		/// The inverse of Encode, with depth quantized to DEPTH_BITS.
+		/// </summary>
+		DrawKey Decode(uint64_t sortKey);
+
+		/// <summary>
+		/// Drops the depth bits: draws with equal state keys can share a batch.
+		/// </summary>
+		constexpr uint64_t GetStateKey(uint64_t sortKey)
+		{
+			return sortKey >> DEPTH_BITS;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "pch.h"
+#include "DrawStateTracker.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	void DrawStateTracker::Reset()
+	{
+		for (SlotState& slot : m_slots)
+		{
+			slot.isSet = false;
+		}
+	}
+
+	bool DrawStateTracker::Update(uint32_t slot, const void* value, size_t size)
+	{
+		if (slot >= SLOT_COUNT)
+		{
+			++m_stats.issuedCount;
+			return true;
+		}
+
+		if (size > MAX_VALUE_SIZE)
+		{
+			SetUntracked(slot);
+			return true;
+		}
+
+		SlotState& state{ m_slots[slot] };
+		if (state.isSet && (state.size == size) && (memcmp(state.bytes.data(), value, size) == 0))
+		{
+			++m_stats.avoidedCount;
+			return false;
+		}
+
+		state.isSet = true;
+		state.size = static_cast<uint8_t>(size);
+		memcpy(state.bytes.data(), value, size);
+		if (slot == ROOT_SIGNATURE_SLOT)
+		{
+			for (uint32_t parameter = 0; parameter < MAX_ROOT_PARAMETERS; ++parameter)
+			{
+				m_slots[FIRST_ROOT_PARAMETER_SLOT + parameter].isSet = false;
+			}
+		}
+		++m_stats.issuedCount;
+		return true;
+	}
+
+	void DrawStateTracker::SetUntracked(uint32_t slot)
+	{
+		if (slot < SLOT_COUNT)
+		{
+			m_slots[slot].isSet = false;
+		}
+		++m_stats.issuedCount;
+	}
+
+	const DrawStateTracker::Stats& DrawStateTracker::GetStats() const
+	{
+		return m_stats;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
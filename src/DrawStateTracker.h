@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// DrawStateTracker remembers the state last set on one command list and tells
+	/// whether a Set* call would change it, so redundant calls can be dropped. Values
+	/// are compared byte for byte. Command lists don't inherit state, so a tracker
+	/// covers one command list between resets.
+	/// </summary>
+	class DrawStateTracker
+	{
+	public:
+		static constexpr uint32_t MAX_VERTEX_BUFFERS{ 4 };
+		static constexpr uint32_t MAX_ROOT_PARAMETERS{ 8 };
+
+		// Values larger than this aren't tracked and are always set
+		static constexpr size_t MAX_VALUE_SIZE{ 32 };
+
+		enum Slot : uint32_t
+		{
+			PIPELINE_SLOT,
+			ROOT_SIGNATURE_SLOT,
+			TOPOLOGY_SLOT,
+			VIEWPORT_SLOT,
+			SCISSOR_SLOT,
+			RENDER_TARGET_SLOT,
+			INDEX_BUFFER_SLOT,
+			FIRST_VERTEX_BUFFER_SLOT,
+			FIRST_ROOT_PARAMETER_SLOT = FIRST_VERTEX_BUFFER_SLOT + MAX_VERTEX_BUFFERS,
+			SLOT_COUNT = FIRST_ROOT_PARAMETER_SLOT + MAX_ROOT_PARAMETERS,
+		};
+
+		struct Stats
+		{
+			uint64_t issuedCount{ 0 };
+			uint64_t avoidedCount{ 0 };
+		};
+
+		/// <summary>
+		/// Forgets all state, e.g. when the command list is reset.
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Records value in slot and returns true if the call must be issued. A new
+		/// root signature also forgets every root parameter, as D3D12 does.
+		/// </summary>
+		bool Update(uint32_t slot, const void* value, size_t size);
+
+		template<typename T>
+		bool Update(uint32_t slot, const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Tracked state must be compared byte for byte");
+			return Update(slot, &value, sizeof(T));
+		}
+
+		/// <summary>
+		/// Records a call that set slot to something that can't be compared, such as
+		/// a partial update, so the next Update of slot is always issued.
+		/// </summary>
+		void SetUntracked(uint32_t slot);
+
+		const Stats& GetStats() const;
+
+	private:
+		struct SlotState
+		{
+			bool isSet;
+			uint8_t size;
+			std::array<uint8_t, MAX_VALUE_SIZE> bytes;
+		};
+
+		std::array<SlotState, SLOT_COUNT> m_slots{};
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "pch.h"
+#include "FixedTimestep.h"
+#include "IClock.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	FixedTimestep::FixedTimestep(
+		IClock* clock,
+		std::chrono::nanoseconds tickDuration,
+		uint32_t maxTicksPerFrame
+	) :
+		m_clock{ clock },
+		m_tickDuration{ tickDuration },
+		m_maxTicksPerFrame{ maxTicksPerFrame }
+	{ }
+
+	uint32_t FixedTimestep::BeginFrame()
+	{
+		const std::chrono::nanoseconds now{ m_clock->Now() };
+		if (!m_isStarted)
+		{
+			// The first frame only establishes the time base
+			m_isStarted = true;
+			m_lastTime = now;
+			return 0;
+		}
+
+		m_accumulator += (now - m_lastTime);
+		m_lastTime = now;
+
+		uint32_t ticks{ 0 };
+		while ((m_accumulator >= m_tickDuration) && (ticks < m_maxTicksPerFrame))
+		{
+			m_accumulator -= m_tickDuration;
+			++ticks;
+		}
+
+		// If we've hit the catch-up cap, drop the remaining whole ticks rather than
+		// spiraling further behind on the next frame.
+		if (m_accumulator >= m_tickDuration)
+		{
+			const auto dropped{ m_accumulator / m_tickDuration };
+			m_droppedTickCount += static_cast<uint64_t>(dropped);
+			m_accumulator -= (dropped * m_tickDuration);
+		}
+
+		m_tickCount += ticks;
+		return ticks;
+	}
+
+	std::chrono::nanoseconds FixedTimestep::GetTickDuration() const
+	{
+		return m_tickDuration;
+	}
+
+	float FixedTimestep::GetTickSeconds() const
+	{
+		return std::chrono::duration<float>(m_tickDuration).count();
+	}
+
+	float FixedTimestep::GetInterpolationAlpha() const
+	{
+		return static_cast<float>(m_accumulator.count()) /
+			static_cast<float>(m_tickDuration.count());
+	}
+
+	std::chrono::nanoseconds FixedTimestep::GetTimeUntilNextTick() const
+	{
+		return (m_tickDuration - m_accumulator);
+	}
+
+	uint64_t FixedTimestep::GetTickCount() const
+	{
+		return m_tickCount;
+	}
+
+	uint64_t FixedTimestep::GetDroppedTickCount() const
+	{
+		return m_droppedTickCount;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	class IClock;
+
+	/// <summary>
+	/// FixedTimestep accumulates elapsed real time and converts it into a number of
+	/// fixed-length simulation ticks, so simulation cost is independent of frame rate.
+	/// The leftover fraction of a tick is exposed as an interpolation alpha for rendering.
+	/// </summary>
+	class FixedTimestep
+	{
+	public:
+		FixedTimestep(
+			IClock* clock,
+			std::chrono::nanoseconds tickDuration,
+			uint32_t maxTicksPerFrame
+		);
+
+		/// <summary>
+		/// Samples the clock and returns how many ticks should be simulated this frame.
+		/// </summary>
+		uint32_t BeginFrame();
+		std::chrono::nanoseconds GetTickDuration() const;
+		float GetTickSeconds() const;
+		float GetInterpolationAlpha() const;
+		std::chrono::nanoseconds GetTimeUntilNextTick() const;
+		uint64_t GetTickCount() const;
+		uint64_t GetDroppedTickCount() const;
+
+	private:
+		IClock* const m_clock;
+		const std::chrono::nanoseconds m_tickDuration;
+		const uint32_t m_maxTicksPerFrame;
+
+		bool m_isStarted{ false };
+		std::chrono::nanoseconds m_lastTime{ 0 };
+		std::chrono::nanoseconds m_accumulator{ 0 };
+		uint64_t m_tickCount{ 0 };
+		uint64_t m_droppedTickCount{ 0 };
+	};
+}
\ No newline at end of file
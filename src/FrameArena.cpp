@@ -0,0 +1,89 @@
+#include "pch.h"
+#include "FrameArena.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		uintptr_t AlignUp(uintptr_t value, size_t alignment)
+		{
+			return (value + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1);
+		}
+	}
+
+#pragma region Public
+	LinearArena::LinearArena(size_t capacity) :
+		m_block{ std::make_unique<std::byte[]>(capacity) },
+		m_capacity{ capacity }
+	{ }
+
+	void* LinearArena::Allocate(size_t size, size_t alignment)
+	{
+		alignment = std::max<size_t>(alignment, 1);
+		const uintptr_t base{ reinterpret_cast<uintptr_t>(m_block.get()) };
+		const uintptr_t aligned{ AlignUp(base + m_offset, alignment) };
+		if ((aligned + size) <= (base + m_capacity))
+		{
+			m_offset = static_cast<size_t>(aligned + size - base);
+			m_peakBytes = std::max(m_peakBytes, m_offset + m_overflowBytes);
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		// Out of room; fall back to the heap until the next Reset grows the block
+		const size_t blockSize{ size + alignment };
+		m_overflowBlocks.push_back(std::make_unique<std::byte[]>(blockSize));
+		m_overflowBytes += blockSize;
+		m_peakBytes = std::max(m_peakBytes, m_offset + m_overflowBytes);
+		++m_overflowCount;
+		return reinterpret_cast<void*>(
+			AlignUp(reinterpret_cast<uintptr_t>(m_overflowBlocks.back().get()), alignment));
+	}
+
+	void LinearArena::Reset()
+	{
+		if (!m_overflowBlocks.empty())
+		{
+			m_overflowBlocks.clear();
+			m_capacity = std::max(m_capacity * 2, m_peakBytes);
+			m_block = std::make_unique<std::byte[]>(m_capacity);
+		}
+		m_offset = 0;
+		m_overflowBytes = 0;
+	}
+
+	size_t LinearArena::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	size_t LinearArena::GetUsedBytes() const
+	{
+		return m_offset + m_overflowBytes;
+	}
+
+	size_t LinearArena::GetPeakBytes() const
+	{
+		return m_peakBytes;
+	}
+
+	uint64_t LinearArena::GetOverflowCount() const
+	{
+		return m_overflowCount;
+	}
+#pragma endregion Public
+
+#pragma region Protected
+	void* LinearArena::do_allocate(size_t bytes, size_t alignment)
+	{
+		return Allocate(bytes, alignment);
+	}
+
+	void LinearArena::do_deallocate(void*, size_t, size_t)
+	{ }
+
+	bool LinearArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+	{
+		return (this == &other);
+	}
+#pragma endregion Protected
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// LinearArena is a bump allocator over one block. Individual frees are no-ops;
+	/// everything is released at once by Reset. When the block runs out, allocations
+	/// spill into separate heap blocks and the next Reset grows the main block to
+	/// the peak usage, so a steady workload stops touching the heap after warm-up.
+	/// As a memory_resource it backs std::pmr containers directly. It isn't
+	/// thread-safe: the renderer's frame arena is only allocated from on the main
+	/// thread, and reset at the start of each frame.
+	/// </summary>
+	class LinearArena : public std::pmr::memory_resource
+	{
+	public:
+		explicit LinearArena(size_t capacity);
+
+		void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		T* AllocateArray(size_t count)
+		{
+			return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void Reset();
+
+		size_t GetCapacity() const;
+		size_t GetUsedBytes() const;
+		size_t GetPeakBytes() const;
+		uint64_t GetOverflowCount() const;
+
+	protected:
+		// std::pmr::memory_resource
+		virtual void* do_allocate(size_t bytes, size_t alignment);
+		virtual void do_deallocate(void* pointer, size_t bytes, size_t alignment);
+		virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept;
+
+	private:
+		std::unique_ptr<std::byte[]> m_block;
+		size_t m_capacity{ 0 };
+		size_t m_offset{ 0 };
+		size_t m_peakBytes{ 0 };
+
+		// Spill-over once the block is full, released by Reset
+		std::vector<std::unique_ptr<std::byte[]>> m_overflowBlocks;
+		size_t m_overflowBytes{ 0 };
+		uint64_t m_overflowCount{ 0 };
+	};
+}
\ No newline at end of file
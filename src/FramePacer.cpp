@@ -0,0 +1,77 @@
+#include "pch.h"
+#include "FramePacer.h"
+#include "IFence.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	FramePacer::FramePacer(
+		IFence* fence,
+		uint32_t framesInFlight
+	) :
+		m_fence{ fence },
+		m_framesInFlight{ std::max<uint32_t>(framesInFlight, 1) },
+		m_contextFenceValues(m_framesInFlight, 0)
+	{ }
+
+	uint32_t FramePacer::BeginFrame()
+	{
+		m_currentContext = static_cast<uint32_t>(m_frameCount % m_framesInFlight);
+
+		const uint64_t retireValue{ m_contextFenceValues[m_currentContext] };
+		if (m_fence->GetCompletedValue() < retireValue)
+		{
+			++m_stallCount;
+			m_fence->Wait(retireValue);
+		}
+		return m_currentContext;
+	}
+
+	uint64_t FramePacer::EndFrame()
+	{
+		++m_lastSignaledFenceValue;
+		m_fence->Signal(m_lastSignaledFenceValue);
+		m_contextFenceValues[m_currentContext] = m_lastSignaledFenceValue;
+		++m_frameCount;
+		return m_lastSignaledFenceValue;
+	}
+
+	void FramePacer::WaitForIdle()
+	{
+		// Signal a fresh value so that work submitted outside of a frame is covered too
+		++m_lastSignaledFenceValue;
+		m_fence->Signal(m_lastSignaledFenceValue);
+		m_fence->Wait(m_lastSignaledFenceValue);
+	}
+
+	uint32_t FramePacer::GetFramesInFlight() const
+	{
+		return m_framesInFlight;
+	}
+
+	uint32_t FramePacer::GetCurrentContext() const
+	{
+		return m_currentContext;
+	}
+
+	uint64_t FramePacer::GetCompletedFenceValue() const
+	{
+		return m_fence->GetCompletedValue();
+	}
+
+	uint64_t FramePacer::GetLastSignaledFenceValue() const
+	{
+		return m_lastSignaledFenceValue;
+	}
+
+	uint64_t FramePacer::GetFrameCount() const
+	{
+		return m_frameCount;
+	}
+
+	uint64_t FramePacer::GetStallCount() const
+	{
+		return m_stallCount;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	class IFence;
+
+	/// <summary>
+	/// FramePacer lets the CPU record up to N frames ahead of the GPU. Each frame in
+	/// flight has its own context slot (command allocator, transient memory, etc.),
+	/// and a slot is only handed out again once the GPU has finished the frame that
+	/// last used it.
+	/// </summary>
+	class FramePacer
+	{
+	public:
+		FramePacer(IFence* fence, uint32_t framesInFlight);
+
+		/// <summary>
+		/// Starts a frame, blocking only if the GPU still owns the next context slot.
+		/// Returns that slot's index.
+		/// </summary>
+		uint32_t BeginFrame();
+
+		/// <summary>
+		/// Signals the end of the current frame's submitted work. Returns the fence
+		/// value that marks its completion.
+		/// </summary>
+		uint64_t EndFrame();
+
+		/// <summary>
+		/// Blocks until the GPU has completed all submitted frames.
+		/// </summary>
+		void WaitForIdle();
+
+		uint32_t GetFramesInFlight() const;
+		uint32_t GetCurrentContext() const;
+		uint64_t GetCompletedFenceValue() const;
+		uint64_t GetLastSignaledFenceValue() const;
+		uint64_t GetFrameCount() const;
+		uint64_t GetStallCount() const;
+
+	private:
+		IFence* const m_fence;
+		const uint32_t m_framesInFlight;
+
+		// Fence value that retires the last frame recorded in each context slot
+		std::vector<uint64_t> m_contextFenceValues;
+		uint64_t m_lastSignaledFenceValue{ 0 };
+		uint32_t m_currentContext{ 0 };
+		uint64_t m_frameCount{ 0 };
+		uint64_t m_stallCount{ 0 };
+	};
+}
\ No newline at end of file
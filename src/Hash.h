@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace HelloTriangle
+{
+	constexpr uint64_t HASH_SEED{ 14695981039346656037ull };
+
+	/// <summary>
+	/// 64-bit FNV-1a. Pass a previous result as the seed to hash several buffers
+	/// as one stream.
+	/// </summary>
+	inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = HASH_SEED)
+	{
+		const uint8_t* bytes{ static_cast<const uint8_t*>(data) };
+		uint64_t hash{ seed };
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	inline uint64_t HashString(std::string_view value, uint64_t seed = HASH_SEED)
+	{
+		// Include the length so that consecutive strings can't alias each other
+		const uint64_t length{ value.size() };
+		return HashBytes(value.data(), value.size(), HashBytes(&length, sizeof(length), seed));
+	}
+
+	template<typename T>
+	inline uint64_t HashValue(const T& value, uint64_t seed = HASH_SEED)
+	{
+		return HashBytes(&value, sizeof(T), seed);
+	}
+}
\ No newline at end of file
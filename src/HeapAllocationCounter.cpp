@@ -0,0 +1,179 @@
+#include "pch.h"
+#include "HeapAllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> s_heapAllocationCount{ 0 };
+
+	void* CountedAllocate(size_t size)
+	{
+		s_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		return std::malloc((size == 0) ? 1 : size);
+	}
+
+	void* CountedAllocateOrThrow(size_t size)
+	{
+		void* pointer{ CountedAllocate(size) };
+		if (pointer == nullptr)
+		{
+			throw std::bad_alloc{};
+		}
+		return pointer;
+	}
+
+	void* CountedAlignedAllocate(size_t size, std::align_val_t alignment)
+	{
+		s_heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		const size_t alignmentBytes{ static_cast<size_t>(alignment) };
+#if defined(_WIN32)
+		return _aligned_malloc((size == 0) ? 1 : size, alignmentBytes);
+#else
+		// aligned_alloc wants a whole number of alignments
+		const size_t alignedSize{
+			std::max<size_t>(((size + alignmentBytes - 1) / alignmentBytes) * alignmentBytes, alignmentBytes)
+		};
+		return std::aligned_alloc(alignmentBytes, alignedSize);
+#endif
+	}
+
+	void* CountedAlignedAllocateOrThrow(size_t size, std::align_val_t alignment)
+	{
+		void* pointer{ CountedAlignedAllocate(size, alignment) };
+		if (pointer == nullptr)
+		{
+			throw std::bad_alloc{};
+		}
+		return pointer;
+	}
+
+	// Every delete form frees here, so each one pairs with a malloc rather than
+	// with another replaced operator
+	void CountedFree(void* pointer)
+	{
+		std::free(pointer);
+	}
+
+	// And every over-aligned form here, since _aligned_malloc's memory can't be
+	// passed to free
+	void CountedAlignedFree(void* pointer)
+	{
+#if defined(_WIN32)
+		_aligned_free(pointer);
+#else
+		std::free(pointer);
+#endif
+	}
+}
+
+namespace HelloTriangle
+{
+	uint64_t GetHeapAllocationCount()
+	{
+		return s_heapAllocationCount.load(std::memory_order_relaxed);
+	}
+}
+
+// Replacements for the global allocation functions, over-aligned forms included.
+void* operator new(size_t size)
+{
+	return CountedAllocateOrThrow(size);
+}
+
+void* operator new[](size_t size)
+{
+	return CountedAllocateOrThrow(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return CountedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	CountedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	CountedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	CountedFree(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+	CountedFree(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+	CountedFree(pointer);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAllocateOrThrow(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAllocateOrThrow(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAlignedAllocate(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return CountedAlignedAllocate(size, alignment);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+	CountedAlignedFree(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+	CountedAlignedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept
+{
+	CountedAlignedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept
+{
+	CountedAlignedFree(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	CountedAlignedFree(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	CountedAlignedFree(pointer);
+}
\ No newline at end of file
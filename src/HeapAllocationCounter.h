@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Number of calls to the global operator new (scalar, array and over-aligned
+	/// forms) since startup, across all threads. Diff two readings to count the
+	/// allocations made by a span of code.
+	/// </summary>
+	uint64_t GetHeapAllocationCount();
+}
\ No newline at end of file
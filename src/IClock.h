@@ -0,0 +1,29 @@
+#pragma once
+#include <chrono>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// IClock represents a monotonic time source that can be swapped out for a
+	/// deterministic one when driving the simulation without real time
+	/// </summary>
+	class IClock
+	{
+	public:
+		virtual std::chrono::nanoseconds Now() = 0;
+	};
+
+	/// <summary>
+	/// SteadyClock is the default IClock, backed by std::chrono::steady_clock
+	/// </summary>
+	class SteadyClock : public IClock
+	{
+	public:
+		// IClock
+		virtual std::chrono::nanoseconds Now()
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch());
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// IFence represents a monotonically increasing GPU timeline that the CPU can
+	/// signal (after previously submitted work) and wait on.
+	/// </summary>
+	class IFence
+	{
+	public:
+		/// <summary>
+		/// Highest value the GPU has reached.
+		/// </summary>
+		virtual uint64_t GetCompletedValue() = 0;
+
+		/// <summary>
+		/// Queues a signal of the given value behind all previously submitted work.
+		/// </summary>
+		virtual void Signal(uint64_t value) = 0;
+
+		/// <summary>
+		/// Blocks the calling thread until the GPU reaches the given value.
+		/// </summary>
+		virtual void Wait(uint64_t value) = 0;
+	};
+}
\ No newline at end of file
@@ -1,4 +1,6 @@
 #pragma once
+#include "InputEvents.h"
+
 #include <cstdint>
 
 namespace HelloTriangle
@@ -9,6 +11,10 @@ namespace HelloTriangle
 	class IInputSource
 	{
 	public:
-		virtual void GetKeyState() = 0;
+		/// <summary>
+		/// Pops the oldest pending input event. Returns false once no events remain.
+		/// Called from the simulation thread only.
+		/// </summary>
+		virtual bool PollEvent(InputEvent& event) = 0;
 	};
 }
\ No newline at end of file
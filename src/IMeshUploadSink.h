@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	struct CompressedMeshData;
+	struct MeshData;
+
+	/// <summary>
+	/// IMeshUploadSink receives decoded meshes on the main thread and makes them
+	/// drawable. The returned mesh index is what draw submissions refer to.
+	/// </summary>
+	class IMeshUploadSink
+	{
+	public:
+		static constexpr uint32_t INVALID_MESH{ 0xFFFFFFFF };
+
+		/// <summary>
+		/// Queues mesh for upload and returns its mesh index, or INVALID_MESH.
+		/// </summary>
+		virtual uint32_t UploadMesh(const MeshData& mesh) = 0;
+
+		/// <summary>
+		/// Like UploadMesh, for a mesh drawn with COMPRESSED_VERTEX_LAYOUT. The sink
+		/// keeps the mesh's quantization to decode its positions with.
+		/// </summary>
+		virtual uint32_t UploadCompressedMesh(const CompressedMeshData& mesh) = 0;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include "SpscRingBuffer.h"
+
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	enum class InputEventType : uint8_t
+	{
+		KeyDown,
+		KeyUp,
+	};
+
+	/// <summary>
+	/// InputEvent is a compact, timestamped input transition. Key codes are
+	/// Windows virtual-key codes.
+	/// </summary>
+	struct InputEvent
+	{
+		std::chrono::nanoseconds timestamp{ 0 };
+		InputEventType type{ InputEventType::KeyDown };
+		uint8_t key{ 0 };
+	};
+
+	constexpr size_t INPUT_KEY_COUNT{ 256 };
+	constexpr size_t INPUT_EVENT_CAPACITY{ 1024 };
+
+	/// <summary>
+	/// KeyState is a snapshot of which keys are held, indexed by virtual-key code.
+	/// </summary>
+	using KeyState = std::bitset<INPUT_KEY_COUNT>;
+
+	using InputEventQueue = SpscRingBuffer<InputEvent, INPUT_EVENT_CAPACITY>;
+}
\ No newline at end of file
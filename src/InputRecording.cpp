@@ -0,0 +1,195 @@
+#include "pch.h"
+#include "InputRecording.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		template<typename T>
+		void WriteValue(std::ofstream& file, T value)
+		{
+			file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template<typename T>
+		T ReadValue(const uint8_t* data)
+		{
+			T value{};
+			memcpy(&value, data, sizeof(T));
+			return value;
+		}
+	}
+
+#pragma region Public
+	RecordingInputSource::RecordingInputSource(
+		IInputSource* source,
+		const std::filesystem::path& path,
+		const WorldSeedConfig& worldSeed
+	) :
+		m_source{ source },
+		m_file{ path, std::ios::binary | std::ios::trunc }
+	{
+		if (!m_file)
+		{
+			spdlog::warn("RecordingInputSource: Couldn't open '{}', input won't be recorded.", path.string());
+			return;
+		}
+
+		// The tick count is patched in by Close()
+		WriteValue(m_file, InputRecordingFormat::MAGIC);
+		WriteValue(m_file, InputRecordingFormat::VERSION);
+		WriteValue(m_file, uint64_t{ 0 });
+		WriteValue(m_file, worldSeed.entityCount);
+		WriteValue(m_file, worldSeed.seed);
+	}
+
+	RecordingInputSource::~RecordingInputSource()
+	{
+		Close();
+	}
+
+	bool RecordingInputSource::IsOpen() const
+	{
+		return m_file.is_open();
+	}
+
+	uint64_t RecordingInputSource::GetTickCount() const
+	{
+		return m_tickCount;
+	}
+
+	void RecordingInputSource::Close()
+	{
+		if (!m_file.is_open())
+		{
+			return;
+		}
+
+		// Keep any events from a tick that never finished polling
+		if (!m_tickEvents.empty())
+		{
+			WriteTick();
+		}
+		m_file.seekp(sizeof(uint32_t) * 2);
+		WriteValue(m_file, m_tickCount);
+		m_file.close();
+	}
+
+	bool RecordingInputSource::PollEvent(InputEvent& event)
+	{
+		const bool hasEvent{ (m_source != nullptr) && m_source->PollEvent(event) };
+		if (!m_file.is_open())
+		{
+			return hasEvent;
+		}
+
+		if (hasEvent)
+		{
+			m_tickEvents.push_back(event);
+		}
+		else
+		{
+			WriteTick();
+		}
+		return hasEvent;
+	}
+
+	bool ReplayInputSource::Open(const std::filesystem::path& path)
+	{
+		m_offset = 0;
+		m_tickCount = 0;
+		m_replayedTickCount = 0;
+		m_worldSeed = WorldSeedConfig{};
+		m_remainingTickEvents = 0;
+		m_isInTick = false;
+		if (!m_file.Open(path))
+		{
+			spdlog::warn("ReplayInputSource: Couldn't open '{}'.", path.string());
+			return false;
+		}
+
+		const uint8_t* data{ m_file.GetData() };
+		if ((m_file.GetSize() < InputRecordingFormat::HEADER_SIZE) ||
+			(ReadValue<uint32_t>(data) != InputRecordingFormat::MAGIC) ||
+			(ReadValue<uint32_t>(data + 4) != InputRecordingFormat::VERSION))
+		{
+			spdlog::warn("ReplayInputSource: '{}' isn't an input recording.", path.string());
+			m_file.Close();
+			return false;
+		}
+		m_tickCount = ReadValue<uint64_t>(data + 8);
+		m_worldSeed.entityCount = ReadValue<uint32_t>(data + 16);
+		m_worldSeed.seed = ReadValue<uint32_t>(data + 20);
+		m_offset = InputRecordingFormat::HEADER_SIZE;
+		return true;
+	}
+
+	uint64_t ReplayInputSource::GetTickCount() const
+	{
+		return m_tickCount;
+	}
+
+	uint64_t ReplayInputSource::GetReplayedTickCount() const
+	{
+		return m_replayedTickCount;
+	}
+
+	WorldSeedConfig ReplayInputSource::GetWorldSeed() const
+	{
+		return m_worldSeed;
+	}
+
+	bool ReplayInputSource::IsFinished() const
+	{
+		return !m_isInTick &&
+			((m_replayedTickCount >= m_tickCount) ||
+				((m_offset + InputRecordingFormat::TICK_HEADER_SIZE) > m_file.GetSize()));
+	}
+
+	bool ReplayInputSource::PollEvent(InputEvent& event)
+	{
+		if (!m_isInTick)
+		{
+			if (IsFinished())
+			{
+				return false;
+			}
+			m_remainingTickEvents = ReadValue<uint32_t>(m_file.GetData() + m_offset);
+			m_offset += InputRecordingFormat::TICK_HEADER_SIZE;
+			m_isInTick = true;
+		}
+
+		if ((m_remainingTickEvents == 0) ||
+			((m_offset + InputRecordingFormat::EVENT_SIZE) > m_file.GetSize()))
+		{
+			// End of this tick, or a truncated file
+			m_isInTick = false;
+			++m_replayedTickCount;
+			return false;
+		}
+
+		const uint8_t* record{ m_file.GetData() + m_offset };
+		event.timestamp = std::chrono::nanoseconds{ ReadValue<int64_t>(record) };
+		event.type = static_cast<InputEventType>(record[8]);
+		event.key = record[9];
+		m_offset += InputRecordingFormat::EVENT_SIZE;
+		--m_remainingTickEvents;
+		return true;
+	}
+#pragma endregion Public
+
+#pragma region Private
+	void RecordingInputSource::WriteTick()
+	{
+		WriteValue(m_file, static_cast<uint32_t>(m_tickEvents.size()));
+		for (const InputEvent& event : m_tickEvents)
+		{
+			WriteValue(m_file, static_cast<int64_t>(event.timestamp.count()));
+			WriteValue(m_file, static_cast<uint8_t>(event.type));
+			WriteValue(m_file, event.key);
+		}
+		m_tickEvents.clear();
+		++m_tickCount;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+#include "IInputSource.h"
+#include "MappedFile.h"
+#include "WorldSeed.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Input recordings are a header (magic, version, uint64 tick count, then the
+	/// uint32 entity count and seed the world was seeded with) followed by one
+	/// record per simulation tick: a uint32 event count, then that many 10-byte
+	/// events (int64 timestamp in nanoseconds, uint8 type, uint8 key). All values
+	/// are little-endian.
+	/// </summary>
+	namespace InputRecordingFormat
+	{
+		constexpr uint32_t MAGIC{ 0x52495448 }; // 'HTIR'
+		constexpr uint32_t VERSION{ 2 };
+		constexpr size_t HEADER_SIZE{ 24 };
+		constexpr size_t TICK_HEADER_SIZE{ 4 };
+		constexpr size_t EVENT_SIZE{ 10 };
+	}
+
+	/// <summary>
+	/// RecordingInputSource passes events through from another source while writing
+	/// them to a recording. The consumer is expected to poll until PollEvent returns
+	/// false once per tick, as Simulation does; each false return closes a tick.
+	/// worldSeed is stored so a replay can start from the same world.
+	/// </summary>
+	class RecordingInputSource : public IInputSource
+	{
+	public:
+		RecordingInputSource(
+			IInputSource* source,
+			const std::filesystem::path& path,
+			const WorldSeedConfig& worldSeed);
+		~RecordingInputSource();
+
+		RecordingInputSource(const RecordingInputSource&) = delete;
+		RecordingInputSource& operator=(const RecordingInputSource&) = delete;
+
+		bool IsOpen() const;
+		uint64_t GetTickCount() const;
+
+		/// <summary>
+		/// Finishes the recording; called by the destructor if not called earlier.
+		/// </summary>
+		void Close();
+
+		// IInputSource
+		virtual bool PollEvent(InputEvent& event);
+
+	private:
+		IInputSource* const m_source;
+		std::ofstream m_file;
+		std::vector<InputEvent> m_tickEvents;
+		uint64_t m_tickCount{ 0 };
+
+		void WriteTick();
+	};
+
+	/// <summary>
+	/// ReplayInputSource plays a recording back tick by tick: each tick's events are
+	/// returned, then a single false marks the end of the tick. The file is memory
+	/// mapped and parsed as it is consumed.
+	/// </summary>
+	class ReplayInputSource : public IInputSource
+	{
+	public:
+		bool Open(const std::filesystem::path& path);
+
+		uint64_t GetTickCount() const;
+		uint64_t GetReplayedTickCount() const;
+
+		/// <summary>
+		/// The default seed config, with the entity count and seed the recorded
+		/// session's world was seeded with.
+		/// </summary>
+		WorldSeedConfig GetWorldSeed() const;
+		bool IsFinished() const;
+
+		// IInputSource
+		virtual bool PollEvent(InputEvent& event);
+
+	private:
+		MappedFile m_file;
+		size_t m_offset{ 0 };
+		uint64_t m_tickCount{ 0 };
+		uint64_t m_replayedTickCount{ 0 };
+		WorldSeedConfig m_worldSeed{};
+		uint32_t m_remainingTickEvents{ 0 };
+		bool m_isInTick{ false };
+	};
+}
\ No newline at end of file
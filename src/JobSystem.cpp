@@ -0,0 +1,545 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+namespace HelloTriangle
+{
+	struct JobHandle::Node
+	{
+		JobSystem* owner{ nullptr };
+
+		// Held by handles, by the queue while the job is queued or running, and by
+		// each dependency's continuation list; the node returns to the pool at zero
+		std::atomic<int32_t> referenceCount{ 0 };
+
+		std::function<void()> work;
+
+		// ParallelFor batches call batchInvoke on batchBody instead of work
+		JobSystem::BatchFunction batchInvoke{ nullptr };
+		const void* batchBody{ nullptr };
+		size_t batchBegin{ 0 };
+		size_t batchEnd{ 0 };
+
+		// Starts at one as a guard while dependencies are being registered
+		std::atomic<int32_t> pendingDependencies{ 1 };
+
+		std::mutex mutex;
+		bool isDone{ false };
+
+		// Each entry holds a reference to the continuation. Recycled nodes keep the
+		// capacity, so registering continuations stops allocating after warm-up
+		std::vector<Node*> continuations;
+
+		// Thrown by work or inherited from a failed dependency, in which case work
+		// never runs; rethrown by Wait
+		std::exception_ptr exception;
+	};
+
+	namespace
+	{
+		// Identifies the worker (and owning job system) running on this thread, so
+		// jobs scheduled from inside other jobs go to the local deque.
+		thread_local const JobSystem* t_jobSystem{ nullptr };
+		thread_local uint32_t t_workerIndex{ 0 };
+
+		// Jobs created up front per thread: enough for a few ParallelFor calls in
+		// flight, so that the pool rarely has to grow once running
+		constexpr size_t PREALLOCATED_JOBS_PER_THREAD{ 16 };
+	}
+
+#pragma region JobHandle
+	JobHandle::JobHandle(const JobHandle& other) :
+		m_node{ other.m_node }
+	{
+		if (m_node)
+		{
+			m_node->referenceCount.fetch_add(1);
+		}
+	}
+
+	JobHandle::JobHandle(JobHandle&& other) noexcept :
+		m_node{ std::exchange(other.m_node, nullptr) }
+	{ }
+
+	JobHandle& JobHandle::operator=(const JobHandle& other)
+	{
+		JobHandle copy{ other };
+		std::swap(m_node, copy.m_node);
+		return *this;
+	}
+
+	JobHandle& JobHandle::operator=(JobHandle&& other) noexcept
+	{
+		JobHandle moved{ std::move(other) };
+		std::swap(m_node, moved.m_node);
+		return *this;
+	}
+
+	JobHandle::~JobHandle()
+	{
+		if (m_node)
+		{
+			m_node->owner->ReleaseNode(m_node);
+		}
+	}
+
+	JobHandle::JobHandle(Node* node) :
+		m_node{ node }
+	{ }
+
+	bool JobHandle::IsValid() const
+	{
+		return (m_node != nullptr);
+	}
+
+	bool JobHandle::IsDone() const
+	{
+		if (!m_node)
+		{
+			return true;
+		}
+		std::lock_guard<std::mutex> lock{ m_node->mutex };
+		return m_node->isDone;
+	}
+#pragma endregion JobHandle
+
+#pragma region Public
+	JobSystem::JobSystem(uint32_t workerCount)
+	{
+		// One deque per worker, plus a shared deque for threads outside the pool.
+		// Any deque may end up holding every preallocated job
+		const size_t preallocatedJobs{ (static_cast<size_t>(workerCount) + 1) * PREALLOCATED_JOBS_PER_THREAD };
+		for (uint32_t i = 0; i <= workerCount; ++i)
+		{
+			m_queues.push_back(std::make_unique<WorkerQueue>());
+			m_queues.back()->jobs.resize(preallocatedJobs);
+		}
+
+		AddNodes(preallocatedJobs);
+
+		spdlog::info("JobSystem: Starting {} workers...", workerCount);
+		m_workers.reserve(workerCount);
+		for (uint32_t i = 0; i < workerCount; ++i)
+		{
+			m_workers.emplace_back(&JobSystem::WorkerMain, this, i);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ m_sleepMutex };
+			m_isShuttingDown = true;
+		}
+		m_sleepCondition.notify_all();
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+	}
+
+	uint32_t JobSystem::GetThreadCount() const
+	{
+		return static_cast<uint32_t>(m_workers.size() + 1);
+	}
+
+	uint32_t JobSystem::GetCurrentThreadIndex() const
+	{
+		return (t_jobSystem == this) ? t_workerIndex : static_cast<uint32_t>(m_workers.size());
+	}
+
+	JobHandle JobSystem::Schedule(
+		std::function<void()> work,
+		std::initializer_list<JobHandle> dependencies)
+	{
+		JobHandle handle{ AcquireNode() };
+		handle.m_node->work = std::move(work);
+
+		for (const JobHandle& dependency : dependencies)
+		{
+			if (!dependency.m_node)
+			{
+				continue;
+			}
+			std::exception_ptr failure;
+			{
+				std::lock_guard<std::mutex> lock{ dependency.m_node->mutex };
+				if (!dependency.m_node->isDone)
+				{
+					handle.m_node->pendingDependencies.fetch_add(1);
+					handle.m_node->referenceCount.fetch_add(1);
+					dependency.m_node->continuations.push_back(handle.m_node);
+				}
+				else
+				{
+					failure = dependency.m_node->exception;
+				}
+			}
+
+			// Already failed, so there is no continuation left to pass it on. An
+			// earlier dependency may already be running Execute and passing its own
+			// failure on, so this takes the same lock Execute does.
+			if (failure)
+			{
+				std::lock_guard<std::mutex> lock{ handle.m_node->mutex };
+				if (!handle.m_node->exception)
+				{
+					handle.m_node->exception = failure;
+				}
+			}
+		}
+
+		// Release the guard; if every dependency already finished, the job is ready
+		if (handle.m_node->pendingDependencies.fetch_sub(1) == 1)
+		{
+			handle.m_node->referenceCount.fetch_add(1);
+			Enqueue(handle.m_node);
+		}
+		return handle;
+	}
+
+	void JobSystem::Wait(const JobHandle& handle)
+	{
+		const uint32_t preferredQueue{ GetCurrentThreadIndex() };
+		while (!handle.IsDone())
+		{
+			JobHandle::Node* node{ TryDequeue(preferredQueue) };
+			if (node)
+			{
+				Execute(node);
+				continue;
+			}
+
+			// Nothing to help with, so the job is running elsewhere or waiting on one
+			// that is; sleep until a job finishes or more work is queued
+			std::unique_lock<std::mutex> lock{ m_waitMutex };
+			m_waiterCount.fetch_add(1);
+			m_waitCondition.wait(lock, [this, &handle]()
+				{
+					return handle.IsDone() || (m_queuedCount.load() > 0);
+				});
+			m_waiterCount.fetch_sub(1);
+		}
+
+		if (handle.m_node && handle.m_node->exception)
+		{
+			std::rethrow_exception(handle.m_node->exception);
+		}
+	}
+
+	uint32_t JobSystem::GetDefaultWorkerCount()
+	{
+		const uint32_t hardwareThreads{ std::thread::hardware_concurrency() };
+		return (hardwareThreads > 1) ? (hardwareThreads - 1) : 0;
+	}
+#pragma endregion Public
+
+#pragma region Private
+	void JobSystem::RunBatches(size_t count, size_t minBatchSize, const void* body, BatchFunction invoke)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		// Aim for a few batches per thread so stealing can even out imbalance
+		const size_t targetBatches{ static_cast<size_t>(GetThreadCount()) * 4 };
+		const size_t batchSize{
+			std::max(std::max<size_t>(minBatchSize, 1), (count + targetBatches - 1) / targetBatches)
+		};
+		if (batchSize >= count)
+		{
+			invoke(body, 0, count);
+			return;
+		}
+
+		// One job joins every batch, so a single Wait covers them all and inherits
+		// the first exception any of them threw
+		const JobHandle join{ AcquireNode() };
+		for (size_t begin = batchSize; begin < count; begin += batchSize)
+		{
+			JobHandle::Node* batch{ AcquireNode() };
+			batch->batchInvoke = invoke;
+			batch->batchBody = body;
+			batch->batchBegin = begin;
+			batch->batchEnd = std::min(begin + batchSize, count);
+			batch->pendingDependencies.store(0);
+
+			// Not queued yet, so nothing else can see the batch's continuations
+			join.m_node->pendingDependencies.fetch_add(1);
+			join.m_node->referenceCount.fetch_add(1);
+			batch->continuations.push_back(join.m_node);
+			Enqueue(batch);
+		}
+		if (join.m_node->pendingDependencies.fetch_sub(1) == 1)
+		{
+			join.m_node->referenceCount.fetch_add(1);
+			Enqueue(join.m_node);
+		}
+
+		// The calling thread takes the first batch itself. Every batch refers to
+		// body, so all of them have to finish before any exception leaves
+		std::exception_ptr exception;
+		try
+		{
+			invoke(body, 0, batchSize);
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		try
+		{
+			Wait(join);
+		}
+		catch (...)
+		{
+			if (!exception)
+			{
+				exception = std::current_exception();
+			}
+		}
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	void JobSystem::WorkerMain(uint32_t workerIndex)
+	{
+		t_jobSystem = this;
+		t_workerIndex = workerIndex;
+
+		while (true)
+		{
+			JobHandle::Node* node{ TryDequeue(workerIndex) };
+			if (node)
+			{
+				Execute(node);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock{ m_sleepMutex };
+			m_sleepCondition.wait(lock, [this]()
+				{
+					return m_isShuttingDown || (m_queuedCount.load() > 0);
+				});
+			if (m_isShuttingDown)
+			{
+				return;
+			}
+		}
+	}
+
+	JobHandle::Node* JobSystem::AcquireNode()
+	{
+		std::lock_guard<std::mutex> lock{ m_nodeMutex };
+		if (m_freeNodes.empty())
+		{
+			AddNodes(1);
+		}
+
+		JobHandle::Node* node{ m_freeNodes.back() };
+		m_freeNodes.pop_back();
+		node->referenceCount.store(1);
+		return node;
+	}
+
+	void JobSystem::AddNodes(size_t count)
+	{
+		// Room for every node in the free list, so releasing one never allocates
+		m_nodes.reserve(m_nodes.size() + count);
+		m_freeNodes.reserve(m_nodes.size() + count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			m_nodes.push_back(std::make_unique<JobHandle::Node>());
+			m_nodes.back()->owner = this;
+
+			// Any node may become a ParallelFor batch, which continues into its join
+			m_nodes.back()->continuations.reserve(1);
+			m_freeNodes.push_back(m_nodes.back().get());
+		}
+	}
+
+	void JobSystem::ReleaseNode(JobHandle::Node* node)
+	{
+		if (node->referenceCount.fetch_sub(1) != 1)
+		{
+			return;
+		}
+
+		// Only the last reference gets here, so nothing else touches the node
+		node->work = nullptr;
+		node->batchInvoke = nullptr;
+		node->batchBody = nullptr;
+		node->pendingDependencies.store(1);
+		node->isDone = false;
+		node->continuations.clear();
+		node->exception = nullptr;
+
+		std::lock_guard<std::mutex> lock{ m_nodeMutex };
+		m_freeNodes.push_back(node);
+	}
+
+	void JobSystem::Enqueue(JobHandle::Node* node)
+	{
+		uint32_t queueIndex{ static_cast<uint32_t>(m_workers.size()) };
+		if (t_jobSystem == this)
+		{
+			queueIndex = t_workerIndex;
+		}
+		else if (!m_workers.empty())
+		{
+			// Spread external submissions across workers so they start immediately
+			queueIndex = m_nextQueue.fetch_add(1) % static_cast<uint32_t>(m_workers.size());
+		}
+
+		{
+			WorkerQueue& queue{ *m_queues[queueIndex] };
+			std::lock_guard<std::mutex> lock{ queue.mutex };
+			queue.PushBack(node);
+		}
+		m_queuedCount.fetch_add(1);
+
+		// Synchronize with sleeping workers so the wakeup can't be lost
+		{
+			std::lock_guard<std::mutex> lock{ m_sleepMutex };
+		}
+		m_sleepCondition.notify_one();
+		NotifyWaiters();
+	}
+
+	JobHandle::Node* JobSystem::TryDequeue(uint32_t preferredQueue)
+	{
+		const uint32_t queueCount{ static_cast<uint32_t>(m_queues.size()) };
+
+		// Own deque first, newest work first for cache locality
+		{
+			WorkerQueue& queue{ *m_queues[preferredQueue] };
+			std::lock_guard<std::mutex> lock{ queue.mutex };
+			if (queue.count > 0)
+			{
+				m_queuedCount.fetch_sub(1);
+				return queue.PopBack();
+			}
+		}
+
+		// Steal the oldest work from everyone else
+		for (uint32_t offset = 1; offset < queueCount; ++offset)
+		{
+			WorkerQueue& queue{ *m_queues[(preferredQueue + offset) % queueCount] };
+			std::lock_guard<std::mutex> lock{ queue.mutex };
+			if (queue.count > 0)
+			{
+				m_queuedCount.fetch_sub(1);
+				return queue.PopFront();
+			}
+		}
+		return nullptr;
+	}
+
+	void JobSystem::Execute(JobHandle::Node* node)
+	{
+		// A throwing job still completes, or its waiters and dependents would hang
+		if (!node->exception)
+		{
+			try
+			{
+				if (node->batchInvoke)
+				{
+					node->batchInvoke(node->batchBody, node->batchBegin, node->batchEnd);
+				}
+				else if (node->work)
+				{
+					node->work();
+				}
+			}
+			catch (...)
+			{
+				node->exception = std::current_exception();
+			}
+		}
+
+		// Once done, no more continuations get added, so the list can be walked
+		// without the lock
+		{
+			std::lock_guard<std::mutex> lock{ node->mutex };
+			node->isDone = true;
+		}
+		NotifyWaiters();
+
+		for (JobHandle::Node* continuation : node->continuations)
+		{
+			if (node->exception)
+			{
+				std::lock_guard<std::mutex> lock{ continuation->mutex };
+				if (!continuation->exception)
+				{
+					continuation->exception = node->exception;
+				}
+			}
+
+			// The list's reference passes to the queue, or is dropped if the
+			// continuation is still waiting on other dependencies
+			if (continuation->pendingDependencies.fetch_sub(1) == 1)
+			{
+				Enqueue(continuation);
+			}
+			else
+			{
+				ReleaseNode(continuation);
+			}
+		}
+		node->continuations.clear();
+
+		// Drop the queue's reference
+		ReleaseNode(node);
+	}
+
+	void JobSystem::NotifyWaiters()
+	{
+		if (m_waiterCount.load() == 0)
+		{
+			return;
+		}
+
+		// Synchronize with waiters between checking and sleeping, as in Enqueue
+		{
+			std::lock_guard<std::mutex> lock{ m_waitMutex };
+		}
+		m_waitCondition.notify_all();
+	}
+#pragma endregion Private
+
+#pragma region WorkerQueue
+	void JobSystem::WorkerQueue::PushBack(JobHandle::Node* node)
+	{
+		if (count == jobs.size())
+		{
+			// Unroll into a buffer twice the size, oldest job first
+			std::vector<JobHandle::Node*> grown(std::max<size_t>(jobs.size() * 2, 16));
+			for (size_t i = 0; i < count; ++i)
+			{
+				grown[i] = jobs[(front + i) % jobs.size()];
+			}
+			jobs.swap(grown);
+			front = 0;
+		}
+		jobs[(front + count) % jobs.size()] = node;
+		++count;
+	}
+
+	JobHandle::Node* JobSystem::WorkerQueue::PopBack()
+	{
+		--count;
+		return jobs[(front + count) % jobs.size()];
+	}
+
+	JobHandle::Node* JobSystem::WorkerQueue::PopFront()
+	{
+		JobHandle::Node* node{ jobs[front] };
+		front = (front + 1) % jobs.size();
+		--count;
+		return node;
+	}
+#pragma endregion WorkerQueue
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// JobHandle refers to a scheduled job. It can be waited on, or passed as a
+	/// dependency when scheduling other jobs. Jobs live in their JobSystem's pool,
+	/// so handles must not outlive it.
+	/// </summary>
+	class JobHandle
+	{
+	public:
+		JobHandle() = default;
+		JobHandle(const JobHandle& other);
+		JobHandle(JobHandle&& other) noexcept;
+		JobHandle& operator=(const JobHandle& other);
+		JobHandle& operator=(JobHandle&& other) noexcept;
+		~JobHandle();
+
+		bool IsValid() const;
+		bool IsDone() const;
+
+	private:
+		friend class JobSystem;
+		struct Node;
+
+		// Takes over a reference the caller already holds
+		explicit JobHandle(Node* node);
+
+		Node* m_node{ nullptr };
+	};
+
+	/// <summary>
+	/// JobSystem is a work-stealing scheduler. Each worker owns a deque: it pushes and
+	/// pops its own work from the back, while idle workers steal from the front of
+	/// other deques. Threads that wait on a job help execute queued work, and only
+	/// block once there is none, so the calling thread counts as one of the
+	/// available threads. Jobs and deques are recycled, so once they have grown to
+	/// the peak load, ParallelFor doesn't touch the heap.
+	/// </summary>
+	class JobSystem
+	{
+	public:
+		/// <summary>
+		/// Creates a job system with the given number of background workers.
+		/// </summary>
+		JobSystem(uint32_t workerCount);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		/// <summary>
+		/// Background workers plus the calling thread.
+		/// </summary>
+		uint32_t GetThreadCount() const;
+
+		/// <summary>
+		/// Index of the calling thread in [0, GetThreadCount()): workers are numbered
+		/// from zero, and every thread outside the job system maps to the last index.
+		/// </summary>
+		uint32_t GetCurrentThreadIndex() const;
+
+		/// <summary>
+		/// Schedules a job that runs once all of its dependencies have completed. If
+		/// a dependency threw, the job doesn't run and fails with the same exception.
+		/// </summary>
+		JobHandle Schedule(
+			std::function<void()> work,
+			std::initializer_list<JobHandle> dependencies = {});
+
+		/// <summary>
+		/// Blocks until the job completes, executing other jobs while waiting, then
+		/// rethrows the exception the job failed with, if any.
+		/// </summary>
+		void Wait(const JobHandle& handle);
+
+		/// <summary>
+		/// Splits [0, count) into batches of at least minBatchSize and runs them across
+		/// all threads, returning once every batch has completed. Rethrows the first
+		/// exception a batch threw, after waiting for the rest. Batches call work
+		/// through a reference, so it is neither copied nor wrapped.
+		/// </summary>
+		template<typename Function>
+		void ParallelFor(size_t count, size_t minBatchSize, const Function& work)
+		{
+			RunBatches(count, minBatchSize, &work, [](const void* body, size_t begin, size_t end)
+				{
+					(*static_cast<const Function*>(body))(begin, end);
+				});
+		}
+
+		/// <summary>
+		/// Returns a reasonable default worker count for this machine.
+		/// </summary>
+		static uint32_t GetDefaultWorkerCount();
+
+	private:
+		friend class JobHandle;
+
+		using BatchFunction = void (*)(const void* body, size_t begin, size_t end);
+
+		/// <summary>
+		/// WorkerQueue is a deque of jobs in a ring buffer that only grows, so
+		/// steady-state pushes and pops never allocate.
+		/// </summary>
+		struct WorkerQueue
+		{
+			std::mutex mutex;
+			std::vector<JobHandle::Node*> jobs;
+			size_t front{ 0 };
+			size_t count{ 0 };
+
+			void PushBack(JobHandle::Node* node);
+			JobHandle::Node* PopBack();
+			JobHandle::Node* PopFront();
+		};
+
+		std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+		std::atomic<uint32_t> m_nextQueue{ 0 };
+		std::atomic<int64_t> m_queuedCount{ 0 };
+		std::atomic<bool> m_isShuttingDown{ false };
+		std::mutex m_sleepMutex;
+		std::condition_variable m_sleepCondition;
+		std::atomic<uint32_t> m_waiterCount{ 0 };
+		std::mutex m_waitMutex;
+		std::condition_variable m_waitCondition;
+
+		// Every job node ever created, and the ones not in use
+		std::mutex m_nodeMutex;
+		std::vector<std::unique_ptr<JobHandle::Node>> m_nodes;
+		std::vector<JobHandle::Node*> m_freeNodes;
+
+		void RunBatches(size_t count, size_t minBatchSize, const void* body, BatchFunction invoke);
+		void WorkerMain(uint32_t workerIndex);
+		JobHandle::Node* AcquireNode();
+
+		// Called with m_nodeMutex held, or before any jobs exist
+		void AddNodes(size_t count);
+		void ReleaseNode(JobHandle::Node* node);
+		void Enqueue(JobHandle::Node* node);
+		JobHandle::Node* TryDequeue(uint32_t preferredQueue);
+		void Execute(JobHandle::Node* node);
+		void NotifyWaiters();
+	};
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "MappedFile.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace HelloTriangle
+{
+#pragma region Public
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	bool MappedFile::Open(const std::filesystem::path& path)
+	{
+		Close();
+
+#if defined(_WIN32)
+		HANDLE file{ CreateFileW(
+			path.c_str(),
+			GENERIC_READ,
+			FILE_SHARE_READ,
+			nullptr,
+			OPEN_EXISTING,
+			FILE_FLAG_SEQUENTIAL_SCAN,
+			nullptr) };
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+		m_file = file;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size))
+		{
+			Close();
+			return false;
+		}
+		m_size = static_cast<size_t>(size.QuadPart);
+		if (m_size == 0)
+		{
+			// Empty files can't be mapped, but are still valid
+			return true;
+		}
+
+		m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (m_mapping == nullptr)
+		{
+			Close();
+			return false;
+		}
+		m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+		const int file{ open(path.c_str(), O_RDONLY) };
+		if (file < 0)
+		{
+			return false;
+		}
+
+		struct stat status{};
+		if (fstat(file, &status) != 0)
+		{
+			close(file);
+			return false;
+		}
+		m_size = static_cast<size_t>(status.st_size);
+		if (m_size == 0)
+		{
+			close(file);
+			return true;
+		}
+
+		void* data{ mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0) };
+		close(file);
+		if (data != MAP_FAILED)
+		{
+			madvise(data, m_size, MADV_SEQUENTIAL);
+			m_data = static_cast<const uint8_t*>(data);
+		}
+#endif
+
+		if (m_data == nullptr)
+		{
+			Close();
+			return false;
+		}
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+#if defined(_WIN32)
+		if (m_data != nullptr)
+		{
+			UnmapViewOfFile(m_data);
+		}
+		if (m_mapping != nullptr)
+		{
+			CloseHandle(m_mapping);
+			m_mapping = nullptr;
+		}
+		if (m_file != nullptr)
+		{
+			CloseHandle(m_file);
+			m_file = nullptr;
+		}
+#else
+		if (m_data != nullptr)
+		{
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+		}
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	const uint8_t* MappedFile::GetData() const
+	{
+		return m_data;
+	}
+
+	size_t MappedFile::GetSize() const
+	{
+		return m_size;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
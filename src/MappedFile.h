@@ -0,0 +1,36 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// MappedFile maps a whole file read-only into memory. Pages are read in by the
+	/// OS as they are touched, so large files can be streamed through front to back
+	/// without being loaded up front.
+	/// </summary>
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		bool Open(const std::filesystem::path& path);
+		void Close();
+
+		const uint8_t* GetData() const;
+		size_t GetSize() const;
+
+	private:
+		const uint8_t* m_data{ nullptr };
+		size_t m_size{ 0 };
+#if defined(_WIN32)
+		void* m_file{ nullptr };
+		void* m_mapping{ nullptr };
+#endif
+	};
+}
\ No newline at end of file
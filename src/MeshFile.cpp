@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "MeshFile.h"
+
+#include <fstream>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		template<typename T>
+		void AppendValue(std::vector<uint8_t>& bytes, T value)
+		{
+			const uint8_t* data{ reinterpret_cast<const uint8_t*>(&value) };
+			bytes.insert(bytes.end(), data, data + sizeof(T));
+		}
+
+		template<typename T>
+		T ReadValue(const uint8_t* data)
+		{
+			T value{};
+			memcpy(&value, data, sizeof(T));
+			return value;
+		}
+	}
+
+	uint64_t MeshData::GetByteSize() const
+	{
+		return (vertices.size() * sizeof(Vertex)) + (indices.size() * sizeof(uint16_t));
+	}
+
+	const char* GetMeshDecodeResultName(MeshDecodeResult result)
+	{
+		switch (result)
+		{
+		case MeshDecodeResult::Success:
+			return "success";
+		case MeshDecodeResult::NotAMesh:
+			return "not a mesh file";
+		case MeshDecodeResult::UnsupportedVersion:
+			return "unsupported version";
+		case MeshDecodeResult::Truncated:
+			return "truncated";
+		case MeshDecodeResult::TooLarge:
+			return "too large";
+		case MeshDecodeResult::InvalidIndices:
+			return "invalid indices";
+		case MeshDecodeResult::InvalidQuantization:
+			return "invalid quantization";
+		}
+		return "unknown";
+	}
+
+	MeshDecodeResult DecodeMesh(const uint8_t* data, size_t size, MeshData& mesh)
+	{
+		mesh.vertices.clear();
+		mesh.indices.clear();
+
+		if ((size < MeshFileFormat::HEADER_SIZE) || (ReadValue<uint32_t>(data) != MeshFileFormat::MAGIC))
+		{
+			return MeshDecodeResult::NotAMesh;
+		}
+		if (ReadValue<uint32_t>(data + 4) != MeshFileFormat::VERSION)
+		{
+			return MeshDecodeResult::UnsupportedVersion;
+		}
+
+		const uint32_t vertexCount{ ReadValue<uint32_t>(data + 8) };
+		const uint32_t indexCount{ ReadValue<uint32_t>(data + 12) };
+		if ((vertexCount > MeshFileFormat::MAX_VERTICES) || (indexCount > MeshFileFormat::MAX_INDICES))
+		{
+			return MeshDecodeResult::TooLarge;
+		}
+
+		// Counts are bounded above, so these can't overflow
+		const size_t vertexBytes{ static_cast<size_t>(vertexCount) * sizeof(Vertex) };
+		const size_t indexBytes{ static_cast<size_t>(indexCount) * sizeof(uint16_t) };
+		if (size < (MeshFileFormat::HEADER_SIZE + vertexBytes + indexBytes))
+		{
+			return MeshDecodeResult::Truncated;
+		}
+
+		const uint8_t* vertexData{ data + MeshFileFormat::HEADER_SIZE };
+		const uint8_t* indexData{ vertexData + vertexBytes };
+		mesh.indices.resize(indexCount);
+		memcpy(mesh.indices.data(), indexData, indexBytes);
+		if (((indexCount % 3) != 0) ||
+			std::any_of(mesh.indices.begin(), mesh.indices.end(), [vertexCount](uint16_t index) { return index >= vertexCount; }))
+		{
+			mesh.indices.clear();
+			return MeshDecodeResult::InvalidIndices;
+		}
+
+		mesh.vertices.resize(vertexCount);
+		memcpy(mesh.vertices.data(), vertexData, vertexBytes);
+		return MeshDecodeResult::Success;
+	}
+
+	std::vector<uint8_t> EncodeMesh(const MeshData& mesh)
+	{
+		std::vector<uint8_t> bytes;
+		bytes.reserve(MeshFileFormat::HEADER_SIZE + mesh.GetByteSize());
+		AppendValue(bytes, MeshFileFormat::MAGIC);
+		AppendValue(bytes, MeshFileFormat::VERSION);
+		AppendValue(bytes, static_cast<uint32_t>(mesh.vertices.size()));
+		AppendValue(bytes, static_cast<uint32_t>(mesh.indices.size()));
+
+		const uint8_t* vertexData{ reinterpret_cast<const uint8_t*>(mesh.vertices.data()) };
+		bytes.insert(bytes.end(), vertexData, vertexData + (mesh.vertices.size() * sizeof(Vertex)));
+		const uint8_t* indexData{ reinterpret_cast<const uint8_t*>(mesh.indices.data()) };
+		bytes.insert(bytes.end(), indexData, indexData + (mesh.indices.size() * sizeof(uint16_t)));
+		return bytes;
+	}
+
+	bool WriteMeshFile(const std::filesystem::path& path, const MeshData& mesh)
+	{
+		std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+		if (!file)
+		{
+			spdlog::warn("WriteMeshFile: Couldn't open '{}'.", path.string());
+			return false;
+		}
+		const std::vector<uint8_t> bytes{ EncodeMesh(mesh) };
+		file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return file.good();
+	}
+}
\ No newline at end of file
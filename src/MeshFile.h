@@ -0,0 +1,57 @@
+#pragma once
+#include "Vertex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Mesh files are a 16-byte header (magic, version, vertex count, index count)
+	/// followed by the vertices as tightly packed Vertex structs and then the
+	/// uint16 triangle-list indices. All values are little-endian.
+	/// </summary>
+	namespace MeshFileFormat
+	{
+		constexpr uint32_t MAGIC{ 0x534D5448 }; // 'HTMS'
+		constexpr uint32_t VERSION{ 1 };
+		constexpr size_t HEADER_SIZE{ 16 };
+		constexpr uint32_t MAX_VERTICES{ 0x10000 };
+		constexpr uint32_t MAX_INDICES{ 3 * MAX_VERTICES };
+	}
+
+	/// <summary>
+	/// MeshData is a decoded triangle list, ready to be uploaded as-is.
+	/// </summary>
+	struct MeshData
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint16_t> indices;
+
+		uint64_t GetByteSize() const;
+	};
+
+	enum class MeshDecodeResult
+	{
+		Success,
+		NotAMesh,
+		UnsupportedVersion,
+		Truncated,
+		TooLarge,
+		InvalidIndices,
+		InvalidQuantization,
+	};
+
+	const char* GetMeshDecodeResultName(MeshDecodeResult result);
+
+	/// <summary>
+	/// Decodes and validates a mesh file held in memory. Every index must refer to
+	/// an existing vertex and form whole triangles; on failure mesh is left empty.
+	/// </summary>
+	MeshDecodeResult DecodeMesh(const uint8_t* data, size_t size, MeshData& mesh);
+
+	std::vector<uint8_t> EncodeMesh(const MeshData& mesh);
+	bool WriteMeshFile(const std::filesystem::path& path, const MeshData& mesh);
+}
\ No newline at end of file
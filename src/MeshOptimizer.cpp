@@ -0,0 +1,517 @@
+#include "pch.h"
+#include "MeshOptimizer.h"
+#include "Hash.h"
+
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// Forsyth's tuning: the last triangle's vertices score a little less than the
+		// next few so that strips don't turn back on themselves, and vertices with few
+		// triangles left get a boost so that they are finished off
+		constexpr uint32_t FORSYTH_CACHE_SIZE{ 32 };
+		constexpr float FORSYTH_CACHE_DECAY_POWER{ 1.5f };
+		constexpr float FORSYTH_LAST_TRIANGLE_SCORE{ 0.75f };
+		constexpr float FORSYTH_VALENCE_BOOST_SCALE{ 2.0f };
+		constexpr float FORSYTH_VALENCE_BOOST_POWER{ 0.5f };
+
+		constexpr uint32_t NOT_CACHED{ UINT32_MAX };
+		constexpr uint32_t NO_TRIANGLE{ UINT32_MAX };
+		constexpr uint32_t NOT_REMAPPED{ UINT32_MAX };
+		constexpr uint32_t EMPTY_SLOT{ UINT32_MAX };
+		constexpr size_t MIN_VERTEX_TABLE_CAPACITY{ 64 };
+
+		// Valences past this score the same; few vertices have that many triangles
+		constexpr uint32_t FORSYTH_MAX_VALENCE{ 64 };
+
+		/// <summary>
+		/// Vertex scores split into a cache position part and a remaining triangle
+		/// count part, tabulated so that scoring doesn't call pow.
+		/// </summary>
+		struct ForsythScoreTable
+		{
+			ForsythScoreTable()
+			{
+				// The entry past the cache is for vertices that aren't in it
+				for (uint32_t position = 0; position <= FORSYTH_CACHE_SIZE; ++position)
+				{
+					const float scale{ 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3) };
+					cacheScores[position] =
+						(position < 3) ? FORSYTH_LAST_TRIANGLE_SCORE :
+						(position < FORSYTH_CACHE_SIZE) ?
+							std::pow(1.0f - (static_cast<float>(position - 3) * scale), FORSYTH_CACHE_DECAY_POWER) :
+							0.0f;
+				}
+				valenceScores[0] = 0.0f;
+				for (uint32_t valence = 1; valence <= FORSYTH_MAX_VALENCE; ++valence)
+				{
+					valenceScores[valence] =
+						FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(valence), -FORSYTH_VALENCE_BOOST_POWER);
+				}
+			}
+
+			float ScoreVertex(uint32_t cachePosition, uint32_t remainingTriangles) const
+			{
+				if (remainingTriangles == 0)
+				{
+					return -1.0f;
+				}
+				return cacheScores[std::min(cachePosition, FORSYTH_CACHE_SIZE)] +
+					valenceScores[std::min(remainingTriangles, FORSYTH_MAX_VALENCE)];
+			}
+
+			std::array<float, FORSYTH_CACHE_SIZE + 1> cacheScores;
+			std::array<float, FORSYTH_MAX_VALENCE + 1> valenceScores;
+		};
+
+		/// <summary>
+		/// A FIFO cache of the last few transformed vertices, kept as the time each
+		/// vertex was last inserted.
+		/// </summary>
+		class FifoCacheModel
+		{
+		public:
+			FifoCacheModel(size_t vertexCount, uint32_t cacheSize) :
+				m_insertTimes(vertexCount, 0),
+				m_cacheSize{ cacheSize },
+				m_time{ cacheSize + 1 }
+			{ }
+
+			// Returns true if vertex had to be transformed
+			bool Access(uint16_t vertex)
+			{
+				if ((m_time - m_insertTimes[vertex]) <= m_cacheSize)
+				{
+					return false;
+				}
+				m_insertTimes[vertex] = m_time++;
+				return true;
+			}
+
+			void Flush()
+			{
+				m_time += m_cacheSize + 1;
+			}
+
+		private:
+			std::vector<uint32_t> m_insertTimes;
+			const uint32_t m_cacheSize;
+			uint32_t m_time;
+		};
+
+		struct Float3
+		{
+			float x;
+			float y;
+			float z;
+		};
+
+		Float3 Subtract(const float a[3], const float b[3])
+		{
+			return Float3{ a[0] - b[0], a[1] - b[1], a[2] - b[2] };
+		}
+
+		Float3 Cross(const Float3& a, const Float3& b)
+		{
+			return Float3{
+				(a.y * b.z) - (a.z * b.y),
+				(a.z * b.x) - (a.x * b.z),
+				(a.x * b.y) - (a.y * b.x),
+			};
+		}
+
+		// Twice the area, facing the side the triangle is clockwise from
+		Float3 GetTriangleNormal(const Vertex& a, const Vertex& b, const Vertex& c)
+		{
+			return Cross(Subtract(b.position, a.position), Subtract(c.position, a.position));
+		}
+
+		float GetLength(const Float3& value)
+		{
+			return std::sqrt((value.x * value.x) + (value.y * value.y) + (value.z * value.z));
+		}
+
+		// Area-weighted sums over a run of triangles
+		struct TriangleSums
+		{
+			Float3 normal{ 0.0f, 0.0f, 0.0f };
+			Float3 weightedCentroid{ 0.0f, 0.0f, 0.0f };
+			float area{ 0.0f };
+
+			void Add(const Vertex& a, const Vertex& b, const Vertex& c)
+			{
+				const Float3 triangleNormal{ GetTriangleNormal(a, b, c) };
+				const float triangleArea{ GetLength(triangleNormal) };
+				const float weight{ triangleArea / 3.0f };
+				normal.x += triangleNormal.x;
+				normal.y += triangleNormal.y;
+				normal.z += triangleNormal.z;
+				weightedCentroid.x += (a.position[0] + b.position[0] + c.position[0]) * weight;
+				weightedCentroid.y += (a.position[1] + b.position[1] + c.position[1]) * weight;
+				weightedCentroid.z += (a.position[2] + b.position[2] + c.position[2]) * weight;
+				area += triangleArea;
+			}
+
+			Float3 GetCentroid() const
+			{
+				const float scale{ (area > 0.0f) ? (1.0f / area) : 0.0f };
+				return Float3{ weightedCentroid.x * scale, weightedCentroid.y * scale, weightedCentroid.z * scale };
+			}
+		};
+	}
+
+	VertexCacheStats AnalyzeVertexCache(const std::vector<uint16_t>& indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		VertexCacheStats stats;
+		FifoCacheModel cache{ vertexCount, cacheSize };
+		for (uint16_t index : indices)
+		{
+			stats.transformedCount += cache.Access(index) ? 1 : 0;
+		}
+
+		const size_t triangleCount{ indices.size() / 3 };
+		stats.acmr = (triangleCount > 0) ? (static_cast<float>(stats.transformedCount) / static_cast<float>(triangleCount)) : 0.0f;
+		stats.atvr = (vertexCount > 0) ? (static_cast<float>(stats.transformedCount) / static_cast<float>(vertexCount)) : 0.0f;
+		return stats;
+	}
+
+	bool BuildIndexedMesh(const std::vector<Vertex>& triangleVertices, MeshData& mesh)
+	{
+		mesh.vertices.clear();
+		mesh.indices.clear();
+		if (((triangleVertices.size() % 3) != 0) || (triangleVertices.size() > MeshFileFormat::MAX_INDICES))
+		{
+			spdlog::warn("BuildIndexedMesh: {} vertices don't make a valid triangle list.", triangleVertices.size());
+			return false;
+		}
+
+		// Open addressing over vertex indices, at most half full
+		const size_t capacity{ std::bit_ceil(std::max(triangleVertices.size() * 2, MIN_VERTEX_TABLE_CAPACITY)) };
+		const size_t mask{ capacity - 1 };
+		std::vector<uint32_t> slots(capacity, EMPTY_SLOT);
+		mesh.indices.reserve(triangleVertices.size());
+		for (const Vertex& vertex : triangleVertices)
+		{
+			size_t slot{ static_cast<size_t>(HashValue(vertex)) & mask };
+			while ((slots[slot] != EMPTY_SLOT) && (memcmp(&mesh.vertices[slots[slot]], &vertex, sizeof(Vertex)) != 0))
+			{
+				slot = (slot + 1) & mask;
+			}
+
+			if (slots[slot] == EMPTY_SLOT)
+			{
+				if (mesh.vertices.size() == MeshFileFormat::MAX_VERTICES)
+				{
+					spdlog::warn("BuildIndexedMesh: More than {} unique vertices.", MeshFileFormat::MAX_VERTICES);
+					mesh.vertices.clear();
+					mesh.indices.clear();
+					return false;
+				}
+				slots[slot] = static_cast<uint32_t>(mesh.vertices.size());
+				mesh.vertices.push_back(vertex);
+			}
+			mesh.indices.push_back(static_cast<uint16_t>(slots[slot]));
+		}
+		return true;
+	}
+
+	void OptimizeVertexCache(std::vector<uint16_t>& indices, size_t vertexCount)
+	{
+		const size_t triangleCount{ indices.size() / 3 };
+		if (triangleCount < 2)
+		{
+			return;
+		}
+
+		// Each vertex's triangles that haven't been emitted yet, packed into one
+		// array; a vertex's first remainingTriangles[v] entries are the live ones
+		std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+		for (uint16_t index : indices)
+		{
+			++remainingTriangles[index];
+		}
+		std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+		std::inclusive_scan(remainingTriangles.begin(), remainingTriangles.end(), triangleOffsets.begin() + 1);
+		std::vector<uint32_t> vertexTriangles(indices.size());
+		{
+			std::vector<uint32_t> cursors(triangleOffsets.begin(), triangleOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i)
+			{
+				vertexTriangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		static const ForsythScoreTable scores;
+		std::vector<uint32_t> cachePositions(vertexCount, NOT_CACHED);
+		std::vector<float> vertexScores(vertexCount);
+		for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			vertexScores[vertex] = scores.ScoreVertex(NOT_CACHED, remainingTriangles[vertex]);
+		}
+
+		std::vector<float> triangleScores(triangleCount);
+		uint32_t bestTriangle{ 0 };
+		for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			const uint16_t* corners{ &indices[triangle * 3] };
+			triangleScores[triangle] = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+			if (triangleScores[triangle] > triangleScores[bestTriangle])
+			{
+				bestTriangle = static_cast<uint32_t>(triangle);
+			}
+		}
+
+		std::vector<uint8_t> isEmitted(triangleCount, 0);
+		std::vector<uint16_t> output;
+		output.reserve(indices.size());
+
+		// Cache holds the LRU order; the emitted triangle's vertices go to the front
+		// and anything pushed past FORSYTH_CACHE_SIZE falls out
+		std::array<uint16_t, FORSYTH_CACHE_SIZE + 3> cache{};
+		std::array<uint16_t, FORSYTH_CACHE_SIZE + 3> nextCache{};
+		size_t cacheCount{ 0 };
+		size_t scanCursor{ 0 };
+		while (bestTriangle != NO_TRIANGLE)
+		{
+			isEmitted[bestTriangle] = 1;
+			const uint16_t* corners{ &indices[static_cast<size_t>(bestTriangle) * 3] };
+			output.insert(output.end(), corners, corners + 3);
+
+			size_t nextCount{ 0 };
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				const uint16_t vertex{ corners[corner] };
+				uint32_t* triangles{ &vertexTriangles[triangleOffsets[vertex]] };
+				uint32_t& remaining{ remainingTriangles[vertex] };
+				*std::find(triangles, triangles + remaining, bestTriangle) = triangles[remaining - 1];
+				--remaining;
+
+				if (std::find(nextCache.begin(), nextCache.begin() + nextCount, vertex) == nextCache.begin() + nextCount)
+				{
+					nextCache[nextCount++] = vertex;
+				}
+			}
+			for (size_t i = 0; i < cacheCount; ++i)
+			{
+				if ((cache[i] != corners[0]) && (cache[i] != corners[1]) && (cache[i] != corners[2]))
+				{
+					nextCache[nextCount++] = cache[i];
+				}
+			}
+
+			// Rescore every vertex whose position changed, and their live triangles
+			for (size_t i = 0; i < nextCount; ++i)
+			{
+				const uint16_t vertex{ nextCache[i] };
+				cachePositions[vertex] = (i < FORSYTH_CACHE_SIZE) ? static_cast<uint32_t>(i) : NOT_CACHED;
+				const float score{ scores.ScoreVertex(cachePositions[vertex], remainingTriangles[vertex]) };
+				const float delta{ score - vertexScores[vertex] };
+				vertexScores[vertex] = score;
+
+				const uint32_t* triangles{ &vertexTriangles[triangleOffsets[vertex]] };
+				for (uint32_t j = 0; j < remainingTriangles[vertex]; ++j)
+				{
+					triangleScores[triangles[j]] += delta;
+				}
+			}
+			cacheCount = std::min<size_t>(nextCount, FORSYTH_CACHE_SIZE);
+			std::copy(nextCache.begin(), nextCache.begin() + cacheCount, cache.begin());
+
+			// The next triangle is the best one touching the cache
+			bestTriangle = NO_TRIANGLE;
+			float bestScore{ -1.0f };
+			for (size_t i = 0; i < cacheCount; ++i)
+			{
+				const uint16_t vertex{ cache[i] };
+				const uint32_t* triangles{ &vertexTriangles[triangleOffsets[vertex]] };
+				for (uint32_t j = 0; j < remainingTriangles[vertex]; ++j)
+				{
+					if (triangleScores[triangles[j]] > bestScore)
+					{
+						bestScore = triangleScores[triangles[j]];
+						bestTriangle = triangles[j];
+					}
+				}
+			}
+
+			// Or, when the cache has nothing left to offer, the next one in input order
+			if (bestTriangle == NO_TRIANGLE)
+			{
+				while ((scanCursor < triangleCount) && isEmitted[scanCursor])
+				{
+					++scanCursor;
+				}
+				bestTriangle = (scanCursor < triangleCount) ? static_cast<uint32_t>(scanCursor) : NO_TRIANGLE;
+			}
+		}
+
+		indices.swap(output);
+	}
+
+	void OptimizeOverdraw(std::vector<uint16_t>& indices, const std::vector<Vertex>& vertices, float threshold)
+	{
+		const size_t triangleCount{ indices.size() / 3 };
+		if (triangleCount < 2)
+		{
+			return;
+		}
+
+		// Hard boundaries are where the cache order restarts: all three vertices
+		// miss, so the cluster before can move without costing any reuse
+		std::vector<uint32_t> hardStarts;
+		{
+			FifoCacheModel cache{ vertices.size(), VERTEX_CACHE_FIFO_SIZE };
+			for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				uint32_t misses{ 0 };
+				for (size_t corner = 0; corner < 3; ++corner)
+				{
+					misses += cache.Access(indices[(triangle * 3) + corner]) ? 1 : 0;
+				}
+				if ((triangle == 0) || (misses == 3))
+				{
+					hardStarts.push_back(static_cast<uint32_t>(triangle));
+				}
+			}
+			hardStarts.push_back(static_cast<uint32_t>(triangleCount));
+		}
+
+		// Soft boundaries split a hard cluster wherever the part so far, drawn from a
+		// cold cache, is already within threshold of the whole mesh's ACMR
+		const float maxClusterAcmr{ AnalyzeVertexCache(indices, vertices.size()).acmr * threshold };
+		std::vector<uint32_t> clusterStarts;
+		{
+			FifoCacheModel cache{ vertices.size(), VERTEX_CACHE_FIFO_SIZE };
+			for (size_t hard = 0; (hard + 1) < hardStarts.size(); ++hard)
+			{
+				const uint32_t hardEnd{ hardStarts[hard + 1] };
+				uint32_t clusterStart{ hardStarts[hard] };
+				uint32_t misses{ 0 };
+				cache.Flush();
+				clusterStarts.push_back(clusterStart);
+				for (uint32_t triangle = clusterStart; (triangle + 1) < hardEnd; ++triangle)
+				{
+					for (size_t corner = 0; corner < 3; ++corner)
+					{
+						misses += cache.Access(indices[(static_cast<size_t>(triangle) * 3) + corner]) ? 1 : 0;
+					}
+					const float clusterAcmr{ static_cast<float>(misses) / static_cast<float>(triangle - clusterStart + 1) };
+					if (clusterAcmr <= maxClusterAcmr)
+					{
+						clusterStart = triangle + 1;
+						misses = 0;
+						cache.Flush();
+						clusterStarts.push_back(clusterStart);
+					}
+				}
+			}
+			clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+		}
+
+		const size_t clusterCount{ clusterStarts.size() - 1 };
+		std::vector<TriangleSums> clusterSums(clusterCount);
+		TriangleSums meshSums;
+		for (size_t cluster = 0; cluster < clusterCount; ++cluster)
+		{
+			for (size_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle)
+			{
+				const uint16_t* corners{ &indices[triangle * 3] };
+				clusterSums[cluster].Add(vertices[corners[0]], vertices[corners[1]], vertices[corners[2]]);
+			}
+			meshSums.weightedCentroid.x += clusterSums[cluster].weightedCentroid.x;
+			meshSums.weightedCentroid.y += clusterSums[cluster].weightedCentroid.y;
+			meshSums.weightedCentroid.z += clusterSums[cluster].weightedCentroid.z;
+			meshSums.area += clusterSums[cluster].area;
+		}
+
+		// Clusters facing away from the center are likelier to occlude the rest
+		const Float3 meshCentroid{ meshSums.GetCentroid() };
+		std::vector<float> clusterKeys(clusterCount);
+		for (size_t cluster = 0; cluster < clusterCount; ++cluster)
+		{
+			const TriangleSums& sums{ clusterSums[cluster] };
+			const float normalLength{ GetLength(sums.normal) };
+			const Float3 centroid{ sums.GetCentroid() };
+			clusterKeys[cluster] = (normalLength > 0.0f) ?
+				(((centroid.x - meshCentroid.x) * sums.normal.x) +
+					((centroid.y - meshCentroid.y) * sums.normal.y) +
+					((centroid.z - meshCentroid.z) * sums.normal.z)) / normalLength :
+				0.0f;
+		}
+
+		std::vector<uint32_t> clusterOrder(clusterCount);
+		std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+			[&clusterKeys](uint32_t a, uint32_t b)
+			{
+				return clusterKeys[a] > clusterKeys[b];
+			});
+
+		std::vector<uint16_t> output;
+		output.reserve(indices.size());
+		for (uint32_t cluster : clusterOrder)
+		{
+			output.insert(
+				output.end(),
+				indices.begin() + (static_cast<size_t>(clusterStarts[cluster]) * 3),
+				indices.begin() + (static_cast<size_t>(clusterStarts[cluster + 1]) * 3));
+		}
+		indices.swap(output);
+	}
+
+	void OptimizeVertexFetch(MeshData& mesh)
+	{
+		std::vector<uint32_t> remap(mesh.vertices.size(), NOT_REMAPPED);
+		std::vector<Vertex> vertices;
+		vertices.reserve(mesh.vertices.size());
+		for (uint16_t& index : mesh.indices)
+		{
+			if (remap[index] == NOT_REMAPPED)
+			{
+				remap[index] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(mesh.vertices[index]);
+			}
+			index = static_cast<uint16_t>(remap[index]);
+		}
+		mesh.vertices.swap(vertices);
+	}
+
+	void OptimizeMesh(MeshData& mesh)
+	{
+		OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+		OptimizeOverdraw(mesh.indices, mesh.vertices);
+		OptimizeVertexFetch(mesh);
+	}
+
+	std::vector<std::array<float, 3>> ComputeVertexNormals(const MeshData& mesh)
+	{
+		std::vector<std::array<float, 3>> normals(mesh.vertices.size(), std::array<float, 3>{ 0.0f, 0.0f, 0.0f });
+		for (size_t i = 0; (i + 2) < mesh.indices.size(); i += 3)
+		{
+			const uint16_t* corners{ &mesh.indices[i] };
+			const Float3 normal{
+				GetTriangleNormal(mesh.vertices[corners[0]], mesh.vertices[corners[1]], mesh.vertices[corners[2]])
+			};
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				std::array<float, 3>& vertexNormal{ normals[corners[corner]] };
+				vertexNormal[0] += normal.x;
+				vertexNormal[1] += normal.y;
+				vertexNormal[2] += normal.z;
+			}
+		}
+
+		for (std::array<float, 3>& normal : normals)
+		{
+			const float length{ GetLength(Float3{ normal[0], normal[1], normal[2] }) };
+			normal = (length > 0.0f) ?
+				std::array<float, 3>{ normal[0] / length, normal[1] / length, normal[2] / length } :
+				std::array<float, 3>{ 0.0f, 0.0f, 1.0f };
+		}
+		return normals;
+	}
+}
\ No newline at end of file
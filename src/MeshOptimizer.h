@@ -0,0 +1,78 @@
+#pragma once
+#include "MeshFile.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// How well an index order reuses a FIFO post-transform vertex cache. acmr is
+	/// vertex shader invocations per triangle (0.5 at best for large meshes, 3 at
+	/// worst) and atvr invocations per vertex (1 at best).
+	/// </summary>
+	struct VertexCacheStats
+	{
+		uint32_t transformedCount{ 0 };
+		float acmr{ 0.0f };
+		float atvr{ 0.0f };
+	};
+
+	// The FIFO cache size AnalyzeVertexCache and OptimizeOverdraw model, a
+	// conservative guess for current GPUs
+	constexpr uint32_t VERTEX_CACHE_FIFO_SIZE{ 16 };
+
+	// OptimizeOverdraw may raise the ACMR by this factor to make clusters smaller
+	constexpr float DEFAULT_OVERDRAW_THRESHOLD{ 1.05f };
+
+	VertexCacheStats AnalyzeVertexCache(
+		const std::vector<uint16_t>& indices,
+		size_t vertexCount,
+		uint32_t cacheSize = VERTEX_CACHE_FIFO_SIZE);
+
+	/// <summary>
+	/// Turns a triangle list without indices into an indexed mesh, merging vertices
+	/// that are bitwise identical. Fails if more than MeshFileFormat::MAX_VERTICES
+	/// vertices are unique.
+	/// </summary>
+	bool BuildIndexedMesh(const std::vector<Vertex>& triangleVertices, MeshData& mesh);
+
+	/// <summary>
+	/// Reorders triangles for post-transform vertex cache reuse, using Forsyth's
+	/// linear-speed greedy algorithm with a 32-entry LRU cache model.
+	/// </summary>
+	void OptimizeVertexCache(std::vector<uint16_t>& indices, size_t vertexCount);
+
+	/// <summary>
+	/// Reorders vertex-cache-optimized triangles so that the outside of the mesh
+	/// tends to draw first, reducing overdraw (Sander et al., "Fast Triangle
+	/// Reordering for Vertex Locality and Reduced Overdraw"). Triangles are split
+	/// into clusters where the cache order restarts anyway, or where a cluster's
+	/// own ACMR is within threshold of the whole mesh's, and clusters are sorted by
+	/// how far they face away from the mesh's centroid.
+	/// </summary>
+	void OptimizeOverdraw(
+		std::vector<uint16_t>& indices,
+		const std::vector<Vertex>& vertices,
+		float threshold = DEFAULT_OVERDRAW_THRESHOLD);
+
+	/// <summary>
+	/// Reorders vertices by first use so the vertex fetches follow the index
+	/// order, dropping vertices no index refers to.
+	/// </summary>
+	void OptimizeVertexFetch(MeshData& mesh);
+
+	/// <summary>
+	/// Runs OptimizeVertexCache, OptimizeOverdraw and OptimizeVertexFetch in turn.
+	/// </summary>
+	void OptimizeMesh(MeshData& mesh);
+
+	/// <summary>
+	/// Area-weighted vertex normals, facing the side triangles are clockwise from,
+	/// which D3D12 treats as the front by default. Vertices without any area get
+	/// +z.
+	/// </summary>
+	std::vector<std::array<float, 3>> ComputeVertexNormals(const MeshData& mesh);
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "pch.h"
+#include "MeshProcessor.h"
+#include "CompressedMeshFile.h"
+#include "MappedFile.h"
+
+namespace HelloTriangle
+{
+	bool ProcessMesh(MeshData& mesh, CompressedMeshData& compressed, MeshProcessorStats& stats)
+	{
+		stats.cacheBefore = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+		stats.byteSize = mesh.GetByteSize();
+		OptimizeMesh(mesh);
+		stats.cacheAfter = AnalyzeVertexCache(mesh.indices, mesh.vertices.size());
+
+		compressed = CompressMesh(mesh);
+		stats.compressedIndexByteSize = EncodeIndexStream(compressed.indices).size();
+		stats.compressedByteSize = (compressed.vertices.size() * sizeof(CompressedVertex)) + stats.compressedIndexByteSize;
+		stats.compressionError = MeasureVertexCompressionError(mesh, compressed);
+		stats.compressionErrorBound = GetVertexCompressionErrorBound(compressed.quantization);
+		return (stats.compressionError.position <= stats.compressionErrorBound.position) &&
+			(stats.compressionError.color <= stats.compressionErrorBound.color);
+	}
+
+	bool ProcessMeshFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath)
+	{
+		MeshData mesh;
+		{
+			MappedFile file;
+			if (!file.Open(inputPath))
+			{
+				spdlog::error("ProcessMeshFile: Couldn't open '{}'.", inputPath.string());
+				return false;
+			}
+			const MeshDecodeResult result{ DecodeMesh(file.GetData(), file.GetSize(), mesh) };
+			if (result != MeshDecodeResult::Success)
+			{
+				spdlog::error("ProcessMeshFile: Couldn't decode '{}': {}.", inputPath.string(), GetMeshDecodeResultName(result));
+				return false;
+			}
+		}
+
+		CompressedMeshData compressed;
+		MeshProcessorStats stats;
+		const bool isWithinBounds{ ProcessMesh(mesh, compressed, stats) };
+		spdlog::info(
+			"ProcessMeshFile: {} vertices, {} triangles. ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}.",
+			mesh.vertices.size(),
+			mesh.indices.size() / 3,
+			stats.cacheBefore.acmr,
+			stats.cacheAfter.acmr,
+			stats.cacheBefore.atvr,
+			stats.cacheAfter.atvr);
+		const uint64_t vertexByteSize{ mesh.vertices.size() * sizeof(Vertex) };
+		const uint64_t compressedVertexByteSize{ compressed.vertices.size() * sizeof(CompressedVertex) };
+		const uint64_t indexByteSize{ mesh.indices.size() * sizeof(uint16_t) };
+		const auto getRatio{ [](uint64_t before, uint64_t after)
+		{
+			return static_cast<double>(before) / std::max<double>(static_cast<double>(after), 1.0);
+		} };
+		spdlog::info(
+			"ProcessMeshFile: Compressed {} bytes to {} ({:.2f}x); vertices {} to {} ({:.2f}x), indices {} to {} ({:.2f}x).",
+			stats.byteSize,
+			stats.compressedByteSize,
+			getRatio(stats.byteSize, stats.compressedByteSize),
+			vertexByteSize,
+			compressedVertexByteSize,
+			getRatio(vertexByteSize, compressedVertexByteSize),
+			indexByteSize,
+			stats.compressedIndexByteSize,
+			getRatio(indexByteSize, stats.compressedIndexByteSize));
+		spdlog::info(
+			"ProcessMeshFile: Round-trip error: position {:.3g} (bound {:.3g}), color {:.3g} (bound {:.3g}).",
+			stats.compressionError.position,
+			stats.compressionErrorBound.position,
+			stats.compressionError.color,
+			stats.compressionErrorBound.color);
+		if (!isWithinBounds)
+		{
+			spdlog::error("ProcessMeshFile: Compression error is out of bounds.");
+			return false;
+		}
+
+		if (!WriteCompressedMeshFile(outputPath, compressed))
+		{
+			return false;
+		}
+		spdlog::info("ProcessMeshFile: Wrote {}.", outputPath.string());
+		return true;
+	}
+}
\ No newline at end of file
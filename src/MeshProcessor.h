@@ -0,0 +1,36 @@
+#pragma once
+#include "MeshFile.h"
+#include "MeshOptimizer.h"
+#include "VertexCompression.h"
+
+#include <filesystem>
+
+namespace HelloTriangle
+{
+	struct MeshProcessorStats
+	{
+		VertexCacheStats cacheBefore;
+		VertexCacheStats cacheAfter;
+		uint64_t byteSize{ 0 };
+		// As stored in a compressed mesh file, not counting the header; the indices
+		// are uint16 again once loaded
+		uint64_t compressedByteSize{ 0 };
+		uint64_t compressedIndexByteSize{ 0 };
+		VertexCompressionError compressionError;
+		VertexCompressionError compressionErrorBound;
+	};
+
+	/// <summary>
+	/// The import-time mesh pipeline: reorders mesh with OptimizeMesh, then
+	/// compresses the result and checks the round trip against the error bound.
+	/// Returns false if any error is out of bounds.
+	/// </summary>
+	bool ProcessMesh(MeshData& mesh, CompressedMeshData& compressed, MeshProcessorStats& stats);
+
+	/// <summary>
+	/// Runs ProcessMesh on a mesh file, logs what it achieved and writes the
+	/// compressed mesh to outputPath as a compressed mesh file, which AssetStreamer
+	/// loads like a plain one.
+	/// </summary>
+	bool ProcessMeshFile(const std::filesystem::path& inputPath, const std::filesystem::path& outputPath);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "pch.h"
+#include "MessageTranslator.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// Key message lParam bit 30 is set when the key was already down
+		constexpr int64_t PREVIOUS_KEY_STATE_BIT{ int64_t{ 1 } << 30 };
+	}
+
+	bool TranslateMessageToEvent(
+		const RawMessage& message,
+		std::chrono::nanoseconds timestamp,
+		InputEvent& event)
+	{
+		InputEventType type{ InputEventType::KeyDown };
+		switch (message.id)
+		{
+		case RawMessageId::KEY_DOWN:
+		case RawMessageId::SYS_KEY_DOWN:
+			if ((message.lParam & PREVIOUS_KEY_STATE_BIT) != 0)
+			{
+				return false;
+			}
+			type = InputEventType::KeyDown;
+			break;
+
+		case RawMessageId::KEY_UP:
+		case RawMessageId::SYS_KEY_UP:
+			type = InputEventType::KeyUp;
+			break;
+
+		default:
+			return false;
+		}
+
+		event = InputEvent
+		{
+			.timestamp = timestamp,
+			.type = type,
+			.key = static_cast<uint8_t>(message.wParam & 0xFF),
+		};
+		return true;
+	}
+}
\ No newline at end of file
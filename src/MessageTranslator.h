@@ -0,0 +1,40 @@
+#pragma once
+#include "InputEvents.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// RawMessage carries a window message's id and parameters without any Win32
+	/// types, so translation can run (and be tested) off Windows.
+	/// </summary>
+	struct RawMessage
+	{
+		uint32_t id;
+		uint64_t wParam;
+		int64_t lParam;
+	};
+
+	/// <summary>
+	/// Win32 message ids understood by TranslateMessageToEvent, mirrored here to
+	/// keep the translator free of Windows headers.
+	/// </summary>
+	namespace RawMessageId
+	{
+		constexpr uint32_t KEY_DOWN{ 0x0100 };
+		constexpr uint32_t KEY_UP{ 0x0101 };
+		constexpr uint32_t SYS_KEY_DOWN{ 0x0104 };
+		constexpr uint32_t SYS_KEY_UP{ 0x0105 };
+	}
+
+	/// <summary>
+	/// Turns a window message into an input event. Returns false for messages that
+	/// aren't input, and for auto-repeated key downs of a key that is already held.
+	/// </summary>
+	bool TranslateMessageToEvent(
+		const RawMessage& message,
+		std::chrono::nanoseconds timestamp,
+		InputEvent& event);
+}
\ No newline at end of file
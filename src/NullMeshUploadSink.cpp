@@ -0,0 +1,31 @@
+#include "pch.h"
+#include "NullMeshUploadSink.h"
+#include "MeshFile.h"
+#include "VertexCompression.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	uint32_t NullMeshUploadSink::GetMeshCount() const
+	{
+		return m_meshCount;
+	}
+
+	uint64_t NullMeshUploadSink::GetUploadedBytes() const
+	{
+		return m_uploadedBytes;
+	}
+
+	uint32_t NullMeshUploadSink::UploadMesh(const MeshData& mesh)
+	{
+		m_uploadedBytes += mesh.GetByteSize();
+		return m_meshCount++;
+	}
+
+	uint32_t NullMeshUploadSink::UploadCompressedMesh(const CompressedMeshData& mesh)
+	{
+		m_uploadedBytes += mesh.GetByteSize();
+		return m_meshCount++;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include "IMeshUploadSink.h"
+
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// NullMeshUploadSink accepts every mesh without a device and only keeps counts,
+	/// so streaming can be run and measured headlessly.
+	/// </summary>
+	class NullMeshUploadSink : public IMeshUploadSink
+	{
+	public:
+		uint32_t GetMeshCount() const;
+		uint64_t GetUploadedBytes() const;
+
+		// IMeshUploadSink
+		virtual uint32_t UploadMesh(const MeshData& mesh);
+		virtual uint32_t UploadCompressedMesh(const CompressedMeshData& mesh);
+
+	private:
+		uint32_t m_meshCount{ 0 };
+		uint64_t m_uploadedBytes{ 0 };
+	};
+}
\ No newline at end of file
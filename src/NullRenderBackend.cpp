@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "NullRenderBackend.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	const std::vector<NullRenderBackend::Command>& NullRenderBackend::GetCommands() const
+	{
+		return m_commands;
+	}
+
+	uint32_t NullRenderBackend::GetPassCount() const
+	{
+		return m_passCount;
+	}
+
+	uint32_t NullRenderBackend::GetBarrierCount() const
+	{
+		return m_barrierCount;
+	}
+
+	void NullRenderBackend::Clear()
+	{
+		m_commands.clear();
+		m_passCount = 0;
+		m_barrierCount = 0;
+	}
+
+	void NullRenderBackend::BeginPass(const std::string& name)
+	{
+		++m_passCount;
+		m_commands.push_back(Command{
+			.type = CommandType::BeginPass,
+			.passName = name,
+		});
+	}
+
+	void NullRenderBackend::ResourceBarrier(
+		RenderResourceHandle resource,
+		ResourceState before,
+		ResourceState after)
+	{
+		++m_barrierCount;
+		m_commands.push_back(Command{
+			.type = CommandType::Barrier,
+			.resource = resource,
+			.before = before,
+			.after = after,
+		});
+	}
+
+	void NullRenderBackend::EndPass()
+	{
+		m_commands.push_back(Command{
+			.type = CommandType::EndPass,
+		});
+	}
+#pragma endregion Public
+}
\ No newline at end of file
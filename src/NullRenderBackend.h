@@ -0,0 +1,50 @@
+#pragma once
+#include "RenderGraph.h"
+
+#include <string>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// NullRenderBackend records the command stream a RenderGraph produces without
+	/// talking to any graphics API, so graph scheduling can run and be measured headlessly.
+	/// </summary>
+	class NullRenderBackend : public IRenderBackend
+	{
+	public:
+		enum class CommandType : uint8_t
+		{
+			BeginPass,
+			Barrier,
+			EndPass,
+		};
+
+		struct Command
+		{
+			CommandType type;
+			std::string passName{};
+			RenderResourceHandle resource{ INVALID_RENDER_RESOURCE };
+			ResourceState before{ ResourceState::Undefined };
+			ResourceState after{ ResourceState::Undefined };
+		};
+
+		const std::vector<Command>& GetCommands() const;
+		uint32_t GetPassCount() const;
+		uint32_t GetBarrierCount() const;
+		void Clear();
+
+		// IRenderBackend
+		virtual void BeginPass(const std::string& name);
+		virtual void ResourceBarrier(
+			RenderResourceHandle resource,
+			ResourceState before,
+			ResourceState after);
+		virtual void EndPass();
+
+	private:
+		std::vector<Command> m_commands;
+		uint32_t m_passCount{ 0 };
+		uint32_t m_barrierCount{ 0 };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,310 @@
+#include "pch.h"
+#include "OcclusionBuffer.h"
+
+#include <bit>
+#include <cmath>
+
+namespace HelloTriangle
+{
+#pragma region Public
+	OcclusionBuffer::OcclusionBuffer(uint32_t width, uint32_t height) :
+		m_width{ width },
+		m_height{ height }
+	{
+		// Halve down to a single texel, rounding up so every texel has a parent
+		uint32_t levelWidth{ width };
+		uint32_t levelHeight{ height };
+		while (true)
+		{
+			m_levels.push_back(Level{
+				levelWidth,
+				levelHeight,
+				std::vector<float>(static_cast<size_t>(levelWidth) * levelHeight, 1.0f)
+			});
+			if ((levelWidth == 1) && (levelHeight == 1))
+			{
+				break;
+			}
+			levelWidth = (levelWidth + 1) / 2;
+			levelHeight = (levelHeight + 1) / 2;
+		}
+	}
+
+	void OcclusionBuffer::Begin(const float viewProjection[16])
+	{
+		std::copy(viewProjection, viewProjection + 16, m_viewProjection);
+		for (size_t row = 0; row < 4; ++row)
+		{
+			const float* m{ &m_viewProjection[row * 4] };
+			m_rowExtents[row] = std::abs(m[0]) + std::abs(m[1]) + std::abs(m[2]);
+		}
+		std::fill(m_levels[0].depth.begin(), m_levels[0].depth.end(), 1.0f);
+	}
+
+	void OcclusionBuffer::RasterizeOccluder(const MeshData& mesh, const InstanceData& instance)
+	{
+		for (size_t i = 0; (i + 2) < mesh.indices.size(); i += 3)
+		{
+			++m_stats.occluderTriangles;
+
+			float screenX[3];
+			float screenY[3];
+			float farthestDepth{ 0.0f };
+			bool isProjected{ true };
+			for (size_t v = 0; v < 3; ++v)
+			{
+				// Same placement as VSMain: scale, then offset
+				const Vertex& vertex{ mesh.vertices[mesh.indices[i + v]] };
+				float position[3];
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					position[axis] = (vertex.position[axis] * instance.positionScale[3]) + instance.positionScale[axis];
+				}
+
+				float depth{ 0.0f };
+				isProjected = isProjected && ProjectPoint(position, screenX[v], screenY[v], depth);
+				farthestDepth = std::max(farthestDepth, depth);
+			}
+
+			// Clipping occluders isn't worth it; dropping them only loses occlusion
+			if (!isProjected)
+			{
+				++m_stats.occluderTrianglesSkipped;
+				continue;
+			}
+			RasterizeTriangle(screenX, screenY, std::min(farthestDepth, 1.0f));
+		}
+	}
+
+	void OcclusionBuffer::BuildHierarchy()
+	{
+		for (size_t level = 1; level < m_levels.size(); ++level)
+		{
+			const Level& source{ m_levels[level - 1] };
+			Level& destination{ m_levels[level] };
+			for (uint32_t y = 0; y < destination.height; ++y)
+			{
+				const uint32_t y0{ y * 2 };
+				const uint32_t y1{ std::min(y0 + 1, source.height - 1) };
+				for (uint32_t x = 0; x < destination.width; ++x)
+				{
+					const uint32_t x0{ x * 2 };
+					const uint32_t x1{ std::min(x0 + 1, source.width - 1) };
+					destination.depth[(static_cast<size_t>(y) * destination.width) + x] = std::max(
+						std::max(
+							source.depth[(static_cast<size_t>(y0) * source.width) + x0],
+							source.depth[(static_cast<size_t>(y0) * source.width) + x1]),
+						std::max(
+							source.depth[(static_cast<size_t>(y1) * source.width) + x0],
+							source.depth[(static_cast<size_t>(y1) * source.width) + x1]));
+				}
+			}
+		}
+	}
+
+	bool OcclusionBuffer::IsSphereVisible(float x, float y, float z, float radius)
+	{
+		++m_stats.spheresTested;
+
+		// Clip space is linear in the point, so the sphere's bounding box maps to
+		// the center's clip coordinates plus or minus radius times each row's
+		// absolute sum. Dividing that range by w bounds the screen rectangle.
+		float center[4];
+		float extent[4];
+		for (size_t row = 0; row < 4; ++row)
+		{
+			const float* m{ &m_viewProjection[row * 4] };
+			center[row] = (((m[0] * x) + (m[1] * y)) + (m[2] * z)) + m[3];
+			extent[row] = m_rowExtents[row] * radius;
+		}
+		const float minW{ center[3] - extent[3] };
+		const float maxW{ center[3] + extent[3] };
+		if (minW < MIN_CLIP_W)
+		{
+			// Straddles the camera plane, so it can't be behind anything
+			return true;
+		}
+
+		auto divideRange = [minW, maxW](float low, float high, float& minimum, float& maximum)
+		{
+			minimum = std::min(low / minW, low / maxW);
+			maximum = std::max(high / minW, high / maxW);
+		};
+		float minNdcX{ 0.0f };
+		float maxNdcX{ 0.0f };
+		float minNdcY{ 0.0f };
+		float maxNdcY{ 0.0f };
+		divideRange(center[0] - extent[0], center[0] + extent[0], minNdcX, maxNdcX);
+		divideRange(center[1] - extent[1], center[1] + extent[1], minNdcY, maxNdcY);
+
+		// Viewport transform, y down, as in ProjectPoint
+		const float minX{ ((minNdcX * 0.5f) + 0.5f) * static_cast<float>(m_width) };
+		const float maxX{ ((maxNdcX * 0.5f) + 0.5f) * static_cast<float>(m_width) };
+		const float minY{ (0.5f - (maxNdcY * 0.5f)) * static_cast<float>(m_height) };
+		const float maxY{ (0.5f - (minNdcY * 0.5f)) * static_cast<float>(m_height) };
+		if ((maxX < 0.0f) || (maxY < 0.0f) ||
+			(minX >= static_cast<float>(m_width)) || (minY >= static_cast<float>(m_height)))
+		{
+			// Off screen: leave it to frustum culling
+			return true;
+		}
+
+		uint32_t x0{ static_cast<uint32_t>(std::max(minX, 0.0f)) };
+		uint32_t y0{ static_cast<uint32_t>(std::max(minY, 0.0f)) };
+		uint32_t x1{ static_cast<uint32_t>(std::min(maxX, static_cast<float>(m_width - 1))) };
+		uint32_t y1{ static_cast<uint32_t>(std::min(maxY, static_cast<float>(m_height - 1))) };
+
+		// A span of up to 2^k pixels covers at most two texels of level k wherever
+		// it starts; depending on where it starts, one level finer may do too.
+		// Either way four reads suffice, and nothing branches on the size.
+		const uint32_t span{ std::max(std::max(x1 - x0, y1 - y0), 1u) };
+		const uint32_t coarseLevel{ static_cast<uint32_t>(std::bit_width(span - 1)) };
+		const uint32_t canRefine{ static_cast<uint32_t>(coarseLevel > 0) };
+		const uint32_t fineLevel{ coarseLevel - canRefine };
+		const uint32_t fitsX{ static_cast<uint32_t>(((x1 >> fineLevel) - (x0 >> fineLevel)) <= 1) };
+		const uint32_t fitsY{ static_cast<uint32_t>(((y1 >> fineLevel) - (y0 >> fineLevel)) <= 1) };
+		const uint32_t level{ coarseLevel - (canRefine & fitsX & fitsY) };
+		const Level& hiz{ m_levels[level] };
+		x0 >>= level;
+		y0 >>= level;
+		x1 >>= level;
+		y1 >>= level;
+		const float farthestDepth{ std::max(
+			std::max(
+				hiz.depth[(static_cast<size_t>(y0) * hiz.width) + x0],
+				hiz.depth[(static_cast<size_t>(y0) * hiz.width) + x1]),
+			std::max(
+				hiz.depth[(static_cast<size_t>(y1) * hiz.width) + x0],
+				hiz.depth[(static_cast<size_t>(y1) * hiz.width) + x1])) };
+
+		// Occluded if every box corner is behind farthestDepth, i.e. z - depth * w > 0.
+		// That is linear in the point, so its minimum over the box is exact without
+		// dividing each corner by w.
+		const float* zRow{ &m_viewProjection[8] };
+		const float* wRow{ &m_viewProjection[12] };
+		float spread{ 0.0f };
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			spread += std::abs(zRow[axis] - (farthestDepth * wRow[axis]));
+		}
+		if ((center[2] - (farthestDepth * center[3])) - (spread * radius) <= 0.0f)
+		{
+			return true;
+		}
+		++m_stats.spheresOccluded;
+		return false;
+	}
+
+	uint32_t OcclusionBuffer::GetWidth() const
+	{
+		return m_width;
+	}
+
+	uint32_t OcclusionBuffer::GetHeight() const
+	{
+		return m_height;
+	}
+
+	size_t OcclusionBuffer::GetLevelCount() const
+	{
+		return m_levels.size();
+	}
+
+	const OcclusionBuffer::Stats& OcclusionBuffer::GetStats() const
+	{
+		return m_stats;
+	}
+
+	void OcclusionBuffer::ResetStats()
+	{
+		m_stats = Stats{};
+	}
+#pragma endregion Public
+
+#pragma region Private
+	bool OcclusionBuffer::ProjectPoint(const float point[3], float& screenX, float& screenY, float& depth) const
+	{
+		float clip[4];
+		for (size_t row = 0; row < 4; ++row)
+		{
+			const float* m{ &m_viewProjection[row * 4] };
+			clip[row] = (((m[0] * point[0]) + (m[1] * point[1])) + (m[2] * point[2])) + m[3];
+		}
+		if (clip[3] < MIN_CLIP_W)
+		{
+			return false;
+		}
+
+		// Viewport transform into pixel space, y down, as SoftwareRasterizer does
+		const float inverseW{ 1.0f / clip[3] };
+		screenX = ((clip[0] * inverseW * 0.5f) + 0.5f) * static_cast<float>(m_width);
+		screenY = (0.5f - (clip[1] * inverseW * 0.5f)) * static_cast<float>(m_height);
+		depth = clip[2] * inverseW;
+		return true;
+	}
+
+	void OcclusionBuffer::RasterizeTriangle(const float screenX[3], const float screenY[3], float depth)
+	{
+		const float area{
+			((screenY[2] - screenY[0]) * (screenX[1] - screenX[0])) -
+			((screenX[2] - screenX[0]) * (screenY[1] - screenY[0]))
+		};
+		if (area == 0.0f)
+		{
+			return;
+		}
+
+		const float minX{ std::min({ screenX[0], screenX[1], screenX[2] }) };
+		const float maxX{ std::max({ screenX[0], screenX[1], screenX[2] }) };
+		const float minY{ std::min({ screenY[0], screenY[1], screenY[2] }) };
+		const float maxY{ std::max({ screenY[0], screenY[1], screenY[2] }) };
+		if ((maxX < 0.0f) || (maxY < 0.0f) ||
+			(minX >= static_cast<float>(m_width)) || (minY >= static_cast<float>(m_height)))
+		{
+			return;
+		}
+		// Clamp before converting; points near the camera plane project very far out
+		const uint32_t x0{ static_cast<uint32_t>(std::max(minX, 0.0f)) };
+		const uint32_t y0{ static_cast<uint32_t>(std::max(minY, 0.0f)) };
+		const uint32_t x1{ static_cast<uint32_t>(std::min(std::ceil(maxX), static_cast<float>(m_width - 1))) };
+		const uint32_t y1{ static_cast<uint32_t>(std::min(std::ceil(maxY), static_cast<float>(m_height - 1))) };
+
+		// Edge i is opposite vertex i; flipping by the sign of the area accepts
+		// both windings
+		const float orientation{ (area > 0.0f) ? 1.0f : -1.0f };
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		for (size_t i = 0; i < 3; ++i)
+		{
+			const size_t a{ (i + 1) % 3 };
+			const size_t b{ (i + 2) % 3 };
+			const float dx{ screenX[b] - screenX[a] };
+			const float dy{ screenY[b] - screenY[a] };
+			edgeA[i] = -dy * orientation;
+			edgeB[i] = dx * orientation;
+			edgeC[i] = ((screenX[a] * dy) - (screenY[a] * dx)) * orientation;
+		}
+
+		std::vector<float>& buffer{ m_levels[0].depth };
+		for (uint32_t y = y0; y <= y1; ++y)
+		{
+			const float py{ static_cast<float>(y) + 0.5f };
+			float* row{ &buffer[static_cast<size_t>(y) * m_width] };
+			for (uint32_t x = x0; x <= x1; ++x)
+			{
+				const float px{ static_cast<float>(x) + 0.5f };
+				bool isCovered{ true };
+				for (size_t i = 0; i < 3; ++i)
+				{
+					isCovered = isCovered && (((edgeA[i] * px) + (edgeB[i] * py) + edgeC[i]) >= 0.0f);
+				}
+				if (isCovered)
+				{
+					row[x] = std::min(row[x], depth);
+				}
+			}
+		}
+	}
+#pragma endregion Private
+}
\ No newline at end of file
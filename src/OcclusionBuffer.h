@@ -0,0 +1,83 @@
+#pragma once
+#include "DrawBatcher.h"
+#include "MeshFile.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// OcclusionBuffer is a low-resolution software depth buffer for CPU occlusion
+	/// culling. Occluder meshes are rasterized at their farthest depth, then a
+	/// hierarchical-Z pyramid is built where each texel holds the farthest depth of
+	/// the four below it. A bounding volume is occluded when its nearest depth lies
+	/// behind every texel its screen rectangle touches, which takes at most four
+	/// texel reads at the right pyramid level.
+	/// Coverage is sampled at pixel centers, so an object showing through less than
+	/// one buffer pixel may be culled.
+	/// </summary>
+	class OcclusionBuffer
+	{
+	public:
+		struct Stats
+		{
+			uint64_t occluderTriangles{ 0 };
+			uint64_t occluderTrianglesSkipped{ 0 };
+			uint64_t spheresTested{ 0 };
+			uint64_t spheresOccluded{ 0 };
+		};
+
+		OcclusionBuffer(uint32_t width, uint32_t height);
+
+		/// <summary>
+		/// Clears to the far plane and sets the row-major view-projection (as Camera
+		/// produces) used by the following calls.
+		/// </summary>
+		void Begin(const float viewProjection[16]);
+
+		/// <summary>
+		/// Rasterizes both faces of an indexed mesh, placed the way VSMain applies
+		/// instance. Triangles crossing the near plane are skipped.
+		/// </summary>
+		void RasterizeOccluder(const MeshData& mesh, const InstanceData& instance);
+
+		/// <summary>
+		/// Builds the pyramid from the rasterized occluders. Call after the last
+		/// occluder and before testing.
+		/// </summary>
+		void BuildHierarchy();
+
+		/// <summary>
+		/// False only if the sphere is certainly behind the occluders.
+		/// </summary>
+		bool IsSphereVisible(float x, float y, float z, float radius);
+
+		uint32_t GetWidth() const;
+		uint32_t GetHeight() const;
+		size_t GetLevelCount() const;
+		const Stats& GetStats() const;
+		void ResetStats();
+
+	private:
+		// Clip-space w below which a point counts as behind the camera
+		static constexpr float MIN_CLIP_W{ 1e-5f };
+
+		struct Level
+		{
+			uint32_t width;
+			uint32_t height;
+			std::vector<float> depth;
+		};
+
+		const uint32_t m_width;
+		const uint32_t m_height;
+		float m_viewProjection[16]{};
+		float m_rowExtents[4]{};
+		std::vector<Level> m_levels;
+		Stats m_stats;
+
+		bool ProjectPoint(const float point[3], float& screenX, float& screenY, float& depth) const;
+		void RasterizeTriangle(const float screenX[3], const float screenY[3], float depth);
+	};
+}
\ No newline at end of file
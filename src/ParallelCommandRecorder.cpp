@@ -0,0 +1,79 @@
+#include "pch.h"
+#include "ParallelCommandRecorder.h"
+#include "JobSystem.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	ParallelCommandRecorder::ParallelCommandRecorder(
+		JobSystem* jobSystem,
+		uint32_t maxChunks,
+		size_t minItemsPerChunk
+	) :
+		m_jobSystem{ jobSystem },
+		m_maxChunks{ std::max<uint32_t>(maxChunks, 1) },
+		m_minItemsPerChunk{ std::max<size_t>(minItemsPerChunk, 1) }
+	{ }
+
+	std::pmr::vector<RecordRange> ParallelCommandRecorder::Partition(
+		size_t itemCount,
+		uint32_t maxChunks,
+		size_t minItemsPerChunk,
+		std::pmr::memory_resource* memory)
+	{
+		std::pmr::vector<RecordRange> ranges{ memory };
+		if (itemCount == 0)
+		{
+			return ranges;
+		}
+
+		minItemsPerChunk = std::max<size_t>(minItemsPerChunk, 1);
+		const size_t chunkCount{ std::clamp<size_t>(
+			itemCount / minItemsPerChunk,
+			1,
+			std::max<uint32_t>(maxChunks, 1)) };
+
+		// Spread the remainder over the first chunks so sizes differ by at most one
+		const size_t baseSize{ itemCount / chunkCount };
+		const size_t remainder{ itemCount % chunkCount };
+		ranges.reserve(chunkCount);
+		size_t begin{ 0 };
+		for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			const size_t size{ baseSize + ((chunk < remainder) ? 1 : 0) };
+			ranges.push_back(RecordRange{ begin, begin + size });
+			begin += size;
+		}
+		return ranges;
+	}
+
+	uint32_t ParallelCommandRecorder::Record(
+		ICommandListPool& pool,
+		size_t itemCount,
+		const std::function<void(uint32_t chunk, size_t begin, size_t end)>& record,
+		std::pmr::memory_resource* memory)
+	{
+		const std::pmr::vector<RecordRange> ranges{ Partition(itemCount, m_maxChunks, m_minItemsPerChunk, memory) };
+		auto recordChunks = [&pool, &ranges, &record](size_t begin, size_t end)
+		{
+			for (size_t chunk = begin; chunk < end; ++chunk)
+			{
+				const uint32_t chunkIndex{ static_cast<uint32_t>(chunk) };
+				pool.BeginChunk(chunkIndex);
+				record(chunkIndex, ranges[chunk].begin, ranges[chunk].end);
+				pool.EndChunk(chunkIndex);
+			}
+		};
+
+		if (m_jobSystem && (ranges.size() > 1))
+		{
+			m_jobSystem->ParallelFor(ranges.size(), 1, recordChunks);
+		}
+		else
+		{
+			recordChunks(0, ranges.size());
+		}
+		return static_cast<uint32_t>(ranges.size());
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <vector>
+
+namespace HelloTriangle
+{
+	class JobSystem;
+
+	/// <summary>
+	/// ICommandListPool supplies one command list per recording chunk. BeginChunk and
+	/// EndChunk are called from worker threads, but never concurrently for the same chunk.
+	/// </summary>
+	class ICommandListPool
+	{
+	public:
+		virtual void BeginChunk(uint32_t chunk) = 0;
+		virtual void EndChunk(uint32_t chunk) = 0;
+	};
+
+	struct RecordRange
+	{
+		size_t begin;
+		size_t end;
+	};
+
+	/// <summary>
+	/// ParallelCommandRecorder splits a frame's ordered draw items into contiguous
+	/// chunks and records each chunk into its own command list on the job system.
+	/// Chunk i always covers the i-th range, so submitting the chunk lists in index
+	/// order replays the items in their original order.
+	/// </summary>
+	class ParallelCommandRecorder
+	{
+	public:
+		ParallelCommandRecorder(JobSystem* jobSystem, uint32_t maxChunks, size_t minItemsPerChunk);
+
+		/// <summary>
+		/// Splits [0, itemCount) into at most maxChunks contiguous, near-equal ranges
+		/// of at least minItemsPerChunk items each (except when there are fewer items).
+		/// </summary>
+		static std::pmr::vector<RecordRange> Partition(
+			size_t itemCount,
+			uint32_t maxChunks,
+			size_t minItemsPerChunk,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+		/// <summary>
+		/// Records every item and returns the number of chunks used. Scratch data
+		/// for the call is allocated from memory, such as a frame arena.
+		/// </summary>
+		uint32_t Record(
+			ICommandListPool& pool,
+			size_t itemCount,
+			const std::function<void(uint32_t chunk, size_t begin, size_t end)>& record,
+			std::pmr::memory_resource* memory = std::pmr::get_default_resource());
+
+	private:
+		JobSystem* const m_jobSystem;
+		const uint32_t m_maxChunks;
+		const size_t m_minItemsPerChunk;
+	};
+}
\ No newline at end of file
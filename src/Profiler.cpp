@@ -0,0 +1,209 @@
+#include "pch.h"
+#include "IClock.h"
+#include "Profiler.h"
+
+#include <fstream>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		std::atomic<Profiler*> s_activeProfiler{ nullptr };
+		std::atomic<uint64_t> s_nextProfilerId{ 1 };
+
+		double ToMilliseconds(std::chrono::nanoseconds duration)
+		{
+			return std::chrono::duration<double, std::milli>(duration).count();
+		}
+
+		double ToMicroseconds(std::chrono::nanoseconds duration)
+		{
+			return std::chrono::duration<double, std::micro>(duration).count();
+		}
+
+		void WriteJsonString(std::ostream& stream, const char* text)
+		{
+			stream << '"';
+			for (const char* c = text; *c != '\0'; ++c)
+			{
+				if ((*c == '"') || (*c == '\\'))
+				{
+					stream << '\\';
+				}
+				stream << *c;
+			}
+			stream << '"';
+		}
+	}
+
+#pragma region Public
+	Profiler::Profiler(IClock* clock) :
+		m_clock{ clock },
+		m_startTime{ clock->Now() },
+		m_id{ s_nextProfilerId.fetch_add(1) },
+		m_lastFrameEnd{ m_startTime }
+	{ }
+
+	Profiler::~Profiler()
+	{
+		Profiler* self{ this };
+		s_activeProfiler.compare_exchange_strong(self, nullptr);
+	}
+
+	Profiler* Profiler::GetActive()
+	{
+		return s_activeProfiler.load(std::memory_order_acquire);
+	}
+
+	void Profiler::SetActive(Profiler* profiler)
+	{
+		s_activeProfiler.store(profiler, std::memory_order_release);
+	}
+
+	std::chrono::nanoseconds Profiler::Now()
+	{
+		return m_clock->Now();
+	}
+
+	void Profiler::RecordZone(
+		const char* name,
+		std::chrono::nanoseconds begin,
+		std::chrono::nanoseconds end)
+	{
+		ThreadBuffer& buffer{ GetThreadBuffer() };
+
+		// Only this thread writes count, so a relaxed load is enough; the release
+		// store publishes the zone to the exporting thread. Once the ring is full
+		// this overwrites the oldest zone.
+		const uint64_t index{ buffer.count.load(std::memory_order_relaxed) };
+		buffer.zones[index % ZONES_PER_THREAD] = ProfileZone{ name, begin, end };
+		buffer.count.store(index + 1, std::memory_order_release);
+	}
+
+	void Profiler::EndFrame()
+	{
+		const std::chrono::nanoseconds now{ m_clock->Now() };
+		m_frameTimes.Add(now - m_lastFrameEnd);
+		m_lastFrameEnd = now;
+	}
+
+	void Profiler::RecordGpuFrameTime(std::chrono::nanoseconds duration)
+	{
+		m_gpuFrameTimes.Add(duration);
+	}
+
+	FrameTimeStats Profiler::GetFrameStats() const
+	{
+		return m_frameTimes.GetStats();
+	}
+
+	FrameTimeStats Profiler::GetGpuFrameStats() const
+	{
+		return m_gpuFrameTimes.GetStats();
+	}
+
+	uint64_t Profiler::GetDroppedZoneCount() const
+	{
+		std::scoped_lock lock{ m_threadsMutex };
+		uint64_t dropped{ 0 };
+		for (const auto& buffer : m_threads)
+		{
+			dropped += buffer->GetDroppedCount();
+		}
+		return dropped;
+	}
+
+	bool Profiler::WriteChromeTrace(const std::filesystem::path& path) const
+	{
+		std::ofstream file{ path, std::ios::trunc };
+		if (!file)
+		{
+			spdlog::warn("Profiler: Couldn't open {} for writing.", path.string());
+			return false;
+		}
+
+		std::scoped_lock lock{ m_threadsMutex };
+		file << "{\"traceEvents\":[";
+		bool first{ true };
+		uint64_t dropped{ 0 };
+		for (const auto& buffer : m_threads)
+		{
+			// Oldest first, starting past whatever the ring has overwritten
+			const uint64_t count{ buffer->count.load(std::memory_order_acquire) };
+			const uint64_t oldest{ (count > ZONES_PER_THREAD) ? (count - ZONES_PER_THREAD) : 0 };
+			dropped += oldest;
+			for (uint64_t i = oldest; i < count; ++i)
+			{
+				const ProfileZone& zone{ buffer->zones[i % ZONES_PER_THREAD] };
+				file << (first ? "\n" : ",\n") << "{\"name\":";
+				WriteJsonString(file, zone.name);
+				file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex
+					<< ",\"ts\":" << ToMicroseconds(zone.begin - m_startTime)
+					<< ",\"dur\":" << ToMicroseconds(zone.end - zone.begin) << "}";
+				first = false;
+			}
+		}
+		file << "\n],\"otherData\":{\"droppedZones\":" << dropped << "}}\n";
+		return static_cast<bool>(file);
+	}
+#pragma endregion Public
+
+#pragma region Private
+	uint64_t Profiler::ThreadBuffer::GetDroppedCount() const
+	{
+		const uint64_t recorded{ count.load(std::memory_order_acquire) };
+		return (recorded > ZONES_PER_THREAD) ? (recorded - ZONES_PER_THREAD) : 0;
+	}
+
+	void Profiler::FrameTimeHistory::Add(std::chrono::nanoseconds duration)
+	{
+		m_durations[m_count % FRAME_HISTORY] = duration;
+		++m_count;
+	}
+
+	FrameTimeStats Profiler::FrameTimeHistory::GetStats() const
+	{
+		FrameTimeStats stats{ m_count, 0.0, 0.0, 0.0 };
+		const size_t sampleCount{ static_cast<size_t>(std::min<uint64_t>(m_count, FRAME_HISTORY)) };
+		if (sampleCount == 0)
+		{
+			return stats;
+		}
+
+		std::array<std::chrono::nanoseconds, FRAME_HISTORY> sorted{ m_durations };
+		std::sort(sorted.begin(), sorted.begin() + sampleCount);
+		auto percentile = [&sorted, sampleCount](double fraction)
+		{
+			const size_t rank{ static_cast<size_t>(fraction * static_cast<double>(sampleCount - 1) + 0.5) };
+			return ToMilliseconds(sorted[rank]);
+		};
+		stats.p50Milliseconds = percentile(0.50);
+		stats.p99Milliseconds = percentile(0.99);
+		stats.maxMilliseconds = ToMilliseconds(sorted[sampleCount - 1]);
+		return stats;
+	}
+
+	Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+	{
+		// Cached per thread; the id check catches a different profiler reusing a
+		// destroyed one's address.
+		thread_local ThreadBuffer* t_buffer{ nullptr };
+		thread_local uint64_t t_profilerId{ 0 };
+		if (t_profilerId == m_id)
+		{
+			return *t_buffer;
+		}
+
+		auto buffer{ std::make_unique<ThreadBuffer>() };
+		buffer->zones = std::make_unique<ProfileZone[]>(ZONES_PER_THREAD);
+		{
+			std::scoped_lock lock{ m_threadsMutex };
+			buffer->threadIndex = static_cast<uint32_t>(m_threads.size());
+			t_buffer = buffer.get();
+			m_threads.push_back(std::move(buffer));
+		}
+		t_profilerId = m_id;
+		return *t_buffer;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
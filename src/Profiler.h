@@ -0,0 +1,152 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define HELLOTRIANGLE_PROFILE_CONCAT_INNER(a, b) a##b
+#define HELLOTRIANGLE_PROFILE_CONCAT(a, b) HELLOTRIANGLE_PROFILE_CONCAT_INNER(a, b)
+
+/// Times the enclosing scope as a zone on the active profiler. name must be a
+/// string literal, since only the pointer is recorded.
+#define HELLOTRIANGLE_PROFILE_SCOPE(name) \
+	::HelloTriangle::ProfileScope HELLOTRIANGLE_PROFILE_CONCAT(profileScope, __LINE__){ name }
+
+namespace HelloTriangle
+{
+	class IClock;
+
+	struct ProfileZone
+	{
+		const char* name;
+		std::chrono::nanoseconds begin;
+		std::chrono::nanoseconds end;
+	};
+
+	struct FrameTimeStats
+	{
+		uint64_t frameCount;
+		double p50Milliseconds;
+		double p99Milliseconds;
+		double maxMilliseconds;
+	};
+
+	/// <summary>
+	/// Profiler collects scoped timing zones from any thread into per-thread buffers
+	/// and keeps rolling frame-time percentiles. Each thread appends only to its own
+	/// buffer, so recording a zone takes no locks; a lock is only taken the first
+	/// time a thread records. Each buffer is a ring holding the thread's latest
+	/// ZONES_PER_THREAD zones; older zones are overwritten and counted as dropped.
+	/// </summary>
+	class Profiler
+	{
+	public:
+		static constexpr size_t ZONES_PER_THREAD = 1 << 16;
+		static constexpr size_t FRAME_HISTORY = 256;
+
+		explicit Profiler(IClock* clock);
+		~Profiler();
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		/// <summary>
+		/// The profiler that ProfileScope records into, or nullptr to disable zones.
+		/// </summary>
+		static Profiler* GetActive();
+		static void SetActive(Profiler* profiler);
+
+		std::chrono::nanoseconds Now();
+		void RecordZone(const char* name, std::chrono::nanoseconds begin, std::chrono::nanoseconds end);
+
+		/// <summary>
+		/// Marks a frame boundary. Frame and GPU timing calls must all come from the
+		/// same thread.
+		/// </summary>
+		void EndFrame();
+		void RecordGpuFrameTime(std::chrono::nanoseconds duration);
+		FrameTimeStats GetFrameStats() const;
+		FrameTimeStats GetGpuFrameStats() const;
+		uint64_t GetDroppedZoneCount() const;
+
+		/// <summary>
+		/// Writes every zone still buffered in Chrome's trace event format, viewable in
+		/// chrome://tracing or Perfetto, with the dropped zone count under otherData.
+		/// Call once recording threads are idle.
+		/// </summary>
+		bool WriteChromeTrace(const std::filesystem::path& path) const;
+
+	private:
+		struct ThreadBuffer
+		{
+			uint32_t threadIndex{ 0 };
+			std::unique_ptr<ProfileZone[]> zones;
+
+			// Zones ever recorded; the latest is at (count - 1) % ZONES_PER_THREAD
+			std::atomic<uint64_t> count{ 0 };
+
+			uint64_t GetDroppedCount() const;
+		};
+
+		class FrameTimeHistory
+		{
+		public:
+			void Add(std::chrono::nanoseconds duration);
+			FrameTimeStats GetStats() const;
+
+		private:
+			std::array<std::chrono::nanoseconds, FRAME_HISTORY> m_durations{};
+			uint64_t m_count{ 0 };
+		};
+
+		IClock* const m_clock;
+		const std::chrono::nanoseconds m_startTime;
+		const uint64_t m_id;
+
+		mutable std::mutex m_threadsMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> m_threads;
+
+		std::chrono::nanoseconds m_lastFrameEnd;
+		FrameTimeHistory m_frameTimes;
+		FrameTimeHistory m_gpuFrameTimes;
+
+		ThreadBuffer& GetThreadBuffer();
+	};
+
+	/// <summary>
+	/// ProfileScope records its own lifetime as a zone on the active profiler.
+	/// </summary>
+	class ProfileScope
+	{
+	public:
+		explicit ProfileScope(const char* name) :
+			m_name{ name },
+			m_profiler{ Profiler::GetActive() }
+		{
+			if (m_profiler)
+			{
+				m_begin = m_profiler->Now();
+			}
+		}
+
+		~ProfileScope()
+		{
+			if (m_profiler)
+			{
+				m_profiler->RecordZone(m_name, m_begin, m_profiler->Now());
+			}
+		}
+
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		const char* const m_name;
+		Profiler* const m_profiler;
+		std::chrono::nanoseconds m_begin{ 0 };
+	};
+}
\ No newline at end of file
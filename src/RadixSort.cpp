@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "RadixSort.h"
+
+#include <array>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t DIGIT_BITS{ 8 };
+		constexpr size_t DIGIT_COUNT{ 64 / DIGIT_BITS };
+		constexpr size_t BUCKET_COUNT{ 1 << DIGIT_BITS };
+	}
+
+	void RadixSort(std::vector<RadixSortEntry>& entries, std::vector<RadixSortEntry>& scratch)
+	{
+		const size_t count{ entries.size() };
+		if (count < 2)
+		{
+			return;
+		}
+		scratch.resize(count);
+
+		std::array<std::array<uint32_t, BUCKET_COUNT>, DIGIT_COUNT> histograms{};
+		for (const RadixSortEntry& entry : entries)
+		{
+			for (size_t digit = 0; digit < DIGIT_COUNT; ++digit)
+			{
+				++histograms[digit][(entry.key >> (digit * DIGIT_BITS)) & (BUCKET_COUNT - 1)];
+			}
+		}
+
+		for (size_t digit = 0; digit < DIGIT_COUNT; ++digit)
+		{
+			std::array<uint32_t, BUCKET_COUNT>& histogram{ histograms[digit] };
+			const uint64_t firstBucket{ (entries[0].key >> (digit * DIGIT_BITS)) & (BUCKET_COUNT - 1) };
+			if (histogram[firstBucket] == count)
+			{
+				// Every key has the same digit; this pass wouldn't move anything
+				continue;
+			}
+
+			// Bucket counts become each bucket's first output slot
+			uint32_t offset{ 0 };
+			for (uint32_t& bucket : histogram)
+			{
+				const uint32_t bucketCount{ bucket };
+				bucket = offset;
+				offset += bucketCount;
+			}
+
+			for (const RadixSortEntry& entry : entries)
+			{
+				scratch[histogram[(entry.key >> (digit * DIGIT_BITS)) & (BUCKET_COUNT - 1)]++] = entry;
+			}
+			entries.swap(scratch);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// RadixSortEntry is a 64-bit key with a 32-bit payload, typically the index of
+	/// the item the key was made for.
+	/// </summary>
+	struct RadixSortEntry
+	{
+		uint64_t key;
+		uint32_t value;
+	};
+
+	/// <summary>
+	/// Sorts entries by key, keeping equal keys in their original order. This is an
+	/// LSD radix sort over 8-bit digits: one pass builds every digit's histogram,
+	/// then each digit that isn't the same for all keys costs one scatter pass.
+	/// Sort keys usually leave most high bits constant, so few passes run.
+	/// scratch is resized as needed and keeps its capacity across calls.
+	/// </summary>
+	void RadixSort(std::vector<RadixSortEntry>& entries, std::vector<RadixSortEntry>& scratch);
+}
\ No newline at end of file
@@ -0,0 +1,313 @@
+#include "pch.h"
+#include "RenderGraph.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		uint64_t AlignUp(uint64_t value, uint64_t alignment)
+		{
+			return ((value + alignment - 1) / alignment) * alignment;
+		}
+	}
+
+#pragma region Public
+	RenderResourceHandle RenderGraph::ImportResource(
+		std::string name,
+		ResourceState initialState,
+		ResourceState finalState)
+	{
+		m_isCompiled = false;
+		Resource& resource{ AddResource() };
+		resource.name = std::move(name);
+		resource.isImported = true;
+		resource.initialState = initialState;
+		resource.finalState = finalState;
+		return m_resourceCount - 1;
+	}
+
+	RenderResourceHandle RenderGraph::CreateTransient(
+		std::string name,
+		uint64_t sizeBytes,
+		uint64_t alignment)
+	{
+		m_isCompiled = false;
+		Resource& resource{ AddResource() };
+		resource.name = std::move(name);
+		resource.sizeBytes = sizeBytes;
+		resource.alignment = std::max<uint64_t>(alignment, 1);
+		return m_resourceCount - 1;
+	}
+
+	uint32_t RenderGraph::AddPass(std::string name, std::function<void()> execute)
+	{
+		m_isCompiled = false;
+		if (m_passCount == m_passes.size())
+		{
+			m_passes.emplace_back();
+		}
+
+		// Reuse the slot in place so its vectors keep their capacity
+		Pass& pass{ m_passes[m_passCount++] };
+		pass.name = std::move(name);
+		pass.execute = std::move(execute);
+		pass.accesses.clear();
+		pass.hasSideEffects = false;
+		pass.isCulled = false;
+		pass.barriers.clear();
+		return m_passCount - 1;
+	}
+
+	void RenderGraph::Read(uint32_t pass, RenderResourceHandle resource, ResourceState state)
+	{
+		assert((pass < m_passCount) && (resource < m_resourceCount));
+		m_isCompiled = false;
+		m_passes[pass].accesses.push_back(Access{ resource, state, false });
+	}
+
+	void RenderGraph::Write(uint32_t pass, RenderResourceHandle resource, ResourceState state)
+	{
+		assert((pass < m_passCount) && (resource < m_resourceCount));
+		m_isCompiled = false;
+		m_passes[pass].accesses.push_back(Access{ resource, state, true });
+	}
+
+	void RenderGraph::SetSideEffects(uint32_t pass)
+	{
+		assert(pass < m_passCount);
+		m_isCompiled = false;
+		m_passes[pass].hasSideEffects = true;
+	}
+
+	void RenderGraph::Compile()
+	{
+		m_stats = RenderGraphStats{};
+		m_stats.declaredPassCount = m_passCount;
+
+		CullPasses();
+		PlaceBarriers();
+		AliasTransients();
+		m_isCompiled = true;
+	}
+
+	void RenderGraph::Execute(IRenderBackend& backend)
+	{
+		if (!m_isCompiled)
+		{
+			Compile();
+		}
+
+		for (uint32_t p = 0; p < m_passCount; ++p)
+		{
+			const Pass& pass{ m_passes[p] };
+			if (pass.isCulled)
+			{
+				continue;
+			}
+
+			backend.BeginPass(pass.name);
+			for (const Barrier& barrier : pass.barriers)
+			{
+				backend.ResourceBarrier(barrier.resource, barrier.before, barrier.after);
+			}
+			if (pass.execute)
+			{
+				pass.execute();
+			}
+			backend.EndPass();
+		}
+
+		for (const Barrier& barrier : m_finalBarriers)
+		{
+			backend.ResourceBarrier(barrier.resource, barrier.before, barrier.after);
+		}
+	}
+
+	void RenderGraph::Reset()
+	{
+		m_resourceCount = 0;
+		m_passCount = 0;
+		m_finalBarriers.clear();
+		m_stats = RenderGraphStats{};
+		m_isCompiled = false;
+	}
+
+	const RenderGraphStats& RenderGraph::GetStats() const
+	{
+		return m_stats;
+	}
+
+	uint64_t RenderGraph::GetHeapOffset(RenderResourceHandle resource) const
+	{
+		assert(resource < m_resourceCount);
+		return m_resources[resource].heapOffset;
+	}
+#pragma endregion Public
+
+#pragma region Private
+	RenderGraph::Resource& RenderGraph::AddResource()
+	{
+		if (m_resourceCount == m_resources.size())
+		{
+			m_resources.emplace_back();
+		}
+
+		Resource& resource{ m_resources[m_resourceCount++] };
+		resource.isImported = false;
+		resource.initialState = ResourceState::Undefined;
+		resource.finalState = ResourceState::Undefined;
+		resource.sizeBytes = 0;
+		resource.alignment = 1;
+		return resource;
+	}
+
+	void RenderGraph::CullPasses()
+	{
+		// Walk backwards from the outputs: imported resources are observed outside the
+		// graph, and anything a surviving pass reads is needed by it.
+		std::vector<uint8_t>& isNeeded{ m_isResourceNeeded };
+		isNeeded.resize(m_resourceCount);
+		for (uint32_t r = 0; r < m_resourceCount; ++r)
+		{
+			isNeeded[r] = m_resources[r].isImported;
+		}
+
+		for (uint32_t p = m_passCount; p-- > 0;)
+		{
+			Pass& pass{ m_passes[p] };
+			bool isKept{ pass.hasSideEffects };
+			for (const Access& access : pass.accesses)
+			{
+				if (access.isWrite && isNeeded[access.resource])
+				{
+					isKept = true;
+				}
+			}
+
+			pass.isCulled = !isKept;
+			if (pass.isCulled)
+			{
+				++m_stats.culledPassCount;
+				continue;
+			}
+
+			for (const Access& access : pass.accesses)
+			{
+				if (!access.isWrite)
+				{
+					isNeeded[access.resource] = true;
+				}
+			}
+		}
+	}
+
+	void RenderGraph::PlaceBarriers()
+	{
+		std::vector<ResourceState>& currentStates{ m_currentStates };
+		currentStates.resize(m_resourceCount);
+		for (uint32_t r = 0; r < m_resourceCount; ++r)
+		{
+			currentStates[r] = m_resources[r].initialState;
+			m_resources[r].firstPass = std::numeric_limits<uint32_t>::max();
+			m_resources[r].lastPass = 0;
+		}
+
+		for (uint32_t p = 0; p < m_passCount; ++p)
+		{
+			Pass& pass{ m_passes[p] };
+			pass.barriers.clear();
+			if (pass.isCulled)
+			{
+				continue;
+			}
+
+			for (const Access& access : pass.accesses)
+			{
+				Resource& resource{ m_resources[access.resource] };
+				resource.firstPass = std::min(resource.firstPass, p);
+				resource.lastPass = std::max(resource.lastPass, p);
+
+				// Transient contents are undefined on first use, so there is
+				// nothing to transition from.
+				ResourceState& current{ currentStates[access.resource] };
+				if ((current != access.state) && (current != ResourceState::Undefined))
+				{
+					pass.barriers.push_back(Barrier{ access.resource, current, access.state });
+					++m_stats.barrierCount;
+				}
+				current = access.state;
+			}
+		}
+
+		m_finalBarriers.clear();
+		for (RenderResourceHandle r = 0; r < m_resourceCount; ++r)
+		{
+			const Resource& resource{ m_resources[r] };
+			if (resource.isImported &&
+				(resource.finalState != ResourceState::Undefined) &&
+				(currentStates[r] != resource.finalState))
+			{
+				m_finalBarriers.push_back(Barrier{ r, currentStates[r], resource.finalState });
+				++m_stats.barrierCount;
+			}
+		}
+	}
+
+	void RenderGraph::AliasTransients()
+	{
+		std::vector<RenderResourceHandle>& transients{ m_transients };
+		transients.clear();
+		for (RenderResourceHandle r = 0; r < m_resourceCount; ++r)
+		{
+			const Resource& resource{ m_resources[r] };
+			if (!resource.isImported && (resource.firstPass <= resource.lastPass))
+			{
+				transients.push_back(r);
+				m_stats.transientBytes += resource.sizeBytes;
+			}
+		}
+
+		// Place the largest resources first; each one goes at the lowest offset that
+		// doesn't overlap a placed resource whose lifetime intersects its own.
+		std::sort(transients.begin(), transients.end(),
+			[this](RenderResourceHandle a, RenderResourceHandle b)
+			{
+				return m_resources[a].sizeBytes > m_resources[b].sizeBytes;
+			});
+
+		std::vector<RenderResourceHandle>& placed{ m_placedTransients };
+		std::vector<std::pair<uint64_t, uint64_t>>& occupied{ m_occupiedRanges };
+		placed.clear();
+		for (RenderResourceHandle r : transients)
+		{
+			Resource& resource{ m_resources[r] };
+
+			occupied.clear();
+			for (RenderResourceHandle other : placed)
+			{
+				const Resource& o{ m_resources[other] };
+				if ((o.firstPass <= resource.lastPass) && (resource.firstPass <= o.lastPass))
+				{
+					occupied.emplace_back(o.heapOffset, o.heapOffset + o.sizeBytes);
+				}
+			}
+			std::sort(occupied.begin(), occupied.end());
+
+			uint64_t offset{ 0 };
+			for (const auto& [begin, end] : occupied)
+			{
+				if ((AlignUp(offset, resource.alignment) + resource.sizeBytes) <= begin)
+				{
+					break;
+				}
+				offset = std::max(offset, end);
+			}
+			resource.heapOffset = AlignUp(offset, resource.alignment);
+			placed.push_back(r);
+
+			m_stats.aliasedHeapBytes =
+				std::max(m_stats.aliasedHeapBytes, resource.heapOffset + resource.sizeBytes);
+		}
+	}
+#pragma endregion Private
+}
\ No newline at end of file
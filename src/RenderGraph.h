@@ -0,0 +1,162 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace HelloTriangle
+{
+	enum class ResourceState : uint8_t
+	{
+		Undefined,
+		Present,
+		RenderTarget,
+		DepthWrite,
+		ShaderRead,
+		UnorderedAccess,
+		CopySource,
+		CopyDest,
+	};
+
+	using RenderResourceHandle = uint32_t;
+	constexpr RenderResourceHandle INVALID_RENDER_RESOURCE{ std::numeric_limits<uint32_t>::max() };
+
+	/// <summary>
+	/// IRenderBackend receives the compiled command stream of a RenderGraph. Backends
+	/// map graph resources onto API objects; the graph itself never touches an API.
+	/// </summary>
+	class IRenderBackend
+	{
+	public:
+		virtual void BeginPass(const std::string& name) = 0;
+		virtual void ResourceBarrier(
+			RenderResourceHandle resource,
+			ResourceState before,
+			ResourceState after) = 0;
+		virtual void EndPass() = 0;
+	};
+
+	/// <summary>
+	/// RenderGraphStats describes the result of the most recent Compile().
+	/// </summary>
+	struct RenderGraphStats
+	{
+		uint32_t declaredPassCount{ 0 };
+		uint32_t culledPassCount{ 0 };
+		uint32_t barrierCount{ 0 };
+		uint64_t transientBytes{ 0 };
+		uint64_t aliasedHeapBytes{ 0 };
+	};
+
+	/// <summary>
+	/// RenderGraph collects the passes of a frame along with the resources each pass
+	/// reads and writes. Compiling the graph culls passes that don't contribute to an
+	/// output, places the state transitions each pass needs, and packs transient
+	/// resources with disjoint lifetimes into shared heap memory.
+	/// Passes execute in declaration order.
+	/// </summary>
+	class RenderGraph
+	{
+	public:
+		/// <summary>
+		/// Adds an externally owned resource, such as a swap chain buffer. The graph
+		/// transitions it back to finalState at the end of the frame.
+		/// </summary>
+		RenderResourceHandle ImportResource(
+			std::string name,
+			ResourceState initialState,
+			ResourceState finalState);
+
+		/// <summary>
+		/// Adds a resource that only lives for the duration of the frame.
+		/// </summary>
+		RenderResourceHandle CreateTransient(std::string name, uint64_t sizeBytes, uint64_t alignment);
+
+		uint32_t AddPass(std::string name, std::function<void()> execute);
+		void Read(uint32_t pass, RenderResourceHandle resource, ResourceState state);
+		void Write(uint32_t pass, RenderResourceHandle resource, ResourceState state);
+
+		/// <summary>
+		/// Keeps a pass even if nothing reads what it writes.
+		/// </summary>
+		void SetSideEffects(uint32_t pass);
+
+		void Compile();
+		void Execute(IRenderBackend& backend);
+
+		/// <summary>
+		/// Discards all passes and resources. Pass and resource slots, and the
+		/// compile scratch, keep their capacity so a graph rebuilt every frame
+		/// stops allocating once it has seen its largest frame.
+		/// </summary>
+		void Reset();
+
+		const RenderGraphStats& GetStats() const;
+		uint64_t GetHeapOffset(RenderResourceHandle resource) const;
+
+	private:
+		struct Resource
+		{
+			std::string name;
+			bool isImported{ false };
+			ResourceState initialState{ ResourceState::Undefined };
+			ResourceState finalState{ ResourceState::Undefined };
+			uint64_t sizeBytes{ 0 };
+			uint64_t alignment{ 1 };
+
+			// Filled in by Compile()
+			uint32_t firstPass{ std::numeric_limits<uint32_t>::max() };
+			uint32_t lastPass{ 0 };
+			uint64_t heapOffset{ 0 };
+		};
+
+		struct Access
+		{
+			RenderResourceHandle resource;
+			ResourceState state;
+			bool isWrite;
+		};
+
+		struct Barrier
+		{
+			RenderResourceHandle resource;
+			ResourceState before;
+			ResourceState after;
+		};
+
+		struct Pass
+		{
+			std::string name;
+			std::function<void()> execute;
+			std::vector<Access> accesses{};
+			bool hasSideEffects{ false };
+
+			// Filled in by Compile()
+			bool isCulled{ false };
+			std::vector<Barrier> barriers{};
+		};
+
+		// Slots past the counts are kept from earlier frames for reuse
+		std::vector<Resource> m_resources;
+		uint32_t m_resourceCount{ 0 };
+		std::vector<Pass> m_passes;
+		uint32_t m_passCount{ 0 };
+		std::vector<Barrier> m_finalBarriers;
+
+		// Compile scratch
+		std::vector<uint8_t> m_isResourceNeeded;
+		std::vector<ResourceState> m_currentStates;
+		std::vector<RenderResourceHandle> m_transients;
+		std::vector<RenderResourceHandle> m_placedTransients;
+		std::vector<std::pair<uint64_t, uint64_t>> m_occupiedRanges;
+		RenderGraphStats m_stats;
+		bool m_isCompiled{ false };
+
+		Resource& AddResource();
+		void CullPasses();
+		void PlaceBarriers();
+		void AliasTransients();
+	};
+}
\ No newline at end of file
@@ -1,7 +1,16 @@
 #include "pch.h"
 #include "Renderer.h"
+#include "D3D12PipelineStateHash.h"
+#include "D3D12VertexLayout.h"
+#include "D3DShaderCompiler.h"
+#include "Hash.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "ShaderSource.h"
 #include "Window.h"
 
+#include <fstream>
+
 namespace HelloTriangle
 {
 #pragma region Public
@@ -9,16 +18,28 @@ namespace HelloTriangle
 		Window* window,
 		uint32_t width,
 		uint32_t height,
-		bool useWarpDevice
+		bool useWarpDevice,
+		uint32_t framesInFlight,
+		JobSystem* jobSystem
 	) : 
 		m_window{ window },
+		m_useWarpDevice{ useWarpDevice },
+		m_framesInFlight{ std::clamp<uint32_t>(framesInFlight, 1, MAX_FRAMES_IN_FLIGHT) },
 		m_width{ width },
 		m_height{ height },
 		m_aspectRatio{ static_cast<float>(width) / static_cast<float>(height) },
-		m_useWarpDevice{ useWarpDevice },
 		m_viewport{ 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height) },
-		m_scissorRect{ 0, 0, static_cast<long>(width), static_cast<long> (height) }
-	{ }
+		m_scissorRect{ 0, 0, static_cast<long>(width), static_cast<long> (height) },
+		m_commandRecorder{
+			jobSystem,
+			jobSystem ? std::min(jobSystem->GetThreadCount(), MAX_RECORDING_CHUNKS) : 1,
+			MIN_DRAWS_PER_CHUNK
+		},
+		m_frameArena{ FRAME_ARENA_BYTES }
+	{
+		m_camera.SetLookAt({ 0.0f, 0.0f, -CAMERA_DISTANCE }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+		m_camera.SetPerspective(CAMERA_FIELD_OF_VIEW, m_aspectRatio, CAMERA_NEAR_PLANE, CAMERA_FAR_PLANE);
+	}
 
 	void Renderer::Initialize()
 	{
@@ -28,26 +49,89 @@ namespace HelloTriangle
 
 	void Renderer::Render()
 	{
+		m_frameArena.Reset();
+
+		// Only blocks if the GPU is still using this frame context's resources,
+		// so recording this frame overlaps execution of the previous ones.
+		{
+			HELLOTRIANGLE_PROFILE_SCOPE("Renderer::WaitForFrame");
+			m_frameContext = m_framePacer->BeginFrame();
+		}
+		m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+		m_shaderDescriptorHeap->GetAllocator().Retire(m_framePacer->GetCompletedFenceValue());
+		m_constantRing->Retire(m_framePacer->GetCompletedFenceValue());
+		ReadGpuFrameTime();
+
+		// The hello triangle itself is always drawn, alongside anything submitted
+		m_drawBatcher.Submit(0, m_triangleMesh, InstanceData{ { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } });
+		m_drawBatcher.Build();
+		m_batchingTotals.Add(m_drawBatcher.GetStats());
+		WriteInstanceData();
+		WriteFrameConstants();
+
+		// Meshes uploaded since the last frame must land before anything draws them
+		m_meshStore->Flush(m_commandQueue.Get());
+
 		// Record all the commands we need to render the scene into the command list.
 		PopulateCommandList();
 
-		// Execute the command list.
-		ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
-		m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+		// Execute the command lists in recording order with a single submission.
+		m_submitCommandLists.clear();
+		m_submitCommandLists.push_back(m_commandList.Get());
+		for (uint32_t chunk = 0; chunk < m_recordedChunkCount; ++chunk)
+		{
+			m_submitCommandLists.push_back(m_commandListPool->GetCommandList(chunk));
+		}
+		m_submitCommandLists.push_back(m_postCommandList.Get());
+		m_commandQueue->ExecuteCommandLists(
+			static_cast<uint32_t>(m_submitCommandLists.size()),
+			m_submitCommandLists.data());
 
 		// Present the frame.
-		ThrowIfFailed(m_swapChain->Present(1, 0));
+		{
+			HELLOTRIANGLE_PROFILE_SCOPE("Renderer::Present");
+			ThrowIfFailed(m_swapChain->Present(1, 0));
+		}
+
+		const uint64_t frameFenceValue{ m_framePacer->EndFrame() };
+		m_shaderDescriptorHeap->GetAllocator().FinishFrame(frameFenceValue);
+		m_constantRing->FinishFrame(frameFenceValue);
+		m_drawBatcher.Reset();
+	}
 
-		WaitForPreviousFrame();
+	DrawBatcher& Renderer::GetDrawBatcher()
+	{
+		return m_drawBatcher;
+	}
+
+	Camera& Renderer::GetCamera()
+	{
+		return m_camera;
+	}
+
+	IMeshUploadSink& Renderer::GetMeshUploadSink()
+	{
+		return *m_meshStore;
+	}
+
+	DrawStateTracker::Stats Renderer::GetStateChangeStats() const
+	{
+		return DrawStateTracker::Stats{
+			.issuedCount = m_stateChangesIssued.load(std::memory_order_relaxed),
+			.avoidedCount = m_stateChangesAvoided.load(std::memory_order_relaxed) };
+	}
+
+	const DrawBatchingTotals& Renderer::GetBatchingTotals() const
+	{
+		return m_batchingTotals;
 	}
 
 	void Renderer::OnDestroy()
 	{
 		// Ensure that the GPU is no longer referencing resources that are about to be
 		// cleaned up by the destructor.
-		WaitForPreviousFrame();
-
-		CloseHandle(m_fenceEvent);
+		m_framePacer->WaitForIdle();
+		m_uploadManager->WaitForIdle();
 	}
 #pragma endregion Public
 
@@ -72,6 +156,7 @@ namespace HelloTriangle
 		if (m_useWarpDevice)
 		{
 			MWRL::ComPtr<IDXGIAdapter> warpAdapter;
+			ThrowIfFailed(factory->EnumWarpAdapter(IID_PPV_ARGS(&warpAdapter)));
 			ThrowIfFailed(D3D12CreateDevice(
 				warpAdapter.Get(),
 				D3D_FEATURE_LEVEL_11_0,
@@ -93,6 +178,7 @@ namespace HelloTriangle
 		queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
 		queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
 		ThrowIfFailed(m_d3dDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_commandQueue)));
+		CreateTimestampQueries();
 
 		DXGI_SWAP_CHAIN_DESC1 swapChainDesc{};
 		swapChainDesc.BufferCount = NUM_FRAMES;
@@ -119,49 +205,83 @@ namespace HelloTriangle
 		m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
 
 		// Create descriptor heaps
+		m_rtvHeap = std::make_unique<D3D12DescriptorHeap>(
+			m_d3dDevice.Get(),
+			D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+			NUM_FRAMES,
+			0,
+			false);
+		m_shaderDescriptorHeap = std::make_unique<D3D12DescriptorHeap>(
+			m_d3dDevice.Get(),
+			D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+			PERSISTENT_SHADER_DESCRIPTORS,
+			TRANSIENT_SHADER_DESCRIPTORS,
+			true);
+
+		// Create frame resources
+		for (uint32_t n = 0; n < NUM_FRAMES; ++n)
 		{
-			D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc{};
-			rtvHeapDesc.NumDescriptors = NUM_FRAMES;
-			rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-			rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-			ThrowIfFailed(m_d3dDevice->CreateDescriptorHeap(
-				&rtvHeapDesc,
-				IID_PPV_ARGS(&m_rtvHeap)
-			));
-			m_rtvDescriptorSize = 
-				m_d3dDevice->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+			ThrowIfFailed(m_swapChain->GetBuffer(n, IID_PPV_ARGS(&m_renderTargets[n])));
+			m_rtvIndices[n] = m_rtvHeap->GetAllocator().AllocatePersistent(1);
+			m_d3dDevice->CreateRenderTargetView(
+				m_renderTargets[n].Get(),
+				nullptr,
+				m_rtvHeap->GetCpuHandle(m_rtvIndices[n]));
 		}
 
-		// Create frame resources
+		// Each frame in flight records into its own allocator, since an allocator
+		// can't be reset until the GPU has finished with its commands.
+		for (uint32_t n = 0; n < m_framesInFlight; ++n)
 		{
-			CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle
-			{
-				m_rtvHeap->GetCPUDescriptorHandleForHeapStart()
-			};
-			for (uint32_t n = 0; n < NUM_FRAMES; ++n)
-			{
-				ThrowIfFailed(m_swapChain->GetBuffer(n, IID_PPV_ARGS(&m_renderTargets[n])));
-				m_d3dDevice->CreateRenderTargetView(m_renderTargets[n].Get(), nullptr, rtvHandle);
-				rtvHandle.Offset(1, m_rtvDescriptorSize);
-			}
+			ThrowIfFailed(m_d3dDevice->CreateCommandAllocator(
+				D3D12_COMMAND_LIST_TYPE_DIRECT,
+				IID_PPV_ARGS(&m_commandAllocators[n])
+			));
 		}
 
-		ThrowIfFailed(m_d3dDevice->CreateCommandAllocator(
-			D3D12_COMMAND_LIST_TYPE_DIRECT,
-			IID_PPV_ARGS(&m_commandAllocator)
-		));
+		m_fence = std::make_unique<D3D12Fence>(m_d3dDevice.Get(), m_commandQueue.Get());
+		m_uploadManager = std::make_unique<UploadManager>(m_d3dDevice.Get(), UPLOAD_STAGING_CAPACITY);
+		m_meshStore = std::make_unique<D3D12MeshStore>(m_uploadManager.get());
+		m_framePacer = std::make_unique<FramePacer>(m_fence.get(), m_framesInFlight);
 	}
 
 	void Renderer::LoadAssets()
 	{
-		// Create an empty root signature
+		const auto loadStart{ std::chrono::steady_clock::now() };
+		const std::filesystem::path cacheDirectory{ GetExecutableDirectory() };
+		if (!m_shaderArchive.Load(cacheDirectory / "Shaders.archive"))
+		{
+			spdlog::warn("Renderer: No shader archive from the build; shaders will be compiled at runtime.");
+		}
+		m_shaderCache.Load(cacheDirectory / "Shaders.cache");
+		m_pipelineCache.Load(cacheDirectory / "Pipelines.cache");
+
+		// Create the root signature
 		// "describes the parameters that are passed to the various programmable shader stages
 		// of the rendering pipeline."
+		// Frame constants are bound as a root CBV into the constant ring; per-draw
+		// and per-mesh constants are small enough to live in the root signature itself.
 		{
+			std::array<CD3DX12_ROOT_PARAMETER, 3> rootParameters;
+			rootParameters[ROOT_PARAMETER_FRAME_CONSTANTS].InitAsConstantBufferView(
+				0,
+				0,
+				D3D12_SHADER_VISIBILITY_VERTEX);
+			rootParameters[ROOT_PARAMETER_DRAW_CONSTANTS].InitAsConstants(
+				DRAW_CONSTANT_COUNT,
+				1,
+				0,
+				D3D12_SHADER_VISIBILITY_VERTEX);
+			rootParameters[ROOT_PARAMETER_MESH_CONSTANTS].InitAsConstants(
+				MESH_CONSTANT_COUNT,
+				2,
+				0,
+				D3D12_SHADER_VISIBILITY_VERTEX);
+
 			CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
 			rootSignatureDesc.Init(
-				0,
-				nullptr,
+				static_cast<uint32_t>(rootParameters.size()),
+				rootParameters.data(),
 				0,
 				nullptr,
 				D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT
@@ -176,6 +296,7 @@ namespace HelloTriangle
 				&signature,
 				&error
 			));
+			m_rootSignatureHash = HashBytes(signature->GetBufferPointer(), signature->GetBufferSize());
 			ThrowIfFailed(m_d3dDevice->CreateRootSignature(
 				0,
 				signature->GetBufferPointer(),
@@ -184,62 +305,57 @@ namespace HelloTriangle
 			));
 		}
 
-		// Create the pipeline state, which includes compiling and loading shaders
+		// Create the pipeline states, which includes compiling and loading shaders.
+		// Compressed meshes get their own pipeline, which differs only in the
+		// vertex shader and the mesh vertices' layout.
 		{
 			Microsoft::WRL::ComPtr<ID3DBlob> vertexShader;
+			Microsoft::WRL::ComPtr<ID3DBlob> compressedVertexShader;
 			Microsoft::WRL::ComPtr<ID3DBlob> pixelShader;
 
-			uint32_t compileFlags{ 0 };
-#ifdef _DEBUG
-			compileFlags |= (D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION);
-#endif
-
-			ThrowIfFailed(D3DCompileFromFile(
-				L"C:\\Users\\Hayden\\Source\\HelloTriangle\\x64\\Debug\\shaders.hlsl",
-				nullptr,
-				nullptr,
-				"VSMain",
-				"vs_5_0",
-				compileFlags,
-				0,
-				&vertexShader,
-				nullptr
-			));
-
-			ThrowIfFailed(D3DCompileFromFile(
-				L"C:\\Users\\Hayden\\Source\\HelloTriangle\\x64\\Debug\\shaders.hlsl",
-				nullptr,
-				nullptr,
-				"PSMain",
-				"ps_5_0",
-				compileFlags,
-				0,
-				&pixelShader,
-				nullptr
-			));
+			const uint32_t compileFlags{ GetShaderCompileFlags() };
+			const std::filesystem::path shaderPath{ GetExecutableDirectory() / "Shaders.hlsl" };
+			vertexShader = LoadShader(shaderPath, VERTEX_SHADER, compileFlags);
+			compressedVertexShader = LoadShader(shaderPath, COMPRESSED_VERTEX_SHADER, compileFlags);
+			pixelShader = LoadShader(shaderPath, PIXEL_SHADER, compileFlags);
 
-			// Define the vertex input layout.
-			std::array<D3D12_INPUT_ELEMENT_DESC, 2> inputElementDescs
+			// Define the vertex input layouts. Slot 0 carries mesh vertices, slot 1
+			// carries one InstanceData per instance.
+			const std::array<D3D12_INPUT_ELEMENT_DESC, 2> instanceElementDescs
 			{{
 				{
-					"POSITION",
-					0,
-					DXGI_FORMAT_R32G32B32_FLOAT,
+					"INSTANCE_TRANSFORM",
 					0,
+					DXGI_FORMAT_R32G32B32A32_FLOAT,
+					1,
 					0,
-					D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-					0
+					D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA,
+					1
 				},
 				{
-					"COLOR",
+					"INSTANCE_COLOR",
 					0,
 					DXGI_FORMAT_R32G32B32A32_FLOAT,
-					0,
-					12,
-					D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
-					0
+					1,
+					16,
+					D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA,
+					1
 				}
 			}};
+			std::vector<D3D12_INPUT_ELEMENT_DESC> inputElementDescs;
+			AppendD3D12InputElements(VERTEX_LAYOUT.data(), VERTEX_LAYOUT.size(), 0, inputElementDescs);
+			inputElementDescs.insert(inputElementDescs.end(), instanceElementDescs.begin(), instanceElementDescs.end());
+
+			std::vector<D3D12_INPUT_ELEMENT_DESC> compressedInputElementDescs;
+			AppendD3D12InputElements(
+				COMPRESSED_VERTEX_LAYOUT.data(),
+				COMPRESSED_VERTEX_LAYOUT.size(),
+				0,
+				compressedInputElementDescs);
+			compressedInputElementDescs.insert(
+				compressedInputElementDescs.end(),
+				instanceElementDescs.begin(),
+				instanceElementDescs.end());
 
 			D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{ 0 };
 			psoDesc.InputLayout =
@@ -259,17 +375,34 @@ namespace HelloTriangle
 			psoDesc.NumRenderTargets = 1;
 			psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
 			psoDesc.SampleDesc.Count = 1;
-			ThrowIfFailed(m_d3dDevice->CreateGraphicsPipelineState(
-				&psoDesc,
-				IID_PPV_ARGS(&m_pipelineState)
-			));
+			CreatePipelineState(psoDesc, m_pipelineState);
+
+			psoDesc.InputLayout =
+			{
+				compressedInputElementDescs.data(),
+				static_cast<uint32_t>(compressedInputElementDescs.size())
+			};
+			psoDesc.VS = CD3DX12_SHADER_BYTECODE{ compressedVertexShader.Get() };
+			CreatePipelineState(psoDesc, m_compressedPipelineState);
 		}
 
+		if (m_shaderCache.IsDirty())
+		{
+			m_shaderCache.Save(cacheDirectory / "Shaders.cache");
+		}
+		if (m_pipelineCache.IsDirty())
+		{
+			m_pipelineCache.Save(cacheDirectory / "Pipelines.cache");
+		}
+		spdlog::info(
+			"Renderer: Shaders and pipeline state ready in {:.2f}ms.",
+			std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count());
+
 		// Create the command list
 		ThrowIfFailed(m_d3dDevice->CreateCommandList(
 			0,
 			D3D12_COMMAND_LIST_TYPE_DIRECT,
-			m_commandAllocator.Get(),
+			m_commandAllocators[0].Get(),
 			nullptr,
 			IID_PPV_ARGS(&m_commandList)
 		));
@@ -278,158 +411,413 @@ namespace HelloTriangle
 		// to record yet. The main loop expects it to be closed, so close it now.
 		ThrowIfFailed(m_commandList->Close());
 
-		// Create the vertex buffer
+		// The post list records whatever the graph emits after the draws, such as
+		// the back buffer's transition back to Present.
+		ThrowIfFailed(m_d3dDevice->CreateCommandList(
+			0,
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			m_commandAllocators[0].Get(),
+			nullptr,
+			IID_PPV_ARGS(&m_postCommandList)
+		));
+		ThrowIfFailed(m_postCommandList->Close());
+
+		m_commandListPool = std::make_unique<D3D12CommandListPool>(
+			m_d3dDevice.Get(),
+			m_framesInFlight,
+			MAX_RECORDING_CHUNKS);
+
+		// Create the built-in triangle mesh. Streamed meshes go through the same
+		// mesh store.
+		{
+			// Define the geometry for a triangle. The camera's projection corrects
+			// for the aspect ratio, so the vertices are in plain world units.
+			MeshData triangle;
+			triangle.vertices =
+			{
+				{ { 0.0f, 0.25f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+				{ { 0.25f, -0.25f, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+				{ { -0.25f, -0.25f, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+			};
+			triangle.indices = { 0, 1, 2 };
+			m_triangleMesh = m_meshStore->UploadMesh(triangle);
+		}
+
+		// Create per-frame instance buffers. Instance data changes every frame, so it
+		// is written straight into persistently mapped upload memory, one buffer per
+		// frame in flight so the CPU never overwrites data the GPU is reading.
 		{
-			// Define the geometry for a triangle
-			std::array<Vertex, 3> triangleVertices
-			{ {
-				{ { 0.0f, 0.25f * m_aspectRatio, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
-				{ { 0.25f, -0.25f * m_aspectRatio, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
-				{ { -0.25f, -0.25f * m_aspectRatio, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
-			} };
-			const uint32_t vertexBufferSize = 
-				static_cast<uint32_t>(triangleVertices.size() * sizeof(Vertex));
-
-			// Note: using upload heaps to transfer static data like vert buffers is not 
-			// recommended. Every time the GPU needs it, the upload heap will be marshalled 
-			// over. Please read up on Default Heap usage. An upload heap is used here for 
-			// code simplicity and because there are very few verts to actually transfer.
-			CD3DX12_HEAP_PROPERTIES vertexHeap{ D3D12_HEAP_TYPE_UPLOAD };
-			CD3DX12_RESOURCE_DESC bufferResource{ CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize) };
+			CD3DX12_HEAP_PROPERTIES uploadHeap{ D3D12_HEAP_TYPE_UPLOAD };
+			CD3DX12_RESOURCE_DESC bufferResource{
+				CD3DX12_RESOURCE_DESC::Buffer(MAX_INSTANCES * sizeof(InstanceData))
+			};
+			for (uint32_t n = 0; n < m_framesInFlight; ++n)
+			{
+				ThrowIfFailed(m_d3dDevice->CreateCommittedResource(
+					&uploadHeap,
+					D3D12_HEAP_FLAG_NONE,
+					&bufferResource,
+					D3D12_RESOURCE_STATE_GENERIC_READ,
+					nullptr,
+					IID_PPV_ARGS(&m_instanceBuffers[n])
+				));
+				CD3DX12_RANGE readRange{ 0, 0 }; // No intention to read on CPU
+				ThrowIfFailed(m_instanceBuffers[n]->Map(
+					0,
+					&readRange,
+					reinterpret_cast<void**>(&m_instanceData[n])
+				));
+			}
+			m_drawBatcher.Reserve(MAX_INSTANCES);
+		}
+
+		// Create the constant buffer ring. One mapped buffer serves every frame in
+		// flight; allocations are fenced rather than split per frame context.
+		{
+			CD3DX12_HEAP_PROPERTIES uploadHeap{ D3D12_HEAP_TYPE_UPLOAD };
+			CD3DX12_RESOURCE_DESC bufferResource{ CD3DX12_RESOURCE_DESC::Buffer(CONSTANT_RING_CAPACITY) };
 			ThrowIfFailed(m_d3dDevice->CreateCommittedResource(
-				&vertexHeap,
+				&uploadHeap,
 				D3D12_HEAP_FLAG_NONE,
 				&bufferResource,
 				D3D12_RESOURCE_STATE_GENERIC_READ,
 				nullptr,
-				IID_PPV_ARGS(&m_vertexBuffer)
+				IID_PPV_ARGS(&m_constantBuffer)
 			));
-
-			// Copy triangle data to vertex buffer
-			uint8_t* vertexDataBegin;
 			CD3DX12_RANGE readRange{ 0, 0 }; // No intention to read on CPU
-			ThrowIfFailed(m_vertexBuffer->Map(
+			uint8_t* constantData{ nullptr };
+			ThrowIfFailed(m_constantBuffer->Map(
 				0,
 				&readRange,
-				reinterpret_cast<void**>(&vertexDataBegin)
+				reinterpret_cast<void**>(&constantData)
 			));
-			memcpy(
-				vertexDataBegin,
-				triangleVertices.data(),
-				(triangleVertices.size() * sizeof(Vertex))
-			);
-			m_vertexBuffer->Unmap(0, nullptr);
-
-			// Initialize vertex buffer view
-			m_vertexBufferView.BufferLocation = m_vertexBuffer->GetGPUVirtualAddress();
-			m_vertexBufferView.StrideInBytes = sizeof(Vertex);
-			m_vertexBufferView.SizeInBytes = vertexBufferSize;
+			m_constantRing = std::make_unique<ConstantBufferRing>(
+				constantData,
+				m_constantBuffer->GetGPUVirtualAddress(),
+				CONSTANT_RING_CAPACITY);
 		}
 
-		// Create synchronization objects and wait until assets are uploaded to GPU
-		{
-			ThrowIfFailed(m_d3dDevice->CreateFence(
-				0,
-				D3D12_FENCE_FLAG_NONE,
-				IID_PPV_ARGS(&m_fence)
-			));
-			m_fenceValue = 1;
-
-			// Create an event handle for frame synchronization
-			m_fenceEvent = CreateEventW(nullptr, false, false, nullptr);
-			if (m_fenceEvent == nullptr)
-			{
-				ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
-			}
-
-			WaitForPreviousFrame();
-		}
+		// Rendering must not start until the copies land; have the direct queue
+		// wait on the copy queue rather than blocking the CPU.
+		m_meshStore->Flush(m_commandQueue.Get());
 
+		// Wait until assets are uploaded to GPU
+		m_framePacer->WaitForIdle();
 	}
 
 	void Renderer::PopulateCommandList()
 	{
+		HELLOTRIANGLE_PROFILE_SCOPE("Renderer::PopulateCommandList");
+
 		// Command list allocators can only be reset when the associated 
-		// command lists have finished execution on the GPU; apps should use 
-		// fences to determine GPU execution progress.
-		ThrowIfFailed(m_commandAllocator->Reset());
+		// command lists have finished execution on the GPU; the frame pacer has
+		// already waited for this frame context's previous use to retire.
+		ID3D12CommandAllocator* commandAllocator{ m_commandAllocators[m_frameContext].Get() };
+		ThrowIfFailed(commandAllocator->Reset());
+		m_commandListPool->SetFrameContext(m_frameContext, m_pipelineState.Get());
 
 		// However, when ExecuteCommandList() is called on a particular command 
 		// list, that command list can then be reset at any time and must be before 
 		// re-recording.
-		ThrowIfFailed(m_commandList->Reset(m_commandAllocator.Get(), m_pipelineState.Get()));
-
-		// Set necessary state
-		m_commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-		m_commandList->RSSetViewports(1, &m_viewport);
-		m_commandList->RSSetScissorRects(1, &m_scissorRect);
-
-		// Indicate that the back buffer will be used as a render target.
-		CD3DX12_RESOURCE_BARRIER renderTransition{
-			CD3DX12_RESOURCE_BARRIER::Transition(
-				m_renderTargets[m_frameIndex].Get(),
-				D3D12_RESOURCE_STATE_PRESENT,
-				D3D12_RESOURCE_STATE_RENDER_TARGET
-			)
-		};
-		m_commandList->ResourceBarrier(
-			1,
-			&renderTransition
-		);
-
-		CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle{
-			m_rtvHeap->GetCPUDescriptorHandleForHeapStart(),
-			static_cast<int32_t>(m_frameIndex),
-			m_rtvDescriptorSize
-		};
-		m_commandList->OMSetRenderTargets(1, &rtvHandle, false, nullptr);
+		ThrowIfFailed(m_commandList->Reset(commandAllocator, m_pipelineState.Get()));
+		const uint32_t firstTimestamp{ m_frameContext * 2 };
+		m_commandList->EndQuery(m_timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, firstTimestamp);
+
+		// Build this frame's graph. The graph places the back buffer's
+		// Present <-> RenderTarget transitions around the passes that use it.
+		m_renderGraph.Reset();
+		m_renderBackend.ClearBindings();
+		m_renderBackend.SetCommandList(m_commandList.Get());
+
+		const RenderResourceHandle backBuffer{ m_renderGraph.ImportResource(
+			"BackBuffer",
+			ResourceState::Present,
+			ResourceState::Present
+		) };
+		m_renderBackend.BindResource(backBuffer, m_renderTargets[m_frameIndex].Get());
+
+		const uint32_t mainPass{ m_renderGraph.AddPass("Main", [this]() { RecordMainPass(); }) };
+		m_renderGraph.Write(mainPass, backBuffer, ResourceState::RenderTarget);
+
+		m_renderGraph.Compile();
+		m_renderGraph.Execute(m_renderBackend);
+
+		m_postCommandList->EndQuery(m_timestampQueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, firstTimestamp + 1);
+		m_postCommandList->ResolveQueryData(
+			m_timestampQueryHeap.Get(),
+			D3D12_QUERY_TYPE_TIMESTAMP,
+			firstTimestamp,
+			2,
+			m_timestampReadback.Get(),
+			firstTimestamp * sizeof(uint64_t));
+		m_timestampPending[m_frameContext] = true;
+
+		ThrowIfFailed(m_postCommandList->Close());
+	}
+
+	void Renderer::RecordMainPass()
+	{
+		const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ m_rtvHeap->GetCpuHandle(m_rtvIndices[m_frameIndex]) };
 
 		// Record commands.
 		const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
 		m_commandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
-		m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		m_commandList->IASetVertexBuffers(0, 1, &m_vertexBufferView);
-		m_commandList->DrawInstanced(3, 1, 0, 0);
 
-		// Indicate that the back buffer will now be used to present.
-		CD3DX12_RESOURCE_BARRIER presentTransition
+		// The draws go into chunk lists recorded on worker threads, so everything
+		// the graph records after this pass must land in a list submitted after
+		// them. The allocator is free again once m_commandList is closed. The
+		// backend ends the pass's event on m_commandList before it closes and
+		// begins it again on m_postCommandList.
+		m_renderBackend.SetCommandList(nullptr);
+		ThrowIfFailed(m_commandList->Close());
+		m_recordedChunkCount = m_commandRecorder.Record(
+			*m_commandListPool,
+			m_drawBatcher.GetBatches().size(),
+			[this](uint32_t chunk, size_t begin, size_t end)
+			{
+				HELLOTRIANGLE_PROFILE_SCOPE("Renderer::RecordChunk");
+				D3D12StateTrackingCommandList commandList{ m_commandListPool->GetCommandList(chunk) };
+				SetDrawState(commandList);
+				RecordDraws(commandList, begin, end);
+
+				const DrawStateTracker::Stats& stats{ commandList.GetStats() };
+				m_stateChangesIssued.fetch_add(stats.issuedCount, std::memory_order_relaxed);
+				m_stateChangesAvoided.fetch_add(stats.avoidedCount, std::memory_order_relaxed);
+			},
+			&m_frameArena);
+
+		ThrowIfFailed(m_postCommandList->Reset(m_commandAllocators[m_frameContext].Get(), nullptr));
+		m_renderBackend.SetCommandList(m_postCommandList.Get());
+	}
+
+	void Renderer::SetDrawState(D3D12StateTrackingCommandList& commandList)
+	{
+		// Command lists don't inherit state from each other, so each chunk sets
+		// up the per-frame draw state before recording its draws.
+		const D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle{ m_rtvHeap->GetCpuHandle(m_rtvIndices[m_frameIndex]) };
+		commandList.RSSetViewport(m_viewport);
+		commandList.RSSetScissorRect(m_scissorRect);
+		commandList.OMSetRenderTarget(rtvHandle);
+		commandList.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		commandList.IASetVertexBuffer(1, m_instanceBufferViews[m_frameContext]);
+	}
+
+	void Renderer::RecordDraws(D3D12StateTrackingCommandList& commandList, size_t firstBatch, size_t endBatch)
+	{
+		// One draw per batch; StartInstanceLocation selects the batch's slice of
+		// the instance stream, and root constants carry the batch's material.
+		// Every batch states everything it needs and the tracker drops what is
+		// already set; batches are sorted by state, so most of it is.
+		const std::vector<DrawBatch>& batches{ m_drawBatcher.GetBatches() };
+		for (size_t batchIndex = firstBatch; batchIndex < endBatch; ++batchIndex)
 		{
-			CD3DX12_RESOURCE_BARRIER::Transition(
-				m_renderTargets[m_frameIndex].Get(),
-				D3D12_RESOURCE_STATE_RENDER_TARGET,
-				D3D12_RESOURCE_STATE_PRESENT
-			)
+			const DrawBatch& batch{ batches[batchIndex] };
+			if (batch.firstInstance >= m_instanceCount)
+			{
+				break;
+			}
+			const D3D12MeshStore::Mesh* mesh{ m_meshStore->GetMesh(batch.mesh) };
+			if (!mesh)
+			{
+				continue;
+			}
+
+			// The pipeline follows the mesh's vertex format; there is a single root
+			// signature so far, which every batch's root signature index refers to
+			commandList.SetPipelineState(
+				mesh->isCompressed ? m_compressedPipelineState.Get() : m_pipelineState.Get());
+			commandList.SetGraphicsRootSignature(m_rootSignature.Get());
+			commandList.SetGraphicsRootConstantBufferView(ROOT_PARAMETER_FRAME_CONSTANTS, m_frameConstantsAddress);
+			commandList.IASetVertexBuffer(0, mesh->vertexBufferView);
+			commandList.IASetIndexBuffer(mesh->indexBufferView);
+
+			const uint32_t instanceCount{
+				std::min(batch.instanceCount, m_instanceCount - batch.firstInstance)
+			};
+			const DrawConstants& drawConstants{
+				MATERIAL_DRAW_CONSTANTS[batch.material % MATERIAL_DRAW_CONSTANTS.size()]
+			};
+			commandList.SetGraphicsRoot32BitConstants(
+				ROOT_PARAMETER_DRAW_CONSTANTS,
+				DRAW_CONSTANT_COUNT,
+				&drawConstants,
+				0);
+			if (mesh->isCompressed)
+			{
+				commandList.SetGraphicsRoot32BitConstants(
+					ROOT_PARAMETER_MESH_CONSTANTS,
+					MESH_CONSTANT_COUNT,
+					&mesh->meshConstants,
+					0);
+			}
+			commandList.DrawIndexedInstanced(mesh->indexCount, instanceCount, 0, 0, batch.firstInstance);
+		}
+	}
+
+	void Renderer::CreateTimestampQueries()
+	{
+		ThrowIfFailed(m_commandQueue->GetTimestampFrequency(&m_timestampFrequency));
+
+		D3D12_QUERY_HEAP_DESC queryHeapDesc{};
+		queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+		queryHeapDesc.Count = MAX_FRAMES_IN_FLIGHT * 2;
+		ThrowIfFailed(m_d3dDevice->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&m_timestampQueryHeap)));
+
+		const CD3DX12_HEAP_PROPERTIES readbackHeapProperties{ D3D12_HEAP_TYPE_READBACK };
+		const CD3DX12_RESOURCE_DESC readbackDesc{
+			CD3DX12_RESOURCE_DESC::Buffer(queryHeapDesc.Count * sizeof(uint64_t))
 		};
-		m_commandList->ResourceBarrier(
-			1,
-			&presentTransition
-		);
+		ThrowIfFailed(m_d3dDevice->CreateCommittedResource(
+			&readbackHeapProperties,
+			D3D12_HEAP_FLAG_NONE,
+			&readbackDesc,
+			D3D12_RESOURCE_STATE_COPY_DEST,
+			nullptr,
+			IID_PPV_ARGS(&m_timestampReadback)
+		));
 
-		ThrowIfFailed(m_commandList->Close());
+		// Readback memory stays mapped; a frame context's values are only read
+		// after the frame pacer has seen the GPU retire it.
+		void* timestampData{ nullptr };
+		ThrowIfFailed(m_timestampReadback->Map(0, nullptr, &timestampData));
+		m_timestampData = static_cast<const uint64_t*>(timestampData);
 	}
 
-	void Renderer::WaitForPreviousFrame()
+	void Renderer::ReadGpuFrameTime()
 	{
-		// WAITING FOR THE FRAME TO COMPLETE BEFORE CONTINUING IS NOT BEST PRACTICE.
-		// This is code implemented as such for simplicity. The D3D12HelloFrameBuffering
-		// sample illustrates how to use fences for efficient resource usage and to
-		// maximize GPU utilization.
-
-		// Signal and increment the fence value.
-		const UINT64 fence = m_fenceValue;
-		ThrowIfFailed(m_commandQueue->Signal(m_fence.Get(), fence));
-		m_fenceValue++;
-
-		// Wait until the previous frame is finished.
-		if (m_fence->GetCompletedValue() < fence)
+		Profiler* profiler{ Profiler::GetActive() };
+		if (!m_timestampPending[m_frameContext] || !profiler || (m_timestampFrequency == 0))
 		{
-			ThrowIfFailed(m_fence->SetEventOnCompletion(fence, m_fenceEvent));
-			WaitForSingleObject(m_fenceEvent, INFINITE);
+			return;
 		}
+		m_timestampPending[m_frameContext] = false;
 
-		m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+		const uint64_t begin{ m_timestampData[m_frameContext * 2] };
+		const uint64_t end{ m_timestampData[(m_frameContext * 2) + 1] };
+		if (end > begin)
+		{
+			profiler->RecordGpuFrameTime(std::chrono::nanoseconds{
+				static_cast<int64_t>(static_cast<double>(end - begin) * 1e9 / static_cast<double>(m_timestampFrequency))
+			});
+		}
+	}
+
+	void Renderer::WriteInstanceData()
+	{
+		const std::vector<InstanceData>& instances{ m_drawBatcher.GetInstances() };
+		m_instanceCount = static_cast<uint32_t>(std::min<size_t>(instances.size(), MAX_INSTANCES));
+		if (m_instanceCount < instances.size())
+		{
+			spdlog::warn(
+				"Renderer: Dropping {} instances over the {} instance limit.",
+				instances.size() - m_instanceCount,
+				MAX_INSTANCES);
+		}
+		memcpy(m_instanceData[m_frameContext], instances.data(), m_instanceCount * sizeof(InstanceData));
+
+		D3D12_VERTEX_BUFFER_VIEW& view{ m_instanceBufferViews[m_frameContext] };
+		view.BufferLocation = m_instanceBuffers[m_frameContext]->GetGPUVirtualAddress();
+		view.StrideInBytes = sizeof(InstanceData);
+		view.SizeInBytes = std::max<uint32_t>(m_instanceCount, 1) * sizeof(InstanceData);
+	}
+
+	void Renderer::WriteFrameConstants()
+	{
+		FrameConstants constants{};
+		const Camera::Matrix& viewProjection{ m_camera.GetViewProjection() };
+		std::copy(viewProjection.begin(), viewProjection.end(), constants.viewProjection);
+
+		const ConstantBufferRing::Allocation allocation{ m_constantRing->Push(constants) };
+		if (!allocation.cpuAddress)
+		{
+			// Frames retire before their context is reused, so this only happens if
+			// the ring is too small for the frames in flight.
+			spdlog::error(
+				"Renderer: Constant buffer ring is full ({} of {} bytes in use).",
+				m_constantRing->GetUsedBytes(),
+				m_constantRing->GetCapacity());
+			throw std::exception{};
+		}
+		m_frameConstantsAddress = allocation.gpuAddress;
+	}
+
+	MWRL::ComPtr<ID3DBlob> Renderer::LoadShader(
+		const std::filesystem::path& sourcePath,
+		const ShaderEntryPoint& entryPoint,
+		uint32_t compileFlags)
+	{
+		std::ifstream file{ sourcePath, std::ios::binary };
+		if (!file)
+		{
+			spdlog::error("Renderer: Could not open shader source '{}'.", sourcePath.string());
+			throw std::exception{};
+		}
+		const std::string source{
+			std::istreambuf_iterator<char>{ file },
+			std::istreambuf_iterator<char>{}
+		};
+
+		// The build compiles every entry point into the shader archive. It only
+		// misses when the installed source no longer matches what was built, and
+		// then the runtime cache saves compiling again on the next launch.
+		const uint64_t key{ ComputeShaderKey(source, sourcePath, entryPoint, compileFlags) };
+		MWRL::ComPtr<ID3DBlob> bytecode;
+		const std::vector<uint8_t>* archived{ m_shaderArchive.Find(key) };
+		if (archived == nullptr)
+		{
+			archived = m_shaderCache.Find(key);
+		}
+		if (archived != nullptr)
+		{
+			ThrowIfFailed(D3DCreateBlob(archived->size(), &bytecode));
+			memcpy(bytecode->GetBufferPointer(), archived->data(), archived->size());
+			return bytecode;
+		}
+
+		spdlog::warn(
+			"Renderer: Shader archive is stale for {} ({}), compiling at runtime.",
+			entryPoint.name,
+			entryPoint.target);
+		bytecode = CompileShader(source, sourcePath, entryPoint, compileFlags);
+		m_shaderCache.Set(key, bytecode->GetBufferPointer(), bytecode->GetBufferSize());
+		return bytecode;
 	}
-	
+
+	void Renderer::CreatePipelineState(
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc,
+		MWRL::ComPtr<ID3D12PipelineState>& pipelineState)
+	{
+		const uint64_t key{ HashPipelineStateDesc(psoDesc, m_rootSignatureHash) };
+
+		if (const std::vector<uint8_t>* cached{ m_pipelineCache.Find(key) })
+		{
+			psoDesc.CachedPSO = { cached->data(), cached->size() };
+			if (SUCCEEDED(m_d3dDevice->CreateGraphicsPipelineState(
+				&psoDesc,
+				IID_PPV_ARGS(&pipelineState))))
+			{
+				psoDesc.CachedPSO = {};
+				return;
+			}
+
+			// Cached blobs are tied to the adapter and driver; rebuild if they changed
+			spdlog::info("Renderer: Cached pipeline state was rejected, rebuilding...");
+			psoDesc.CachedPSO = {};
+			m_pipelineCache.Erase(key);
+		}
+
+		ThrowIfFailed(m_d3dDevice->CreateGraphicsPipelineState(
+			&psoDesc,
+			IID_PPV_ARGS(&pipelineState)
+		));
+
+		MWRL::ComPtr<ID3DBlob> cachedBlob;
+		if (SUCCEEDED(pipelineState->GetCachedBlob(&cachedBlob)))
+		{
+			m_pipelineCache.Set(key, cachedBlob->GetBufferPointer(), cachedBlob->GetBufferSize());
+		}
+	}
+
 	void Renderer::GetHardwareAdapter(
 		IDXGIFactory1* pFactory,
 		IDXGIAdapter1** ppAdapter,
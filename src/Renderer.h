@@ -1,10 +1,31 @@
 #pragma once
 #include "pch.h"
+#include "BlobArchive.h"
+#include "Camera.h"
+#include "ConstantBufferRing.h"
+#include "D3D12CommandListPool.h"
+#include "D3D12DescriptorHeap.h"
+#include "D3D12Fence.h"
+#include "D3D12MeshStore.h"
+#include "D3D12RenderBackend.h"
+#include "D3D12StateTrackingCommandList.h"
+#include "DrawBatcher.h"
+#include "FrameArena.h"
+#include "FramePacer.h"
+#include "MeshFile.h"
+#include "ParallelCommandRecorder.h"
+#include "RenderGraph.h"
+#include "ShaderConstants.h"
+#include "ShaderSource.h"
+#include "UploadManager.h"
+#include "Vertex.h"
 #include <DirectXMath.h>
+#include <atomic>
 #include <memory>
 
 namespace HelloTriangle
 {
+	class JobSystem;
 	class Window;
 
 	class Renderer
@@ -14,24 +35,79 @@ namespace HelloTriangle
 			Window* window,
 			uint32_t width,
 			uint32_t height,
-			bool useWarpDevice = false
+			bool useWarpDevice = false,
+			uint32_t framesInFlight = 2,
+			JobSystem* jobSystem = nullptr
 		);
 
 		void Initialize();
+
+		/// <summary>
+		/// Renders a frame from the instances submitted to the DrawBatcher, which are
+		/// already interpolated between simulation ticks.
+		/// </summary>
 		void Render();
+
+		/// <summary>
+		/// Instances submitted here are drawn by the next Render call.
+		/// </summary>
+		DrawBatcher& GetDrawBatcher();
+
+		/// <summary>
+		/// The camera's view-projection is streamed to the shaders every frame.
+		/// </summary>
+		Camera& GetCamera();
+
+		/// <summary>
+		/// Meshes uploaded here can be drawn by mesh index from the next Render call.
+		/// </summary>
+		IMeshUploadSink& GetMeshUploadSink();
+
+		/// <summary>
+		/// Draw-state calls recorded and dropped as redundant, over all frames.
+		/// </summary>
+		DrawStateTracker::Stats GetStateChangeStats() const;
+
+		/// <summary>
+		/// Draws submitted, draw calls they were batched into and the time spent
+		/// batching them, over all frames.
+		/// </summary>
+		const DrawBatchingTotals& GetBatchingTotals() const;
 		void OnDestroy();
 
 	private:
 		static constexpr int NUM_FRAMES = 2;
+		static constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+		static constexpr uint64_t UPLOAD_STAGING_CAPACITY = 4 * 1024 * 1024;
+		static constexpr uint32_t MAX_INSTANCES = 65536;
+		static constexpr uint32_t MAX_RECORDING_CHUNKS = 8;
+		static constexpr size_t MIN_DRAWS_PER_CHUNK = 64;
+		static constexpr size_t FRAME_ARENA_BYTES = 64 * 1024;
+		static constexpr uint32_t PERSISTENT_SHADER_DESCRIPTORS = 4096;
+		static constexpr uint32_t TRANSIENT_SHADER_DESCRIPTORS = 4096;
+		static constexpr uint64_t CONSTANT_RING_CAPACITY = 64 * 1024;
+		static constexpr uint32_t ROOT_PARAMETER_FRAME_CONSTANTS = 0;
+		static constexpr uint32_t ROOT_PARAMETER_DRAW_CONSTANTS = 1;
+		static constexpr uint32_t ROOT_PARAMETER_MESH_CONSTANTS = 2;
 
-		struct Vertex
-		{
-			DirectX::XMFLOAT3 position;
-			DirectX::XMFLOAT4 color;
-		};
+		// Camera defaults: the z = 0 plane spans [-1, 1] vertically, like clip space
+		static constexpr float CAMERA_DISTANCE = 2.0f;
+		static constexpr float CAMERA_FIELD_OF_VIEW = 0.927295218f; // 2 * atan(0.5)
+		static constexpr float CAMERA_NEAR_PLANE = 0.1f;
+		static constexpr float CAMERA_FAR_PLANE = 100.0f;
+
+		// Per-draw root constants, indexed by batch material
+		static constexpr std::array<DrawConstants, 4> MATERIAL_DRAW_CONSTANTS
+		{ {
+			{ { 1.0f, 1.0f, 1.0f, 1.0f } },
+			{ { 1.0f, 0.5f, 0.5f, 1.0f } },
+			{ { 0.5f, 1.0f, 0.5f, 1.0f } },
+			{ { 0.5f, 0.5f, 1.0f, 1.0f } },
+		} };
 
 		Window* const m_window;
 		const bool m_useWarpDevice;
+		const uint32_t m_framesInFlight;
 
 		// Viewport dimensions
 		uint32_t m_width{ 0 };
@@ -44,28 +120,92 @@ namespace HelloTriangle
 		Microsoft::WRL::ComPtr<ID3D12Device> m_d3dDevice;
 		Microsoft::WRL::ComPtr<IDXGISwapChain4> m_swapChain;
 		std::array<Microsoft::WRL::ComPtr<ID3D12Resource>, NUM_FRAMES> m_renderTargets;
-		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_commandAllocator;
+		std::array<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>, MAX_FRAMES_IN_FLIGHT> m_commandAllocators;
 		Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_commandQueue;
 		Microsoft::WRL::ComPtr<ID3D12RootSignature> m_rootSignature;
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
 		Microsoft::WRL::ComPtr<ID3D12PipelineState> m_pipelineState;
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> m_compressedPipelineState;
 		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_commandList;
-		uint32_t m_rtvDescriptorSize{ 0 };
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_postCommandList;
+
+		// Descriptors. Render target views are persistent; the shader-visible heap
+		// also has a per-frame ring for transient descriptor tables.
+		std::unique_ptr<D3D12DescriptorHeap> m_rtvHeap;
+		std::array<uint32_t, NUM_FRAMES> m_rtvIndices{};
+		std::unique_ptr<D3D12DescriptorHeap> m_shaderDescriptorHeap;
+
+		// Shader bytecode compiled at build time, read-only
+		BlobArchive m_shaderArchive;
+
+		// Compiled shader bytecode and pipeline state persisted across launches
+		BlobArchive m_shaderCache;
+		BlobArchive m_pipelineCache;
+		uint64_t m_rootSignatureHash{ 0 };
+
+		// Frame graph, rebuilt every frame
+		RenderGraph m_renderGraph;
+		D3D12RenderBackend m_renderBackend;
+
+		// Draws are recorded in parallel into chunk command lists, which are
+		// submitted between m_commandList and m_postCommandList
+		ParallelCommandRecorder m_commandRecorder;
+		LinearArena m_frameArena;
+		std::unique_ptr<D3D12CommandListPool> m_commandListPool;
+		std::vector<ID3D12CommandList*> m_submitCommandLists;
+		uint32_t m_recordedChunkCount{ 0 };
+		std::atomic<uint64_t> m_stateChangesIssued{ 0 };
+		std::atomic<uint64_t> m_stateChangesAvoided{ 0 };
 
 		// Resources
-		Microsoft::WRL::ComPtr<ID3D12Resource> m_vertexBuffer;
-		D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView{ 0 };
+		std::unique_ptr<UploadManager> m_uploadManager;
+		std::unique_ptr<D3D12MeshStore> m_meshStore;
+		uint32_t m_triangleMesh{ IMeshUploadSink::INVALID_MESH };
+
+		// Per-instance data, rewritten every frame
+		DrawBatcher m_drawBatcher;
+		DrawBatchingTotals m_batchingTotals;
+		std::array<Microsoft::WRL::ComPtr<ID3D12Resource>, MAX_FRAMES_IN_FLIGHT> m_instanceBuffers;
+		std::array<uint8_t*, MAX_FRAMES_IN_FLIGHT> m_instanceData{};
+		std::array<D3D12_VERTEX_BUFFER_VIEW, MAX_FRAMES_IN_FLIGHT> m_instanceBufferViews{};
+		uint32_t m_instanceCount{ 0 };
+
+		// Per-frame constants, streamed through one persistently mapped upload
+		// buffer and reclaimed as the frame pacer's fence values complete
+		Camera m_camera;
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_constantBuffer;
+		std::unique_ptr<ConstantBufferRing> m_constantRing;
+		D3D12_GPU_VIRTUAL_ADDRESS m_frameConstantsAddress{ 0 };
 
 		// Synchronization
 		uint32_t m_frameIndex{ 0 };
-		HANDLE m_fenceEvent{ nullptr };
-		Microsoft::WRL::ComPtr<ID3D12Fence> m_fence;
-		uint64_t m_fenceValue{ 0 };
+		uint32_t m_frameContext{ 0 };
+		std::unique_ptr<D3D12Fence> m_fence;
+		std::unique_ptr<FramePacer> m_framePacer;
+
+		// GPU frame timing, from timestamps at the start and end of each frame context
+		Microsoft::WRL::ComPtr<ID3D12QueryHeap> m_timestampQueryHeap;
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_timestampReadback;
+		const uint64_t* m_timestampData{ nullptr };
+		uint64_t m_timestampFrequency{ 0 };
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> m_timestampPending{};
 
 		void LoadPipeline();
 		void LoadAssets();
 		void PopulateCommandList();
-		void WaitForPreviousFrame();
+		void RecordMainPass();
+		void SetDrawState(D3D12StateTrackingCommandList& commandList);
+		void RecordDraws(D3D12StateTrackingCommandList& commandList, size_t firstBatch, size_t endBatch);
+		void WriteInstanceData();
+		void WriteFrameConstants();
+		void CreateTimestampQueries();
+		void ReadGpuFrameTime();
+		Microsoft::WRL::ComPtr<ID3DBlob> LoadShader(
+			const std::filesystem::path& sourcePath,
+			const ShaderEntryPoint& entryPoint,
+			uint32_t compileFlags);
+		void CreatePipelineState(
+			D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc,
+			Microsoft::WRL::ComPtr<ID3D12PipelineState>& pipelineState);
 
 		void GetHardwareAdapter(
 			IDXGIFactory1* pFactory,
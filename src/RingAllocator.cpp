@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "RingAllocator.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		uint64_t AlignUp(uint64_t value, uint64_t alignment)
+		{
+			return ((value + alignment - 1) / alignment) * alignment;
+		}
+	}
+
+#pragma region Public
+	RingAllocator::RingAllocator(
+		uint64_t capacity
+	) :
+		m_capacity{ capacity }
+	{ }
+
+	uint64_t RingAllocator::Allocate(uint64_t size, uint64_t alignment)
+	{
+		alignment = std::max<uint64_t>(alignment, 1);
+		if ((size == 0) || (size > m_capacity))
+		{
+			return INVALID_OFFSET;
+		}
+
+		if (m_usedBytes == 0)
+		{
+			// Nothing is outstanding, so start over for the largest contiguous span
+			m_head = 0;
+			m_tail = 0;
+		}
+		else if (m_usedBytes == m_capacity)
+		{
+			return INVALID_OFFSET;
+		}
+
+		uint64_t offset{ INVALID_OFFSET };
+		uint64_t consumed{ 0 };
+		if (m_head >= m_tail)
+		{
+			// Free space is [head, capacity) followed by [0, tail)
+			const uint64_t aligned{ AlignUp(m_head, alignment) };
+			if ((aligned + size) <= m_capacity)
+			{
+				offset = aligned;
+				consumed = (aligned + size) - m_head;
+			}
+			else if (size <= m_tail)
+			{
+				// Wrap around; the unused end of the buffer is retired with this batch
+				offset = 0;
+				consumed = (m_capacity - m_head) + size;
+			}
+		}
+		else
+		{
+			// Free space is [head, tail)
+			const uint64_t aligned{ AlignUp(m_head, alignment) };
+			if ((aligned + size) <= m_tail)
+			{
+				offset = aligned;
+				consumed = (aligned + size) - m_head;
+			}
+		}
+
+		if (offset == INVALID_OFFSET)
+		{
+			return INVALID_OFFSET;
+		}
+
+		m_head = offset + size;
+		if (m_head == m_capacity)
+		{
+			m_head = 0;
+		}
+		m_usedBytes += consumed;
+		m_openBatchBytes += consumed;
+		return offset;
+	}
+
+	void RingAllocator::FinishBatch(uint64_t fenceValue)
+	{
+		if (m_openBatchBytes == 0)
+		{
+			return;
+		}
+		m_pendingBatches.push_back(Batch{ fenceValue, m_head, m_openBatchBytes });
+		m_openBatchBytes = 0;
+	}
+
+	void RingAllocator::Retire(uint64_t completedFenceValue)
+	{
+		while (!m_pendingBatches.empty() &&
+			(m_pendingBatches.front().fenceValue <= completedFenceValue))
+		{
+			const Batch& batch{ m_pendingBatches.front() };
+			m_tail = batch.end;
+			m_usedBytes -= batch.size;
+			m_pendingBatches.pop_front();
+		}
+	}
+
+	uint64_t RingAllocator::GetOldestPendingFenceValue() const
+	{
+		return m_pendingBatches.empty() ? 0 : m_pendingBatches.front().fenceValue;
+	}
+
+	uint64_t RingAllocator::GetCapacity() const
+	{
+		return m_capacity;
+	}
+
+	uint64_t RingAllocator::GetUsedBytes() const
+	{
+		return m_usedBytes;
+	}
+
+	bool RingAllocator::HasOpenAllocations() const
+	{
+		return (m_openBatchBytes > 0);
+	}
+#pragma endregion Public
+}
\ No newline at end of file
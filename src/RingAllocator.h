@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <limits>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// RingAllocator suballocates a fixed-size buffer front to back, wrapping around
+	/// when it reaches the end. Allocations are grouped into batches, each tagged with
+	/// the fence value that marks when the GPU is done with them; memory is only
+	/// reclaimed once that fence value completes. It manages offsets only, so the same
+	/// logic backs any persistently mapped buffer.
+	/// </summary>
+	class RingAllocator
+	{
+	public:
+		static constexpr uint64_t INVALID_OFFSET{ std::numeric_limits<uint64_t>::max() };
+
+		RingAllocator(uint64_t capacity);
+
+		/// <summary>
+		/// Returns the offset of a new allocation, or INVALID_OFFSET if there isn't
+		/// enough free space until more batches retire.
+		/// </summary>
+		uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+		/// <summary>
+		/// Closes the current batch: everything allocated since the previous call
+		/// stays reserved until fenceValue completes.
+		/// </summary>
+		void FinishBatch(uint64_t fenceValue);
+
+		/// <summary>
+		/// Reclaims every batch whose fence value is at or below completedFenceValue.
+		/// </summary>
+		void Retire(uint64_t completedFenceValue);
+
+		/// <summary>
+		/// Fence value of the oldest batch still holding memory, or zero if none.
+		/// </summary>
+		uint64_t GetOldestPendingFenceValue() const;
+
+		uint64_t GetCapacity() const;
+		uint64_t GetUsedBytes() const;
+		bool HasOpenAllocations() const;
+
+	private:
+		struct Batch
+		{
+			uint64_t fenceValue;
+			uint64_t end;
+			uint64_t size;
+		};
+
+		const uint64_t m_capacity;
+
+		// Allocations live in [m_tail, m_head), wrapping around the end of the buffer
+		uint64_t m_head{ 0 };
+		uint64_t m_tail{ 0 };
+		uint64_t m_usedBytes{ 0 };
+		uint64_t m_openBatchBytes{ 0 };
+		std::deque<Batch> m_pendingBatches;
+	};
+}
\ No newline at end of file
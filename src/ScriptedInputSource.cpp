@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "ScriptedInputSource.h"
+#include "IClock.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	ScriptedInputSource::ScriptedInputSource(
+		IClock* clock
+	) :
+		m_clock{ clock }
+	{ }
+
+	bool ScriptedInputSource::QueueKeyDown(uint8_t key)
+	{
+		return QueueEvent(InputEvent{
+			.timestamp = m_clock->Now(),
+			.type = InputEventType::KeyDown,
+			.key = key,
+		});
+	}
+
+	bool ScriptedInputSource::QueueKeyUp(uint8_t key)
+	{
+		return QueueEvent(InputEvent{
+			.timestamp = m_clock->Now(),
+			.type = InputEventType::KeyUp,
+			.key = key,
+		});
+	}
+
+	bool ScriptedInputSource::QueueEvent(const InputEvent& event)
+	{
+		if (!m_events.TryPush(event))
+		{
+			m_droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		return true;
+	}
+
+	uint64_t ScriptedInputSource::GetDroppedEventCount() const
+	{
+		return m_droppedEventCount.load(std::memory_order_relaxed);
+	}
+
+	bool ScriptedInputSource::PollEvent(InputEvent& event)
+	{
+		return m_events.TryPop(event);
+	}
+#pragma endregion Public
+}
\ No newline at end of file
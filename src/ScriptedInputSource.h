@@ -0,0 +1,33 @@
+#pragma once
+#include "IInputSource.h"
+
+#include <atomic>
+
+namespace HelloTriangle
+{
+	class IClock;
+
+	/// <summary>
+	/// ScriptedInputSource is a windowless IInputSource. Events are queued
+	/// programmatically (from any single producer thread) and timestamped with the
+	/// supplied clock, so input can be driven headlessly.
+	/// </summary>
+	class ScriptedInputSource : public IInputSource
+	{
+	public:
+		ScriptedInputSource(IClock* clock);
+
+		bool QueueKeyDown(uint8_t key);
+		bool QueueKeyUp(uint8_t key);
+		bool QueueEvent(const InputEvent& event);
+		uint64_t GetDroppedEventCount() const;
+
+		// IInputSource
+		virtual bool PollEvent(InputEvent& event);
+
+	private:
+		IClock* const m_clock;
+		InputEventQueue m_events;
+		std::atomic<uint64_t> m_droppedEventCount{ 0 };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// FrameConstants mirrors the FrameConstants cbuffer (b0) in Shaders.hlsl. It is
+	/// written once per frame into the constant buffer ring. viewProjection is
+	/// row-major and transforms column vectors, matching the shader's row_major
+	/// declaration.
+	/// </summary>
+	struct FrameConstants
+	{
+		float viewProjection[16];
+	};
+	static_assert(sizeof(FrameConstants) % 16 == 0, "FrameConstants must follow HLSL cbuffer packing");
+	static_assert(offsetof(FrameConstants, viewProjection) == 0, "viewProjection is at c0 in FrameConstants");
+	static_assert(sizeof(FrameConstants) == 64, "FrameConstants is one float4x4");
+
+	/// <summary>
+	/// DrawConstants mirrors the DrawConstants cbuffer (b1) in Shaders.hlsl. It is
+	/// small enough to be set as root constants, so it costs no buffer memory.
+	/// </summary>
+	struct DrawConstants
+	{
+		float tint[4];
+	};
+	static_assert(sizeof(DrawConstants) % 4 == 0, "DrawConstants must be a whole number of root constants");
+	static_assert(offsetof(DrawConstants, tint) == 0, "tint is at c0 in DrawConstants");
+	static_assert(sizeof(DrawConstants) == 16, "DrawConstants is one float4");
+
+	constexpr uint32_t DRAW_CONSTANT_COUNT{ sizeof(DrawConstants) / sizeof(uint32_t) };
+
+	/// <summary>
+	/// MeshConstants mirrors the MeshConstants cbuffer (b2) in Shaders.hlsl and is
+	/// also set as root constants. It carries a compressed mesh's
+	/// VertexQuantization, padded to float4s; w is unused.
+	/// </summary>
+	struct MeshConstants
+	{
+		float quantizationOffset[4];
+		float quantizationScale[4];
+	};
+	static_assert(sizeof(MeshConstants) % 4 == 0, "MeshConstants must be a whole number of root constants");
+	static_assert(offsetof(MeshConstants, quantizationOffset) == 0, "quantizationOffset is at c0 in MeshConstants");
+	static_assert(offsetof(MeshConstants, quantizationScale) == 16, "quantizationScale is at c1 in MeshConstants");
+	static_assert(sizeof(MeshConstants) == 32, "MeshConstants is two float4s");
+
+	constexpr uint32_t MESH_CONSTANT_COUNT{ sizeof(MeshConstants) / sizeof(uint32_t) };
+}
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "ShaderSource.h"
+
+#include <fstream>
+#include <set>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr std::string_view INCLUDE_DIRECTIVE{ "include" };
+
+		// Replaces comments with spaces, keeping line breaks so directives stay at
+		// the start of their lines
+		std::string StripComments(std::string_view source)
+		{
+			std::string stripped;
+			stripped.reserve(source.size());
+			size_t i{ 0 };
+			while (i < source.size())
+			{
+				if (source.compare(i, 2, "//") == 0)
+				{
+					while ((i < source.size()) && (source[i] != '\n'))
+					{
+						++i;
+					}
+				}
+				else if (source.compare(i, 2, "/*") == 0)
+				{
+					const size_t end{ source.find("*/", i + 2) };
+					const size_t commentEnd{ (end == std::string_view::npos) ? source.size() : (end + 2) };
+					for (; i < commentEnd; ++i)
+					{
+						stripped.push_back((source[i] == '\n') ? '\n' : ' ');
+					}
+				}
+				else
+				{
+					stripped.push_back(source[i]);
+					++i;
+				}
+			}
+			return stripped;
+		}
+
+		bool ReadFile(const std::filesystem::path& path, std::string& contents)
+		{
+			std::ifstream file{ path, std::ios::binary };
+			if (!file)
+			{
+				return false;
+			}
+			contents.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+			return true;
+		}
+
+		uint64_t HashIncludes(
+			std::string_view source,
+			const std::filesystem::path& directory,
+			std::set<std::filesystem::path>& visited,
+			uint64_t hash)
+		{
+			for (const std::string& name : FindShaderIncludes(source))
+			{
+				const std::filesystem::path path{ (directory / name).lexically_normal() };
+				hash = HashString(name, hash);
+				if (!visited.insert(path).second)
+				{
+					continue;
+				}
+
+				std::string contents;
+				if (!ReadFile(path, contents))
+				{
+					hash = HashValue(false, hash);
+					continue;
+				}
+				hash = HashValue(true, hash);
+				hash = HashString(contents, hash);
+				hash = HashIncludes(contents, path.parent_path(), visited, hash);
+			}
+			return hash;
+		}
+	}
+
+	std::vector<std::string> FindShaderIncludes(std::string_view source)
+	{
+		const std::string stripped{ StripComments(source) };
+		std::vector<std::string> includes;
+		size_t lineStart{ 0 };
+		while (lineStart < stripped.size())
+		{
+			size_t lineEnd{ stripped.find('\n', lineStart) };
+			if (lineEnd == std::string::npos)
+			{
+				lineEnd = stripped.size();
+			}
+			const std::string_view line{ std::string_view{ stripped }.substr(lineStart, lineEnd - lineStart) };
+			lineStart = lineEnd + 1;
+
+			// # include "name" or # include <name>, with any blanks in between
+			size_t i{ line.find_first_not_of(" \t") };
+			if ((i == std::string_view::npos) || (line[i] != '#'))
+			{
+				continue;
+			}
+			i = line.find_first_not_of(" \t", i + 1);
+			if ((i == std::string_view::npos) || (line.compare(i, INCLUDE_DIRECTIVE.size(), INCLUDE_DIRECTIVE) != 0))
+			{
+				continue;
+			}
+			i = line.find_first_not_of(" \t", i + INCLUDE_DIRECTIVE.size());
+			if ((i == std::string_view::npos) || ((line[i] != '"') && (line[i] != '<')))
+			{
+				continue;
+			}
+			const char close{ (line[i] == '"') ? '"' : '>' };
+			const size_t end{ line.find(close, i + 1) };
+			if (end != std::string_view::npos)
+			{
+				includes.emplace_back(line.substr(i + 1, end - i - 1));
+			}
+		}
+		return includes;
+	}
+
+	uint64_t HashShaderSource(
+		std::string_view source,
+		const std::filesystem::path& sourcePath,
+		uint64_t seed)
+	{
+		std::set<std::filesystem::path> visited{ sourcePath.lexically_normal() };
+		return HashIncludes(source, sourcePath.parent_path(), visited, HashString(source, seed));
+	}
+
+	uint64_t ComputeShaderKey(
+		std::string_view source,
+		const std::filesystem::path& sourcePath,
+		const ShaderEntryPoint& entryPoint,
+		uint32_t compileFlags)
+	{
+		uint64_t key{ HashShaderSource(source, sourcePath) };
+		key = HashString(entryPoint.name, key);
+		key = HashString(entryPoint.target, key);
+		return HashValue(compileFlags, key);
+	}
+}
\ No newline at end of file
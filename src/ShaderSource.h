@@ -0,0 +1,60 @@
+#pragma once
+#include "Hash.h"
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace HelloTriangle
+{
+	struct ShaderEntryPoint
+	{
+		const char* name;
+		const char* target;
+	};
+
+	constexpr ShaderEntryPoint VERTEX_SHADER{ "VSMain", "vs_5_0" };
+	constexpr ShaderEntryPoint COMPRESSED_VERTEX_SHADER{ "VSMainCompressed", "vs_5_0" };
+	constexpr ShaderEntryPoint PIXEL_SHADER{ "PSMain", "ps_5_0" };
+
+	/// <summary>
+	/// Every entry point in Shaders.hlsl, all of which are compiled into the shader
+	/// archive at build time.
+	/// </summary>
+	constexpr std::array<ShaderEntryPoint, 3> SHADER_ENTRY_POINTS{
+		VERTEX_SHADER,
+		COMPRESSED_VERTEX_SHADER,
+		PIXEL_SHADER,
+	};
+
+	/// <summary>
+	/// Returns the file names of source's #include directives, in order, as written
+	/// between the quotes or angle brackets. Directives inside comments are skipped.
+	/// </summary>
+	std::vector<std::string> FindShaderIncludes(std::string_view source);
+
+	/// <summary>
+	/// Hashes source together with every file it includes, recursively, resolving
+	/// names against the including file's directory as D3D_COMPILE_STANDARD_FILE_INCLUDE
+	/// does. Includes that can't be read are hashed by name, so creating them
+	/// later changes the hash too. Each file is hashed once, however often it is
+	/// included.
+	/// </summary>
+	uint64_t HashShaderSource(
+		std::string_view source,
+		const std::filesystem::path& sourcePath,
+		uint64_t seed = HASH_SEED);
+
+	/// <summary>
+	/// Keys compiled bytecode by everything that affects compilation, included files
+	/// too, so that any source or flag change misses archived bytecode.
+	/// </summary>
+	uint64_t ComputeShaderKey(
+		std::string_view source,
+		const std::filesystem::path& sourcePath,
+		const ShaderEntryPoint& entryPoint,
+		uint32_t compileFlags);
+}
\ No newline at end of file
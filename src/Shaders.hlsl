@@ -1,19 +1,63 @@
+// Written once per frame into the constant buffer ring (see ShaderConstants.h)
+cbuffer FrameConstants : register(b0)
+{
+    row_major float4x4 viewProjection;
+};
+
+// Root constants, set per draw
+cbuffer DrawConstants : register(b1)
+{
+    float4 tint;
+};
+
+// Root constants, set per compressed mesh (see VertexQuantization)
+cbuffer MeshConstants : register(b2)
+{
+    float4 quantizationOffset;
+    float4 quantizationScale;
+};
+
 struct PSInput
 {
     float4 position : SV_POSITION;
     float4 color : COLOR;
 };
 
-PSInput VSMain(float4 position : POSITION, float4 color : COLOR)
+// instanceTransform.xyz offsets the mesh, instanceTransform.w scales it uniformly
+PSInput TransformVertex(float3 position, float4 color, float4 instanceTransform, float4 instanceColor)
 {
     PSInput result;
 
-    result.position = position;
-    result.color = color;
+    const float3 worldPosition = (position * instanceTransform.w) + instanceTransform.xyz;
+    result.position = mul(viewProjection, float4(worldPosition, 1.0f));
+    result.color = color * instanceColor * tint;
 
     return result;
 }
 
+PSInput VSMain(
+    float3 position : POSITION,
+    float4 color : COLOR,
+    float4 instanceTransform : INSTANCE_TRANSFORM,
+    float4 instanceColor : INSTANCE_COLOR)
+{
+    return TransformVertex(position, color, instanceTransform, instanceColor);
+}
+
+// COMPRESSED_VERTEX_LAYOUT: the input assembler expands the UNORM color and the
+// SNORM position, split into xy and z, to floats, and the quantization maps the
+// position back to the mesh.
+PSInput VSMainCompressed(
+    float4 color : COLOR,
+    float2 positionXY : POSITION0,
+    float positionZ : POSITION1,
+    float4 instanceTransform : INSTANCE_TRANSFORM,
+    float4 instanceColor : INSTANCE_COLOR)
+{
+    const float3 meshPosition = quantizationOffset.xyz + (quantizationScale.xyz * float3(positionXY, positionZ));
+    return TransformVertex(meshPosition, color, instanceTransform, instanceColor);
+}
+
 float4 PSMain(PSInput input) : SV_TARGET
 {
     return input.color;
@@ -0,0 +1,509 @@
+#include "pch.h"
+#include "SimdKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HELLOTRIANGLE_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC allows any intrinsic in any function, so no per-function target is needed
+#define HELLOTRIANGLE_TARGET_SSE2
+#define HELLOTRIANGLE_TARGET_AVX2
+#else
+#define HELLOTRIANGLE_TARGET_SSE2 __attribute__((target("sse2")))
+#define HELLOTRIANGLE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace HelloTriangle
+{
+	namespace
+	{
+#pragma region Scalar
+		void IntegratePositionsScalar(
+			size_t count,
+			float* positionX,
+			float* positionY,
+			float* positionZ,
+			const float* velocityX,
+			const float* velocityY,
+			const float* velocityZ,
+			float deltaSeconds)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				positionX[i] += velocityX[i] * deltaSeconds;
+				positionY[i] += velocityY[i] * deltaSeconds;
+				positionZ[i] += velocityZ[i] * deltaSeconds;
+			}
+		}
+
+		void UpdateAabbsScalar(
+			size_t count,
+			const float* centerX,
+			const float* centerY,
+			const float* centerZ,
+			const float* halfExtentX,
+			const float* halfExtentY,
+			const float* halfExtentZ,
+			float* const bounds[6])
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				bounds[0][i] = centerX[i] - halfExtentX[i];
+				bounds[1][i] = centerY[i] - halfExtentY[i];
+				bounds[2][i] = centerZ[i] - halfExtentZ[i];
+				bounds[3][i] = centerX[i] + halfExtentX[i];
+				bounds[4][i] = centerY[i] + halfExtentY[i];
+				bounds[5][i] = centerZ[i] + halfExtentZ[i];
+			}
+		}
+
+		void TransformPointsScalar(
+			size_t count,
+			const float matrix[16],
+			const float* x,
+			const float* y,
+			const float* z,
+			float* const out[4])
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				for (size_t row = 0; row < 4; ++row)
+				{
+					const float* m{ &matrix[row * 4] };
+					out[row][i] = (((m[0] * x[i]) + (m[1] * y[i])) + (m[2] * z[i])) + m[3];
+				}
+			}
+		}
+
+		size_t CullSpheresScalar(
+			size_t count,
+			const float planes[24],
+			const float* x,
+			const float* y,
+			const float* z,
+			const float* radius,
+			float defaultRadius,
+			uint32_t firstIndex,
+			uint32_t* visibleIndices)
+		{
+			size_t visibleCount{ 0 };
+			for (size_t i = 0; i < count; ++i)
+			{
+				const float r{ radius ? radius[i] : defaultRadius };
+				bool isVisible{ true };
+				for (size_t plane = 0; plane < 6; ++plane)
+				{
+					const float* p{ &planes[plane * 4] };
+					const float distance{ (((p[0] * x[i]) + (p[1] * y[i])) + (p[2] * z[i])) + p[3] };
+					isVisible = isVisible && (distance >= -r);
+				}
+
+				// Write unconditionally and advance only on a hit, so there is no
+				// data-dependent branch; the slot written is never past i
+				visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i);
+				visibleCount += isVisible ? 1 : 0;
+			}
+			return visibleCount;
+		}
+#pragma endregion Scalar
+
+#ifdef HELLOTRIANGLE_SIMD_X86
+#pragma region Sse2
+		HELLOTRIANGLE_TARGET_SSE2 void IntegratePositionsSse2(
+			size_t count,
+			float* positionX,
+			float* positionY,
+			float* positionZ,
+			const float* velocityX,
+			const float* velocityY,
+			const float* velocityZ,
+			float deltaSeconds)
+		{
+			const __m128 dt{ _mm_set1_ps(deltaSeconds) };
+			size_t i{ 0 };
+			for (; (i + 4) <= count; i += 4)
+			{
+				_mm_storeu_ps(&positionX[i], _mm_add_ps(
+					_mm_loadu_ps(&positionX[i]), _mm_mul_ps(_mm_loadu_ps(&velocityX[i]), dt)));
+				_mm_storeu_ps(&positionY[i], _mm_add_ps(
+					_mm_loadu_ps(&positionY[i]), _mm_mul_ps(_mm_loadu_ps(&velocityY[i]), dt)));
+				_mm_storeu_ps(&positionZ[i], _mm_add_ps(
+					_mm_loadu_ps(&positionZ[i]), _mm_mul_ps(_mm_loadu_ps(&velocityZ[i]), dt)));
+			}
+			IntegratePositionsScalar(
+				count - i,
+				&positionX[i], &positionY[i], &positionZ[i],
+				&velocityX[i], &velocityY[i], &velocityZ[i],
+				deltaSeconds);
+		}
+
+		HELLOTRIANGLE_TARGET_SSE2 void UpdateAabbsSse2(
+			size_t count,
+			const float* centerX,
+			const float* centerY,
+			const float* centerZ,
+			const float* halfExtentX,
+			const float* halfExtentY,
+			const float* halfExtentZ,
+			float* const bounds[6])
+		{
+			const float* centers[3]{ centerX, centerY, centerZ };
+			const float* halfExtents[3]{ halfExtentX, halfExtentY, halfExtentZ };
+			size_t i{ 0 };
+			for (; (i + 4) <= count; i += 4)
+			{
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					const __m128 c{ _mm_loadu_ps(&centers[axis][i]) };
+					const __m128 e{ _mm_loadu_ps(&halfExtents[axis][i]) };
+					_mm_storeu_ps(&bounds[axis][i], _mm_sub_ps(c, e));
+					_mm_storeu_ps(&bounds[axis + 3][i], _mm_add_ps(c, e));
+				}
+			}
+			float* const tail[6]
+			{
+				&bounds[0][i], &bounds[1][i], &bounds[2][i],
+				&bounds[3][i], &bounds[4][i], &bounds[5][i],
+			};
+			UpdateAabbsScalar(
+				count - i,
+				&centerX[i], &centerY[i], &centerZ[i],
+				&halfExtentX[i], &halfExtentY[i], &halfExtentZ[i],
+				tail);
+		}
+
+		HELLOTRIANGLE_TARGET_SSE2 void TransformPointsSse2(
+			size_t count,
+			const float matrix[16],
+			const float* x,
+			const float* y,
+			const float* z,
+			float* const out[4])
+		{
+			size_t i{ 0 };
+			for (; (i + 4) <= count; i += 4)
+			{
+				const __m128 px{ _mm_loadu_ps(&x[i]) };
+				const __m128 py{ _mm_loadu_ps(&y[i]) };
+				const __m128 pz{ _mm_loadu_ps(&z[i]) };
+				for (size_t row = 0; row < 4; ++row)
+				{
+					const float* m{ &matrix[row * 4] };
+					__m128 r{ _mm_mul_ps(_mm_set1_ps(m[0]), px) };
+					r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m[1]), py));
+					r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(m[2]), pz));
+					r = _mm_add_ps(r, _mm_set1_ps(m[3]));
+					_mm_storeu_ps(&out[row][i], r);
+				}
+			}
+			float* const tail[4]{ &out[0][i], &out[1][i], &out[2][i], &out[3][i] };
+			TransformPointsScalar(count - i, matrix, &x[i], &y[i], &z[i], tail);
+		}
+
+		HELLOTRIANGLE_TARGET_SSE2 size_t CullSpheresSse2(
+			size_t count,
+			const float planes[24],
+			const float* x,
+			const float* y,
+			const float* z,
+			const float* radius,
+			float defaultRadius,
+			uint32_t firstIndex,
+			uint32_t* visibleIndices)
+		{
+			size_t visibleCount{ 0 };
+			size_t i{ 0 };
+			for (; (i + 4) <= count; i += 4)
+			{
+				const __m128 px{ _mm_loadu_ps(&x[i]) };
+				const __m128 py{ _mm_loadu_ps(&y[i]) };
+				const __m128 pz{ _mm_loadu_ps(&z[i]) };
+				const __m128 negativeRadius{ _mm_sub_ps(
+					_mm_setzero_ps(), radius ? _mm_loadu_ps(&radius[i]) : _mm_set1_ps(defaultRadius)) };
+				__m128 inside{ _mm_castsi128_ps(_mm_set1_epi32(-1)) };
+				for (size_t plane = 0; plane < 6; ++plane)
+				{
+					const float* p{ &planes[plane * 4] };
+					__m128 distance{ _mm_mul_ps(_mm_set1_ps(p[0]), px) };
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p[1]), py));
+					distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(p[2]), pz));
+					distance = _mm_add_ps(distance, _mm_set1_ps(p[3]));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+				}
+
+				const int mask{ _mm_movemask_ps(inside) };
+				if (mask == 0)
+				{
+					continue;
+				}
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i + lane);
+					visibleCount += (mask >> lane) & 1;
+				}
+			}
+			return visibleCount + CullSpheresScalar(
+				count - i,
+				planes,
+				&x[i], &y[i], &z[i],
+				radius ? &radius[i] : nullptr,
+				defaultRadius,
+				firstIndex + static_cast<uint32_t>(i),
+				&visibleIndices[visibleCount]);
+		}
+#pragma endregion Sse2
+
+#pragma region Avx2
+		HELLOTRIANGLE_TARGET_AVX2 void IntegratePositionsAvx2(
+			size_t count,
+			float* positionX,
+			float* positionY,
+			float* positionZ,
+			const float* velocityX,
+			const float* velocityY,
+			const float* velocityZ,
+			float deltaSeconds)
+		{
+			const __m256 dt{ _mm256_set1_ps(deltaSeconds) };
+			size_t i{ 0 };
+			for (; (i + 8) <= count; i += 8)
+			{
+				_mm256_storeu_ps(&positionX[i], _mm256_add_ps(
+					_mm256_loadu_ps(&positionX[i]), _mm256_mul_ps(_mm256_loadu_ps(&velocityX[i]), dt)));
+				_mm256_storeu_ps(&positionY[i], _mm256_add_ps(
+					_mm256_loadu_ps(&positionY[i]), _mm256_mul_ps(_mm256_loadu_ps(&velocityY[i]), dt)));
+				_mm256_storeu_ps(&positionZ[i], _mm256_add_ps(
+					_mm256_loadu_ps(&positionZ[i]), _mm256_mul_ps(_mm256_loadu_ps(&velocityZ[i]), dt)));
+			}
+			IntegratePositionsScalar(
+				count - i,
+				&positionX[i], &positionY[i], &positionZ[i],
+				&velocityX[i], &velocityY[i], &velocityZ[i],
+				deltaSeconds);
+		}
+
+		HELLOTRIANGLE_TARGET_AVX2 void UpdateAabbsAvx2(
+			size_t count,
+			const float* centerX,
+			const float* centerY,
+			const float* centerZ,
+			const float* halfExtentX,
+			const float* halfExtentY,
+			const float* halfExtentZ,
+			float* const bounds[6])
+		{
+			const float* centers[3]{ centerX, centerY, centerZ };
+			const float* halfExtents[3]{ halfExtentX, halfExtentY, halfExtentZ };
+			size_t i{ 0 };
+			for (; (i + 8) <= count; i += 8)
+			{
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					const __m256 c{ _mm256_loadu_ps(&centers[axis][i]) };
+					const __m256 e{ _mm256_loadu_ps(&halfExtents[axis][i]) };
+					_mm256_storeu_ps(&bounds[axis][i], _mm256_sub_ps(c, e));
+					_mm256_storeu_ps(&bounds[axis + 3][i], _mm256_add_ps(c, e));
+				}
+			}
+			float* const tail[6]
+			{
+				&bounds[0][i], &bounds[1][i], &bounds[2][i],
+				&bounds[3][i], &bounds[4][i], &bounds[5][i],
+			};
+			UpdateAabbsScalar(
+				count - i,
+				&centerX[i], &centerY[i], &centerZ[i],
+				&halfExtentX[i], &halfExtentY[i], &halfExtentZ[i],
+				tail);
+		}
+
+		HELLOTRIANGLE_TARGET_AVX2 void TransformPointsAvx2(
+			size_t count,
+			const float matrix[16],
+			const float* x,
+			const float* y,
+			const float* z,
+			float* const out[4])
+		{
+			size_t i{ 0 };
+			for (; (i + 8) <= count; i += 8)
+			{
+				const __m256 px{ _mm256_loadu_ps(&x[i]) };
+				const __m256 py{ _mm256_loadu_ps(&y[i]) };
+				const __m256 pz{ _mm256_loadu_ps(&z[i]) };
+				for (size_t row = 0; row < 4; ++row)
+				{
+					const float* m{ &matrix[row * 4] };
+					__m256 r{ _mm256_mul_ps(_mm256_set1_ps(m[0]), px) };
+					r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_set1_ps(m[1]), py));
+					r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_set1_ps(m[2]), pz));
+					r = _mm256_add_ps(r, _mm256_set1_ps(m[3]));
+					_mm256_storeu_ps(&out[row][i], r);
+				}
+			}
+			float* const tail[4]{ &out[0][i], &out[1][i], &out[2][i], &out[3][i] };
+			TransformPointsScalar(count - i, matrix, &x[i], &y[i], &z[i], tail);
+		}
+
+		HELLOTRIANGLE_TARGET_AVX2 size_t CullSpheresAvx2(
+			size_t count,
+			const float planes[24],
+			const float* x,
+			const float* y,
+			const float* z,
+			const float* radius,
+			float defaultRadius,
+			uint32_t firstIndex,
+			uint32_t* visibleIndices)
+		{
+			size_t visibleCount{ 0 };
+			size_t i{ 0 };
+			for (; (i + 8) <= count; i += 8)
+			{
+				const __m256 px{ _mm256_loadu_ps(&x[i]) };
+				const __m256 py{ _mm256_loadu_ps(&y[i]) };
+				const __m256 pz{ _mm256_loadu_ps(&z[i]) };
+				const __m256 negativeRadius{ _mm256_sub_ps(
+					_mm256_setzero_ps(), radius ? _mm256_loadu_ps(&radius[i]) : _mm256_set1_ps(defaultRadius)) };
+				__m256 inside{ _mm256_castsi256_ps(_mm256_set1_epi32(-1)) };
+				for (size_t plane = 0; plane < 6; ++plane)
+				{
+					const float* p{ &planes[plane * 4] };
+					__m256 distance{ _mm256_mul_ps(_mm256_set1_ps(p[0]), px) };
+					distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(p[1]), py));
+					distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(p[2]), pz));
+					distance = _mm256_add_ps(distance, _mm256_set1_ps(p[3]));
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+				}
+
+				const int mask{ _mm256_movemask_ps(inside) };
+				if (mask == 0)
+				{
+					// Most spheres of a large scene are off screen; skip the stores
+					continue;
+				}
+				for (int lane = 0; lane < 8; ++lane)
+				{
+					visibleIndices[visibleCount] = firstIndex + static_cast<uint32_t>(i + lane);
+					visibleCount += (mask >> lane) & 1;
+				}
+			}
+			return visibleCount + CullSpheresScalar(
+				count - i,
+				planes,
+				&x[i], &y[i], &z[i],
+				radius ? &radius[i] : nullptr,
+				defaultRadius,
+				firstIndex + static_cast<uint32_t>(i),
+				&visibleIndices[visibleCount]);
+		}
+#pragma endregion Avx2
+#endif
+
+		constexpr SimdKernels SCALAR_KERNELS
+		{
+			.level = SimdLevel::Scalar,
+			.IntegratePositions = IntegratePositionsScalar,
+			.UpdateAabbs = UpdateAabbsScalar,
+			.TransformPoints = TransformPointsScalar,
+			.CullSpheres = CullSpheresScalar,
+		};
+
+#ifdef HELLOTRIANGLE_SIMD_X86
+		constexpr SimdKernels SSE2_KERNELS
+		{
+			.level = SimdLevel::Sse2,
+			.IntegratePositions = IntegratePositionsSse2,
+			.UpdateAabbs = UpdateAabbsSse2,
+			.TransformPoints = TransformPointsSse2,
+			.CullSpheres = CullSpheresSse2,
+		};
+
+		constexpr SimdKernels AVX2_KERNELS
+		{
+			.level = SimdLevel::Avx2,
+			.IntegratePositions = IntegratePositionsAvx2,
+			.UpdateAabbs = UpdateAabbsAvx2,
+			.TransformPoints = TransformPointsAvx2,
+			.CullSpheres = CullSpheresAvx2,
+		};
+#endif
+	}
+
+	SimdLevel DetectSimdLevel()
+	{
+#ifdef HELLOTRIANGLE_SIMD_X86
+#if defined(_MSC_VER)
+		int info[4]{};
+		__cpuid(info, 0);
+		const int maxLeaf{ info[0] };
+
+		__cpuid(info, 1);
+		const bool hasSse2{ (info[3] & (1 << 26)) != 0 };
+		const bool hasOsxsave{ (info[2] & (1 << 27)) != 0 };
+		const bool hasAvx{ (info[2] & (1 << 28)) != 0 };
+
+		bool hasAvx2{ false };
+		if ((maxLeaf >= 7) && hasOsxsave && hasAvx)
+		{
+			// The OS must also preserve YMM state across context switches
+			const unsigned long long xcr0{ _xgetbv(0) };
+			if ((xcr0 & 0x6) == 0x6)
+			{
+				__cpuidex(info, 7, 0);
+				hasAvx2 = (info[1] & (1 << 5)) != 0;
+			}
+		}
+#else
+		const bool hasSse2{ __builtin_cpu_supports("sse2") != 0 };
+		const bool hasAvx2{ __builtin_cpu_supports("avx2") != 0 };
+#endif
+		if (hasAvx2)
+		{
+			return SimdLevel::Avx2;
+		}
+		if (hasSse2)
+		{
+			return SimdLevel::Sse2;
+		}
+#endif
+		return SimdLevel::Scalar;
+	}
+
+	const SimdKernels& GetSimdKernels(SimdLevel level)
+	{
+#ifdef HELLOTRIANGLE_SIMD_X86
+		static const SimdLevel supported{ DetectSimdLevel() };
+		if (level > supported)
+		{
+			level = supported;
+		}
+
+		switch (level)
+		{
+		case SimdLevel::Avx2:
+			return AVX2_KERNELS;
+		case SimdLevel::Sse2:
+			return SSE2_KERNELS;
+		default:
+			break;
+		}
+#endif
+		return SCALAR_KERNELS;
+	}
+
+	const char* GetSimdLevelName(SimdLevel level)
+	{
+		switch (level)
+		{
+		case SimdLevel::Avx2:
+			return "AVX2";
+		case SimdLevel::Sse2:
+			return "SSE2";
+		default:
+			return "Scalar";
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	enum class SimdLevel
+	{
+		Scalar,
+		Sse2,
+		Avx2,
+	};
+
+	/// <summary>
+	/// SimdKernels is a table of batch kernels over SoA float streams, all implemented
+	/// for a single instruction set. Every level produces the same results as the scalar
+	/// path (no fused multiply-add), so levels can be swapped freely.
+	/// </summary>
+	struct SimdKernels
+	{
+		SimdLevel level;
+
+		/// <summary>
+		/// position += velocity * deltaSeconds, per component.
+		/// </summary>
+		void (*IntegratePositions)(
+			size_t count,
+			float* positionX,
+			float* positionY,
+			float* positionZ,
+			const float* velocityX,
+			const float* velocityY,
+			const float* velocityZ,
+			float deltaSeconds);
+
+		/// <summary>
+		/// Computes min/max corners from centers and half extents.
+		/// bounds holds six streams: minX, minY, minZ, maxX, maxY, maxZ.
+		/// </summary>
+		void (*UpdateAabbs)(
+			size_t count,
+			const float* centerX,
+			const float* centerY,
+			const float* centerZ,
+			const float* halfExtentX,
+			const float* halfExtentY,
+			const float* halfExtentZ,
+			float* const bounds[6]);
+
+		/// <summary>
+		/// out = matrix * (x, y, z, 1) for every point. matrix is row-major, 16 floats.
+		/// out holds four streams: x, y, z, w.
+		/// </summary>
+		void (*TransformPoints)(
+			size_t count,
+			const float matrix[16],
+			const float* x,
+			const float* y,
+			const float* z,
+			float* const out[4]);
+
+		/// <summary>
+		/// Writes firstIndex + i for every sphere i that is not entirely outside any of
+		/// six inward-facing planes (24 floats, a, b, c, d each) to visibleIndices, in
+		/// order, and returns how many were written. visibleIndices needs room for
+		/// count entries. radius may be null, in which case every sphere uses
+		/// defaultRadius.
+		/// </summary>
+		size_t (*CullSpheres)(
+			size_t count,
+			const float planes[24],
+			const float* x,
+			const float* y,
+			const float* z,
+			const float* radius,
+			float defaultRadius,
+			uint32_t firstIndex,
+			uint32_t* visibleIndices);
+	};
+
+	/// <summary>
+	/// Returns the widest instruction set supported by the executing CPU.
+	/// </summary>
+	SimdLevel DetectSimdLevel();
+
+	/// <summary>
+	/// Returns the kernel table for the given level, clamped to what this build
+	/// and CPU support.
+	/// </summary>
+	const SimdKernels& GetSimdKernels(SimdLevel level);
+
+	const char* GetSimdLevelName(SimdLevel level);
+}
\ No newline at end of file
@@ -1,19 +1,171 @@
 #include "pch.h"
 #include "IInputSource.h"
+#include "JobSystem.h"
+#include "Profiler.h"
 #include "Simulation.h"
+#include "SimulationSnapshot.h"
 
 namespace HelloTriangle
 {
+	namespace
+	{
+		// Smallest slice of entities worth handing to another thread
+		constexpr size_t MIN_ENTITIES_PER_JOB{ 4096 };
+
+		// Spatial index cells hold a few entities each at typical densities, and
+		// entity bounds cover the largest mesh drawn for an entity
+		constexpr float SPATIAL_CELL_SIZE{ 0.25f };
+		constexpr float ENTITY_BOUNDING_RADIUS{ 0.05f };
+	}
+
 #pragma region Public
 	Simulation::Simulation(
-		IInputSource* inputSource
+		IInputSource* inputSource,
+		JobSystem* jobSystem
 	):
-		m_inputSource(inputSource)
-	{}
+		m_inputSource(inputSource),
+		m_jobSystem(jobSystem),
+		m_kernels(&GetSimdKernels(DetectSimdLevel())),
+		m_spatialIndex(SpatialIndex::Config{ SPATIAL_CELL_SIZE, ENTITY_BOUNDING_RADIUS, true })
+	{
+		spdlog::info("Simulation: Using {} kernels.", GetSimdLevelName(m_kernels->level));
+	}
+
+	void Simulation::Update(float deltaSeconds)
+	{
+		HELLOTRIANGLE_PROFILE_SCOPE("Simulation::Update");
+		ProcessInput();
+		IntegrateMovement(deltaSeconds);
+		++m_tick;
+	}
+
+	World& Simulation::GetWorld()
+	{
+		return m_world;
+	}
+
+	const World& Simulation::GetWorld() const
+	{
+		return m_world;
+	}
+
+	const SpatialIndex& Simulation::GetSpatialIndex()
+	{
+		HELLOTRIANGLE_PROFILE_SCOPE("Simulation::GetSpatialIndex");
+		m_spatialIndex.Sync(m_world);
+		return m_spatialIndex;
+	}
+
+	PreviousPositionsView Simulation::GetPreviousPositions() const
+	{
+		return PreviousPositionsView{
+			.count = m_previousX.size(),
+			.x = m_previousX.data(),
+			.y = m_previousY.data(),
+			.z = m_previousZ.data(),
+		};
+	}
+
+	const KeyState& Simulation::GetKeyState() const
+	{
+		return m_keyState;
+	}
 
-	void Simulation::Update()
+	uint32_t Simulation::GetTickEventCount() const
 	{
-		// TODO
+		return m_tickEventCount;
+	}
+
+	uint64_t Simulation::GetTick() const
+	{
+		return m_tick;
+	}
+
+	void Simulation::SaveSnapshot(SimulationSnapshot& snapshot) const
+	{
+		snapshot.world = m_world;
+		snapshot.keyState = m_keyState;
+		snapshot.tick = m_tick;
+	}
+
+	void Simulation::RestoreSnapshot(const SimulationSnapshot& snapshot)
+	{
+		m_world = snapshot.world;
+		m_keyState = snapshot.keyState;
+		m_tick = snapshot.tick;
+		m_tickEventCount = 0;
+		m_previousX.clear();
+		m_previousY.clear();
+		m_previousZ.clear();
+
+		// Every entity may have moved; the next sync rebuilds rather than trusting
+		// the old index
+		m_spatialIndex.Invalidate();
+	}
+
+	uint64_t Simulation::ComputeStateHash() const
+	{
+		uint64_t hash{ m_world.ComputeHash() };
+		for (size_t key = 0; key < m_keyState.size(); ++key)
+		{
+			hash = HashValue(static_cast<uint8_t>(m_keyState[key]), hash);
+		}
+		return HashValue(m_tick, hash);
 	}
 #pragma endregion Public
+
+#pragma region Private
+	void Simulation::ProcessInput()
+	{
+		m_tickEventCount = 0;
+		if (!m_inputSource)
+		{
+			return;
+		}
+
+		InputEvent event{};
+		while (m_inputSource->PollEvent(event))
+		{
+			m_keyState.set(event.key, (event.type == InputEventType::KeyDown));
+			++m_tickEventCount;
+		}
+	}
+
+	void Simulation::IntegrateMovement(float deltaSeconds)
+	{
+		const MovingView moving{ m_world.GetMovingView() };
+
+		// Only grows once the entity count settles, so steady-state ticks don't allocate
+		m_previousX.resize(moving.count);
+		m_previousY.resize(moving.count);
+		m_previousZ.resize(moving.count);
+
+		auto integrate = [this, &moving, deltaSeconds](size_t begin, size_t end)
+		{
+			// Copied slice by slice while the slice is about to be read anyway
+			const size_t bytes{ (end - begin) * sizeof(float) };
+			std::memcpy(m_previousX.data() + begin, moving.positionX + begin, bytes);
+			std::memcpy(m_previousY.data() + begin, moving.positionY + begin, bytes);
+			std::memcpy(m_previousZ.data() + begin, moving.positionZ + begin, bytes);
+			m_kernels->IntegratePositions(
+				end - begin,
+				&moving.positionX[begin],
+				&moving.positionY[begin],
+				&moving.positionZ[begin],
+				&moving.velocityX[begin],
+				&moving.velocityY[begin],
+				&moving.velocityZ[begin],
+				deltaSeconds);
+		};
+
+		if (m_jobSystem)
+		{
+			m_jobSystem->ParallelFor(moving.count, MIN_ENTITIES_PER_JOB, integrate);
+		}
+		else
+		{
+			integrate(0, moving.count);
+		}
+	}
+#pragma endregion Private
 }
\ No newline at end of file
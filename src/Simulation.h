@@ -1,8 +1,27 @@
 #pragma once
+#include "InputEvents.h"
+#include "SimdKernels.h"
+#include "SpatialIndex.h"
+#include "World.h"
 
 namespace HelloTriangle
 {
 	class IInputSource;
+	class JobSystem;
+	struct SimulationSnapshot;
+
+	/// <summary>
+	/// PreviousPositionsView exposes where the moving entities were at the start of
+	/// the most recent tick, in the same dense order as the World's position pool.
+	/// Entities from count on did not move during that tick.
+	/// </summary>
+	struct PreviousPositionsView
+	{
+		size_t count{ 0 };
+		const float* x{ nullptr };
+		const float* y{ nullptr };
+		const float* z{ nullptr };
+	};
 
 	/// <summary>
 	/// The Simulation class manages the main loop and various subsystems (input, graphics, etc.)
@@ -10,10 +29,58 @@ namespace HelloTriangle
 	class Simulation
 	{
 	public:
-		Simulation(IInputSource* inputSource);
-		void Update();
+		Simulation(IInputSource* inputSource, JobSystem* jobSystem = nullptr);
+		void Update(float deltaSeconds);
+		World& GetWorld();
+		const World& GetWorld() const;
+
+		/// <summary>
+		/// Brings the spatial index up to date with the World and returns it. Nothing
+		/// in the tick needs it, so it is only synced when asked for; Sync is
+		/// incremental, so asking every tick costs about what syncing in Update did.
+		/// </summary>
+		const SpatialIndex& GetSpatialIndex();
+
+		/// <summary>
+		/// Positions from before the most recent tick, for interpolating between
+		/// ticks when rendering. Empty until the first tick and after a restore; only
+		/// valid until the World is next changed outside Update.
+		/// </summary>
+		PreviousPositionsView GetPreviousPositions() const;
+
+		/// <summary>
+		/// Keys held as of the start of the most recent tick.
+		/// </summary>
+		const KeyState& GetKeyState() const;
+		uint32_t GetTickEventCount() const;
+
+		/// <summary>
+		/// Number of ticks simulated, including any replayed after a restore.
+		/// </summary>
+		uint64_t GetTick() const;
+
+		/// <summary>
+		/// Captures the current state. Restoring it and replaying the same input
+		/// reproduces the same states bit for bit, whatever the worker count.
+		/// </summary>
+		void SaveSnapshot(SimulationSnapshot& snapshot) const;
+		void RestoreSnapshot(const SimulationSnapshot& snapshot);
+		uint64_t ComputeStateHash() const;
 
 	private:
 		IInputSource* const m_inputSource{ nullptr };
+		JobSystem* const m_jobSystem{ nullptr };
+		const SimdKernels* const m_kernels{ nullptr };
+		World m_world;
+		SpatialIndex m_spatialIndex;
+		KeyState m_keyState;
+		std::vector<float> m_previousX;
+		std::vector<float> m_previousY;
+		std::vector<float> m_previousZ;
+		uint32_t m_tickEventCount{ 0 };
+		uint64_t m_tick{ 0 };
+
+		void ProcessInput();
+		void IntegrateMovement(float deltaSeconds);
 	};
 }
\ No newline at end of file
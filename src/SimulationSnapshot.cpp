@@ -0,0 +1,34 @@
+#include "pch.h"
+#include "SimulationSnapshot.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	SnapshotRing::SnapshotRing(size_t capacity, size_t entityCapacity) :
+		m_snapshots(std::max<size_t>(capacity, 1))
+	{
+		for (SimulationSnapshot& snapshot : m_snapshots)
+		{
+			snapshot.world.Reserve(entityCapacity);
+		}
+	}
+
+	SimulationSnapshot& SnapshotRing::Acquire(uint64_t tick)
+	{
+		SimulationSnapshot& snapshot{ m_snapshots[tick % m_snapshots.size()] };
+		snapshot.tick = SimulationSnapshot::INVALID_TICK;
+		return snapshot;
+	}
+
+	const SimulationSnapshot* SnapshotRing::Find(uint64_t tick) const
+	{
+		const SimulationSnapshot& snapshot{ m_snapshots[tick % m_snapshots.size()] };
+		return (snapshot.tick == tick) ? &snapshot : nullptr;
+	}
+
+	size_t SnapshotRing::GetCapacity() const
+	{
+		return m_snapshots.size();
+	}
+#pragma endregion Public
+}
\ No newline at end of file
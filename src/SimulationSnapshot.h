@@ -0,0 +1,53 @@
+#pragma once
+#include "InputEvents.h"
+#include "World.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// SimulationSnapshot is a full copy of the Simulation's state as of the start of
+	/// a tick. Copying into a snapshot that already holds a world of similar size
+	/// reuses its storage, so steady-state captures are plain copies of the SoA streams.
+	/// A capture is bound by memory bandwidth at World::GetByteSize, about 52 bytes
+	/// per entity: a few microseconds buys a few thousand entities, while 100k
+	/// entities take a few hundred microseconds, so capture every tick only while
+	/// that fits the frame budget.
+	/// </summary>
+	struct SimulationSnapshot
+	{
+		static constexpr uint64_t INVALID_TICK{ std::numeric_limits<uint64_t>::max() };
+
+		uint64_t tick{ INVALID_TICK };
+		World world;
+		KeyState keyState;
+	};
+
+	/// <summary>
+	/// SnapshotRing keeps the most recent snapshots in a preallocated ring, one slot
+	/// per tick, overwriting the oldest.
+	/// </summary>
+	class SnapshotRing
+	{
+	public:
+		SnapshotRing(size_t capacity, size_t entityCapacity);
+
+		/// <summary>
+		/// Returns the slot for tick to capture into, evicting whatever it held.
+		/// </summary>
+		SimulationSnapshot& Acquire(uint64_t tick);
+
+		/// <summary>
+		/// Returns the snapshot taken at tick, or nullptr if it has been overwritten
+		/// or was never taken.
+		/// </summary>
+		const SimulationSnapshot* Find(uint64_t tick) const;
+		size_t GetCapacity() const;
+
+	private:
+		std::vector<SimulationSnapshot> m_snapshots;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,405 @@
+#include "pch.h"
+#include "SoftwareRasterizer.h"
+#include "JobSystem.h"
+
+#include <cmath>
+#include <fstream>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define HELLOTRIANGLE_RASTER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// R8G8B8A8_UNORM conversion, rounding to nearest like the GPU does. NaN maps
+		// to 0, as _mm_max_ps does in the SSE2 path.
+		uint32_t PackColor(float r, float g, float b, float a)
+		{
+			auto toUnorm = [](float value) -> uint32_t
+			{
+				return static_cast<uint32_t>(std::lrintf(((value > 0.0f) ? std::min(value, 1.0f) : 0.0f) * 255.0f));
+			};
+			return toUnorm(r) | (toUnorm(g) << 8) | (toUnorm(b) << 16) | (toUnorm(a) << 24);
+		}
+	}
+
+#pragma region Public
+	SoftwareRasterizer::SoftwareRasterizer(
+		uint32_t width,
+		uint32_t height,
+		JobSystem* jobSystem,
+		bool useSimd
+	) :
+		m_width{ width },
+		m_height{ height },
+		m_tilesX{ (width + TILE_SIZE - 1) / TILE_SIZE },
+		m_tilesY{ (height + TILE_SIZE - 1) / TILE_SIZE },
+		m_jobSystem{ jobSystem },
+		m_useSimd{ useSimd },
+		m_pixels(static_cast<size_t>(width) * height, 0),
+		m_tileBins(static_cast<size_t>(m_tilesX) * m_tilesY),
+		m_tilePixelCounts(static_cast<size_t>(m_tilesX) * m_tilesY, 0)
+	{ }
+
+	void SoftwareRasterizer::Clear(const float color[4])
+	{
+		std::fill(m_pixels.begin(), m_pixels.end(), PackColor(color[0], color[1], color[2], color[3]));
+	}
+
+	void SoftwareRasterizer::Draw(const Vertex* vertices, uint32_t vertexCount)
+	{
+		const InstanceData identity{ { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } };
+		DrawInstanced(vertices, vertexCount, &identity, 1);
+	}
+
+	void SoftwareRasterizer::DrawInstanced(
+		const Vertex* vertices,
+		uint32_t vertexCount,
+		const InstanceData* instances,
+		uint32_t instanceCount)
+	{
+		for (uint32_t instance = 0; instance < instanceCount; ++instance)
+		{
+			for (uint32_t i = 0; (i + 2) < vertexCount; i += 3)
+			{
+				// Same math as VSMain: scale, offset, then tint
+				const InstanceData& data{ instances[instance] };
+				Vertex transformed[3];
+				for (uint32_t v = 0; v < 3; ++v)
+				{
+					for (uint32_t axis = 0; axis < 3; ++axis)
+					{
+						transformed[v].position[axis] =
+							(vertices[i + v].position[axis] * data.positionScale[3]) + data.positionScale[axis];
+					}
+					for (uint32_t channel = 0; channel < 4; ++channel)
+					{
+						transformed[v].color[channel] = vertices[i + v].color[channel] * data.color[channel];
+					}
+				}
+				BinTriangle(transformed[0], transformed[1], transformed[2]);
+			}
+		}
+	}
+
+	void SoftwareRasterizer::BinTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2)
+	{
+		++m_stats.trianglesSubmitted;
+
+		Triangle triangle{};
+		if (!SetupTriangle(v0, v1, v2, triangle))
+		{
+			++m_stats.trianglesCulled;
+			return;
+		}
+
+		// Bin the triangle into every tile its bounds overlap. Bins hold indices in
+		// submission order, which preserves draw order within each tile.
+		const uint32_t triangleIndex{ static_cast<uint32_t>(m_triangles.size()) };
+		m_triangles.push_back(triangle);
+		const uint32_t tileMinX{ static_cast<uint32_t>(triangle.minX) / TILE_SIZE };
+		const uint32_t tileMaxX{ static_cast<uint32_t>(triangle.maxX) / TILE_SIZE };
+		const uint32_t tileMinY{ static_cast<uint32_t>(triangle.minY) / TILE_SIZE };
+		const uint32_t tileMaxY{ static_cast<uint32_t>(triangle.maxY) / TILE_SIZE };
+		for (uint32_t ty = tileMinY; ty <= tileMaxY; ++ty)
+		{
+			for (uint32_t tx = tileMinX; tx <= tileMaxX; ++tx)
+			{
+				m_tileBins[(ty * m_tilesX) + tx].push_back(triangleIndex);
+			}
+		}
+	}
+
+	void SoftwareRasterizer::Flush()
+	{
+		const uint32_t tileCount{ m_tilesX * m_tilesY };
+		if (m_jobSystem)
+		{
+			m_jobSystem->ParallelFor(tileCount, 1, [this](size_t begin, size_t end)
+				{
+					for (size_t tile = begin; tile < end; ++tile)
+					{
+						RasterizeTile(static_cast<uint32_t>(tile));
+					}
+				});
+		}
+		else
+		{
+			for (uint32_t tile = 0; tile < tileCount; ++tile)
+			{
+				RasterizeTile(tile);
+			}
+		}
+
+		for (uint32_t tile = 0; tile < tileCount; ++tile)
+		{
+			m_stats.pixelsShaded += m_tilePixelCounts[tile];
+			m_tilePixelCounts[tile] = 0;
+			m_tileBins[tile].clear();
+		}
+		m_triangles.clear();
+	}
+
+	bool SoftwareRasterizer::WriteImage(const std::string& path) const
+	{
+		std::ofstream file{ path, std::ios::binary };
+		if (!file)
+		{
+			spdlog::error("SoftwareRasterizer: Could not open '{}' for writing.", path);
+			return false;
+		}
+
+		file << "P6\n" << m_width << " " << m_height << "\n255\n";
+		std::vector<char> row(static_cast<size_t>(m_width) * 3);
+		for (uint32_t y = 0; y < m_height; ++y)
+		{
+			for (uint32_t x = 0; x < m_width; ++x)
+			{
+				const uint32_t pixel{ m_pixels[(static_cast<size_t>(y) * m_width) + x] };
+				row[(x * 3) + 0] = static_cast<char>(pixel & 0xFF);
+				row[(x * 3) + 1] = static_cast<char>((pixel >> 8) & 0xFF);
+				row[(x * 3) + 2] = static_cast<char>((pixel >> 16) & 0xFF);
+			}
+			file.write(row.data(), row.size());
+		}
+		return file.good();
+	}
+
+	uint32_t SoftwareRasterizer::GetWidth() const
+	{
+		return m_width;
+	}
+
+	uint32_t SoftwareRasterizer::GetHeight() const
+	{
+		return m_height;
+	}
+
+	const uint32_t* SoftwareRasterizer::GetPixels() const
+	{
+		return m_pixels.data();
+	}
+
+	const SoftwareRasterizer::Stats& SoftwareRasterizer::GetStats() const
+	{
+		return m_stats;
+	}
+
+	void SoftwareRasterizer::ResetStats()
+	{
+		m_stats = Stats{};
+	}
+#pragma endregion Public
+
+#pragma region Private
+	bool SoftwareRasterizer::SetupTriangle(
+		const Vertex& v0,
+		const Vertex& v1,
+		const Vertex& v2,
+		Triangle& triangle)
+	{
+		// With an identity view-projection VSMain outputs w = 1, so clip space is NDC.
+		// Triangles entirely outside the depth range are clipped away.
+		const Vertex* vertices[3]{ &v0, &v1, &v2 };
+		if (((v0.position[2] < 0.0f) && (v1.position[2] < 0.0f) && (v2.position[2] < 0.0f)) ||
+			((v0.position[2] > 1.0f) && (v1.position[2] > 1.0f) && (v2.position[2] > 1.0f)))
+		{
+			return false;
+		}
+
+		// Viewport transform into pixel space, y down
+		float sx[3];
+		float sy[3];
+		for (size_t i = 0; i < 3; ++i)
+		{
+			sx[i] = ((vertices[i]->position[0] * 0.5f) + 0.5f) * static_cast<float>(m_width);
+			sy[i] = (0.5f - (vertices[i]->position[1] * 0.5f)) * static_cast<float>(m_height);
+		}
+
+		// Positive area means clockwise on screen, which is front-facing by default.
+		// Written so that a NaN area, from a NaN position, is culled too.
+		const float area{
+			((sy[2] - sy[0]) * (sx[1] - sx[0])) - ((sx[2] - sx[0]) * (sy[1] - sy[0]))
+		};
+		if (!(area > 0.0f) || !std::isfinite(area))
+		{
+			return false;
+		}
+
+		const float minX{ std::min({ sx[0], sx[1], sx[2] }) };
+		const float maxX{ std::max({ sx[0], sx[1], sx[2] }) };
+		const float minY{ std::min({ sy[0], sy[1], sy[2] }) };
+		const float maxY{ std::max({ sy[0], sy[1], sy[2] }) };
+		// Clamped before converting, since huge triangles don't fit in an int32_t
+		const float width{ static_cast<float>(m_width) };
+		const float height{ static_cast<float>(m_height) };
+		triangle.minX = static_cast<int32_t>(std::clamp(std::floor(minX), 0.0f, width));
+		triangle.minY = static_cast<int32_t>(std::clamp(std::floor(minY), 0.0f, height));
+		triangle.maxX = static_cast<int32_t>(std::clamp(std::ceil(maxX), -1.0f, width - 1.0f));
+		triangle.maxY = static_cast<int32_t>(std::clamp(std::ceil(maxY), -1.0f, height - 1.0f));
+		if ((triangle.minX > triangle.maxX) || (triangle.minY > triangle.maxY))
+		{
+			return false;
+		}
+
+		// Edge i is opposite vertex i, so it evaluates to area * barycentric i
+		const float inverseArea{ 1.0f / area };
+		for (size_t i = 0; i < 3; ++i)
+		{
+			const size_t a{ (i + 1) % 3 };
+			const size_t b{ (i + 2) % 3 };
+			const float dx{ sx[b] - sx[a] };
+			const float dy{ sy[b] - sy[a] };
+			triangle.edgeA[i] = -dy;
+			triangle.edgeB[i] = dx;
+			triangle.edgeC[i] = (sx[a] * dy) - (sy[a] * dx);
+
+			// Top-left fill rule: pixels exactly on a top or left edge are covered
+			triangle.isTopLeft[i] = ((dy == 0.0f) && (dx > 0.0f)) || (dy < 0.0f);
+		}
+
+		for (size_t channel = 0; channel < 4; ++channel)
+		{
+			triangle.colorA[channel] = 0.0f;
+			triangle.colorB[channel] = 0.0f;
+			triangle.colorC[channel] = 0.0f;
+			for (size_t i = 0; i < 3; ++i)
+			{
+				const float weight{ vertices[i]->color[channel] * inverseArea };
+				triangle.colorA[channel] += triangle.edgeA[i] * weight;
+				triangle.colorB[channel] += triangle.edgeB[i] * weight;
+				triangle.colorC[channel] += triangle.edgeC[i] * weight;
+			}
+		}
+		return true;
+	}
+
+	void SoftwareRasterizer::RasterizeTile(uint32_t tileIndex)
+	{
+		const std::vector<uint32_t>& bin{ m_tileBins[tileIndex] };
+		if (bin.empty())
+		{
+			return;
+		}
+
+		const int32_t tileX{ static_cast<int32_t>((tileIndex % m_tilesX) * TILE_SIZE) };
+		const int32_t tileY{ static_cast<int32_t>((tileIndex / m_tilesX) * TILE_SIZE) };
+		const int32_t tileEndX{ std::min(tileX + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(m_width)) - 1 };
+		const int32_t tileEndY{ std::min(tileY + static_cast<int32_t>(TILE_SIZE), static_cast<int32_t>(m_height)) - 1 };
+		uint64_t pixelCount{ 0 };
+
+		for (uint32_t triangleIndex : bin)
+		{
+			const Triangle& t{ m_triangles[triangleIndex] };
+			const int32_t x0{ std::max(t.minX, tileX) };
+			const int32_t x1{ std::min(t.maxX, tileEndX) };
+			const int32_t y0{ std::max(t.minY, tileY) };
+			const int32_t y1{ std::min(t.maxY, tileEndY) };
+
+			auto shadePixel = [&t](float px, float py, uint32_t& pixel) -> bool
+			{
+				for (size_t i = 0; i < 3; ++i)
+				{
+					// The same comparisons as the SSE2 path, so NaN is outside on both
+					const float w{ (t.edgeA[i] * px) + (t.edgeB[i] * py) + t.edgeC[i] };
+					if (!((w > 0.0f) || ((w == 0.0f) && t.isTopLeft[i])))
+					{
+						return false;
+					}
+				}
+				float color[4];
+				for (size_t channel = 0; channel < 4; ++channel)
+				{
+					color[channel] = (t.colorA[channel] * px) + (t.colorB[channel] * py) + t.colorC[channel];
+				}
+				pixel = PackColor(color[0], color[1], color[2], color[3]);
+				return true;
+			};
+
+			for (int32_t y = y0; y <= y1; ++y)
+			{
+				uint32_t* row{ &m_pixels[static_cast<size_t>(y) * m_width] };
+				const float py{ static_cast<float>(y) + 0.5f };
+				int32_t x{ x0 };
+
+#ifdef HELLOTRIANGLE_RASTER_SSE2
+				// Four pixels at a time. Groups are aligned to the tile, so masked
+				// stores never touch pixels owned by another tile.
+				if (m_useSimd)
+				{
+					x = tileX + (((x0 - tileX) / 4) * 4);
+					const __m128 laneOffsets{ _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f) };
+					const __m128 vy{ _mm_set1_ps(py) };
+					const __m128 zero{ _mm_setzero_ps() };
+					const __m128 scale{ _mm_set1_ps(255.0f) };
+					const __m128 one{ _mm_set1_ps(1.0f) };
+					for (; (x + 3) <= tileEndX && x <= x1; x += 4)
+					{
+						const __m128 vx{ _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets) };
+						const __m128i lane{ _mm_add_epi32(_mm_set1_epi32(x), _mm_setr_epi32(0, 1, 2, 3)) };
+						__m128 mask{ _mm_castsi128_ps(_mm_and_si128(
+							_mm_cmpgt_epi32(lane, _mm_set1_epi32(x0 - 1)),
+							_mm_cmplt_epi32(lane, _mm_set1_epi32(x1 + 1)))) };
+						for (size_t i = 0; i < 3; ++i)
+						{
+							const __m128 w{ _mm_add_ps(_mm_add_ps(
+								_mm_mul_ps(_mm_set1_ps(t.edgeA[i]), vx),
+								_mm_mul_ps(_mm_set1_ps(t.edgeB[i]), vy)),
+								_mm_set1_ps(t.edgeC[i])) };
+							__m128 inside{ _mm_cmpgt_ps(w, zero) };
+							if (t.isTopLeft[i])
+							{
+								inside = _mm_or_ps(inside, _mm_cmpeq_ps(w, zero));
+							}
+							mask = _mm_and_ps(mask, inside);
+						}
+
+						const int laneMask{ _mm_movemask_ps(mask) };
+						if (laneMask == 0)
+						{
+							continue;
+						}
+
+						__m128i packed{ _mm_setzero_si128() };
+						for (int channel = 0; channel < 4; ++channel)
+						{
+							__m128 c{ _mm_add_ps(_mm_add_ps(
+								_mm_mul_ps(_mm_set1_ps(t.colorA[channel]), vx),
+								_mm_mul_ps(_mm_set1_ps(t.colorB[channel]), vy)),
+								_mm_set1_ps(t.colorC[channel])) };
+							c = _mm_min_ps(_mm_max_ps(c, zero), one);
+							const __m128i unorm{ _mm_cvtps_epi32(_mm_mul_ps(c, scale)) };
+							packed = _mm_or_si128(packed, _mm_slli_epi32(unorm, channel * 8));
+						}
+
+						__m128i* destination{ reinterpret_cast<__m128i*>(&row[x]) };
+						const __m128i existing{ _mm_loadu_si128(destination) };
+						const __m128i laneSelect{ _mm_castps_si128(mask) };
+						_mm_storeu_si128(destination, _mm_or_si128(
+							_mm_and_si128(laneSelect, packed),
+							_mm_andnot_si128(laneSelect, existing)));
+
+						for (int bits = laneMask; bits != 0; bits &= (bits - 1))
+						{
+							++pixelCount;
+						}
+					}
+					x = std::max(x, x0);
+				}
+#endif
+				for (; x <= x1; ++x)
+				{
+					if (shadePixel(static_cast<float>(x) + 0.5f, py, row[x]))
+					{
+						++pixelCount;
+					}
+				}
+			}
+		}
+		m_tilePixelCounts[tileIndex] += pixelCount;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
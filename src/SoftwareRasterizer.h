@@ -0,0 +1,106 @@
+#pragma once
+#include "DrawBatcher.h"
+#include "Vertex.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace HelloTriangle
+{
+	class JobSystem;
+
+	/// <summary>
+	/// SoftwareRasterizer is a tile-based CPU implementation of the HelloTriangle
+	/// pipeline: Shaders.hlsl's VSMain with an identity view-projection and a white draw
+	/// tint, the interpolated-color PSMain, the default rasterizer state (back-face
+	/// culling, clockwise front faces) and an R8G8B8A8_UNORM target. Triangles are
+	/// binned into screen tiles and the tiles are shaded in parallel, so no GPU is
+	/// needed to produce or benchmark frames.
+	/// Where SSE2 is available, rows are shaded four pixels at a time. useSimd = false
+	/// forces the scalar path, which produces the same pixels bit for bit; NaN edge
+	/// values count as outside and NaN colors pack to 0 on both.
+	/// </summary>
+	class SoftwareRasterizer
+	{
+	public:
+		struct Stats
+		{
+			uint64_t trianglesSubmitted{ 0 };
+			uint64_t trianglesCulled{ 0 };
+			uint64_t pixelsShaded{ 0 };
+		};
+
+		SoftwareRasterizer(uint32_t width, uint32_t height, JobSystem* jobSystem = nullptr, bool useSimd = true);
+
+		void Clear(const float color[4]);
+
+		/// <summary>
+		/// Queues a triangle list for the current frame, as a single identity instance.
+		/// </summary>
+		void Draw(const Vertex* vertices, uint32_t vertexCount);
+
+		/// <summary>
+		/// Queues one copy of a triangle list per instance, transformed and tinted the
+		/// way VSMain applies InstanceData.
+		/// </summary>
+		void DrawInstanced(
+			const Vertex* vertices,
+			uint32_t vertexCount,
+			const InstanceData* instances,
+			uint32_t instanceCount);
+
+		/// <summary>
+		/// Rasterizes everything queued since the last Flush.
+		/// </summary>
+		void Flush();
+
+		/// <summary>
+		/// Writes the frame as a binary PPM image.
+		/// </summary>
+		bool WriteImage(const std::string& path) const;
+
+		uint32_t GetWidth() const;
+		uint32_t GetHeight() const;
+		const uint32_t* GetPixels() const;
+		const Stats& GetStats() const;
+		void ResetStats();
+
+	private:
+		static constexpr uint32_t TILE_SIZE{ 64 };
+
+		// Screen-space setup for one triangle: three edge functions and one plane
+		// equation per color channel, all of the form a*x + b*y + c.
+		struct Triangle
+		{
+			float edgeA[3];
+			float edgeB[3];
+			float edgeC[3];
+			bool isTopLeft[3];
+			float colorA[4];
+			float colorB[4];
+			float colorC[4];
+			int32_t minX;
+			int32_t minY;
+			int32_t maxX;
+			int32_t maxY;
+		};
+
+		const uint32_t m_width;
+		const uint32_t m_height;
+		const uint32_t m_tilesX;
+		const uint32_t m_tilesY;
+		JobSystem* const m_jobSystem;
+		const bool m_useSimd;
+
+		std::vector<uint32_t> m_pixels;
+		std::vector<Triangle> m_triangles;
+		std::vector<std::vector<uint32_t>> m_tileBins;
+		std::vector<uint64_t> m_tilePixelCounts;
+		Stats m_stats;
+
+		void BinTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2);
+		bool SetupTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2, Triangle& triangle);
+		void RasterizeTile(uint32_t tileIndex);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "pch.h"
+#include "SpatialGrid.h"
+
+#include <cmath>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// Cell coordinates are packed into 21 bits per axis for the hash key
+		constexpr int32_t CELL_COORDINATE_LIMIT{ (1 << 20) - 1 };
+
+		constexpr size_t MIN_LOOKUP_CAPACITY{ 64 };
+
+		size_t HashCellKey(uint64_t key, size_t mask)
+		{
+			// Fibonacci hashing; the high bits mix all three axes
+			return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+		}
+	}
+
+#pragma region Public
+	SpatialGrid::SpatialGrid(float cellSize) :
+		m_cellSize{ cellSize },
+		m_inverseCellSize{ 1.0f / cellSize }
+	{ }
+
+	void SpatialGrid::Update(uint32_t id, float x, float y, float z, float radius)
+	{
+		if (id >= m_items.size())
+		{
+			m_items.resize(static_cast<size_t>(id) + 1);
+		}
+		m_maxRadius = std::max(m_maxRadius, radius);
+
+		const int32_t cellX{ ToCellCoordinate(x) };
+		const int32_t cellY{ ToCellCoordinate(y) };
+		const int32_t cellZ{ ToCellCoordinate(z) };
+
+		Item& item{ m_items[id] };
+		if (item.cell != INVALID_CELL)
+		{
+			Cell& current{ m_cells[item.cell] };
+			if ((current.coordinates[0] == cellX) &&
+				(current.coordinates[1] == cellY) &&
+				(current.coordinates[2] == cellZ))
+			{
+				// The common case: still in the same cell
+				current.spheres[item.slot] = Sphere{ x, y, z, radius, id };
+				return;
+			}
+			RemoveFromCell(id);
+		}
+		else
+		{
+			++m_count;
+		}
+
+		const uint32_t cellIndex{ FindOrCreateCell(cellX, cellY, cellZ) };
+		Cell& cell{ m_cells[cellIndex] };
+		item.cell = cellIndex;
+		item.slot = static_cast<uint32_t>(cell.spheres.size());
+		cell.spheres.push_back(Sphere{ x, y, z, radius, id });
+	}
+
+	void SpatialGrid::Remove(uint32_t id)
+	{
+		if (!Contains(id))
+		{
+			return;
+		}
+		RemoveFromCell(id);
+		--m_count;
+	}
+
+	bool SpatialGrid::Contains(uint32_t id) const
+	{
+		return (id < m_items.size()) && (m_items[id].cell != INVALID_CELL);
+	}
+
+	void SpatialGrid::Clear()
+	{
+		m_items.clear();
+		m_cells.clear();
+		m_freeCells.clear();
+		m_lookup.clear();
+		m_occupiedCellCount = 0;
+		m_count = 0;
+		m_maxRadius = 0.0f;
+	}
+
+	void SpatialGrid::QueryAabb(const Aabb& box, std::vector<uint32_t>& ids) const
+	{
+		if (m_count == 0)
+		{
+			return;
+		}
+
+		int32_t first[3];
+		int32_t last[3];
+		uint64_t rangeCellCount{ 1 };
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			first[axis] = ToCellCoordinate(box.min[axis] - m_maxRadius);
+			last[axis] = ToCellCoordinate(box.max[axis] + m_maxRadius);
+			rangeCellCount *= static_cast<uint64_t>(last[axis] - first[axis]) + 1;
+		}
+
+		if (rangeCellCount <= m_occupiedCellCount)
+		{
+			// Small boxes: look up each cell in range
+			for (int32_t z = first[2]; z <= last[2]; ++z)
+			{
+				for (int32_t y = first[1]; y <= last[1]; ++y)
+				{
+					for (int32_t x = first[0]; x <= last[0]; ++x)
+					{
+						const uint32_t cellIndex{ FindCell(MakeCellKey(x, y, z)) };
+						if (cellIndex != INVALID_CELL)
+						{
+							QueryCell(m_cells[cellIndex], box, ids);
+						}
+					}
+				}
+			}
+			return;
+		}
+
+		// Large boxes: cheaper to walk the occupied cells
+		for (const Cell& cell : m_cells)
+		{
+			if (!cell.spheres.empty() &&
+				(cell.coordinates[0] >= first[0]) && (cell.coordinates[0] <= last[0]) &&
+				(cell.coordinates[1] >= first[1]) && (cell.coordinates[1] <= last[1]) &&
+				(cell.coordinates[2] >= first[2]) && (cell.coordinates[2] <= last[2]))
+			{
+				QueryCell(cell, box, ids);
+			}
+		}
+	}
+
+	void SpatialGrid::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const
+	{
+		for (const Cell& cell : m_cells)
+		{
+			if (cell.spheres.empty())
+			{
+				continue;
+			}
+
+			const Containment containment{ frustum.TestAabb(GetLooseCellBounds(cell)) };
+			if (containment == Containment::Outside)
+			{
+				continue;
+			}
+			if (containment == Containment::Inside)
+			{
+				for (const Sphere& sphere : cell.spheres)
+				{
+					ids.push_back(sphere.id);
+				}
+				continue;
+			}
+
+			for (const Sphere& sphere : cell.spheres)
+			{
+				if (frustum.ContainsSphere(sphere.x, sphere.y, sphere.z, sphere.radius))
+				{
+					ids.push_back(sphere.id);
+				}
+			}
+		}
+	}
+
+	size_t SpatialGrid::GetCount() const
+	{
+		return m_count;
+	}
+
+	size_t SpatialGrid::GetCellCount() const
+	{
+		return m_occupiedCellCount;
+	}
+
+	float SpatialGrid::GetCellSize() const
+	{
+		return m_cellSize;
+	}
+#pragma endregion Public
+
+#pragma region Private
+	int32_t SpatialGrid::ToCellCoordinate(float value) const
+	{
+		const float cell{ std::floor(value * m_inverseCellSize) };
+		return static_cast<int32_t>(std::clamp(
+			cell,
+			static_cast<float>(-CELL_COORDINATE_LIMIT),
+			static_cast<float>(CELL_COORDINATE_LIMIT)));
+	}
+
+	uint64_t SpatialGrid::MakeCellKey(int32_t x, int32_t y, int32_t z)
+	{
+		constexpr uint64_t MASK{ (1ull << 21) - 1 };
+		return (static_cast<uint64_t>(x + CELL_COORDINATE_LIMIT) & MASK) |
+			((static_cast<uint64_t>(y + CELL_COORDINATE_LIMIT) & MASK) << 21) |
+			((static_cast<uint64_t>(z + CELL_COORDINATE_LIMIT) & MASK) << 42);
+	}
+
+	uint32_t SpatialGrid::FindCell(uint64_t key) const
+	{
+		if (m_lookup.empty())
+		{
+			return INVALID_CELL;
+		}
+
+		const size_t mask{ m_lookup.size() - 1 };
+		for (size_t slot = HashCellKey(key, mask); ; slot = (slot + 1) & mask)
+		{
+			const LookupSlot& entry{ m_lookup[slot] };
+			if (entry.key == key)
+			{
+				return entry.cell;
+			}
+			if (entry.key == EMPTY_KEY)
+			{
+				return INVALID_CELL;
+			}
+		}
+	}
+
+	uint32_t SpatialGrid::FindOrCreateCell(int32_t x, int32_t y, int32_t z)
+	{
+		const uint64_t key{ MakeCellKey(x, y, z) };
+		const uint32_t found{ FindCell(key) };
+		if (found != INVALID_CELL)
+		{
+			return found;
+		}
+
+		// Reuse emptied cells so their vectors keep their capacity
+		uint32_t cellIndex{ 0 };
+		if (!m_freeCells.empty())
+		{
+			cellIndex = m_freeCells.back();
+			m_freeCells.pop_back();
+		}
+		else
+		{
+			cellIndex = static_cast<uint32_t>(m_cells.size());
+			m_cells.emplace_back();
+		}
+
+		Cell& cell{ m_cells[cellIndex] };
+		cell.coordinates[0] = x;
+		cell.coordinates[1] = y;
+		cell.coordinates[2] = z;
+		InsertLookup(key, cellIndex);
+		return cellIndex;
+	}
+
+	void SpatialGrid::InsertLookup(uint64_t key, uint32_t cell)
+	{
+		// Keep the table at most half full so probe runs stay short
+		if ((m_occupiedCellCount + 1) * 2 > m_lookup.size())
+		{
+			std::vector<LookupSlot> previous{ std::move(m_lookup) };
+			m_lookup.assign(std::max(MIN_LOOKUP_CAPACITY, previous.size() * 2), LookupSlot{ EMPTY_KEY, INVALID_CELL });
+			const size_t mask{ m_lookup.size() - 1 };
+			for (const LookupSlot& entry : previous)
+			{
+				if (entry.key == EMPTY_KEY)
+				{
+					continue;
+				}
+				size_t slot{ HashCellKey(entry.key, mask) };
+				while (m_lookup[slot].key != EMPTY_KEY)
+				{
+					slot = (slot + 1) & mask;
+				}
+				m_lookup[slot] = entry;
+			}
+		}
+
+		const size_t mask{ m_lookup.size() - 1 };
+		size_t slot{ HashCellKey(key, mask) };
+		while (m_lookup[slot].key != EMPTY_KEY)
+		{
+			slot = (slot + 1) & mask;
+		}
+		m_lookup[slot] = LookupSlot{ key, cell };
+		++m_occupiedCellCount;
+	}
+
+	void SpatialGrid::EraseLookup(uint64_t key)
+	{
+		const size_t mask{ m_lookup.size() - 1 };
+		size_t hole{ HashCellKey(key, mask) };
+		while (m_lookup[hole].key != key)
+		{
+			hole = (hole + 1) & mask;
+		}
+
+		// Backward-shift the rest of the probe run instead of leaving a tombstone
+		for (size_t slot = (hole + 1) & mask; m_lookup[slot].key != EMPTY_KEY; slot = (slot + 1) & mask)
+		{
+			const size_t home{ HashCellKey(m_lookup[slot].key, mask) };
+			const size_t distanceToHole{ (hole - home) & mask };
+			const size_t distanceToSlot{ (slot - home) & mask };
+			if (distanceToHole < distanceToSlot)
+			{
+				m_lookup[hole] = m_lookup[slot];
+				hole = slot;
+			}
+		}
+		m_lookup[hole] = LookupSlot{ EMPTY_KEY, INVALID_CELL };
+		--m_occupiedCellCount;
+	}
+
+	void SpatialGrid::RemoveFromCell(uint32_t id)
+	{
+		Item& item{ m_items[id] };
+		Cell& cell{ m_cells[item.cell] };
+
+		// Swap with the cell's last sphere so the cell stays packed
+		const uint32_t lastSlot{ static_cast<uint32_t>(cell.spheres.size() - 1) };
+		if (item.slot != lastSlot)
+		{
+			cell.spheres[item.slot] = cell.spheres[lastSlot];
+			m_items[cell.spheres[item.slot].id].slot = item.slot;
+		}
+		cell.spheres.pop_back();
+
+		if (cell.spheres.empty())
+		{
+			EraseLookup(MakeCellKey(cell.coordinates[0], cell.coordinates[1], cell.coordinates[2]));
+			m_freeCells.push_back(item.cell);
+		}
+		item.cell = INVALID_CELL;
+	}
+
+	Aabb SpatialGrid::GetLooseCellBounds(const Cell& cell) const
+	{
+		Aabb bounds{};
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			bounds.min[axis] = (static_cast<float>(cell.coordinates[axis]) * m_cellSize) - m_maxRadius;
+			bounds.max[axis] = (static_cast<float>(cell.coordinates[axis] + 1) * m_cellSize) + m_maxRadius;
+		}
+		return bounds;
+	}
+
+	void SpatialGrid::QueryCell(const Cell& cell, const Aabb& box, std::vector<uint32_t>& ids) const
+	{
+		for (const Sphere& sphere : cell.spheres)
+		{
+			if (SphereIntersectsAabb(sphere.x, sphere.y, sphere.z, sphere.radius, box))
+			{
+				ids.push_back(sphere.id);
+			}
+		}
+	}
+#pragma endregion Private
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#pragma once
+#include "Bounds.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// SpatialGrid is a loose, hashed uniform grid of spheres keyed by caller ids.
+	/// Each sphere lives in the one cell that contains its center, and queries widen
+	/// their search by the largest radius seen, so objects never straddle cells and
+	/// a move only touches the grid when the center crosses a cell boundary. Only
+	/// occupied cells exist, found through an open-addressing hash of their
+	/// coordinates. Each cell keeps its spheres packed together, so a cell costs a
+	/// couple of cache lines to test.
+	/// Queries are const and may run concurrently with each other, but not with
+	/// updates.
+	/// </summary>
+	class SpatialGrid
+	{
+	public:
+		SpatialGrid(float cellSize);
+
+		/// <summary>
+		/// Inserts id, or moves it if it's already in the grid.
+		/// </summary>
+		void Update(uint32_t id, float x, float y, float z, float radius);
+		void Remove(uint32_t id);
+		bool Contains(uint32_t id) const;
+		void Clear();
+
+		/// <summary>
+		/// Removes every id for which shouldRemove(id) returns true.
+		/// </summary>
+		template<typename Predicate>
+		void RemoveIf(Predicate&& shouldRemove)
+		{
+			for (uint32_t id = 0; id < m_items.size(); ++id)
+			{
+				if ((m_items[id].cell != INVALID_CELL) && shouldRemove(id))
+				{
+					Remove(id);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Appends the ids of every sphere that touches box.
+		/// </summary>
+		void QueryAabb(const Aabb& box, std::vector<uint32_t>& ids) const;
+
+		/// <summary>
+		/// Appends the ids of every sphere not entirely outside frustum.
+		/// </summary>
+		void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const;
+
+		size_t GetCount() const;
+		size_t GetCellCount() const;
+		float GetCellSize() const;
+
+	private:
+		static constexpr uint32_t INVALID_CELL{ std::numeric_limits<uint32_t>::max() };
+
+		struct Item
+		{
+			uint32_t cell{ INVALID_CELL };
+			uint32_t slot{ 0 };
+		};
+
+		struct Sphere
+		{
+			float x;
+			float y;
+			float z;
+			float radius;
+			uint32_t id;
+		};
+
+		struct Cell
+		{
+			int32_t coordinates[3];
+			std::vector<Sphere> spheres;
+		};
+
+		// Open-addressing slot mapping a cell key to its index in m_cells
+		struct LookupSlot
+		{
+			uint64_t key;
+			uint32_t cell;
+		};
+		static constexpr uint64_t EMPTY_KEY{ std::numeric_limits<uint64_t>::max() };
+
+		const float m_cellSize;
+		const float m_inverseCellSize;
+
+		// Largest radius ever inserted; queries are widened by this much
+		float m_maxRadius{ 0.0f };
+
+		std::vector<Item> m_items;
+		std::vector<Cell> m_cells;
+		std::vector<uint32_t> m_freeCells;
+		size_t m_count{ 0 };
+
+		// Power-of-two sized, at most half full, linear probing
+		std::vector<LookupSlot> m_lookup;
+		size_t m_occupiedCellCount{ 0 };
+
+		int32_t ToCellCoordinate(float value) const;
+		static uint64_t MakeCellKey(int32_t x, int32_t y, int32_t z);
+		uint32_t FindCell(uint64_t key) const;
+		uint32_t FindOrCreateCell(int32_t x, int32_t y, int32_t z);
+		void InsertLookup(uint64_t key, uint32_t cell);
+		void EraseLookup(uint64_t key);
+		void RemoveFromCell(uint32_t id);
+		Aabb GetLooseCellBounds(const Cell& cell) const;
+		void QueryCell(const Cell& cell, const Aabb& box, std::vector<uint32_t>& ids) const;
+	};
+}
\ No newline at end of file
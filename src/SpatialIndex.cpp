@@ -0,0 +1,164 @@
+#include "pch.h"
+#include "SpatialIndex.h"
+#include "JobSystem.h"
+#include "World.h"
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// Queries handed to a job at a time
+		constexpr size_t QUERIES_PER_CHUNK{ 64 };
+	}
+
+#pragma region Public
+	SpatialIndex::SpatialIndex(const Config& config) :
+		m_config{ config },
+		m_grid{ config.cellSize }
+	{ }
+
+	void SpatialIndex::Sync(const World& world)
+	{
+		const ComponentPool<World::POSITION_FIELDS>& positions{ world.GetPositions() };
+		const size_t movingCount{ world.GetMovingCount() };
+		const size_t gridCount{ m_config.useStaticBvh ? movingCount : positions.Size() };
+		const Entity* entities{ positions.Entities() };
+		const float* x{ positions.Field(0) };
+		const float* y{ positions.Field(1) };
+		const float* z{ positions.Field(2) };
+
+		// Most moving entities stay in their cell, which is just a store
+		for (size_t i = 0; i < gridCount; ++i)
+		{
+			m_grid.Update(entities[i].index, x[i], y[i], z[i], m_config.entityRadius);
+		}
+
+		// Every current entity is in the grid now, so any surplus is stale: entities
+		// that were destroyed or stopped moving since the last sync.
+		if (m_grid.GetCount() != gridCount)
+		{
+			m_grid.RemoveIf([&positions, gridCount](uint32_t entityIndex)
+			{
+				// The grid only keeps slots; a slot reused since is a different
+				// entity, but one that is in the grid now if it is moving
+				return positions.IndexOfSlot(entityIndex) >= gridCount;
+			});
+		}
+
+		if (!m_config.useStaticBvh)
+		{
+			return;
+		}
+		if (m_isStaticBvhValid && (m_staticVersion == world.GetStaticVersion()))
+		{
+			return;
+		}
+
+		const size_t staticCount{ positions.Size() - movingCount };
+		m_staticIds.resize(staticCount);
+		for (size_t i = 0; i < staticCount; ++i)
+		{
+			m_staticIds[i] = entities[movingCount + i].index;
+		}
+		m_staticBvh.Build(
+			staticCount,
+			m_staticIds.data(),
+			x + movingCount,
+			y + movingCount,
+			z + movingCount,
+			nullptr,
+			m_config.entityRadius);
+		m_isStaticBvhValid = true;
+		m_staticVersion = world.GetStaticVersion();
+		++m_bvhBuildCount;
+	}
+
+	void SpatialIndex::Invalidate()
+	{
+		m_grid.Clear();
+		m_staticBvh.Clear();
+		m_isStaticBvhValid = false;
+	}
+
+	void SpatialIndex::QueryAabb(const Aabb& box, std::vector<uint32_t>& entityIndices) const
+	{
+		m_grid.QueryAabb(box, entityIndices);
+		m_staticBvh.QueryAabb(box, entityIndices);
+	}
+
+	void SpatialIndex::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& entityIndices) const
+	{
+		m_grid.QueryFrustum(frustum, entityIndices);
+		m_staticBvh.QueryFrustum(frustum, entityIndices);
+	}
+
+	void SpatialIndex::QueryAabbs(
+		const Aabb* boxes,
+		size_t count,
+		SpatialQueryResults& results,
+		JobSystem* jobSystem) const
+	{
+		// Each chunk collects its results separately, then they're stitched
+		// together in query order, so the output doesn't depend on scheduling.
+		const size_t chunkCount{ (count + QUERIES_PER_CHUNK - 1) / QUERIES_PER_CHUNK };
+		if (results.chunkEntityIndices.size() < chunkCount)
+		{
+			results.chunkEntityIndices.resize(chunkCount);
+			results.chunkCounts.resize(chunkCount);
+		}
+
+		auto queryChunks = [this, boxes, count, &results](size_t beginChunk, size_t endChunk)
+		{
+			for (size_t chunk = beginChunk; chunk < endChunk; ++chunk)
+			{
+				std::vector<uint32_t>& chunkIndices{ results.chunkEntityIndices[chunk] };
+				std::vector<uint32_t>& chunkCounts{ results.chunkCounts[chunk] };
+				chunkIndices.clear();
+				chunkCounts.clear();
+				const size_t end{ std::min(count, (chunk + 1) * QUERIES_PER_CHUNK) };
+				for (size_t query = chunk * QUERIES_PER_CHUNK; query < end; ++query)
+				{
+					const size_t before{ chunkIndices.size() };
+					QueryAabb(boxes[query], chunkIndices);
+					chunkCounts.push_back(static_cast<uint32_t>(chunkIndices.size() - before));
+				}
+			}
+		};
+
+		if (jobSystem)
+		{
+			jobSystem->ParallelFor(chunkCount, 1, queryChunks);
+		}
+		else
+		{
+			queryChunks(0, chunkCount);
+		}
+
+		results.offsets.resize(count + 1);
+		results.entityIndices.clear();
+		results.offsets[0] = 0;
+		size_t query{ 0 };
+		for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+		{
+			const std::vector<uint32_t>& chunkIndices{ results.chunkEntityIndices[chunk] };
+			results.entityIndices.insert(results.entityIndices.end(), chunkIndices.begin(), chunkIndices.end());
+			for (const uint32_t queryCount : results.chunkCounts[chunk])
+			{
+				results.offsets[query + 1] = results.offsets[query] + queryCount;
+				++query;
+			}
+		}
+	}
+
+	SpatialIndex::Stats SpatialIndex::GetStats() const
+	{
+		Stats stats;
+		stats.dynamicCount = m_grid.GetCount();
+		stats.staticCount = m_staticBvh.GetCount();
+		stats.cellCount = m_grid.GetCellCount();
+		stats.bvhNodeCount = m_staticBvh.GetNodeCount();
+		stats.bvhBuildCount = m_bvhBuildCount;
+		return stats;
+	}
+#pragma endregion Public
+}
\ No newline at end of file
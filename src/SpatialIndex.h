@@ -0,0 +1,101 @@
+#pragma once
+#include "Bounds.h"
+#include "SpatialGrid.h"
+#include "StaticBvh.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	class JobSystem;
+	class World;
+
+	/// <summary>
+	/// SpatialQueryResults holds the answers to a batch of queries: query i's
+	/// entity indices are entityIndices[offsets[i]] .. entityIndices[offsets[i + 1]].
+	/// Reusing one across frames keeps its storage.
+	/// </summary>
+	struct SpatialQueryResults
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> entityIndices;
+
+		// Per-chunk scratch for parallel queries
+		std::vector<std::vector<uint32_t>> chunkEntityIndices;
+		std::vector<std::vector<uint32_t>> chunkCounts;
+	};
+
+	/// <summary>
+	/// SpatialIndex answers range and frustum queries over a World's positioned
+	/// entities, treating each as a sphere of a fixed radius. Moving entities live in
+	/// a loose grid that Sync updates in place each tick; static entities optionally
+	/// live in a BVH that is only rebuilt when World::GetStaticVersion changes.
+	/// Results are entity indices (Entity::index).
+	/// </summary>
+	class SpatialIndex
+	{
+	public:
+		struct Config
+		{
+			float cellSize{ 1.0f };
+			float entityRadius{ 0.05f };
+			bool useStaticBvh{ true };
+		};
+
+		struct Stats
+		{
+			size_t dynamicCount{ 0 };
+			size_t staticCount{ 0 };
+			size_t cellCount{ 0 };
+			size_t bvhNodeCount{ 0 };
+			uint64_t bvhBuildCount{ 0 };
+		};
+
+		SpatialIndex(const Config& config);
+
+		/// <summary>
+		/// Brings the index up to date with world's positions.
+		/// </summary>
+		void Sync(const World& world);
+
+		/// <summary>
+		/// Forces the next Sync to rebuild everything, e.g. after the world was
+		/// replaced wholesale by a snapshot restore.
+		/// </summary>
+		void Invalidate();
+
+		/// <summary>
+		/// Appends every entity that touches box.
+		/// </summary>
+		void QueryAabb(const Aabb& box, std::vector<uint32_t>& entityIndices) const;
+
+		/// <summary>
+		/// Appends every entity not entirely outside frustum.
+		/// </summary>
+		void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& entityIndices) const;
+
+		/// <summary>
+		/// Answers count box queries, split across jobSystem's threads if given.
+		/// Each query's results are in the same order QueryAabb would give.
+		/// </summary>
+		void QueryAabbs(
+			const Aabb* boxes,
+			size_t count,
+			SpatialQueryResults& results,
+			JobSystem* jobSystem = nullptr) const;
+
+		Stats GetStats() const;
+
+	private:
+		const Config m_config;
+		SpatialGrid m_grid;
+		StaticBvh m_staticBvh;
+		bool m_isStaticBvhValid{ false };
+		uint64_t m_staticVersion{ 0 };
+		uint64_t m_bvhBuildCount{ 0 };
+
+		// Scratch for rebuilding the BVH
+		std::vector<uint32_t> m_staticIds;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// SpscRingBuffer is a fixed-capacity, lock-free queue for exactly one producer
+	/// thread and one consumer thread. It never allocates after construction.
+	/// Capacity must be a power of two.
+	/// </summary>
+	template<typename T, size_t Capacity>
+	class SpscRingBuffer
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	public:
+		/// <summary>
+		/// Producer only. Returns false if the buffer is full.
+		/// </summary>
+		bool TryPush(const T& item)
+		{
+			const size_t head{ m_head.load(std::memory_order_relaxed) };
+			const size_t tail{ m_tail.load(std::memory_order_acquire) };
+			if ((head - tail) == Capacity)
+			{
+				return false;
+			}
+			m_items[head & (Capacity - 1)] = item;
+			m_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// <summary>
+		/// Consumer only. Returns false if the buffer is empty.
+		/// </summary>
+		bool TryPop(T& item)
+		{
+			const size_t tail{ m_tail.load(std::memory_order_relaxed) };
+			const size_t head{ m_head.load(std::memory_order_acquire) };
+			if (head == tail)
+			{
+				return false;
+			}
+			item = m_items[tail & (Capacity - 1)];
+			m_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		size_t Size() const
+		{
+			return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+		}
+
+	private:
+		// Keep the producer and consumer indices on separate cache lines
+		alignas(64) std::atomic<size_t> m_head{ 0 };
+		alignas(64) std::atomic<size_t> m_tail{ 0 };
+		std::array<T, Capacity> m_items{};
+	};
+}
\ No newline at end of file
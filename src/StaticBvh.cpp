@@ -0,0 +1,252 @@
+#include "pch.h"
+#include "StaticBvh.h"
+
+#include <limits>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// Deep enough for any tree over 2^32 spheres with median splits
+		constexpr size_t MAX_TRAVERSAL_DEPTH{ 64 };
+	}
+
+#pragma region Public
+	void StaticBvh::Build(
+		size_t count,
+		const uint32_t* ids,
+		const float* x,
+		const float* y,
+		const float* z,
+		const float* radius,
+		float defaultRadius)
+	{
+		Clear();
+		if (count == 0)
+		{
+			return;
+		}
+
+		m_order.resize(count);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			m_order[i] = i;
+		}
+
+		// Split nodes breadth-first; each split reorders its slice of m_order
+		// Median splits leave at least LEAF_SIZE / 2 spheres per leaf
+		m_nodes.reserve(((4 * count) / LEAF_SIZE) + 1);
+		m_nodes.push_back(Node{ {}, 0, static_cast<uint32_t>(count) });
+		const float* const centers[3]{ x, y, z };
+		for (size_t nodeIndex = 0; nodeIndex < m_nodes.size(); ++nodeIndex)
+		{
+			const uint32_t first{ m_nodes[nodeIndex].first };
+			const uint32_t nodeCount{ m_nodes[nodeIndex].count };
+			if (nodeCount <= LEAF_SIZE)
+			{
+				continue;
+			}
+
+			// Longest axis of the centers' extent
+			float minimum[3]{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+			float maximum[3]{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+			for (uint32_t i = first; i < (first + nodeCount); ++i)
+			{
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					minimum[axis] = std::min(minimum[axis], centers[axis][m_order[i]]);
+					maximum[axis] = std::max(maximum[axis], centers[axis][m_order[i]]);
+				}
+			}
+			size_t splitAxis{ 0 };
+			for (size_t axis = 1; axis < 3; ++axis)
+			{
+				if ((maximum[axis] - minimum[axis]) > (maximum[splitAxis] - minimum[splitAxis]))
+				{
+					splitAxis = axis;
+				}
+			}
+
+			const uint32_t half{ nodeCount / 2 };
+			const float* center{ centers[splitAxis] };
+			std::nth_element(
+				m_order.begin() + first,
+				m_order.begin() + first + half,
+				m_order.begin() + first + nodeCount,
+				[center](uint32_t a, uint32_t b) { return center[a] < center[b]; });
+
+			const uint32_t childIndex{ static_cast<uint32_t>(m_nodes.size()) };
+			m_nodes[nodeIndex].first = childIndex;
+			m_nodes[nodeIndex].count = 0;
+			m_nodes.push_back(Node{ {}, first, half });
+			m_nodes.push_back(Node{ {}, first + half, nodeCount - half });
+		}
+
+		// Lay the spheres out in leaf order
+		m_ids.resize(count);
+		m_x.resize(count);
+		m_y.resize(count);
+		m_z.resize(count);
+		m_radius.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint32_t source{ m_order[i] };
+			m_ids[i] = ids[source];
+			m_x[i] = x[source];
+			m_y[i] = y[source];
+			m_z[i] = z[source];
+			m_radius[i] = radius ? radius[source] : defaultRadius;
+		}
+
+		// Children always follow their parents, so a reverse pass sees them first
+		for (size_t nodeIndex = m_nodes.size(); nodeIndex-- > 0;)
+		{
+			Node& node{ m_nodes[nodeIndex] };
+			if (node.count > 0)
+			{
+				node.bounds = ComputeBounds(node.first, node.count);
+				continue;
+			}
+
+			const Aabb& left{ m_nodes[node.first].bounds };
+			const Aabb& right{ m_nodes[node.first + 1].bounds };
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				node.bounds.min[axis] = std::min(left.min[axis], right.min[axis]);
+				node.bounds.max[axis] = std::max(left.max[axis], right.max[axis]);
+			}
+		}
+	}
+
+	void StaticBvh::Clear()
+	{
+		m_nodes.clear();
+		m_ids.clear();
+		m_x.clear();
+		m_y.clear();
+		m_z.clear();
+		m_radius.clear();
+	}
+
+	void StaticBvh::QueryAabb(const Aabb& box, std::vector<uint32_t>& ids) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		uint32_t stack[MAX_TRAVERSAL_DEPTH];
+		size_t stackSize{ 0 };
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			const Node& node{ m_nodes[stack[--stackSize]] };
+			const bool overlaps{
+				(node.bounds.min[0] <= box.max[0]) && (node.bounds.max[0] >= box.min[0]) &&
+				(node.bounds.min[1] <= box.max[1]) && (node.bounds.max[1] >= box.min[1]) &&
+				(node.bounds.min[2] <= box.max[2]) && (node.bounds.max[2] >= box.min[2])
+			};
+			if (!overlaps)
+			{
+				continue;
+			}
+
+			if (node.count == 0)
+			{
+				stack[stackSize++] = node.first;
+				stack[stackSize++] = node.first + 1;
+				continue;
+			}
+			for (uint32_t i = node.first; i < (node.first + node.count); ++i)
+			{
+				if (SphereIntersectsAabb(m_x[i], m_y[i], m_z[i], m_radius[i], box))
+				{
+					ids.push_back(m_ids[i]);
+				}
+			}
+		}
+	}
+
+	void StaticBvh::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const
+	{
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		// Once a node is fully inside, everything below it is too
+		struct Entry
+		{
+			uint32_t node;
+			bool isInside;
+		};
+		Entry stack[MAX_TRAVERSAL_DEPTH];
+		size_t stackSize{ 0 };
+		stack[stackSize++] = Entry{ 0, false };
+		while (stackSize > 0)
+		{
+			const Entry entry{ stack[--stackSize] };
+			const Node& node{ m_nodes[entry.node] };
+			bool isInside{ entry.isInside };
+			if (!isInside)
+			{
+				const Containment containment{ frustum.TestAabb(node.bounds) };
+				if (containment == Containment::Outside)
+				{
+					continue;
+				}
+				isInside = (containment == Containment::Inside);
+			}
+
+			if (node.count == 0)
+			{
+				stack[stackSize++] = Entry{ node.first, isInside };
+				stack[stackSize++] = Entry{ node.first + 1, isInside };
+				continue;
+			}
+			if (isInside)
+			{
+				ids.insert(ids.end(), m_ids.begin() + node.first, m_ids.begin() + node.first + node.count);
+				continue;
+			}
+			for (uint32_t i = node.first; i < (node.first + node.count); ++i)
+			{
+				if (frustum.ContainsSphere(m_x[i], m_y[i], m_z[i], m_radius[i]))
+				{
+					ids.push_back(m_ids[i]);
+				}
+			}
+		}
+	}
+
+	size_t StaticBvh::GetCount() const
+	{
+		return m_ids.size();
+	}
+
+	size_t StaticBvh::GetNodeCount() const
+	{
+		return m_nodes.size();
+	}
+#pragma endregion Public
+
+#pragma region Private
+	Aabb StaticBvh::ComputeBounds(uint32_t first, uint32_t count) const
+	{
+		Aabb bounds{
+			{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() },
+			{ std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() }
+		};
+		for (uint32_t i = first; i < (first + count); ++i)
+		{
+			const float center[3]{ m_x[i], m_y[i], m_z[i] };
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				bounds.min[axis] = std::min(bounds.min[axis], center[axis] - m_radius[i]);
+				bounds.max[axis] = std::max(bounds.max[axis], center[axis] + m_radius[i]);
+			}
+		}
+		return bounds;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include "Bounds.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// StaticBvh is a bounding volume hierarchy over spheres that don't move. It is
+	/// rebuilt from scratch rather than refit: nodes split at the median of the
+	/// longest axis of their centers until they hold at most LEAF_SIZE spheres, and
+	/// the spheres are reordered so every leaf is a contiguous SoA range.
+	/// Queries are const and may run concurrently.
+	/// </summary>
+	class StaticBvh
+	{
+	public:
+		static constexpr uint32_t LEAF_SIZE{ 8 };
+
+		/// <summary>
+		/// Replaces the contents with count spheres. radius may be null, in which
+		/// case every sphere has defaultRadius.
+		/// </summary>
+		void Build(
+			size_t count,
+			const uint32_t* ids,
+			const float* x,
+			const float* y,
+			const float* z,
+			const float* radius,
+			float defaultRadius = 0.0f);
+		void Clear();
+
+		/// <summary>
+		/// Appends the ids of every sphere that touches box.
+		/// </summary>
+		void QueryAabb(const Aabb& box, std::vector<uint32_t>& ids) const;
+
+		/// <summary>
+		/// Appends the ids of every sphere not entirely outside frustum.
+		/// </summary>
+		void QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& ids) const;
+
+		size_t GetCount() const;
+		size_t GetNodeCount() const;
+
+	private:
+		// Leaves have count > 0 and cover [first, first + count); interior nodes
+		// have count == 0 and their children at first and first + 1.
+		struct Node
+		{
+			Aabb bounds;
+			uint32_t first;
+			uint32_t count;
+		};
+
+		std::vector<Node> m_nodes;
+		std::vector<uint32_t> m_ids;
+		std::vector<float> m_x;
+		std::vector<float> m_y;
+		std::vector<float> m_z;
+		std::vector<float> m_radius;
+
+		// Build scratch, kept to avoid reallocating on rebuild
+		std::vector<uint32_t> m_order;
+
+		Aabb ComputeBounds(uint32_t first, uint32_t count) const;
+	};
+}
\ No newline at end of file
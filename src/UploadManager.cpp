@@ -0,0 +1,184 @@
+#include "pch.h"
+#include "UploadManager.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	UploadManager::UploadManager(
+		ID3D12Device* device,
+		uint64_t stagingCapacity
+	) :
+		m_device{ device },
+		m_stagingRing{ stagingCapacity }
+	{
+		D3D12_COMMAND_QUEUE_DESC queueDesc{};
+		queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+		queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+		ThrowIfFailed(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_copyQueue)));
+		m_fence = std::make_unique<D3D12Fence>(m_device, m_copyQueue.Get());
+
+		// The staging buffer stays mapped for its whole lifetime
+		CD3DX12_HEAP_PROPERTIES uploadHeap{ D3D12_HEAP_TYPE_UPLOAD };
+		CD3DX12_RESOURCE_DESC bufferResource{ CD3DX12_RESOURCE_DESC::Buffer(stagingCapacity) };
+		ThrowIfFailed(m_device->CreateCommittedResource(
+			&uploadHeap,
+			D3D12_HEAP_FLAG_NONE,
+			&bufferResource,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(&m_stagingBuffer)
+		));
+		CD3DX12_RANGE readRange{ 0, 0 }; // No intention to read on CPU
+		ThrowIfFailed(m_stagingBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_stagingData)));
+	}
+
+	MWRL::ComPtr<ID3D12Resource> UploadManager::CreateBuffer(const void* data, uint64_t size)
+	{
+		MWRL::ComPtr<ID3D12Resource> buffer;
+		CD3DX12_HEAP_PROPERTIES defaultHeap{ D3D12_HEAP_TYPE_DEFAULT };
+		CD3DX12_RESOURCE_DESC bufferResource{ CD3DX12_RESOURCE_DESC::Buffer(size) };
+
+		// Buffers created in COMMON can be written by the copy queue and are
+		// implicitly promoted to whatever read state the direct queue uses them in.
+		ThrowIfFailed(m_device->CreateCommittedResource(
+			&defaultHeap,
+			D3D12_HEAP_FLAG_NONE,
+			&bufferResource,
+			D3D12_RESOURCE_STATE_COMMON,
+			nullptr,
+			IID_PPV_ARGS(&buffer)
+		));
+		UploadBuffer(buffer.Get(), 0, data, size);
+		return buffer;
+	}
+
+	void UploadManager::UploadBuffer(
+		ID3D12Resource* destination,
+		uint64_t destinationOffset,
+		const void* data,
+		uint64_t size)
+	{
+		const uint64_t stagingOffset{ AllocateStaging(size) };
+		memcpy(m_stagingData + stagingOffset, data, size);
+
+		BeginRecording();
+		m_commandList->CopyBufferRegion(
+			destination,
+			destinationOffset,
+			m_stagingBuffer.Get(),
+			stagingOffset,
+			size
+		);
+	}
+
+	uint64_t UploadManager::Submit()
+	{
+		if (!m_isRecording)
+		{
+			return m_lastSubmittedFenceValue;
+		}
+
+		ThrowIfFailed(m_commandList->Close());
+		ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
+		m_copyQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+		m_isRecording = false;
+
+		++m_lastSubmittedFenceValue;
+		m_fence->Signal(m_lastSubmittedFenceValue);
+		m_stagingRing.FinishBatch(m_lastSubmittedFenceValue);
+		m_retiringAllocators.push_back(CommandAllocatorEntry{
+			std::move(m_currentAllocator),
+			m_lastSubmittedFenceValue
+		});
+		return m_lastSubmittedFenceValue;
+	}
+
+	void UploadManager::QueueWait(ID3D12CommandQueue* queue)
+	{
+		m_fence->QueueWait(queue, m_lastSubmittedFenceValue);
+	}
+
+	void UploadManager::WaitForIdle()
+	{
+		m_fence->Wait(m_lastSubmittedFenceValue);
+		m_stagingRing.Retire(m_fence->GetCompletedValue());
+	}
+
+	uint64_t UploadManager::GetStagingBytesInUse() const
+	{
+		return m_stagingRing.GetUsedBytes();
+	}
+#pragma endregion Public
+
+#pragma region Private
+	uint64_t UploadManager::AllocateStaging(uint64_t size)
+	{
+		if (size > m_stagingRing.GetCapacity())
+		{
+			spdlog::error(
+				"UploadManager: {} byte upload exceeds the {} byte staging ring.",
+				size,
+				m_stagingRing.GetCapacity());
+			throw std::exception{};
+		}
+
+		m_stagingRing.Retire(m_fence->GetCompletedValue());
+		uint64_t offset{ m_stagingRing.Allocate(size, STAGING_ALIGNMENT) };
+		while (offset == RingAllocator::INVALID_OFFSET)
+		{
+			if (m_stagingRing.HasOpenAllocations())
+			{
+				// The ring is full of copies that haven't been submitted yet
+				Submit();
+			}
+
+			// Wait for the oldest batch to free up its staging memory
+			m_fence->Wait(m_stagingRing.GetOldestPendingFenceValue());
+			m_stagingRing.Retire(m_fence->GetCompletedValue());
+			offset = m_stagingRing.Allocate(size, STAGING_ALIGNMENT);
+		}
+		return offset;
+	}
+
+	void UploadManager::BeginRecording()
+	{
+		if (m_isRecording)
+		{
+			return;
+		}
+
+		// Reuse an allocator whose batch has already finished on the GPU
+		const uint64_t completedValue{ m_fence->GetCompletedValue() };
+		if (!m_retiringAllocators.empty() &&
+			(m_retiringAllocators.front().fenceValue <= completedValue))
+		{
+			m_currentAllocator = std::move(m_retiringAllocators.front().allocator);
+			m_retiringAllocators.pop_front();
+			ThrowIfFailed(m_currentAllocator->Reset());
+		}
+		else
+		{
+			ThrowIfFailed(m_device->CreateCommandAllocator(
+				D3D12_COMMAND_LIST_TYPE_COPY,
+				IID_PPV_ARGS(&m_currentAllocator)
+			));
+		}
+
+		if (!m_commandList)
+		{
+			ThrowIfFailed(m_device->CreateCommandList(
+				0,
+				D3D12_COMMAND_LIST_TYPE_COPY,
+				m_currentAllocator.Get(),
+				nullptr,
+				IID_PPV_ARGS(&m_commandList)
+			));
+		}
+		else
+		{
+			ThrowIfFailed(m_commandList->Reset(m_currentAllocator.Get(), nullptr));
+		}
+		m_isRecording = true;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+#include "pch.h"
+#include "D3D12Fence.h"
+#include "RingAllocator.h"
+
+#include <deque>
+#include <memory>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// UploadManager moves static data into DEFAULT-heap resources. Data is staged in
+	/// a persistently mapped upload ring, copies are batched onto a dedicated copy
+	/// queue, and staging memory is reclaimed as the copy queue's fence advances.
+	/// </summary>
+	class UploadManager
+	{
+	public:
+		UploadManager(ID3D12Device* device, uint64_t stagingCapacity);
+
+		UploadManager(const UploadManager&) = delete;
+		UploadManager& operator=(const UploadManager&) = delete;
+
+		/// <summary>
+		/// Creates a DEFAULT-heap buffer and queues a copy of data into it. The buffer
+		/// is usable once the batch it was queued in has been submitted and waited on.
+		/// </summary>
+		Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(const void* data, uint64_t size);
+
+		/// <summary>
+		/// Queues a copy of data into an existing buffer in the COMMON state.
+		/// </summary>
+		void UploadBuffer(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size);
+
+		/// <summary>
+		/// Submits all queued copies as one batch. Returns the fence value that marks
+		/// its completion, or the last submitted value if nothing was queued.
+		/// </summary>
+		uint64_t Submit();
+
+		/// <summary>
+		/// Makes the given queue wait (on the GPU) for every submitted copy.
+		/// </summary>
+		void QueueWait(ID3D12CommandQueue* queue);
+
+		/// <summary>
+		/// Blocks the CPU until every submitted copy has completed.
+		/// </summary>
+		void WaitForIdle();
+
+		uint64_t GetStagingBytesInUse() const;
+
+	private:
+		static constexpr uint64_t STAGING_ALIGNMENT{ 16 };
+
+		struct CommandAllocatorEntry
+		{
+			Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator;
+			uint64_t fenceValue;
+		};
+
+		ID3D12Device* const m_device;
+		Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_copyQueue;
+		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_commandList;
+		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_currentAllocator;
+		std::deque<CommandAllocatorEntry> m_retiringAllocators;
+		std::unique_ptr<D3D12Fence> m_fence;
+		uint64_t m_lastSubmittedFenceValue{ 0 };
+		bool m_isRecording{ false };
+
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_stagingBuffer;
+		uint8_t* m_stagingData{ nullptr };
+		RingAllocator m_stagingRing;
+
+		uint64_t AllocateStaging(uint64_t size);
+		void BeginRecording();
+	};
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <exception>
+#include <filesystem>
 
 inline void ThrowIfFailed(HRESULT hr)
 {
@@ -9,4 +10,15 @@ inline void ThrowIfFailed(HRESULT hr)
 	{
 		throw std::exception{};
 	}
+}
+
+inline std::filesystem::path GetExecutableDirectory()
+{
+	wchar_t modulePath[MAX_PATH]{};
+	const DWORD length{ GetModuleFileNameW(nullptr, modulePath, MAX_PATH) };
+	if ((length == 0) || (length == MAX_PATH))
+	{
+		return std::filesystem::current_path();
+	}
+	return std::filesystem::path{ modulePath }.parent_path();
 }
\ No newline at end of file
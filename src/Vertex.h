@@ -0,0 +1,15 @@
+#pragma once
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// Vertex is the POSITION float3 + COLOR float4 layout consumed by Shaders.hlsl.
+	/// It is kept free of DirectXMath so CPU-side consumers don't depend on Windows headers.
+	/// </summary>
+	struct Vertex
+	{
+		float position[3];
+		float color[4];
+	};
+	static_assert(sizeof(Vertex) == 28, "Vertex must match the D3D12 input layout");
+}
\ No newline at end of file
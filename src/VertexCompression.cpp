@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "VertexCompression.h"
+
+#include <cfloat>
+#include <cmath>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr float SNORM16_MAX{ 32767.0f };
+		constexpr float UNORM8_MAX{ 255.0f };
+
+		int16_t EncodeSnorm16(float value)
+		{
+			return static_cast<int16_t>(std::lrint(std::clamp(value, -1.0f, 1.0f) * SNORM16_MAX));
+		}
+
+		float DecodeSnorm16(int16_t value)
+		{
+			return std::max(static_cast<float>(value) / SNORM16_MAX, -1.0f);
+		}
+
+		uint8_t EncodeUnorm8(float value)
+		{
+			// Also maps NaN to 0
+			return static_cast<uint8_t>(std::lrint((value > 0.0f) ? (std::min(value, 1.0f) * UNORM8_MAX) : 0.0f));
+		}
+
+		float DecodeUnorm8(uint8_t value)
+		{
+			return static_cast<float>(value) / UNORM8_MAX;
+		}
+
+		// A uint16 index's distance from the next new vertex fits 18 bits zigzagged,
+		// so three varint bytes
+		constexpr size_t MAX_VARINT_BYTES{ 3 };
+	}
+
+	uint64_t CompressedMeshData::GetByteSize() const
+	{
+		return (vertices.size() * sizeof(CompressedVertex)) + (indices.size() * sizeof(uint16_t));
+	}
+
+	CompressedMeshData CompressMesh(const MeshData& mesh)
+	{
+		CompressedMeshData compressed;
+		compressed.indices = mesh.indices;
+		compressed.quantization = VertexQuantization{ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+		if (mesh.vertices.empty())
+		{
+			return compressed;
+		}
+
+		VertexQuantization& quantization{ compressed.quantization };
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			const auto [min, max]{ std::minmax_element(
+				mesh.vertices.begin(),
+				mesh.vertices.end(),
+				[axis](const Vertex& a, const Vertex& b)
+				{
+					return a.position[axis] < b.position[axis];
+				}) };
+			quantization.offset[axis] = 0.5f * (min->position[axis] + max->position[axis]);
+			quantization.scale[axis] = 0.5f * (max->position[axis] - min->position[axis]);
+		}
+
+		compressed.vertices.resize(mesh.vertices.size());
+		for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		{
+			const Vertex& vertex{ mesh.vertices[i] };
+			CompressedVertex& packed{ compressed.vertices[i] };
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				// A flat axis decodes to its offset whatever is stored
+				const float scale{ quantization.scale[axis] };
+				packed.position[axis] = (scale > 0.0f) ?
+					EncodeSnorm16((vertex.position[axis] - quantization.offset[axis]) / scale) :
+					0;
+			}
+			for (size_t channel = 0; channel < 4; ++channel)
+			{
+				packed.color[channel] = EncodeUnorm8(vertex.color[channel]);
+			}
+		}
+		return compressed;
+	}
+
+	Vertex DecompressVertex(const CompressedVertex& vertex, const VertexQuantization& quantization)
+	{
+		Vertex decoded;
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			decoded.position[axis] = quantization.offset[axis] + (quantization.scale[axis] * DecodeSnorm16(vertex.position[axis]));
+		}
+		for (size_t channel = 0; channel < 4; ++channel)
+		{
+			decoded.color[channel] = DecodeUnorm8(vertex.color[channel]);
+		}
+		return decoded;
+	}
+
+	std::vector<uint8_t> EncodeIndexStream(const std::vector<uint16_t>& indices)
+	{
+		std::vector<uint8_t> bytes;
+		bytes.reserve(indices.size() + (indices.size() / 2));
+		int32_t next{ 0 };
+		for (const uint16_t index : indices)
+		{
+			const int32_t delta{ next - static_cast<int32_t>(index) };
+			uint32_t value{ (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31) };
+			while (value >= 0x80)
+			{
+				bytes.push_back(static_cast<uint8_t>(value | 0x80));
+				value >>= 7;
+			}
+			bytes.push_back(static_cast<uint8_t>(value));
+			next = std::max(next, static_cast<int32_t>(index) + 1);
+		}
+		return bytes;
+	}
+
+	bool DecodeIndexStream(const uint8_t* data, size_t size, size_t indexCount, std::vector<uint16_t>& indices)
+	{
+		indices.resize(indexCount);
+		const uint8_t* read{ data };
+		const uint8_t* end{ data + size };
+		int32_t next{ 0 };
+		for (uint16_t& index : indices)
+		{
+			uint32_t value{ 0 };
+			uint32_t shift{ 0 };
+			bool isComplete{ false };
+			for (size_t i = 0; (i < MAX_VARINT_BYTES) && (read != end); ++i, shift += 7)
+			{
+				const uint8_t byte{ *read++ };
+				value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					isComplete = true;
+					break;
+				}
+			}
+
+			const int32_t delta{ static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1) };
+			const int32_t decoded{ next - delta };
+			if (!isComplete || (decoded < 0) || (decoded > UINT16_MAX))
+			{
+				indices.clear();
+				return false;
+			}
+			index = static_cast<uint16_t>(decoded);
+			next = std::max(next, decoded + 1);
+		}
+
+		if (read != end)
+		{
+			indices.clear();
+			return false;
+		}
+		return true;
+	}
+
+	VertexCompressionError GetVertexCompressionErrorBound(const VertexQuantization& quantization)
+	{
+		// Half a step per axis, plus float rounding in the decode
+		float positionSquared{ 0.0f };
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			const float axisError{
+				(0.5f * quantization.scale[axis] / SNORM16_MAX) +
+				((std::abs(quantization.offset[axis]) + quantization.scale[axis]) * FLT_EPSILON)
+			};
+			positionSquared += axisError * axisError;
+		}
+
+		return VertexCompressionError{
+			.position = std::sqrt(positionSquared),
+			.color = (0.5f / UNORM8_MAX) + FLT_EPSILON,
+		};
+	}
+
+	VertexCompressionError MeasureVertexCompressionError(const MeshData& mesh, const CompressedMeshData& compressed)
+	{
+		VertexCompressionError error;
+		for (size_t i = 0; i < mesh.vertices.size(); ++i)
+		{
+			const Vertex& original{ mesh.vertices[i] };
+			const Vertex decoded{ DecompressVertex(compressed.vertices[i], compressed.quantization) };
+
+			double positionSquared{ 0.0 };
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const double delta{ static_cast<double>(decoded.position[axis]) - original.position[axis] };
+				positionSquared += delta * delta;
+			}
+			error.position = std::max(error.position, static_cast<float>(std::sqrt(positionSquared)));
+
+			for (size_t channel = 0; channel < 4; ++channel)
+			{
+				const float expected{ std::clamp(original.color[channel], 0.0f, 1.0f) };
+				error.color = std::max(error.color, std::abs(decoded.color[channel] - expected));
+			}
+		}
+		return error;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#pragma once
+#include "MeshFile.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	enum class VertexFormat
+	{
+		Float32x3,
+		Float32x4,
+		Snorm16x1,
+		Snorm16x2,
+		Snorm16x4,
+		Unorm8x4,
+	};
+
+	/// <summary>
+	/// VertexAttribute describes one element of a vertex layout without depending on
+	/// a graphics API; D3D12VertexLayout turns it into a D3D12 input element.
+	/// </summary>
+	struct VertexAttribute
+	{
+		const char* semantic;
+		uint32_t semanticIndex;
+		VertexFormat format;
+		uint32_t offset;
+	};
+
+	constexpr uint32_t GetVertexFormatSize(VertexFormat format)
+	{
+		switch (format)
+		{
+		case VertexFormat::Float32x3:
+			return 12;
+		case VertexFormat::Float32x4:
+			return 16;
+		case VertexFormat::Snorm16x1:
+			return 2;
+		case VertexFormat::Snorm16x2:
+		case VertexFormat::Unorm8x4:
+			return 4;
+		case VertexFormat::Snorm16x4:
+			return 8;
+		}
+		return 0;
+	}
+
+	/// <summary>
+	/// True if every attribute starts at a multiple of its format's size, up to 4
+	/// bytes, which is what D3D12 requires of input element offsets.
+	/// </summary>
+	template<size_t N>
+	constexpr bool IsVertexLayoutAligned(const std::array<VertexAttribute, N>& layout)
+	{
+		for (const VertexAttribute& attribute : layout)
+		{
+			const uint32_t alignment{ std::min<uint32_t>(GetVertexFormatSize(attribute.format), 4) };
+			if ((alignment == 0) || ((attribute.offset % alignment) != 0))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr std::array<VertexAttribute, 2> VERTEX_LAYOUT
+	{ {
+		{ "POSITION", 0, VertexFormat::Float32x3, 0 },
+		{ "COLOR", 0, VertexFormat::Float32x4, 12 },
+	} };
+	static_assert(IsVertexLayoutAligned(VERTEX_LAYOUT), "VERTEX_LAYOUT has a misaligned attribute");
+
+	/// <summary>
+	/// CompressedVertex is a 12-byte Vertex, 2.3x smaller. color is UNORM and
+	/// position is SNORM within the mesh's bounds. There is no three-component
+	/// 16-bit vertex format, so the layout splits position into xy and z; color
+	/// goes first so that xy is 4-byte aligned, and padding keeps the stride a
+	/// multiple of 4.
+	/// </summary>
+	struct CompressedVertex
+	{
+		uint8_t color[4];
+		int16_t position[3];
+		int16_t padding;
+	};
+	static_assert(sizeof(CompressedVertex) == 12, "CompressedVertex must match COMPRESSED_VERTEX_LAYOUT");
+
+	constexpr std::array<VertexAttribute, 3> COMPRESSED_VERTEX_LAYOUT
+	{ {
+		{ "COLOR", 0, VertexFormat::Unorm8x4, offsetof(CompressedVertex, color) },
+		{ "POSITION", 0, VertexFormat::Snorm16x2, offsetof(CompressedVertex, position) },
+		{ "POSITION", 1, VertexFormat::Snorm16x1, offsetof(CompressedVertex, position) + (2 * sizeof(int16_t)) },
+	} };
+	static_assert(IsVertexLayoutAligned(COMPRESSED_VERTEX_LAYOUT), "COMPRESSED_VERTEX_LAYOUT has a misaligned attribute");
+
+	/// <summary>
+	/// Maps SNORM positions back to the mesh: position = offset + scale * snorm.
+	/// The renderer passes these to VSMainCompressed as MeshConstants, which applies
+	/// them before the instance transform.
+	/// </summary>
+	struct VertexQuantization
+	{
+		float offset[3];
+		float scale[3];
+	};
+
+	/// <summary>
+	/// CompressedMeshData is MeshData with CompressedVertex vertices.
+	/// </summary>
+	struct CompressedMeshData
+	{
+		std::vector<CompressedVertex> vertices;
+		std::vector<uint16_t> indices;
+		VertexQuantization quantization;
+
+		uint64_t GetByteSize() const;
+	};
+
+	/// <summary>
+	/// Encodes a triangle list's indices for storage, typically in 1 to 1.5 bytes
+	/// each rather than 2. Each index is stored as its distance from the next
+	/// vertex not yet referred to, zigzagged and as a LEB128 varint: after
+	/// OptimizeVertexFetch vertices are numbered by first use, so new vertices
+	/// cost a byte and reused ones are close behind.
+	/// </summary>
+	std::vector<uint8_t> EncodeIndexStream(const std::vector<uint16_t>& indices);
+
+	/// <summary>
+	/// Decodes indexCount indices that EncodeIndexStream wrote to exactly size
+	/// bytes. Returns false if the stream is shorter or longer, or decodes to an
+	/// index that doesn't fit 16 bits; indices are left empty then.
+	/// </summary>
+	bool DecodeIndexStream(const uint8_t* data, size_t size, size_t indexCount, std::vector<uint16_t>& indices);
+
+	/// <summary>
+	/// Largest differences between a mesh and its compressed copy, in mesh units
+	/// and color channel units.
+	/// </summary>
+	struct VertexCompressionError
+	{
+		float position{ 0.0f };
+		float color{ 0.0f };
+	};
+
+	/// <summary>
+	/// Quantizes mesh's vertices to the bounds of its positions. Colors are clamped
+	/// to [0, 1].
+	/// </summary>
+	CompressedMeshData CompressMesh(const MeshData& mesh);
+
+	Vertex DecompressVertex(const CompressedVertex& vertex, const VertexQuantization& quantization);
+
+	/// <summary>
+	/// The error CompressMesh guarantees, given the quantization it chose: half a
+	/// quantization step per position axis and color channel.
+	/// </summary>
+	VertexCompressionError GetVertexCompressionErrorBound(const VertexQuantization& quantization);
+
+	/// <summary>
+	/// Compares every vertex of mesh with its compressed copy, which must come from
+	/// CompressMesh(mesh).
+	/// </summary>
+	VertexCompressionError MeasureVertexCompressionError(const MeshData& mesh, const CompressedMeshData& compressed);
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "pch.h"
+#include "VisibilityCuller.h"
+#include "Profiler.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	VisibilityCuller::VisibilityCuller(const Config& config) :
+		m_kernels{ &GetSimdKernels(config.simdLevel) },
+		m_occlusionBuffer{
+			config.useOcclusion
+				? std::make_unique<OcclusionBuffer>(config.occlusionWidth, config.occlusionHeight)
+				: nullptr
+		}
+	{ }
+
+	void VisibilityCuller::BeginFrame(const float viewProjection[16])
+	{
+		m_frustum = Frustum::FromViewProjection(viewProjection);
+		if (m_occlusionBuffer)
+		{
+			m_occlusionBuffer->Begin(viewProjection);
+			m_isHierarchyBuilt = false;
+		}
+	}
+
+	void VisibilityCuller::AddOccluder(const MeshData& mesh, const InstanceData& instance)
+	{
+		if (!m_occlusionBuffer)
+		{
+			return;
+		}
+		m_occlusionBuffer->RasterizeOccluder(mesh, instance);
+		m_isHierarchyBuilt = false;
+	}
+
+	void VisibilityCuller::Cull(
+		size_t count,
+		const float* x,
+		const float* y,
+		const float* z,
+		const float* radius,
+		float defaultRadius,
+		std::vector<uint32_t>& visibleIndices)
+	{
+		HELLOTRIANGLE_PROFILE_SCOPE("VisibilityCuller::Cull");
+
+		// The kernel writes in place, so make room for every sphere up front
+		const size_t start{ visibleIndices.size() };
+		visibleIndices.resize(start + count);
+		uint32_t* const output{ visibleIndices.data() + start };
+		const size_t inFrustum{ m_kernels->CullSpheres(
+			count,
+			m_frustum.planes[0].data(),
+			x,
+			y,
+			z,
+			radius,
+			defaultRadius,
+			0,
+			output) };
+
+		size_t visibleCount{ inFrustum };
+		if (m_occlusionBuffer)
+		{
+			if (!m_isHierarchyBuilt)
+			{
+				m_occlusionBuffer->BuildHierarchy();
+				m_isHierarchyBuilt = true;
+			}
+
+			// Compact the frustum survivors in place
+			visibleCount = 0;
+			for (size_t i = 0; i < inFrustum; ++i)
+			{
+				const uint32_t index{ output[i] };
+				if (m_occlusionBuffer->IsSphereVisible(x[index], y[index], z[index], radius ? radius[index] : defaultRadius))
+				{
+					output[visibleCount++] = index;
+				}
+			}
+		}
+		visibleIndices.resize(start + visibleCount);
+
+		m_stats.tested += count;
+		m_stats.frustumCulled += count - inFrustum;
+		m_stats.occlusionCulled += inFrustum - visibleCount;
+		m_stats.visible += visibleCount;
+	}
+
+	bool VisibilityCuller::IsOcclusionEnabled() const
+	{
+		return m_occlusionBuffer != nullptr;
+	}
+
+	const Frustum& VisibilityCuller::GetFrustum() const
+	{
+		return m_frustum;
+	}
+
+	const VisibilityCuller::Stats& VisibilityCuller::GetStats() const
+	{
+		return m_stats;
+	}
+
+	void VisibilityCuller::ResetStats()
+	{
+		m_stats = Stats{};
+	}
+#pragma endregion Public
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include "Bounds.h"
+#include "OcclusionBuffer.h"
+#include "SimdKernels.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// VisibilityCuller turns SoA bounding spheres into a compact list of the ones
+	/// worth drawing. A SIMD frustum pass runs first; if occlusion is enabled, the
+	/// survivors are then tested against an OcclusionBuffer holding this frame's
+	/// occluders. Results are indices into the streams passed to Cull.
+	/// </summary>
+	class VisibilityCuller
+	{
+	public:
+		struct Config
+		{
+			bool useOcclusion{ false };
+			uint32_t occlusionWidth{ 256 };
+			uint32_t occlusionHeight{ 128 };
+			SimdLevel simdLevel{ SimdLevel::Avx2 };
+		};
+
+		struct Stats
+		{
+			uint64_t tested{ 0 };
+			uint64_t frustumCulled{ 0 };
+			uint64_t occlusionCulled{ 0 };
+			uint64_t visible{ 0 };
+		};
+
+		VisibilityCuller(const Config& config);
+
+		/// <summary>
+		/// Starts a frame seen through a row-major view-projection, as Camera
+		/// produces, and clears the previous frame's occluders.
+		/// </summary>
+		void BeginFrame(const float viewProjection[16]);
+
+		/// <summary>
+		/// Adds an occluder for this frame. Ignored when occlusion is off.
+		/// </summary>
+		void AddOccluder(const MeshData& mesh, const InstanceData& instance);
+
+		/// <summary>
+		/// Appends the index of every sphere that may be visible to visibleIndices,
+		/// in stream order. radius may be null, in which case every sphere uses
+		/// defaultRadius.
+		/// </summary>
+		void Cull(
+			size_t count,
+			const float* x,
+			const float* y,
+			const float* z,
+			const float* radius,
+			float defaultRadius,
+			std::vector<uint32_t>& visibleIndices);
+
+		bool IsOcclusionEnabled() const;
+		const Frustum& GetFrustum() const;
+		const Stats& GetStats() const;
+		void ResetStats();
+
+	private:
+		const SimdKernels* const m_kernels;
+		std::unique_ptr<OcclusionBuffer> m_occlusionBuffer;
+		Frustum m_frustum{};
+		bool m_isHierarchyBuilt{ false };
+		Stats m_stats;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "pch.h"
 #include "Window.h"
+#include "MessageTranslator.h"
+#include "Profiler.h"
 
 namespace HelloTriangle
 {
@@ -50,30 +52,58 @@ namespace HelloTriangle
 
 	MessagePumpResult Window::PumpMessages()
 	{
+		HELLOTRIANGLE_PROFILE_SCOPE("Window::PumpMessages");
+		const std::chrono::nanoseconds start{ m_clock.Now() };
+
+		// Drain everything queued since the last frame, so a burst of input is
+		// handled at once rather than one message per frame. A null hwnd also
+		// retrieves thread messages, which is how WM_QUIT arrives.
+		uint32_t messageCount{ 0 };
+		bool quit{ false };
 		MSG msg{ 0 };
-		if (PeekMessageW(&msg, m_handle, 0, 0, PM_REMOVE))
+		while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
 		{
+			++messageCount;
+			if (msg.message == WM_QUIT)
+			{
+				quit = true;
+				break;
+			}
 			TranslateMessage(&msg);
 			DispatchMessageW(&msg);
 		}
 
-		if (msg.message == WM_NULL)
+		const std::chrono::nanoseconds duration{ m_clock.Now() - start };
+		m_pumpStats.lastMessageCount = messageCount;
+		m_pumpStats.maxMessageCount = std::max(m_pumpStats.maxMessageCount, messageCount);
+		m_pumpStats.totalMessageCount += messageCount;
+		m_pumpStats.lastDuration = duration;
+		m_pumpStats.maxDuration = std::max(m_pumpStats.maxDuration, duration);
+
+		if (quit)
 		{
-			if (!IsWindow(m_handle))
-			{
-				m_handle = nullptr;
-				std::wstring windowClass{ m_windowClass.begin(), m_windowClass.end() };
-				UnregisterClassW(windowClass.c_str(), m_hInstance);
-				return MessagePumpResult::Closed;
-			}
+			m_handle = nullptr;
+			std::wstring windowClass{ m_windowClass.begin(), m_windowClass.end() };
+			UnregisterClassW(windowClass.c_str(), m_hInstance);
+			return MessagePumpResult::Closed;
 		}
 
 		return MessagePumpResult::Continue;
 	}
 
-	void Window::GetKeyState()
+	const MessagePumpStats& Window::GetPumpStats() const
+	{
+		return m_pumpStats;
+	}
+
+	uint64_t Window::GetDroppedEventCount() const
+	{
+		return m_droppedEventCount;
+	}
+
+	bool Window::PollEvent(InputEvent& event)
 	{
-		// TODO
+		return m_events.TryPop(event);
 	}
 #pragma endregion Public
 
@@ -127,6 +157,14 @@ namespace HelloTriangle
 		);
 	}
 
+	void Window::QueueEvent(const InputEvent& event)
+	{
+		if (!m_events.TryPush(event))
+		{
+			++m_droppedEventCount;
+		}
+	}
+
 	LRESULT CALLBACK Window::WindowProc(
 		HWND hwnd,
 		UINT msg,
@@ -172,14 +210,17 @@ namespace HelloTriangle
 		LPARAM lParam
 	)
 	{
+		InputEvent event{};
+		const RawMessage message{ msg, static_cast<uint64_t>(wParam), static_cast<int64_t>(lParam) };
+		if (TranslateMessageToEvent(message, m_clock.Now(), event))
+		{
+			QueueEvent(event);
+		}
+
 		switch (msg)
 		{
 		case WM_KEYDOWN:
-			// TODO
-			return 0;
-
 		case WM_KEYUP:
-			// TODO
 			return 0;
 
 		case WM_PAINT:
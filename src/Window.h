@@ -1,4 +1,5 @@
 #pragma once
+#include "IClock.h"
 #include "IInputSource.h"
 
 #include <wtypes.h>
@@ -12,6 +13,18 @@ namespace HelloTriangle
 		Closed,
 	};
 
+	/// <summary>
+	/// MessagePumpStats describes the cost of draining the message queue.
+	/// </summary>
+	struct MessagePumpStats
+	{
+		uint32_t lastMessageCount;
+		uint32_t maxMessageCount;
+		uint64_t totalMessageCount;
+		std::chrono::nanoseconds lastDuration;
+		std::chrono::nanoseconds maxDuration;
+	};
+
 	class Window : public IInputSource
 	{
 	public:
@@ -26,10 +39,17 @@ namespace HelloTriangle
 		uint32_t GetWidth();
 		uint32_t GetHeight();
 		HWND GetHwnd();
+		/// <summary>
+		/// Dispatches every pending message for this thread, returning Closed once
+		/// WM_QUIT has been seen.
+		/// </summary>
 		MessagePumpResult PumpMessages();
+		const MessagePumpStats& GetPumpStats() const;
+
+		uint64_t GetDroppedEventCount() const;
 
 		// IInputSource
-		virtual void GetKeyState();
+		virtual bool PollEvent(InputEvent& event);
 
 	private:
 		HWND m_handle{ nullptr };
@@ -39,8 +59,15 @@ namespace HelloTriangle
 		const uint32_t m_width;
 		const uint32_t m_height;
 
+		// Input
+		SteadyClock m_clock;
+		InputEventQueue m_events;
+		uint64_t m_droppedEventCount{ 0 };
+		MessagePumpStats m_pumpStats{};
+
 		void RegisterWindowClass();
 		void CreateHwnd();
+		void QueueEvent(const InputEvent& event);
 		static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 		LRESULT CALLBACK InstanceWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 	};
@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "World.h"
+
+namespace HelloTriangle
+{
+#pragma region Public
+	void World::Reserve(size_t entityCount)
+	{
+		m_generations.reserve(entityCount);
+		m_positions.Reserve(entityCount);
+		m_velocities.Reserve(entityCount);
+		m_colors.Reserve(entityCount);
+	}
+
+	Entity World::CreateEntity()
+	{
+		Entity entity{};
+		if (!m_freeIndices.empty())
+		{
+			entity.index = m_freeIndices.back();
+			m_freeIndices.pop_back();
+		}
+		else
+		{
+			entity.index = static_cast<uint32_t>(m_generations.size());
+			m_generations.push_back(0);
+		}
+		entity.generation = m_generations[entity.index];
+		++m_aliveCount;
+		return entity;
+	}
+
+	void World::DestroyEntity(Entity entity)
+	{
+		if (!IsAlive(entity))
+		{
+			spdlog::warn("World: Attempted to destroy stale entity {}.", entity.index);
+			return;
+		}
+
+		LeaveMovingGroup(entity);
+		if (m_positions.Contains(entity))
+		{
+			++m_staticVersion;
+		}
+		m_positions.Remove(entity);
+		m_velocities.Remove(entity);
+		m_colors.Remove(entity);
+
+		++m_generations[entity.index];
+		m_freeIndices.push_back(entity.index);
+		--m_aliveCount;
+	}
+
+	bool World::IsAlive(Entity entity) const
+	{
+		return (entity.index < m_generations.size()) &&
+			(m_generations[entity.index] == entity.generation);
+	}
+
+	size_t World::GetEntityCount() const
+	{
+		return m_aliveCount;
+	}
+
+	void World::SetPosition(Entity entity, float x, float y, float z)
+	{
+		assert(IsAlive(entity));
+		m_positions.Add(entity, { x, y, z });
+		JoinMovingGroup(entity);
+		if (m_positions.IndexOf(entity) >= m_movingCount)
+		{
+			++m_staticVersion;
+		}
+	}
+
+	void World::SetVelocity(Entity entity, float x, float y, float z)
+	{
+		assert(IsAlive(entity));
+		m_velocities.Add(entity, { x, y, z });
+		JoinMovingGroup(entity);
+	}
+
+	void World::SetColor(Entity entity, float r, float g, float b, float a)
+	{
+		assert(IsAlive(entity));
+		m_colors.Add(entity, { r, g, b, a });
+	}
+
+	void World::RemoveVelocity(Entity entity)
+	{
+		if (!IsAlive(entity))
+		{
+			spdlog::warn("World: Attempted to remove velocity of stale entity {}.", entity.index);
+			return;
+		}
+
+		LeaveMovingGroup(entity);
+		m_velocities.Remove(entity);
+	}
+
+	MovingView World::GetMovingView()
+	{
+		return MovingView
+		{
+			.count = m_movingCount,
+			.positionX = m_positions.Field(0),
+			.positionY = m_positions.Field(1),
+			.positionZ = m_positions.Field(2),
+			.velocityX = m_velocities.Field(0),
+			.velocityY = m_velocities.Field(1),
+			.velocityZ = m_velocities.Field(2),
+		};
+	}
+
+	ComponentPool<World::POSITION_FIELDS>& World::GetPositions()
+	{
+		return m_positions;
+	}
+
+	const ComponentPool<World::POSITION_FIELDS>& World::GetPositions() const
+	{
+		return m_positions;
+	}
+
+	size_t World::GetMovingCount() const
+	{
+		return m_movingCount;
+	}
+
+	ComponentPool<World::VELOCITY_FIELDS>& World::GetVelocities()
+	{
+		return m_velocities;
+	}
+
+	ComponentPool<World::COLOR_FIELDS>& World::GetColors()
+	{
+		return m_colors;
+	}
+
+	const ComponentPool<World::COLOR_FIELDS>& World::GetColors() const
+	{
+		return m_colors;
+	}
+
+	uint64_t World::ComputeHash() const
+	{
+		uint64_t hash{ HashValue(m_generations.size()) };
+		hash = HashBytes(m_generations.data(), m_generations.size() * sizeof(uint32_t), hash);
+		hash = HashValue(m_freeIndices.size(), hash);
+		hash = HashBytes(m_freeIndices.data(), m_freeIndices.size() * sizeof(uint32_t), hash);
+		hash = HashValue(m_aliveCount, hash);
+		hash = HashValue(m_movingCount, hash);
+		hash = m_positions.ComputeHash(hash);
+		hash = m_velocities.ComputeHash(hash);
+		return m_colors.ComputeHash(hash);
+	}
+
+	size_t World::GetByteSize() const
+	{
+		return ((m_generations.size() + m_freeIndices.size()) * sizeof(uint32_t)) +
+			m_positions.GetByteSize() +
+			m_velocities.GetByteSize() +
+			m_colors.GetByteSize();
+	}
+
+	uint64_t World::GetStaticVersion() const
+	{
+		return m_staticVersion;
+	}
+#pragma endregion Public
+
+#pragma region Private
+	void World::JoinMovingGroup(Entity entity)
+	{
+		const uint32_t positionIndex{ m_positions.IndexOf(entity) };
+		const uint32_t velocityIndex{ m_velocities.IndexOf(entity) };
+		if ((positionIndex == ComponentPool<POSITION_FIELDS>::INVALID_INDEX) ||
+			(velocityIndex == ComponentPool<VELOCITY_FIELDS>::INVALID_INDEX) ||
+			(positionIndex < m_movingCount))
+		{
+			// Either not a moving entity, or already packed into the group
+			return;
+		}
+
+		m_positions.Swap(positionIndex, m_movingCount);
+		m_velocities.Swap(velocityIndex, m_movingCount);
+		++m_movingCount;
+		++m_staticVersion;
+	}
+
+	void World::LeaveMovingGroup(Entity entity)
+	{
+		const uint32_t positionIndex{ m_positions.IndexOf(entity) };
+		if ((positionIndex == ComponentPool<POSITION_FIELDS>::INVALID_INDEX) ||
+			(positionIndex >= m_movingCount))
+		{
+			return;
+		}
+
+		// Both pools hold the entity at the same slot while it's in the group
+		--m_movingCount;
+		m_positions.Swap(positionIndex, m_movingCount);
+		m_velocities.Swap(positionIndex, m_movingCount);
+		++m_staticVersion;
+	}
+#pragma endregion Private
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+#include "ComponentPool.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace HelloTriangle
+{
+	/// <summary>
+	/// MovingView exposes the contiguous SoA streams of every entity that has both a
+	/// position and a velocity. All streams share the same dense order.
+	/// </summary>
+	struct MovingView
+	{
+		size_t count{ 0 };
+		float* positionX{ nullptr };
+		float* positionY{ nullptr };
+		float* positionZ{ nullptr };
+		const float* velocityX{ nullptr };
+		const float* velocityY{ nullptr };
+		const float* velocityZ{ nullptr };
+	};
+
+	/// <summary>
+	/// World is the entity-component store for the Simulation. Components live in
+	/// sparse-set pools with SoA storage. Entities that have both a position and a
+	/// velocity are kept packed at the front of both pools, in matching order, so the
+	/// integration query walks dense arrays without any sparse lookups.
+	/// </summary>
+	class World
+	{
+	public:
+		static constexpr size_t POSITION_FIELDS{ 3 };
+		static constexpr size_t VELOCITY_FIELDS{ 3 };
+		static constexpr size_t COLOR_FIELDS{ 4 };
+
+		void Reserve(size_t entityCount);
+		Entity CreateEntity();
+		void DestroyEntity(Entity entity);
+		bool IsAlive(Entity entity) const;
+		size_t GetEntityCount() const;
+
+		void SetPosition(Entity entity, float x, float y, float z);
+		void SetVelocity(Entity entity, float x, float y, float z);
+		void SetColor(Entity entity, float r, float g, float b, float a);
+		void RemoveVelocity(Entity entity);
+
+		MovingView GetMovingView();
+		ComponentPool<POSITION_FIELDS>& GetPositions();
+		const ComponentPool<POSITION_FIELDS>& GetPositions() const;
+
+		/// <summary>
+		/// Number of moving entities, packed at the front of the position pool.
+		/// </summary>
+		size_t GetMovingCount() const;
+		ComponentPool<VELOCITY_FIELDS>& GetVelocities();
+		ComponentPool<COLOR_FIELDS>& GetColors();
+		const ComponentPool<COLOR_FIELDS>& GetColors() const;
+
+		/// <summary>
+		/// Hashes all entity and component state, for comparing worlds across runs.
+		/// </summary>
+		uint64_t ComputeHash() const;
+
+		/// <summary>
+		/// Bytes of live entity and component state, the amount a snapshot copies.
+		/// </summary>
+		size_t GetByteSize() const;
+
+		/// <summary>
+		/// Changes whenever a static entity (one with a position but no velocity) is
+		/// added, removed or moved, so caches over static entities know to rebuild.
+		/// Static entities are packed after the moving ones in the position pool.
+		/// </summary>
+		uint64_t GetStaticVersion() const;
+
+	private:
+		std::vector<uint32_t> m_generations;
+		std::vector<uint32_t> m_freeIndices;
+		size_t m_aliveCount{ 0 };
+
+		ComponentPool<POSITION_FIELDS> m_positions;
+		ComponentPool<VELOCITY_FIELDS> m_velocities;
+		ComponentPool<COLOR_FIELDS> m_colors;
+
+		// Number of entities packed at the front of m_positions and m_velocities
+		uint32_t m_movingCount{ 0 };
+		uint64_t m_staticVersion{ 0 };
+
+		void JoinMovingGroup(Entity entity);
+		void LeaveMovingGroup(Entity entity);
+	};
+}
\ No newline at end of file
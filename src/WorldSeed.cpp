@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "WorldSeed.h"
+#include "World.h"
+
+#include <random>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// std::uniform_real_distribution differs between standard libraries, but
+		// mt19937's output doesn't, so map its top 24 bits to [min, max) directly
+		float NextFloat(std::mt19937& random, float min, float max)
+		{
+			const float unit{ static_cast<float>(random() >> 8) * (1.0f / 16'777'216.0f) };
+			return min + ((max - min) * unit);
+		}
+	}
+
+	void SeedWorld(World& world, const WorldSeedConfig& config)
+	{
+		std::mt19937 random{ config.seed };
+		world.Reserve(world.GetEntityCount() + config.entityCount);
+		for (uint32_t i = 0; i < config.entityCount; ++i)
+		{
+			const Entity entity{ world.CreateEntity() };
+			const float x{ NextFloat(random, -config.halfExtent, config.halfExtent) };
+			const float y{ NextFloat(random, -config.halfExtent, config.halfExtent) };
+			const float z{ NextFloat(random, -config.halfExtent, config.halfExtent) };
+			world.SetPosition(entity, x, y, z);
+
+			const float r{ NextFloat(random, 0.25f, 1.0f) };
+			const float g{ NextFloat(random, 0.25f, 1.0f) };
+			const float b{ NextFloat(random, 0.25f, 1.0f) };
+			world.SetColor(entity, r, g, b, 1.0f);
+
+			if ((config.staticInterval > 0) && ((i % config.staticInterval) == 0))
+			{
+				continue;
+			}
+			const float velocityX{ NextFloat(random, -config.maxSpeed, config.maxSpeed) };
+			const float velocityY{ NextFloat(random, -config.maxSpeed, config.maxSpeed) };
+			const float velocityZ{ NextFloat(random, -config.maxSpeed, config.maxSpeed) };
+			world.SetVelocity(entity, velocityX, velocityY, velocityZ);
+		}
+	}
+}
\ No newline at end of file
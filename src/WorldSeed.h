@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+
+namespace HelloTriangle
+{
+	class World;
+
+	/// <summary>
+	/// WorldSeedConfig describes a scene of entities spread over a cube around the
+	/// origin. Every staticInterval-th entity has no velocity, so the static side
+	/// of the spatial index has something in it and the scene never drifts empty.
+	/// </summary>
+	struct WorldSeedConfig
+	{
+		uint32_t entityCount{ 10'000 };
+		uint32_t seed{ 1234 };
+		float halfExtent{ 1.0f };
+		float maxSpeed{ 0.05f };
+		uint32_t staticInterval{ 4 };
+	};
+
+	/// <summary>
+	/// Creates config.entityCount entities with positions, velocities and colors.
+	/// The same config always produces the same world on every platform, so a
+	/// replay can rebuild the world a recording started from.
+	/// </summary>
+	void SeedWorld(World& world, const WorldSeedConfig& config);
+}
\ No newline at end of file
@@ -1,9 +1,242 @@
 #include "pch.h"
 #include "Renderer.h"
+#include "AssetStreamer.h"
+#include "Benchmarks.h"
+#include "D3DShaderCompiler.h"
 #include "Window.h"
 #include "Simulation.h"
+#include "FixedTimestep.h"
+#include "HeapAllocationCounter.h"
+#include "InputRecording.h"
+#include "IClock.h"
+#include "JobSystem.h"
+#include "MeshProcessor.h"
+#include "Profiler.h"
+#include "SimulationSnapshot.h"
+#include "VisibilityCuller.h"
+#include "WorldSeed.h"
 
+#include <fstream>
 #include <memory>
+#include <string_view>
+#include <thread>
+
+namespace
+{
+	// Simulation runs at a fixed rate regardless of how fast we can render
+	constexpr std::chrono::nanoseconds SIMULATION_TICK_DURATION{ 1'000'000'000 / 60 };
+
+	// Upper bound on catch-up ticks per frame, to avoid spiraling after a long stall
+	constexpr uint32_t SIMULATION_MAX_TICKS_PER_FRAME{ 5 };
+
+	// Frames excluded from heap allocation counts while caches and pools fill up
+	constexpr uint64_t ALLOCATION_WARMUP_FRAMES{ 120 };
+
+	// Scale applied to the triangle mesh when drawing simulated entities
+	constexpr float ENTITY_DRAW_SCALE{ 0.05f };
+
+	// Bounding sphere of a drawn entity; the triangle's corners are within 0.36
+	// of its origin before scaling
+	constexpr float ENTITY_CULL_RADIUS{ 0.36f * ENTITY_DRAW_SCALE };
+
+	// Where a mesh streamed in with --mesh= is drawn
+	constexpr HelloTriangle::InstanceData STREAMED_MESH_INSTANCE{
+		{ 0.5f, 0.0f, 0.0f, 0.5f },
+		{ 1.0f, 1.0f, 1.0f, 1.0f }
+	};
+
+	// Parses "<prefix><number>" arguments, such as --entities=1000
+	bool ParseUnsignedArgument(std::wstring_view argument, std::wstring_view prefix, uint32_t& value)
+	{
+		if (argument.substr(0, prefix.size()) != prefix)
+		{
+			return false;
+		}
+		value = static_cast<uint32_t>(std::wcstoul(std::wstring{ argument.substr(prefix.size()) }.c_str(), nullptr, 10));
+		return true;
+	}
+
+	// Returns the text after prefix for the first argument that starts with it
+	std::wstring_view FindArgumentValue(int argc, wchar_t* argv[], std::wstring_view prefix)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::wstring_view argument{ argv[i] };
+			if (argument.substr(0, prefix.size()) == prefix)
+			{
+				return argument.substr(prefix.size());
+			}
+		}
+		return {};
+	}
+
+	// Runs the headless benchmark scenarios and writes their results as JSON.
+	// Usage: --benchmark [--entities=N] [--draws=M] [--frames=K] [--input-events=L] [--output=path] [--raster-out=frame.ppm]
+	int RunBenchmarkMode(int argc, wchar_t* argv[])
+	{
+		HelloTriangle::BenchmarkConfig config{};
+		std::filesystem::path outputPath{ GetExecutableDirectory() / "Benchmark.json" };
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::wstring_view argument{ argv[i] };
+			if (ParseUnsignedArgument(argument, L"--entities=", config.entityCount) ||
+				ParseUnsignedArgument(argument, L"--draws=", config.drawCount) ||
+				ParseUnsignedArgument(argument, L"--frames=", config.frameCount) ||
+				ParseUnsignedArgument(argument, L"--input-events=", config.inputEventCount))
+			{
+				continue;
+			}
+			if (argument.substr(0, 9) == L"--output=")
+			{
+				outputPath = argument.substr(9);
+			}
+			else if (argument.substr(0, 13) == L"--raster-out=")
+			{
+				config.rasterImagePath = std::filesystem::path{ argument.substr(13) }.string();
+			}
+		}
+
+		std::vector<HelloTriangle::BenchmarkResult> results;
+		const bool passed{ HelloTriangle::RunBenchmarks(config, results) };
+		std::ofstream file{ outputPath, std::ios::trunc };
+		if (!file)
+		{
+			spdlog::error("Main: Couldn't open {} for writing.", outputPath.string());
+			return 1;
+		}
+		HelloTriangle::WriteBenchmarkResults(file, config, results);
+		spdlog::info("Main: Wrote {} benchmark results to {}.", results.size(), outputPath.string());
+		if (!passed)
+		{
+			spdlog::error("Main: Benchmark correctness checks failed.");
+			return 1;
+		}
+		return 0;
+	}
+
+	// Drives the simulation from a recording as fast as possible, without a window,
+	// starting from the world the recording was seeded with. With --expect-hash=,
+	// fails unless the final state hash matches.
+	// Usage: --replay=path [--expect-hash=hex]
+	int RunReplayMode(int argc, wchar_t* argv[], const std::filesystem::path& recordingPath)
+	{
+		HelloTriangle::ReplayInputSource replay;
+		if (!replay.Open(recordingPath))
+		{
+			return 1;
+		}
+
+		HelloTriangle::JobSystem jobSystem{ HelloTriangle::JobSystem::GetDefaultWorkerCount() };
+		HelloTriangle::Simulation simulation{ &replay, &jobSystem };
+		const HelloTriangle::WorldSeedConfig worldSeed{ replay.GetWorldSeed() };
+		HelloTriangle::SeedWorld(simulation.GetWorld(), worldSeed);
+		const float tickSeconds{ std::chrono::duration<float>(SIMULATION_TICK_DURATION).count() };
+
+		spdlog::info("Main: Replaying {} ticks from {}...", replay.GetTickCount(), recordingPath.string());
+		const auto start{ std::chrono::steady_clock::now() };
+		while (!replay.IsFinished())
+		{
+			simulation.Update(tickSeconds);
+		}
+		const auto elapsed{ std::chrono::steady_clock::now() - start };
+
+		const auto recordedDuration{ SIMULATION_TICK_DURATION * replay.GetReplayedTickCount() };
+		spdlog::info(
+			"Main: Replayed {} ticks in {:.2f}ms ({:.1f}x real time), state hash {:016x}.",
+			replay.GetReplayedTickCount(),
+			std::chrono::duration<double, std::milli>(elapsed).count(),
+			std::chrono::duration<double>(recordedDuration).count() /
+				std::max(std::chrono::duration<double>(elapsed).count(), 1e-9),
+			simulation.ComputeStateHash());
+
+		const std::wstring_view expectedHashText{ FindArgumentValue(argc, argv, L"--expect-hash=") };
+		if (!expectedHashText.empty())
+		{
+			const uint64_t expectedHash{ std::wcstoull(std::wstring{ expectedHashText }.c_str(), nullptr, 16) };
+			if (simulation.ComputeStateHash() != expectedHash)
+			{
+				spdlog::error("Main: Replay diverged! Expected state hash {:016x}.", expectedHash);
+				return 1;
+			}
+			spdlog::info("Main: Replay matched the expected state hash.");
+		}
+		return 0;
+	}
+
+	// Optimizes and compresses a mesh file offline, checking the compression error.
+	// Usage: --optimize-mesh=path [--output=path]
+	int RunOptimizeMeshMode(int argc, wchar_t* argv[], const std::filesystem::path& inputPath)
+	{
+		std::filesystem::path outputPath{ FindArgumentValue(argc, argv, L"--output=") };
+		if (outputPath.empty())
+		{
+			outputPath = std::filesystem::path{ inputPath }.replace_extension(L".compressed.mesh");
+		}
+		return HelloTriangle::ProcessMeshFile(inputPath, outputPath) ? 0 : 1;
+	}
+
+	// Compiles Shaders.hlsl next to the executable into the shader archive the
+	// renderer loads, so launching doesn't wait on the compiler. Run by the build.
+	// Usage: --compile-shaders=path
+	int RunCompileShadersMode(const std::filesystem::path& archivePath)
+	{
+		return HelloTriangle::CompileShaderArchive(GetExecutableDirectory() / "Shaders.hlsl", archivePath) ? 0 : 1;
+	}
+
+	// Culls the entities' SoA positions against the camera and submits the survivors
+	void SubmitEntityInstances(
+		const HelloTriangle::Simulation& simulation,
+		HelloTriangle::Camera& camera,
+		HelloTriangle::VisibilityCuller& culler,
+		std::vector<uint32_t>& visibleEntities,
+		HelloTriangle::DrawBatcher& batcher,
+		float interpolationAlpha)
+	{
+		const HelloTriangle::World& world{ simulation.GetWorld() };
+		const auto& positions{ world.GetPositions() };
+		const float* x{ positions.Field(0) };
+		const float* y{ positions.Field(1) };
+		const float* z{ positions.Field(2) };
+
+		// Culled where entities are as of the latest tick; they are drawn at most one
+		// tick's movement behind that
+		culler.BeginFrame(camera.GetViewProjection().data());
+		visibleEntities.clear();
+		culler.Cull(positions.Size(), x, y, z, nullptr, ENTITY_CULL_RADIUS, visibleEntities);
+
+		// Blend from the previous tick towards the latest one, so motion stays smooth
+		// when frames don't line up with ticks
+		const HelloTriangle::PreviousPositionsView previous{ simulation.GetPreviousPositions() };
+		const size_t interpolatedCount{ std::min(previous.count, world.GetMovingCount()) };
+		const auto& colors{ world.GetColors() };
+		for (const uint32_t i : visibleEntities)
+		{
+			float position[3]{ x[i], y[i], z[i] };
+			if (i < interpolatedCount)
+			{
+				position[0] = previous.x[i] + ((x[i] - previous.x[i]) * interpolationAlpha);
+				position[1] = previous.y[i] + ((y[i] - previous.y[i]) * interpolationAlpha);
+				position[2] = previous.z[i] + ((z[i] - previous.z[i]) * interpolationAlpha);
+			}
+
+			// Colors live in their own pool, in a different order
+			float color[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
+			const uint32_t colorIndex{ colors.IndexOf(positions.Entities()[i]) };
+			if (colorIndex != HelloTriangle::ComponentPool<HelloTriangle::World::COLOR_FIELDS>::INVALID_INDEX)
+			{
+				for (size_t channel = 0; channel < 4; ++channel)
+				{
+					color[channel] = colors.Field(channel)[colorIndex];
+				}
+			}
+
+			batcher.Submit(0, 0, HelloTriangle::InstanceData{
+				{ position[0], position[1], position[2], ENTITY_DRAW_SCALE },
+				{ color[0], color[1], color[2], color[3] }
+			});
+		}
+	}
+}
 
 int wmain(int argc, wchar_t* argv[])
 {
@@ -11,12 +244,45 @@ int wmain(int argc, wchar_t* argv[])
 	spdlog::set_level(spdlog::level::debug);
 #endif
 
+	for (int i = 1; i < argc; ++i)
+	{
+		if (std::wstring_view{ argv[i] } == L"--benchmark")
+		{
+			return RunBenchmarkMode(argc, argv);
+		}
+	}
+
+	const std::wstring_view optimizeMeshPath{ FindArgumentValue(argc, argv, L"--optimize-mesh=") };
+	if (!optimizeMeshPath.empty())
+	{
+		return RunOptimizeMeshMode(argc, argv, optimizeMeshPath);
+	}
+
+	const std::wstring_view compileShadersPath{ FindArgumentValue(argc, argv, L"--compile-shaders=") };
+	if (!compileShadersPath.empty())
+	{
+		return RunCompileShadersMode(compileShadersPath);
+	}
+
+	const std::wstring_view replayPath{ FindArgumentValue(argc, argv, L"--replay=") };
+	if (!replayPath.empty())
+	{
+		return RunReplayMode(argc, argv, replayPath);
+	}
+
 	std::unique_ptr<HelloTriangle::Simulation> simulation{ nullptr };
 	std::unique_ptr<HelloTriangle::Window> window{ nullptr };
 	std::unique_ptr<HelloTriangle::Renderer> renderer{ nullptr };
 
 	bool isRenderEnabled = true;
 
+	HelloTriangle::SteadyClock clock;
+	HelloTriangle::Profiler profiler{ &clock };
+	HelloTriangle::Profiler::SetActive(&profiler);
+
+	spdlog::info("Main: Creating job system...");
+	HelloTriangle::JobSystem jobSystem{ HelloTriangle::JobSystem::GetDefaultWorkerCount() };
+
 	if (isRenderEnabled)
 	{
 		spdlog::info("Main: Creating window...");
@@ -32,7 +298,14 @@ int wmain(int argc, wchar_t* argv[])
 		window->Initialize();
 
 		spdlog::info("Main: Creating renderer...");
-		renderer = std::make_unique<HelloTriangle::Renderer>(window.get(), 800, 600);
+		renderer = std::make_unique<HelloTriangle::Renderer>(
+			window.get(),
+			800,
+			600,
+			false,
+			2,
+			&jobSystem
+		);
 		spdlog::info("Main: Initializing renderer...");
 		renderer->Initialize();
 	}
@@ -43,8 +316,65 @@ int wmain(int argc, wchar_t* argv[])
 
 	// Simulation is always initialized, even if we aren't rendering
 	spdlog::info("Main: Creating Simulation...");
-	simulation = std::make_unique<HelloTriangle::Simulation>(window.get());
+	// --entities=N sets how many entities the scene starts with
+	HelloTriangle::WorldSeedConfig worldSeed{};
+	for (int i = 1; i < argc; ++i)
+	{
+		ParseUnsignedArgument(argv[i], L"--entities=", worldSeed.entityCount);
+	}
+
+	// --record=path captures every tick's input for later replay
+	std::unique_ptr<HelloTriangle::RecordingInputSource> recorder{ nullptr };
+	const std::wstring_view recordPath{ FindArgumentValue(argc, argv, L"--record=") };
+	if (!recordPath.empty())
+	{
+		recorder = std::make_unique<HelloTriangle::RecordingInputSource>(window.get(), recordPath, worldSeed);
+	}
+	HelloTriangle::IInputSource* inputSource{ recorder ? recorder.get() : window.get() };
+	simulation = std::make_unique<HelloTriangle::Simulation>(inputSource, &jobSystem);
+	HelloTriangle::SeedWorld(simulation->GetWorld(), worldSeed);
+	spdlog::info("Main: Seeded the world with {} entities.", worldSeed.entityCount);
+
+	// --snapshots=N captures the simulation at the start of every tick into a ring
+	// holding the last N, as rollback would; see SimulationSnapshot for the cost
+	uint32_t snapshotCapacity{ 0 };
+	for (int i = 1; i < argc; ++i)
+	{
+		ParseUnsignedArgument(argv[i], L"--snapshots=", snapshotCapacity);
+	}
+	std::unique_ptr<HelloTriangle::SnapshotRing> snapshots{ nullptr };
+	uint64_t snapshotCaptureCount{ 0 };
+	std::chrono::nanoseconds snapshotCaptureTime{ 0 };
+	if (snapshotCapacity > 0)
+	{
+		snapshots = std::make_unique<HelloTriangle::SnapshotRing>(snapshotCapacity, worldSeed.entityCount);
+	}
+
+	// --mesh=path streams a mesh file in on the loader threads and draws it once
+	// it is resident
+	std::unique_ptr<HelloTriangle::AssetStreamer> assetStreamer{ nullptr };
+	HelloTriangle::AssetStreamer::AssetHandle streamedMesh{ 0 };
+	const std::wstring_view meshPath{ FindArgumentValue(argc, argv, L"--mesh=") };
+	if (renderer && !meshPath.empty())
+	{
+		assetStreamer = std::make_unique<HelloTriangle::AssetStreamer>(HelloTriangle::AssetStreamer::Config{});
+		streamedMesh = assetStreamer->RequestMesh(meshPath);
+	}
+
+	HelloTriangle::FixedTimestep timestep{
+		&clock,
+		SIMULATION_TICK_DURATION,
+		SIMULATION_MAX_TICKS_PER_FRAME
+	};
 	
+	// Heap allocations made by Update and Render after warm-up. Per-frame data
+	// should come from pools and frame arenas, so any at all fail the run.
+	uint64_t frameCount{ 0 };
+	uint64_t steadyUpdateAllocations{ 0 };
+	uint64_t steadyRenderAllocations{ 0 };
+	HelloTriangle::VisibilityCuller culler{ HelloTriangle::VisibilityCuller::Config{} };
+	std::vector<uint32_t> visibleEntities;
+
 	// Game loop
 	spdlog::info("Main: Starting main loop...");
 	while (true)
@@ -60,12 +390,181 @@ int wmain(int argc, wchar_t* argv[])
 			}
 		}
 
-		simulation->Update();
+		const bool isSteadyState{ frameCount >= ALLOCATION_WARMUP_FRAMES };
+		const uint64_t updateAllocationStart{ HelloTriangle::GetHeapAllocationCount() };
+		const uint32_t ticks{ timestep.BeginFrame() };
+		for (uint32_t i = 0; i < ticks; ++i)
+		{
+			if (snapshots)
+			{
+				const auto captureStart{ std::chrono::steady_clock::now() };
+				simulation->SaveSnapshot(snapshots->Acquire(simulation->GetTick()));
+				snapshotCaptureTime += std::chrono::steady_clock::now() - captureStart;
+				++snapshotCaptureCount;
+			}
+			simulation->Update(timestep.GetTickSeconds());
+		}
+		if (isSteadyState)
+		{
+			const uint64_t updateAllocations{ HelloTriangle::GetHeapAllocationCount() - updateAllocationStart };
+			if ((updateAllocations > 0) && (steadyUpdateAllocations == 0))
+			{
+				spdlog::warn("Main: Frame {} made {} heap allocations in Update.", frameCount, updateAllocations);
+			}
+			steadyUpdateAllocations += updateAllocations;
+		}
 
 		if (renderer)
 		{
+			if (assetStreamer)
+			{
+				assetStreamer->Update(renderer->GetMeshUploadSink());
+				const uint32_t meshIndex{ assetStreamer->GetMeshIndex(streamedMesh) };
+				if (meshIndex != HelloTriangle::IMeshUploadSink::INVALID_MESH)
+				{
+					renderer->GetDrawBatcher().Submit(0, meshIndex, STREAMED_MESH_INSTANCE);
+				}
+			}
+
+			const uint64_t renderAllocationStart{ HelloTriangle::GetHeapAllocationCount() };
+			SubmitEntityInstances(
+				*simulation,
+				renderer->GetCamera(),
+				culler,
+				visibleEntities,
+				renderer->GetDrawBatcher(),
+				timestep.GetInterpolationAlpha());
 			renderer->Render();
+			if (isSteadyState)
+			{
+				const uint64_t renderAllocations{ HelloTriangle::GetHeapAllocationCount() - renderAllocationStart };
+				if ((renderAllocations > 0) && (steadyRenderAllocations == 0))
+				{
+					spdlog::warn("Main: Frame {} made {} heap allocations in Render.", frameCount, renderAllocations);
+				}
+				steadyRenderAllocations += renderAllocations;
+			}
 		}
+		else
+		{
+			// Nothing to render, so don't spin - sleep until the next tick is due
+			std::this_thread::sleep_for(timestep.GetTimeUntilNextTick());
+		}
+
+		profiler.EndFrame();
+		++frameCount;
+	}
+	spdlog::info(
+		"Main: Main loop terminated after {} ticks ({} dropped).",
+		timestep.GetTickCount(),
+		timestep.GetDroppedTickCount());
+
+	if (snapshots && (snapshotCaptureCount > 0))
+	{
+		spdlog::info(
+			"Main: Captured {} snapshots in {:.3f}ms each on average, keeping the last {}.",
+			snapshotCaptureCount,
+			std::chrono::duration<double, std::milli>(snapshotCaptureTime).count() / static_cast<double>(snapshotCaptureCount),
+			snapshots->GetCapacity());
+	}
+
+	if (recorder)
+	{
+		recorder->Close();
+		spdlog::info(
+			"Main: Recorded input for {} ticks, final state hash {:016x}.",
+			recorder->GetTickCount(),
+			simulation->ComputeStateHash());
+	}
+
+	if (renderer)
+	{
+		const HelloTriangle::VisibilityCuller::Stats& cullStats{ culler.GetStats() };
+		spdlog::info(
+			"Main: Culling tested {} entities: {} outside the frustum, {} occluded, {} visible.",
+			cullStats.tested,
+			cullStats.frustumCulled,
+			cullStats.occlusionCulled,
+			cullStats.visible);
+
+		const HelloTriangle::DrawStateTracker::Stats stateStats{ renderer->GetStateChangeStats() };
+		spdlog::info(
+			"Main: Draw state tracking issued {} state changes and dropped {} redundant ones.",
+			stateStats.issuedCount,
+			stateStats.avoidedCount);
+
+		const HelloTriangle::DrawBatchingTotals& batchingTotals{ renderer->GetBatchingTotals() };
+		if (batchingTotals.frameCount > 0)
+		{
+			const double frames{ static_cast<double>(batchingTotals.frameCount) };
+			spdlog::info(
+				"Main: Batching merged {:.1f} draws into {:.1f} draw calls per frame in {:.3f}ms, {:.3f}ms at most.",
+				static_cast<double>(batchingTotals.submittedCount) / frames,
+				static_cast<double>(batchingTotals.batchCount) / frames,
+				std::chrono::duration<double, std::milli>(batchingTotals.buildTime).count() / frames,
+				std::chrono::duration<double, std::milli>(batchingTotals.maxBuildTime).count());
+		}
+		if (batchingTotals.rejectedCount > 0)
+		{
+			spdlog::warn(
+				"Main: Dropped {} draws whose mesh or material index didn't fit a draw sort key.",
+				batchingTotals.rejectedCount);
+		}
+	}
+
+	if (window)
+	{
+		const HelloTriangle::MessagePumpStats& pumpStats{ window->GetPumpStats() };
+		spdlog::info(
+			"Main: Message pump handled {} messages, at most {} in {:.3f}ms per frame.",
+			pumpStats.totalMessageCount,
+			pumpStats.maxMessageCount,
+			std::chrono::duration<double, std::milli>(pumpStats.maxDuration).count());
+	}
+
+	if (frameCount > ALLOCATION_WARMUP_FRAMES)
+	{
+		const double steadyFrames{ static_cast<double>(frameCount - ALLOCATION_WARMUP_FRAMES) };
+		spdlog::info(
+			"Main: Heap allocations per frame after warm-up: {:.2f} in Update, {:.2f} in Render.",
+			static_cast<double>(steadyUpdateAllocations) / steadyFrames,
+			static_cast<double>(steadyRenderAllocations) / steadyFrames);
+	}
+	const bool isAllocationFree{ (steadyUpdateAllocations == 0) && (steadyRenderAllocations == 0) };
+	if (!isAllocationFree)
+	{
+		spdlog::error(
+			"Main: Made {} heap allocations in Update and {} in Render after warm-up!",
+			steadyUpdateAllocations,
+			steadyRenderAllocations);
+	}
+
+	const HelloTriangle::FrameTimeStats frameStats{ profiler.GetFrameStats() };
+	spdlog::info(
+		"Main: Frame time over the last {} of {} frames: p50 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms.",
+		std::min<uint64_t>(frameStats.frameCount, HelloTriangle::Profiler::FRAME_HISTORY),
+		frameStats.frameCount,
+		frameStats.p50Milliseconds,
+		frameStats.p99Milliseconds,
+		frameStats.maxMilliseconds);
+	if (renderer)
+	{
+		const HelloTriangle::FrameTimeStats gpuStats{ profiler.GetGpuFrameStats() };
+		spdlog::info(
+			"Main: GPU frame time: p50 {:.2f}ms, p99 {:.2f}ms, max {:.2f}ms.",
+			gpuStats.p50Milliseconds,
+			gpuStats.p99Milliseconds,
+			gpuStats.maxMilliseconds);
+	}
+
+	const std::filesystem::path tracePath{ GetExecutableDirectory() / "Trace.json" };
+	if (profiler.WriteChromeTrace(tracePath))
+	{
+		spdlog::info(
+			"Main: Wrote profile trace to {} ({} older zones overwritten).",
+			tracePath.string(),
+			profiler.GetDroppedZoneCount());
 	}
-	spdlog::info("Main: Main loop terminated.");
+	HelloTriangle::Profiler::SetActive(nullptr);
+	return isAllocationFree ? 0 : 1;
 }
\ No newline at end of file
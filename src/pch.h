@@ -1,5 +1,6 @@
 #pragma once
 
+#if defined(_WIN32)
 // Windows headers
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -12,17 +13,22 @@
 
 // D3D12 Extension Librayr
 #include <d3dx12.h>
+#endif
 
 // STL
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <chrono>
+#include <cstring>
 #include <string>
 
 // Spdlog
 #include <spdlog/spdlog.h>
 
+#if defined(_WIN32)
 // Common program headers
 #include "Utility.h"
 
-namespace MWRL = Microsoft::WRL;
\ No newline at end of file
+namespace MWRL = Microsoft::WRL;
+#endif
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "pch.h"
+#include "AssetStreamer.h"
+#include "NullMeshUploadSink.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr std::chrono::seconds LOAD_TIMEOUT{ 10 };
+
+		/// <summary>
+		/// A file path in the temporary directory, deleted on destruction.
+		/// </summary>
+		class TemporaryPath
+		{
+		public:
+			explicit TemporaryPath(const std::string& name) :
+				m_path(std::filesystem::temp_directory_path() / name)
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			~TemporaryPath()
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			const std::filesystem::path& Get() const
+			{
+				return m_path;
+			}
+
+		private:
+			std::filesystem::path m_path;
+		};
+
+		// A strip of triangleCount triangles, 28 * (triangleCount + 2) + 6 * triangleCount bytes
+		MeshData BuildStripMesh(uint32_t triangleCount)
+		{
+			MeshData mesh;
+			for (uint32_t i = 0; i < (triangleCount + 2); ++i)
+			{
+				const float x{ static_cast<float>(i / 2) };
+				const float y{ static_cast<float>(i % 2) };
+				mesh.vertices.push_back(Vertex{ { x, y, 0.0f }, { x, y, 0.0f, 1.0f } });
+			}
+			for (uint32_t i = 0; i < triangleCount; ++i)
+			{
+				mesh.indices.push_back(static_cast<uint16_t>(i));
+				mesh.indices.push_back(static_cast<uint16_t>(i + 1));
+				mesh.indices.push_back(static_cast<uint16_t>(i + 2));
+			}
+			return mesh;
+		}
+
+		/// <summary>
+		/// Mesh files on disk, each a strip of the given triangle count.
+		/// </summary>
+		class MeshFiles
+		{
+		public:
+			MeshFiles(const char* prefix, const std::vector<uint32_t>& triangleCounts)
+			{
+				for (size_t i = 0; i < triangleCounts.size(); ++i)
+				{
+					m_paths.push_back(std::make_unique<TemporaryPath>(std::string{ prefix } + std::to_string(i) + ".mesh"));
+					EXPECT_TRUE(WriteMeshFile(m_paths.back()->Get(), BuildStripMesh(triangleCounts[i])));
+				}
+			}
+
+			const std::filesystem::path& Get(size_t index) const
+			{
+				return m_paths[index]->Get();
+			}
+
+		private:
+			std::vector<std::unique_ptr<TemporaryPath>> m_paths;
+		};
+
+		// Loaders run on their own threads, so tests wait for the state they need
+		bool WaitForState(const AssetStreamer& streamer, AssetStreamer::AssetHandle handle, AssetState state)
+		{
+			const auto deadline{ std::chrono::steady_clock::now() + LOAD_TIMEOUT };
+			while (streamer.GetState(handle) != state)
+			{
+				if (std::chrono::steady_clock::now() > deadline)
+				{
+					return false;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+			}
+			return true;
+		}
+	}
+
+	TEST(AssetStreamerTests, LoadsHighestPriorityFirst)
+	{
+		const MeshFiles files{ "HelloTriangleStreamerPriority", { 1, 1, 1, 1 } };
+		AssetStreamer streamer{ AssetStreamer::Config{ 1, 1, 1024 * 1024 } };
+		NullMeshUploadSink sink;
+
+		// The first request occupies the only in-flight slot until it is uploaded,
+		// so the rest are all queued when the loader next picks one
+		const AssetStreamer::AssetHandle first{ streamer.RequestMesh(files.Get(0), 0) };
+		ASSERT_TRUE(WaitForState(streamer, first, AssetState::Decoded));
+		const AssetStreamer::AssetHandle low{ streamer.RequestMesh(files.Get(1), 1) };
+		const AssetStreamer::AssetHandle high{ streamer.RequestMesh(files.Get(2), 5) };
+		const AssetStreamer::AssetHandle middle{ streamer.RequestMesh(files.Get(3), 3) };
+		EXPECT_EQ(streamer.GetState(high), AssetState::Queued);
+
+		streamer.Flush(sink);
+		EXPECT_EQ(streamer.GetMeshIndex(first), 0u);
+		EXPECT_EQ(streamer.GetMeshIndex(high), 1u);
+		EXPECT_EQ(streamer.GetMeshIndex(middle), 2u);
+		EXPECT_EQ(streamer.GetMeshIndex(low), 3u);
+	}
+
+	TEST(AssetStreamerTests, UpdateUploadsWithinTheFrameBudget)
+	{
+		// Four 90-byte meshes and one 600-byte mesh, against a 200-byte budget
+		constexpr uint64_t SMALL_MESH_BYTES{ 90 };
+		constexpr uint64_t LARGE_MESH_BYTES{ 600 };
+		const MeshFiles files{ "HelloTriangleStreamerBudget", { 1, 1, 1, 1, 16 } };
+		AssetStreamer streamer{ AssetStreamer::Config{ 2, 8, 200 } };
+		NullMeshUploadSink sink;
+
+		std::vector<AssetStreamer::AssetHandle> handles;
+		for (size_t i = 0; i < 4; ++i)
+		{
+			handles.push_back(streamer.RequestMesh(files.Get(i)));
+		}
+		for (AssetStreamer::AssetHandle handle : handles)
+		{
+			ASSERT_TRUE(WaitForState(streamer, handle, AssetState::Decoded));
+		}
+
+		streamer.Update(sink);
+		EXPECT_EQ(streamer.GetStats().lastFrameUploadedBytes, 2 * SMALL_MESH_BYTES);
+		EXPECT_EQ(sink.GetMeshCount(), 2u);
+		streamer.Update(sink);
+		EXPECT_EQ(sink.GetMeshCount(), 4u);
+		streamer.Update(sink);
+		EXPECT_EQ(streamer.GetStats().lastFrameUploadedBytes, 0u);
+
+		// A mesh over the whole budget still goes, on its own
+		const AssetStreamer::AssetHandle large{ streamer.RequestMesh(files.Get(4)) };
+		ASSERT_TRUE(WaitForState(streamer, large, AssetState::Decoded));
+		streamer.Update(sink);
+		EXPECT_EQ(streamer.GetState(large), AssetState::Resident);
+		EXPECT_EQ(streamer.GetStats().lastFrameUploadedBytes, LARGE_MESH_BYTES);
+		EXPECT_EQ(streamer.GetStats().uploadedBytes, (4 * SMALL_MESH_BYTES) + LARGE_MESH_BYTES);
+		EXPECT_EQ(sink.GetUploadedBytes(), (4 * SMALL_MESH_BYTES) + LARGE_MESH_BYTES);
+		EXPECT_TRUE(streamer.IsIdle());
+	}
+
+	TEST(AssetStreamerTests, MissingAndCorruptFilesFail)
+	{
+		const TemporaryPath missing{ "HelloTriangleStreamerMissing.mesh" };
+		const TemporaryPath garbage{ "HelloTriangleStreamerGarbage.mesh" };
+		const TemporaryPath truncated{ "HelloTriangleStreamerTruncated.mesh" };
+		{
+			std::ofstream file{ garbage.Get(), std::ios::binary };
+			file << "not a mesh file at all";
+		}
+		const std::vector<uint8_t> bytes{ EncodeMesh(BuildStripMesh(4)) };
+		{
+			std::ofstream file{ truncated.Get(), std::ios::binary };
+			file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size() - 1));
+		}
+
+		AssetStreamer streamer{ AssetStreamer::Config{} };
+		NullMeshUploadSink sink;
+		const AssetStreamer::AssetHandle handles[]{
+			streamer.RequestMesh(missing.Get()),
+			streamer.RequestMesh(garbage.Get()),
+			streamer.RequestMesh(truncated.Get()),
+		};
+		streamer.Flush(sink);
+
+		for (AssetStreamer::AssetHandle handle : handles)
+		{
+			SCOPED_TRACE(handle);
+			EXPECT_EQ(streamer.GetState(handle), AssetState::Failed);
+			EXPECT_EQ(streamer.GetMeshIndex(handle), IMeshUploadSink::INVALID_MESH);
+		}
+		EXPECT_EQ(streamer.GetStats().failedCount, 3u);
+		EXPECT_EQ(sink.GetMeshCount(), 0u);
+	}
+
+	TEST(AssetStreamerTests, FlushReturnsOnceEverythingIsResidentOrFailed)
+	{
+		const MeshFiles files{ "HelloTriangleStreamerFlush", { 1, 8, 32, 2, 4, 16 } };
+		const TemporaryPath missing{ "HelloTriangleStreamerFlushMissing.mesh" };
+		AssetStreamer streamer{ AssetStreamer::Config{ 3, 2, 1 } };
+		NullMeshUploadSink sink;
+
+		std::vector<AssetStreamer::AssetHandle> handles;
+		for (size_t i = 0; i < 6; ++i)
+		{
+			handles.push_back(streamer.RequestMesh(files.Get(i), static_cast<int32_t>(i % 3)));
+			if (i == 2)
+			{
+				handles.push_back(streamer.RequestMesh(missing.Get()));
+			}
+		}
+		streamer.Flush(sink);
+
+		EXPECT_TRUE(streamer.IsIdle());
+		const AssetStreamer::Stats stats{ streamer.GetStats() };
+		EXPECT_EQ(stats.requestedCount, 7u);
+		EXPECT_EQ(stats.residentCount, 6u);
+		EXPECT_EQ(stats.failedCount, 1u);
+		for (AssetStreamer::AssetHandle handle : handles)
+		{
+			const AssetState state{ streamer.GetState(handle) };
+			EXPECT_TRUE((state == AssetState::Resident) || (state == AssetState::Failed));
+		}
+		EXPECT_EQ(streamer.GetState(handles[3]), AssetState::Failed);
+
+		// Nothing is left for later frames
+		streamer.Update(sink);
+		EXPECT_EQ(streamer.GetStats().lastFrameUploadedBytes, 0u);
+		EXPECT_EQ(sink.GetMeshCount(), 6u);
+	}
+}
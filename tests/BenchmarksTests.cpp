@@ -0,0 +1,54 @@
+#include "pch.h"
+#include "Benchmarks.h"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace HelloTriangle
+{
+	TEST(BenchmarksTests, WritesOneJsonResultPerLine)
+	{
+		const BenchmarkConfig config{ 10, 20, 30, 40, {} };
+		const std::vector<BenchmarkResult> results{
+			{ "first", 1, 30, 10, 500.0 },
+			{ "second", 4, 30, 20, 0.0 },
+		};
+
+		std::ostringstream stream;
+		WriteBenchmarkResults(stream, config, results);
+		EXPECT_EQ(
+			stream.str(),
+			"{\"config\":{\"entityCount\":10,\"drawCount\":20,\"frameCount\":30,\"inputEventCount\":40},\n"
+			"\"results\":[\n"
+			"{\"name\":\"first\",\"threads\":1,\"iterations\":30,\"items\":10,\"totalMilliseconds\":500,\"itemsPerSecond\":20},\n"
+			"{\"name\":\"second\",\"threads\":4,\"iterations\":30,\"items\":20,\"totalMilliseconds\":0,\"itemsPerSecond\":0}\n"
+			"]}\n");
+	}
+
+	TEST(BenchmarksTests, WritesCountersOnResultsThatHaveThem)
+	{
+		const BenchmarkConfig config{ 10, 20, 30, 40, {} };
+		const std::vector<BenchmarkResult> results{
+			{ "graph", 1, 30, 10, 0.0, { { "culledPasses", 1 }, { "barriers", 7 } } },
+		};
+
+		std::ostringstream stream;
+		WriteBenchmarkResults(stream, config, results);
+		EXPECT_EQ(
+			stream.str(),
+			"{\"config\":{\"entityCount\":10,\"drawCount\":20,\"frameCount\":30,\"inputEventCount\":40},\n"
+			"\"results\":[\n"
+			"{\"name\":\"graph\",\"threads\":1,\"iterations\":30,\"items\":10,\"totalMilliseconds\":0,\"itemsPerSecond\":0,"
+			"\"counters\":{\"culledPasses\":1,\"barriers\":7}}\n"
+			"]}\n");
+	}
+
+	TEST(BenchmarksTests, WritesAnEmptyResultList)
+	{
+		std::ostringstream stream;
+		WriteBenchmarkResults(stream, BenchmarkConfig{}, {});
+		EXPECT_EQ(
+			stream.str(),
+			"{\"config\":{\"entityCount\":100000,\"drawCount\":10000,\"frameCount\":100,\"inputEventCount\":10000},\n\"results\":[\n]}\n");
+	}
+}
@@ -0,0 +1,128 @@
+#include "pch.h"
+#include "BlobArchive.h"
+
+#include <gtest/gtest.h>
+#include <fstream>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		/// <summary>
+		/// A file path in the temporary directory, deleted on destruction.
+		/// </summary>
+		class TemporaryPath
+		{
+		public:
+			explicit TemporaryPath(const char* name) :
+				m_path(std::filesystem::temp_directory_path() / name)
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			~TemporaryPath()
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			const std::filesystem::path& Get() const
+			{
+				return m_path;
+			}
+
+		private:
+			std::filesystem::path m_path;
+		};
+
+		void SetString(BlobArchive& archive, uint64_t key, std::string_view value)
+		{
+			archive.Set(key, value.data(), value.size());
+		}
+
+		std::string FindString(BlobArchive& archive, uint64_t key)
+		{
+			const std::vector<uint8_t>* blob{ archive.Find(key) };
+			return blob ? std::string{ blob->begin(), blob->end() } : std::string{ "<missing>" };
+		}
+	}
+
+	TEST(BlobArchiveTests, RoundTripsEntries)
+	{
+		const TemporaryPath path{ "HelloTriangleBlobArchiveRoundTrip.cache" };
+		{
+			BlobArchive archive;
+			SetString(archive, 1, "first");
+			SetString(archive, 2, "");
+			SetString(archive, 3, "third");
+			EXPECT_TRUE(archive.IsDirty());
+			ASSERT_TRUE(archive.Save(path.Get()));
+			EXPECT_FALSE(archive.IsDirty());
+		}
+
+		BlobArchive archive;
+		ASSERT_TRUE(archive.Load(path.Get()));
+		EXPECT_EQ(archive.GetEntryCount(), 3u);
+		EXPECT_EQ(FindString(archive, 1), "first");
+		EXPECT_EQ(FindString(archive, 2), "");
+		EXPECT_EQ(FindString(archive, 3), "third");
+		EXPECT_EQ(archive.Find(4), nullptr);
+	}
+
+	TEST(BlobArchiveTests, IgnoresCorruptFiles)
+	{
+		const TemporaryPath path{ "HelloTriangleBlobArchiveCorrupt.cache" };
+		{
+			BlobArchive archive;
+			SetString(archive, 1, "payload");
+			ASSERT_TRUE(archive.Save(path.Get()));
+		}
+
+		// Flip the blob's last byte, so only the checksum can tell
+		{
+			std::fstream file{ path.Get(), std::ios::binary | std::ios::in | std::ios::out };
+			file.seekg(-1, std::ios::end);
+			const char last{ static_cast<char>(file.get()) };
+			file.seekp(-1, std::ios::end);
+			file.put(static_cast<char>(last ^ 0x01));
+		}
+
+		BlobArchive archive;
+		EXPECT_FALSE(archive.Load(path.Get()));
+		EXPECT_EQ(archive.GetEntryCount(), 0u);
+
+		std::filesystem::resize_file(path.Get(), 10);
+		EXPECT_FALSE(archive.Load(path.Get()));
+	}
+
+	TEST(BlobArchiveTests, EvictsEntriesUnusedForTooManySessions)
+	{
+		constexpr uint32_t MAX_UNUSED_SESSIONS{ 3 };
+		const TemporaryPath path{ "HelloTriangleBlobArchiveEviction.cache" };
+		{
+			BlobArchive archive{ MAX_UNUSED_SESSIONS };
+			SetString(archive, 1, "used every session");
+			SetString(archive, 2, "never used again");
+			ASSERT_TRUE(archive.Save(path.Get()));
+		}
+
+		// Each session uses the first entry and adds a new one, as a shader edit would
+		for (uint64_t session = 1; session <= MAX_UNUSED_SESSIONS; ++session)
+		{
+			SCOPED_TRACE(session);
+			BlobArchive archive{ MAX_UNUSED_SESSIONS };
+			ASSERT_TRUE(archive.Load(path.Get()));
+			EXPECT_EQ(FindString(archive, 1), "used every session");
+
+			// Nothing is evicted until a save finds it unused for long enough
+			EXPECT_EQ(archive.GetEntryCount(), session + 1);
+			SetString(archive, 100 + session, "added");
+			ASSERT_TRUE(archive.Save(path.Get()));
+		}
+
+		BlobArchive archive{ MAX_UNUSED_SESSIONS };
+		ASSERT_TRUE(archive.Load(path.Get()));
+		EXPECT_EQ(FindString(archive, 1), "used every session");
+		EXPECT_EQ(archive.Find(2), nullptr);
+		EXPECT_EQ(archive.GetEntryCount(), 1u + MAX_UNUSED_SESSIONS);
+	}
+}
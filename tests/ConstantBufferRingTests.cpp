@@ -0,0 +1,97 @@
+#include "pch.h"
+#include "ConstantBufferRing.h"
+#include "ShaderConstants.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint64_t FAKE_GPU_BASE{ 0x10000 };
+
+		/// <summary>
+		/// One constant buffer slot; a vector of these stands in for the mapped upload
+		/// heap with the alignment the ring requires.
+		/// </summary>
+		struct alignas(ConstantBufferRing::CONSTANT_BUFFER_ALIGNMENT) Slot
+		{
+			uint8_t bytes[ConstantBufferRing::CONSTANT_BUFFER_ALIGNMENT];
+		};
+
+		uint64_t GetOffset(const ConstantBufferRing::Allocation& allocation, const std::vector<Slot>& storage)
+		{
+			return static_cast<uint64_t>(allocation.cpuAddress - storage.front().bytes);
+		}
+	}
+
+	TEST(ConstantBufferRingTests, AlignsEveryAllocation)
+	{
+		std::vector<Slot> storage(64);
+		ConstantBufferRing ring{ storage.front().bytes, FAKE_GPU_BASE, storage.size() * sizeof(Slot) };
+
+		for (uint64_t size : { 1ull, 4ull, 64ull, 255ull, 256ull, 257ull, 600ull, 16ull })
+		{
+			SCOPED_TRACE(size);
+			const ConstantBufferRing::Allocation allocation{ ring.Allocate(size) };
+			ASSERT_NE(allocation.cpuAddress, nullptr);
+			const uint64_t offset{ GetOffset(allocation, storage) };
+			EXPECT_EQ(offset % ConstantBufferRing::CONSTANT_BUFFER_ALIGNMENT, 0u);
+			EXPECT_EQ(allocation.gpuAddress, FAKE_GPU_BASE + offset);
+			EXPECT_EQ(allocation.size, ConstantBufferRing::AlignSize(size));
+			EXPECT_GE(allocation.size, size);
+		}
+		EXPECT_EQ(ring.GetFailedAllocationCount(), 0u);
+	}
+
+	TEST(ConstantBufferRingTests, PushCopiesTheConstants)
+	{
+		std::vector<Slot> storage(4);
+		ConstantBufferRing ring{ storage.front().bytes, FAKE_GPU_BASE, storage.size() * sizeof(Slot) };
+
+		MeshConstants constants{ { 1.0f, 2.0f, 3.0f, 0.0f }, { 4.0f, 5.0f, 6.0f, 0.0f } };
+		ring.Push(constants);
+		const ConstantBufferRing::Allocation allocation{ ring.Push(constants) };
+		ASSERT_NE(allocation.cpuAddress, nullptr);
+		EXPECT_EQ(GetOffset(allocation, storage), ConstantBufferRing::CONSTANT_BUFFER_ALIGNMENT);
+
+		MeshConstants copy{};
+		memcpy(&copy, allocation.cpuAddress, sizeof(copy));
+		EXPECT_EQ(copy.quantizationOffset[2], 3.0f);
+		EXPECT_EQ(copy.quantizationScale[0], 4.0f);
+	}
+
+	TEST(ConstantBufferRingTests, ReusesMemoryOnceFramesRetire)
+	{
+		// Room for two frames of two constant buffers each
+		constexpr uint64_t FRAMES_IN_FLIGHT{ 2 };
+		std::vector<Slot> storage(4);
+		ConstantBufferRing ring{ storage.front().bytes, FAKE_GPU_BASE, storage.size() * sizeof(Slot) };
+		const FrameConstants constants{};
+
+		for (uint64_t frame = 1; frame <= 10; ++frame)
+		{
+			SCOPED_TRACE(frame);
+
+			// Pretend the GPU runs FRAMES_IN_FLIGHT frames behind
+			if (frame > FRAMES_IN_FLIGHT)
+			{
+				ring.Retire(frame - FRAMES_IN_FLIGHT);
+			}
+			EXPECT_NE(ring.Push(constants).cpuAddress, nullptr);
+			EXPECT_NE(ring.Push(constants).cpuAddress, nullptr);
+			ring.FinishFrame(frame);
+			EXPECT_EQ(ring.GetUsedBytes(), std::min(frame, FRAMES_IN_FLIGHT) * 2 * sizeof(Slot));
+		}
+		EXPECT_EQ(ring.GetFailedAllocationCount(), 0u);
+
+		// Without retiring, the next frame doesn't fit and the failure is counted
+		EXPECT_EQ(ring.Push(constants).cpuAddress, nullptr);
+		EXPECT_EQ(ring.GetFailedAllocationCount(), 1u);
+
+		ring.Retire(10);
+		EXPECT_EQ(ring.GetUsedBytes(), 0u);
+		EXPECT_NE(ring.Push(constants).cpuAddress, nullptr);
+	}
+}
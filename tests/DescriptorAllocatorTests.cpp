@@ -0,0 +1,213 @@
+#include "pch.h"
+#include "DescriptorAllocator.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t PERSISTENT_CAPACITY{ 256 };
+		constexpr uint32_t TRANSIENT_CAPACITY{ 64 };
+		constexpr uint64_t FRAMES_IN_FLIGHT{ 2 };
+
+		struct Allocation
+		{
+			uint32_t index;
+			uint32_t count;
+		};
+
+		struct FencedRange
+		{
+			uint64_t fenceValue;
+			uint32_t index;
+			uint32_t count;
+		};
+
+		uint32_t Roll(std::mt19937& random, uint32_t sides)
+		{
+			return static_cast<uint32_t>(random() % sides);
+		}
+
+		enum class SlotState
+		{
+			Free,
+			Allocated,
+			Pending,
+		};
+
+		/// <summary>
+		/// SlotModel mirrors what each persistent slot should be, so every answer the
+		/// allocator gives can be checked against it.
+		/// </summary>
+		struct SlotModel
+		{
+			std::vector<SlotState> slots = std::vector<SlotState>(PERSISTENT_CAPACITY, SlotState::Free);
+			std::vector<FencedRange> pendingFrees;
+
+			uint32_t Count(SlotState state) const
+			{
+				return static_cast<uint32_t>(std::count(slots.begin(), slots.end(), state));
+			}
+
+			// Whether first fit should find count contiguous free slots
+			bool HasFreeRun(uint32_t count) const
+			{
+				uint32_t run{ 0 };
+				for (const SlotState state : slots)
+				{
+					run = (state == SlotState::Free) ? (run + 1) : 0;
+					if (run == count)
+					{
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void Set(uint32_t index, uint32_t count, SlotState state)
+			{
+				std::fill_n(slots.begin() + index, count, state);
+			}
+		};
+	}
+
+	TEST(DescriptorAllocatorTests, RandomizedUseKeepsSlotsExclusive)
+	{
+		DescriptorAllocator allocator{ PERSISTENT_CAPACITY, TRANSIENT_CAPACITY };
+		SlotModel model;
+		std::vector<Allocation> live;
+		std::vector<FencedRange> transients;
+		std::mt19937 random{ 1234 };
+		uint32_t transientWrapCount{ 0 };
+		uint32_t lastTransientIndex{ 0 };
+
+		for (uint64_t frame = 1; frame <= 2000; ++frame)
+		{
+			SCOPED_TRACE(frame);
+
+			// Persistent allocations and frees, freed against this frame's fence
+			const uint32_t operationCount{ Roll(random, 8) };
+			for (uint32_t operation = 0; operation < operationCount; ++operation)
+			{
+				if (live.empty() || (Roll(random, 2) == 0))
+				{
+					const uint32_t count{ 1 + Roll(random, 16) };
+					const uint32_t index{ allocator.AllocatePersistent(count) };
+					if (index == DescriptorAllocator::INVALID_INDEX)
+					{
+						// Also fails if released neighbours weren't merged into one range
+						EXPECT_FALSE(model.HasFreeRun(count)) << "first fit missed a free run of " << count;
+						continue;
+					}
+					ASSERT_LE(index + count, PERSISTENT_CAPACITY);
+					for (uint32_t slot = index; slot < index + count; ++slot)
+					{
+						ASSERT_EQ(model.slots[slot], SlotState::Free) << "slot " << slot << " handed out twice";
+					}
+					model.Set(index, count, SlotState::Allocated);
+					live.push_back(Allocation{ index, count });
+				}
+				else
+				{
+					const size_t victim{ random() % live.size() };
+					const Allocation freed{ live[victim] };
+					live[victim] = live.back();
+					live.pop_back();
+					allocator.FreePersistent(freed.index, freed.count, frame);
+					model.Set(freed.index, freed.count, SlotState::Pending);
+					model.pendingFrees.push_back(FencedRange{ frame, freed.index, freed.count });
+				}
+			}
+
+			// Transient tables for this frame, which may wrap around the ring
+			const uint32_t tableCount{ Roll(random, 4) };
+			for (uint32_t table = 0; table < tableCount; ++table)
+			{
+				const uint32_t count{ 1 + Roll(random, 12) };
+				const uint32_t index{ allocator.AllocateTransient(count) };
+				if (index == DescriptorAllocator::INVALID_INDEX)
+				{
+					continue;
+				}
+				ASSERT_GE(index, PERSISTENT_CAPACITY);
+				ASSERT_LE(index + count, PERSISTENT_CAPACITY + TRANSIENT_CAPACITY);
+				for (const FencedRange& other : transients)
+				{
+					ASSERT_TRUE(((index + count) <= other.index) || ((other.index + other.count) <= index))
+						<< "transient slots " << index << "+" << count << " overlap " << other.index << "+" << other.count;
+				}
+				transientWrapCount += (index < lastTransientIndex) ? 1 : 0;
+				lastTransientIndex = index;
+				transients.push_back(FencedRange{ frame, index, count });
+			}
+			allocator.FinishFrame(frame);
+
+			// The GPU runs FRAMES_IN_FLIGHT frames behind
+			const uint64_t completed{ (frame > FRAMES_IN_FLIGHT) ? (frame - FRAMES_IN_FLIGHT) : 0 };
+			allocator.Retire(completed);
+			std::erase_if(model.pendingFrees, [&model, completed](const FencedRange& pending)
+			{
+				if (pending.fenceValue > completed)
+				{
+					return false;
+				}
+				model.Set(pending.index, pending.count, SlotState::Free);
+				return true;
+			});
+			std::erase_if(transients, [completed](const FencedRange& transient)
+			{
+				return transient.fenceValue <= completed;
+			});
+
+			ASSERT_EQ(allocator.GetPersistentFreeCount(), model.Count(SlotState::Free));
+			ASSERT_EQ(allocator.GetPendingFreeCount(), model.Count(SlotState::Pending));
+		}
+
+		// Free everything; after the last fence, the whole region is one range again
+		for (const Allocation& allocation : live)
+		{
+			allocator.FreePersistent(allocation.index, allocation.count, 2001);
+		}
+		allocator.Retire(2001);
+		EXPECT_EQ(allocator.GetPendingFreeCount(), 0u);
+		EXPECT_EQ(allocator.AllocatePersistent(PERSISTENT_CAPACITY), 0u);
+
+		EXPECT_GT(transientWrapCount, 0u);
+	}
+
+	TEST(DescriptorAllocatorTests, RejectsDoubleFrees)
+	{
+		DescriptorAllocator allocator{ PERSISTENT_CAPACITY, TRANSIENT_CAPACITY };
+		const uint32_t first{ allocator.AllocatePersistent(4) };
+		const uint32_t second{ allocator.AllocatePersistent(4) };
+		ASSERT_EQ(first, 0u);
+		ASSERT_EQ(second, 4u);
+
+		// Freeing twice before the fence completes
+		allocator.FreePersistent(first, 4, 1);
+		allocator.FreePersistent(first, 4, 1);
+		allocator.FreePersistent(first + 2, 1, 1);
+		EXPECT_EQ(allocator.GetPendingFreeCount(), 4u);
+
+		// Freeing again after the slots went back to the free list
+		allocator.Retire(1);
+		allocator.FreePersistent(first, 4, 2);
+		EXPECT_EQ(allocator.GetPendingFreeCount(), 0u);
+
+		// Freeing slots that straddle a free range and a live allocation
+		allocator.FreePersistent(first + 3, 2, 2);
+		EXPECT_EQ(allocator.GetPendingFreeCount(), 0u);
+
+		// Slots never allocated at all
+		allocator.FreePersistent(100, 1, 2);
+		EXPECT_EQ(allocator.GetPendingFreeCount(), 0u);
+
+		allocator.FreePersistent(second, 4, 2);
+		allocator.Retire(2);
+		EXPECT_EQ(allocator.GetPersistentFreeCount(), PERSISTENT_CAPACITY);
+		EXPECT_EQ(allocator.AllocatePersistent(PERSISTENT_CAPACITY), 0u);
+	}
+}
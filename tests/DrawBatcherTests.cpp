@@ -0,0 +1,127 @@
+#include "pch.h"
+#include "DrawBatcher.h"
+
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		// Tags an instance so tests can tell which submission it came from
+		InstanceData MakeInstance(float tag)
+		{
+			return InstanceData{ { tag, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } };
+		}
+
+		std::vector<float> GetTags(const DrawBatcher& batcher)
+		{
+			std::vector<float> tags;
+			for (const InstanceData& instance : batcher.GetInstances())
+			{
+				tags.push_back(instance.positionScale[0]);
+			}
+			return tags;
+		}
+	}
+
+	TEST(DrawBatcherTests, MergesDrawsWithEqualMaterialAndMesh)
+	{
+		DrawBatcher batcher;
+		batcher.Submit(1, 2, MakeInstance(0.0f));
+		batcher.Submit(0, 5, MakeInstance(1.0f));
+		batcher.Submit(1, 2, MakeInstance(2.0f));
+		batcher.Submit(1, 2, MakeInstance(3.0f));
+		batcher.Submit(0, 5, MakeInstance(4.0f));
+		batcher.Build();
+
+		const std::vector<DrawBatch>& batches{ batcher.GetBatches() };
+		ASSERT_EQ(batches.size(), 2u);
+		EXPECT_EQ(batches[0].material, 0u);
+		EXPECT_EQ(batches[0].mesh, 5u);
+		EXPECT_EQ(batches[0].firstInstance, 0u);
+		EXPECT_EQ(batches[0].instanceCount, 2u);
+		EXPECT_EQ(batches[1].material, 1u);
+		EXPECT_EQ(batches[1].mesh, 2u);
+		EXPECT_EQ(batches[1].firstInstance, 2u);
+		EXPECT_EQ(batches[1].instanceCount, 3u);
+
+		EXPECT_EQ(batcher.GetStats().submittedCount, 5u);
+		EXPECT_EQ(batcher.GetStats().batchCount, 2u);
+	}
+
+	TEST(DrawBatcherTests, KeepsInstancesInSortedOrder)
+	{
+		// Sorted by state, then front to back, then in submission order
+		DrawBatcher batcher;
+		batcher.Submit(DrawKey{ .material = 1, .mesh = 0, .depth = 0.5f }, MakeInstance(0.0f));
+		batcher.Submit(DrawKey{ .material = 0, .mesh = 1, .depth = 0.9f }, MakeInstance(1.0f));
+		batcher.Submit(DrawKey{ .material = 0, .mesh = 1, .depth = 0.1f }, MakeInstance(2.0f));
+		batcher.Submit(DrawKey{ .material = 1, .mesh = 0, .depth = 0.2f }, MakeInstance(3.0f));
+		batcher.Submit(DrawKey{ .material = 0, .mesh = 0, .depth = 0.7f }, MakeInstance(4.0f));
+		batcher.Submit(DrawKey{ .material = 1, .mesh = 0, .depth = 0.2f }, MakeInstance(5.0f));
+		batcher.Build();
+
+		EXPECT_EQ(GetTags(batcher), (std::vector<float>{ 4.0f, 2.0f, 1.0f, 3.0f, 5.0f, 0.0f }));
+
+		const std::vector<DrawBatch>& batches{ batcher.GetBatches() };
+		ASSERT_EQ(batches.size(), 3u);
+		uint32_t nextInstance{ 0 };
+		for (const DrawBatch& batch : batches)
+		{
+			EXPECT_EQ(batch.firstInstance, nextInstance);
+			nextInstance += batch.instanceCount;
+		}
+		EXPECT_EQ(nextInstance, 6u);
+	}
+
+	TEST(DrawBatcherTests, RejectsIndicesTooWideForTheSortKey)
+	{
+		// Truncated, these would alias mesh 0 and material 0 and join their batch
+		DrawBatcher batcher;
+		EXPECT_TRUE(batcher.Submit(0, 0, MakeInstance(0.0f)));
+		EXPECT_FALSE(batcher.Submit(0, DrawSortKey::MAX_MESH_COUNT, MakeInstance(1.0f)));
+		EXPECT_FALSE(batcher.Submit(DrawSortKey::MAX_MATERIAL_COUNT, 0, MakeInstance(2.0f)));
+		EXPECT_FALSE(batcher.Submit(DrawKey{ .pass = 1u << DrawSortKey::PASS_BITS }, MakeInstance(3.0f)));
+		EXPECT_TRUE(batcher.Submit(DrawSortKey::MAX_MATERIAL_COUNT - 1, DrawSortKey::MAX_MESH_COUNT - 1, MakeInstance(4.0f)));
+		batcher.Build();
+
+		EXPECT_EQ(GetTags(batcher), (std::vector<float>{ 0.0f, 4.0f }));
+		ASSERT_EQ(batcher.GetBatches().size(), 2u);
+		EXPECT_EQ(batcher.GetBatches()[1].mesh, DrawSortKey::MAX_MESH_COUNT - 1);
+		EXPECT_EQ(batcher.GetBatches()[1].material, DrawSortKey::MAX_MATERIAL_COUNT - 1);
+		EXPECT_EQ(batcher.GetStats().submittedCount, 2u);
+		EXPECT_EQ(batcher.GetStats().rejectedCount, 3u);
+
+		batcher.Reset();
+		batcher.Build();
+		EXPECT_EQ(batcher.GetStats().rejectedCount, 0u);
+	}
+
+	TEST(DrawBatcherTests, ResetStartsAnEmptyFrame)
+	{
+		DrawBatcher batcher;
+		batcher.Submit(0, 0, MakeInstance(0.0f));
+		batcher.Build();
+		batcher.Reset();
+		batcher.Submit(3, 4, MakeInstance(1.0f));
+		batcher.Build();
+
+		ASSERT_EQ(batcher.GetBatches().size(), 1u);
+		EXPECT_EQ(batcher.GetBatches()[0].material, 3u);
+		EXPECT_EQ(GetTags(batcher), (std::vector<float>{ 1.0f }));
+	}
+
+	TEST(DrawBatcherTests, TotalsSumFrameStats)
+	{
+		DrawBatchingTotals totals;
+		totals.Add(DrawBatcher::Stats{ 10, 2, std::chrono::nanoseconds{ 300 }, 0 });
+		totals.Add(DrawBatcher::Stats{ 20, 3, std::chrono::nanoseconds{ 500 }, 1 });
+
+		EXPECT_EQ(totals.frameCount, 2u);
+		EXPECT_EQ(totals.submittedCount, 30u);
+		EXPECT_EQ(totals.batchCount, 5u);
+		EXPECT_EQ(totals.rejectedCount, 1u);
+		EXPECT_EQ(totals.buildTime, std::chrono::nanoseconds{ 800 });
+		EXPECT_EQ(totals.maxBuildTime, std::chrono::nanoseconds{ 500 });
+	}
+}
@@ -0,0 +1,93 @@
+#include "pch.h"
+#include "DrawSortKey.h"
+
+#include <gtest/gtest.h>
+#include <limits>
+
+namespace HelloTriangle
+{
+	TEST(DrawSortKeyTests, DecodeRoundTripsEveryField)
+	{
+		const DrawKey key{
+			.pass = (1u << DrawSortKey::PASS_BITS) - 1,
+			.pipeline = 517,
+			.rootSignature = 9,
+			.material = DrawSortKey::MAX_MATERIAL_COUNT - 1,
+			.mesh = 40'000,
+			.depth = 0.375f,
+		};
+		const DrawKey decoded{ DrawSortKey::Decode(DrawSortKey::Encode(key)) };
+		EXPECT_EQ(decoded.pass, key.pass);
+		EXPECT_EQ(decoded.pipeline, key.pipeline);
+		EXPECT_EQ(decoded.rootSignature, key.rootSignature);
+		EXPECT_EQ(decoded.material, key.material);
+		EXPECT_EQ(decoded.mesh, key.mesh);
+
+		// Depth comes back at DEPTH_BITS of precision
+		EXPECT_NEAR(decoded.depth, key.depth, 1.0f / static_cast<float>(1u << DrawSortKey::DEPTH_BITS));
+	}
+
+	TEST(DrawSortKeyTests, QuantizesAndClampsDepth)
+	{
+		// Depth keeps DEPTH_BITS of precision
+		const float step{ 1.0f / static_cast<float>((1u << DrawSortKey::DEPTH_BITS) - 1) };
+		for (const float depth : { 0.1f, 0.5f, 0.999f })
+		{
+			const float decoded{ DrawSortKey::Decode(DrawSortKey::Encode(DrawKey{ .depth = depth })).depth };
+			EXPECT_NEAR(decoded, depth, step / 2.0f);
+		}
+
+		// Depths closer together than one step share a key
+		EXPECT_EQ(
+			DrawSortKey::Encode(DrawKey{ .depth = 0.5f }),
+			DrawSortKey::Encode(DrawKey{ .depth = 0.5f + (step / 4.0f) }));
+
+		EXPECT_EQ(DrawSortKey::Decode(DrawSortKey::Encode(DrawKey{ .depth = -1.0f })).depth, 0.0f);
+		EXPECT_EQ(DrawSortKey::Decode(DrawSortKey::Encode(DrawKey{ .depth = 2.0f })).depth, 1.0f);
+		EXPECT_EQ(
+			DrawSortKey::Decode(DrawSortKey::Encode(DrawKey{ .depth = std::numeric_limits<float>::quiet_NaN() })).depth,
+			0.0f);
+	}
+
+	TEST(DrawSortKeyTests, OrdersByPassThenPipelineThenMaterialThenMeshThenDepth)
+	{
+		// Each key differs from the next in one field, which outweighs every less
+		// significant field being at its largest
+		const DrawKey keys[]{
+			DrawKey{ .pass = 0, .pipeline = 1023, .material = 4095, .mesh = 65535, .depth = 1.0f },
+			DrawKey{ .pass = 1, .pipeline = 0, .material = 4095, .mesh = 65535, .depth = 1.0f },
+			DrawKey{ .pass = 1, .pipeline = 1, .material = 0, .mesh = 65535, .depth = 1.0f },
+			DrawKey{ .pass = 1, .pipeline = 1, .material = 1, .mesh = 0, .depth = 1.0f },
+			DrawKey{ .pass = 1, .pipeline = 1, .material = 1, .mesh = 1, .depth = 0.0f },
+			DrawKey{ .pass = 1, .pipeline = 1, .material = 1, .mesh = 1, .depth = 0.5f },
+		};
+		for (size_t i = 1; i < std::size(keys); ++i)
+		{
+			EXPECT_LT(DrawSortKey::Encode(keys[i - 1]), DrawSortKey::Encode(keys[i])) << "at " << i;
+		}
+	}
+
+	TEST(DrawSortKeyTests, StateKeyIgnoresOnlyDepth)
+	{
+		const DrawKey near{ .material = 3, .mesh = 7, .depth = 0.1f };
+		const DrawKey far{ .material = 3, .mesh = 7, .depth = 0.9f };
+		const DrawKey otherMesh{ .material = 3, .mesh = 8, .depth = 0.1f };
+		EXPECT_EQ(
+			DrawSortKey::GetStateKey(DrawSortKey::Encode(near)),
+			DrawSortKey::GetStateKey(DrawSortKey::Encode(far)));
+		EXPECT_NE(
+			DrawSortKey::GetStateKey(DrawSortKey::Encode(near)),
+			DrawSortKey::GetStateKey(DrawSortKey::Encode(otherMesh)));
+	}
+
+	TEST(DrawSortKeyTests, IsEncodableRejectsFieldsWiderThanTheirBits)
+	{
+		EXPECT_TRUE(DrawSortKey::IsEncodable(DrawKey{
+			.pass = 15, .pipeline = 1023, .rootSignature = 15, .material = 4095, .mesh = 65535 }));
+		EXPECT_FALSE(DrawSortKey::IsEncodable(DrawKey{ .pass = 16 }));
+		EXPECT_FALSE(DrawSortKey::IsEncodable(DrawKey{ .pipeline = 1024 }));
+		EXPECT_FALSE(DrawSortKey::IsEncodable(DrawKey{ .rootSignature = 16 }));
+		EXPECT_FALSE(DrawSortKey::IsEncodable(DrawKey{ .material = 4096 }));
+		EXPECT_FALSE(DrawSortKey::IsEncodable(DrawKey{ .mesh = 65536 }));
+	}
+}
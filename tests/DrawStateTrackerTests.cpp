@@ -0,0 +1,79 @@
+#include "pch.h"
+#include "DrawStateTracker.h"
+
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	TEST(DrawStateTrackerTests, DropsCallsThatRepeatTheCurrentState)
+	{
+		DrawStateTracker tracker;
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::PIPELINE_SLOT, 1u));
+		EXPECT_FALSE(tracker.Update(DrawStateTracker::PIPELINE_SLOT, 1u));
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::PIPELINE_SLOT, 2u));
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::FIRST_VERTEX_BUFFER_SLOT, 2u));
+		EXPECT_FALSE(tracker.Update(DrawStateTracker::FIRST_VERTEX_BUFFER_SLOT, 2u));
+		EXPECT_FALSE(tracker.Update(DrawStateTracker::PIPELINE_SLOT, 2u));
+
+		// Same bytes at a different size are a different value
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::PIPELINE_SLOT, uint64_t{ 2 }));
+
+		EXPECT_EQ(tracker.GetStats().issuedCount, 4u);
+		EXPECT_EQ(tracker.GetStats().avoidedCount, 3u);
+	}
+
+	TEST(DrawStateTrackerTests, NewRootSignatureForgetsRootParameters)
+	{
+		DrawStateTracker tracker;
+		const uint32_t material{ DrawStateTracker::FIRST_ROOT_PARAMETER_SLOT + 1 };
+		tracker.Update(DrawStateTracker::ROOT_SIGNATURE_SLOT, 1u);
+		tracker.Update(material, 7u);
+		tracker.Update(DrawStateTracker::PIPELINE_SLOT, 3u);
+		EXPECT_FALSE(tracker.Update(material, 7u));
+
+		// Setting the same root signature again is dropped and keeps parameters
+		EXPECT_FALSE(tracker.Update(DrawStateTracker::ROOT_SIGNATURE_SLOT, 1u));
+		EXPECT_FALSE(tracker.Update(material, 7u));
+
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::ROOT_SIGNATURE_SLOT, 2u));
+		EXPECT_TRUE(tracker.Update(material, 7u));
+
+		// Other state survives
+		EXPECT_FALSE(tracker.Update(DrawStateTracker::PIPELINE_SLOT, 3u));
+	}
+
+	TEST(DrawStateTrackerTests, SetUntrackedForcesTheNextUpdate)
+	{
+		DrawStateTracker tracker;
+		tracker.Update(DrawStateTracker::INDEX_BUFFER_SLOT, 5u);
+		tracker.SetUntracked(DrawStateTracker::INDEX_BUFFER_SLOT);
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::INDEX_BUFFER_SLOT, 5u));
+		EXPECT_FALSE(tracker.Update(DrawStateTracker::INDEX_BUFFER_SLOT, 5u));
+
+		// Untracked calls are still issued calls
+		EXPECT_EQ(tracker.GetStats().issuedCount, 3u);
+		EXPECT_EQ(tracker.GetStats().avoidedCount, 1u);
+	}
+
+	TEST(DrawStateTrackerTests, ResetForgetsEverything)
+	{
+		DrawStateTracker tracker;
+		tracker.Update(DrawStateTracker::VIEWPORT_SLOT, 1.0f);
+		tracker.Reset();
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::VIEWPORT_SLOT, 1.0f));
+	}
+
+	TEST(DrawStateTrackerTests, AlwaysIssuesValuesTooLargeToTrack)
+	{
+		struct Large
+		{
+			uint8_t bytes[DrawStateTracker::MAX_VALUE_SIZE + 1];
+		};
+		const Large value{};
+
+		DrawStateTracker tracker;
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::RENDER_TARGET_SLOT, value));
+		EXPECT_TRUE(tracker.Update(DrawStateTracker::RENDER_TARGET_SLOT, value));
+		EXPECT_EQ(tracker.GetStats().avoidedCount, 0u);
+	}
+}
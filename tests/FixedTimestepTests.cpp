@@ -0,0 +1,118 @@
+#include "pch.h"
+#include "FixedTimestep.h"
+#include "IClock.h"
+
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+
+		constexpr std::chrono::nanoseconds TICK_DURATION{ 10ms };
+		constexpr uint32_t MAX_TICKS_PER_FRAME{ 4 };
+
+		/// <summary>
+		/// FakeClock only moves when a test advances it.
+		/// </summary>
+		class FakeClock : public IClock
+		{
+		public:
+			// IClock
+			virtual std::chrono::nanoseconds Now()
+			{
+				return m_now;
+			}
+
+			void Advance(std::chrono::nanoseconds duration)
+			{
+				m_now += duration;
+			}
+
+		private:
+			std::chrono::nanoseconds m_now{ 1s };
+		};
+	}
+
+	TEST(FixedTimestepTests, FirstFrameOnlyEstablishesTheTimeBase)
+	{
+		FakeClock clock;
+		FixedTimestep timestep{ &clock, TICK_DURATION, MAX_TICKS_PER_FRAME };
+
+		EXPECT_EQ(timestep.BeginFrame(), 0u);
+		EXPECT_EQ(timestep.GetTickCount(), 0u);
+		EXPECT_EQ(timestep.GetInterpolationAlpha(), 0.0f);
+		EXPECT_EQ(timestep.GetTimeUntilNextTick(), TICK_DURATION);
+	}
+
+	TEST(FixedTimestepTests, RunsOneTickPerElapsedTickDuration)
+	{
+		FakeClock clock;
+		FixedTimestep timestep{ &clock, TICK_DURATION, MAX_TICKS_PER_FRAME };
+		timestep.BeginFrame();
+
+		clock.Advance(4ms);
+		EXPECT_EQ(timestep.BeginFrame(), 0u);
+		clock.Advance(4ms);
+		EXPECT_EQ(timestep.BeginFrame(), 0u);
+		clock.Advance(4ms);
+		EXPECT_EQ(timestep.BeginFrame(), 1u);
+		EXPECT_EQ(timestep.GetTimeUntilNextTick(), 8ms);
+
+		clock.Advance(28ms);
+		EXPECT_EQ(timestep.BeginFrame(), 3u);
+		EXPECT_EQ(timestep.GetTickCount(), 4u);
+		EXPECT_EQ(timestep.GetDroppedTickCount(), 0u);
+	}
+
+	TEST(FixedTimestepTests, CapsCatchUpAndDropsWholeTicks)
+	{
+		FakeClock clock;
+		FixedTimestep timestep{ &clock, TICK_DURATION, MAX_TICKS_PER_FRAME };
+		timestep.BeginFrame();
+
+		// A 105 ms stall is 10 ticks and a half; 4 run and 6 are dropped
+		clock.Advance(105ms);
+		EXPECT_EQ(timestep.BeginFrame(), MAX_TICKS_PER_FRAME);
+		EXPECT_EQ(timestep.GetTickCount(), MAX_TICKS_PER_FRAME);
+		EXPECT_EQ(timestep.GetDroppedTickCount(), 6u);
+
+		// The partial tick survives the drop, so the next frame doesn't fall behind
+		EXPECT_FLOAT_EQ(timestep.GetInterpolationAlpha(), 0.5f);
+		clock.Advance(5ms);
+		EXPECT_EQ(timestep.BeginFrame(), 1u);
+		EXPECT_EQ(timestep.GetDroppedTickCount(), 6u);
+	}
+
+	TEST(FixedTimestepTests, InterpolationAlphaStaysWithinATick)
+	{
+		FakeClock clock;
+		FixedTimestep timestep{ &clock, TICK_DURATION, MAX_TICKS_PER_FRAME };
+		timestep.BeginFrame();
+
+		// Frame times that drift against the tick duration, stalls included
+		const std::chrono::nanoseconds frameTimes[]{ 1ms, 3333us, 7ms, 9999us, 10ms, 10001us, 16667us, 250ms };
+		uint64_t elapsedTicks{ 0 };
+		std::chrono::nanoseconds elapsed{ 0 };
+		for (uint32_t frame = 0; frame < 1000; ++frame)
+		{
+			const std::chrono::nanoseconds frameTime{ frameTimes[frame % std::size(frameTimes)] };
+			clock.Advance(frameTime);
+			elapsed += frameTime;
+			elapsedTicks += timestep.BeginFrame();
+
+			const float alpha{ timestep.GetInterpolationAlpha() };
+			EXPECT_GE(alpha, 0.0f);
+			EXPECT_LT(alpha, 1.0f);
+			EXPECT_GT(timestep.GetTimeUntilNextTick(), 0ns);
+			EXPECT_LE(timestep.GetTimeUntilNextTick(), TICK_DURATION);
+		}
+
+		// Every elapsed whole tick was either run or dropped
+		EXPECT_EQ(elapsedTicks, timestep.GetTickCount());
+		EXPECT_EQ(
+			timestep.GetTickCount() + timestep.GetDroppedTickCount(),
+			static_cast<uint64_t>(elapsed / TICK_DURATION));
+	}
+}
@@ -0,0 +1,130 @@
+#include "pch.h"
+#include "FrameArena.h"
+#include "HeapAllocationCounter.h"
+
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		bool IsAligned(const void* pointer, size_t alignment)
+		{
+			return (reinterpret_cast<uintptr_t>(pointer) % alignment) == 0;
+		}
+	}
+
+	TEST(FrameArenaTests, BumpsAllocationsInOrder)
+	{
+		LinearArena arena{ 1024 };
+		std::byte* first{ static_cast<std::byte*>(arena.Allocate(10, 1)) };
+		std::byte* second{ static_cast<std::byte*>(arena.Allocate(6, 1)) };
+		std::byte* third{ static_cast<std::byte*>(arena.Allocate(1, 1)) };
+		EXPECT_EQ(second, first + 10);
+		EXPECT_EQ(third, second + 6);
+		EXPECT_EQ(arena.GetUsedBytes(), 17u);
+		EXPECT_EQ(arena.GetOverflowCount(), 0u);
+	}
+
+	TEST(FrameArenaTests, AlignsAllocations)
+	{
+		LinearArena arena{ 1024 };
+		std::byte* unaligned{ static_cast<std::byte*>(arena.Allocate(1, 1)) };
+		for (size_t alignment : { 2, 8, 64, 256 })
+		{
+			void* pointer{ arena.Allocate(3, alignment) };
+			EXPECT_TRUE(IsAligned(pointer, alignment));
+			EXPECT_GT(static_cast<std::byte*>(pointer), unaligned);
+		}
+
+		uint64_t* values{ arena.AllocateArray<uint64_t>(4) };
+		EXPECT_TRUE(IsAligned(values, alignof(uint64_t)));
+
+		// Zero means no alignment requirement
+		EXPECT_NE(arena.Allocate(1, 0), nullptr);
+		EXPECT_EQ(arena.GetOverflowCount(), 0u);
+	}
+
+	TEST(FrameArenaTests, OverflowsToTheHeapAndGrowsOnReset)
+	{
+		LinearArena arena{ 64 };
+		void* inBlock{ arena.Allocate(48, 16) };
+		void* overflow{ arena.Allocate(32, 16) };
+		ASSERT_NE(overflow, nullptr);
+		EXPECT_TRUE(IsAligned(overflow, 16));
+		EXPECT_EQ(arena.GetOverflowCount(), 1u);
+		EXPECT_EQ(arena.GetCapacity(), 64u);
+		EXPECT_NE(static_cast<std::byte*>(overflow), static_cast<std::byte*>(inBlock) + 48);
+
+		// The overflow is still usable memory
+		memset(overflow, 0xAB, 32);
+
+		// The block grows to at least the peak, after which the same frame fits
+		arena.Reset();
+		EXPECT_GE(arena.GetCapacity(), arena.GetPeakBytes());
+		EXPECT_GE(arena.GetCapacity(), 80u);
+
+		const uint64_t allocationStart{ GetHeapAllocationCount() };
+		arena.Allocate(48, 16);
+		arena.Allocate(32, 16);
+		EXPECT_EQ(GetHeapAllocationCount() - allocationStart, 0u);
+		EXPECT_EQ(arena.GetOverflowCount(), 1u);
+	}
+
+	TEST(FrameArenaTests, ResetReclaimsTheBlock)
+	{
+		LinearArena arena{ 256 };
+		void* first{ arena.Allocate(100, 1) };
+		arena.Allocate(100, 1);
+		EXPECT_EQ(arena.GetUsedBytes(), 200u);
+
+		arena.Reset();
+		EXPECT_EQ(arena.GetUsedBytes(), 0u);
+		EXPECT_EQ(arena.GetCapacity(), 256u);
+		EXPECT_EQ(arena.GetPeakBytes(), 200u);
+
+		// Without overflow the block is kept and reused from the start
+		EXPECT_EQ(arena.Allocate(100, 1), first);
+	}
+
+	TEST(FrameArenaTests, BacksPmrContainers)
+	{
+		LinearArena arena{ 64 * 1024 };
+		const uint64_t allocationStart{ GetHeapAllocationCount() };
+		{
+			std::pmr::vector<uint32_t> values{ &arena };
+			for (uint32_t i = 0; i < 1000; ++i)
+			{
+				values.push_back(i);
+			}
+			EXPECT_EQ(values[999], 999u);
+
+			std::pmr::string text{ "longer than any small string buffer", &arena };
+			text += text;
+			EXPECT_EQ(text.size(), 70u);
+		}
+		EXPECT_EQ(GetHeapAllocationCount() - allocationStart, 0u);
+
+		// Frees are no-ops, so the vector's regrowth is all still in use
+		EXPECT_GT(arena.GetUsedBytes(), 1000 * sizeof(uint32_t));
+		EXPECT_TRUE(arena.is_equal(arena));
+		EXPECT_FALSE(arena.is_equal(*std::pmr::new_delete_resource()));
+	}
+
+	TEST(FrameArenaTests, HeapAllocationCountIncludesOverAlignedNew)
+	{
+		struct alignas(64) CacheLine
+		{
+			std::byte bytes[64];
+		};
+
+		const uint64_t allocationStart{ GetHeapAllocationCount() };
+		std::vector<CacheLine> lines(4);
+		EXPECT_TRUE(IsAligned(lines.data(), 64));
+		std::unique_ptr<CacheLine> line{ std::make_unique<CacheLine>() };
+		EXPECT_TRUE(IsAligned(line.get(), 64));
+		EXPECT_EQ(GetHeapAllocationCount() - allocationStart, 2u);
+	}
+}
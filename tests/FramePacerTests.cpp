@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "FramePacer.h"
+#include "IFence.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t FRAMES_IN_FLIGHT{ 3 };
+
+		/// <summary>
+		/// FakeFence is a GPU timeline that only advances when a test completes
+		/// signals, or when the CPU waits on one, which then completes everything
+		/// signaled up to it.
+		/// </summary>
+		class FakeFence : public IFence
+		{
+		public:
+			// IFence
+			virtual uint64_t GetCompletedValue()
+			{
+				return m_completedValue;
+			}
+
+			virtual void Signal(uint64_t value)
+			{
+				EXPECT_TRUE(m_signals.empty() || (value > m_signals.back())) << "fence values must increase";
+				m_signals.push_back(value);
+			}
+
+			virtual void Wait(uint64_t value)
+			{
+				EXPECT_TRUE(!m_signals.empty() && (value <= m_signals.back())) << "waited on a value never signaled";
+				m_waits.push_back(value);
+				m_completedValue = std::max(m_completedValue, value);
+			}
+
+			void Complete(uint64_t value)
+			{
+				m_completedValue = std::max(m_completedValue, value);
+			}
+
+			const std::vector<uint64_t>& GetSignals() const
+			{
+				return m_signals;
+			}
+
+			const std::vector<uint64_t>& GetWaits() const
+			{
+				return m_waits;
+			}
+
+		private:
+			uint64_t m_completedValue{ 0 };
+			std::vector<uint64_t> m_signals;
+			std::vector<uint64_t> m_waits;
+		};
+	}
+
+	TEST(FramePacerTests, RecordsAheadWithoutBlockingUpToTheFrameLatency)
+	{
+		FakeFence fence;
+		FramePacer pacer{ &fence, FRAMES_IN_FLIGHT };
+
+		for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+		{
+			EXPECT_EQ(pacer.BeginFrame(), frame);
+			EXPECT_EQ(pacer.EndFrame(), frame + 1);
+		}
+		EXPECT_TRUE(fence.GetWaits().empty());
+		EXPECT_EQ(pacer.GetStallCount(), 0u);
+		EXPECT_EQ(fence.GetSignals(), (std::vector<uint64_t>{ 1, 2, 3 }));
+	}
+
+	TEST(FramePacerTests, BlocksOnTheFrameThatLastUsedTheContext)
+	{
+		FakeFence fence;
+		FramePacer pacer{ &fence, FRAMES_IN_FLIGHT };
+		for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame)
+		{
+			pacer.BeginFrame();
+			pacer.EndFrame();
+		}
+
+		// The GPU hasn't finished anything, so the fourth frame waits for the first
+		EXPECT_EQ(pacer.BeginFrame(), 0u);
+		EXPECT_EQ(fence.GetWaits(), (std::vector<uint64_t>{ 1 }));
+		EXPECT_EQ(pacer.GetStallCount(), 1u);
+		EXPECT_EQ(pacer.EndFrame(), 4u);
+
+		// and the fifth for the second, not for anything later
+		EXPECT_EQ(pacer.BeginFrame(), 1u);
+		EXPECT_EQ(fence.GetWaits(), (std::vector<uint64_t>{ 1, 2 }));
+		EXPECT_EQ(pacer.GetStallCount(), 2u);
+	}
+
+	TEST(FramePacerTests, DoesNotBlockOnFramesTheGpuHasCompleted)
+	{
+		FakeFence fence;
+		FramePacer pacer{ &fence, FRAMES_IN_FLIGHT };
+		for (uint32_t frame = 0; frame < 10 * FRAMES_IN_FLIGHT; ++frame)
+		{
+			pacer.BeginFrame();
+			const uint64_t fenceValue{ pacer.EndFrame() };
+
+			// The GPU trails one frame behind the CPU
+			if (fenceValue > 1)
+			{
+				fence.Complete(fenceValue - 1);
+			}
+			EXPECT_EQ(pacer.GetCompletedFenceValue(), (fenceValue > 1) ? (fenceValue - 1) : 0);
+			EXPECT_EQ(pacer.GetLastSignaledFenceValue(), fenceValue);
+		}
+		EXPECT_TRUE(fence.GetWaits().empty());
+		EXPECT_EQ(pacer.GetStallCount(), 0u);
+		EXPECT_EQ(pacer.GetFrameCount(), 10u * FRAMES_IN_FLIGHT);
+	}
+
+	TEST(FramePacerTests, WaitForIdleCoversEverySubmittedFrame)
+	{
+		FakeFence fence;
+		FramePacer pacer{ &fence, FRAMES_IN_FLIGHT };
+		pacer.BeginFrame();
+		pacer.EndFrame();
+		pacer.BeginFrame();
+		pacer.EndFrame();
+
+		pacer.WaitForIdle();
+		EXPECT_EQ(fence.GetSignals(), (std::vector<uint64_t>{ 1, 2, 3 }));
+		EXPECT_EQ(fence.GetWaits(), (std::vector<uint64_t>{ 3 }));
+		EXPECT_EQ(pacer.GetCompletedFenceValue(), 3u);
+
+		// Frames after idling keep counting up from the idle signal
+		pacer.BeginFrame();
+		EXPECT_EQ(pacer.EndFrame(), 4u);
+	}
+
+	TEST(FramePacerTests, KeepsAtLeastOneFrameInFlight)
+	{
+		FakeFence fence;
+		FramePacer pacer{ &fence, 0 };
+		EXPECT_EQ(pacer.GetFramesInFlight(), 1u);
+
+		EXPECT_EQ(pacer.BeginFrame(), 0u);
+		pacer.EndFrame();
+		EXPECT_EQ(pacer.BeginFrame(), 0u);
+		EXPECT_EQ(fence.GetWaits(), (std::vector<uint64_t>{ 1 }));
+	}
+}
@@ -0,0 +1,211 @@
+#include "pch.h"
+#include "InputRecording.h"
+#include "Simulation.h"
+#include "WorldSeed.h"
+
+#include <gtest/gtest.h>
+#include <fstream>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		/// <summary>
+		/// A file path in the temporary directory, deleted on destruction.
+		/// </summary>
+		class TemporaryPath
+		{
+		public:
+			explicit TemporaryPath(const char* name) :
+				m_path(std::filesystem::temp_directory_path() / name)
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			~TemporaryPath()
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			const std::filesystem::path& Get() const
+			{
+				return m_path;
+			}
+
+		private:
+			std::filesystem::path m_path;
+		};
+
+		/// <summary>
+		/// TickInputSource hands out a fixed list of events per tick, returning false
+		/// once at the end of each tick as a drained window queue does.
+		/// </summary>
+		class TickInputSource : public IInputSource
+		{
+		public:
+			explicit TickInputSource(std::vector<std::vector<InputEvent>> ticks) :
+				m_ticks{ std::move(ticks) }
+			{
+			}
+
+			// IInputSource
+			virtual bool PollEvent(InputEvent& event)
+			{
+				if (m_tick >= m_ticks.size())
+				{
+					return false;
+				}
+				if (m_event == m_ticks[m_tick].size())
+				{
+					++m_tick;
+					m_event = 0;
+					return false;
+				}
+				event = m_ticks[m_tick][m_event++];
+				return true;
+			}
+
+		private:
+			std::vector<std::vector<InputEvent>> m_ticks;
+			size_t m_tick{ 0 };
+			size_t m_event{ 0 };
+		};
+
+		InputEvent MakeEvent(int64_t timestamp, InputEventType type, uint8_t key)
+		{
+			return InputEvent{ .timestamp = std::chrono::nanoseconds{ timestamp }, .type = type, .key = key };
+		}
+
+		// Polls a tick's events until the end-of-tick false, as Simulation does
+		std::vector<InputEvent> PollTick(IInputSource& source)
+		{
+			std::vector<InputEvent> events;
+			InputEvent event{};
+			while (source.PollEvent(event))
+			{
+				events.push_back(event);
+			}
+			return events;
+		}
+
+		void ExpectSameEvents(const std::vector<InputEvent>& actual, const std::vector<InputEvent>& expected)
+		{
+			ASSERT_EQ(actual.size(), expected.size());
+			for (size_t i = 0; i < actual.size(); ++i)
+			{
+				EXPECT_EQ(actual[i].timestamp, expected[i].timestamp) << "event " << i;
+				EXPECT_EQ(actual[i].type, expected[i].type) << "event " << i;
+				EXPECT_EQ(actual[i].key, expected[i].key) << "event " << i;
+			}
+		}
+	}
+
+	TEST(InputRecordingTests, ReplaysTicksAndWorldSeedAsRecorded)
+	{
+		const TemporaryPath path{ "HelloTriangleInputRecordingTests.rec" };
+		const std::vector<std::vector<InputEvent>> ticks{
+			{ MakeEvent(1, InputEventType::KeyDown, 'W'), MakeEvent(2, InputEventType::KeyDown, 'A') },
+			{},
+			{ MakeEvent(-3, InputEventType::KeyUp, 'W') },
+		};
+		{
+			TickInputSource source{ ticks };
+			RecordingInputSource recorder{ &source, path.Get(), WorldSeedConfig{ .entityCount = 77, .seed = 99 } };
+			ASSERT_TRUE(recorder.IsOpen());
+			for (const std::vector<InputEvent>& tick : ticks)
+			{
+				ExpectSameEvents(PollTick(recorder), tick);
+			}
+			EXPECT_EQ(recorder.GetTickCount(), ticks.size());
+		}
+
+		ReplayInputSource replay;
+		ASSERT_TRUE(replay.Open(path.Get()));
+		EXPECT_EQ(replay.GetTickCount(), ticks.size());
+		EXPECT_EQ(replay.GetWorldSeed().entityCount, 77u);
+		EXPECT_EQ(replay.GetWorldSeed().seed, 99u);
+		for (const std::vector<InputEvent>& tick : ticks)
+		{
+			ASSERT_FALSE(replay.IsFinished());
+			ExpectSameEvents(PollTick(replay), tick);
+		}
+		EXPECT_TRUE(replay.IsFinished());
+		EXPECT_EQ(replay.GetReplayedTickCount(), ticks.size());
+	}
+
+	TEST(InputRecordingTests, KeepsOversizedTicksWhole)
+	{
+		const TemporaryPath path{ "HelloTriangleInputRecordingOversized.rec" };
+		std::vector<InputEvent> bigTick;
+		for (int64_t i = 0; i < 70'000; ++i)
+		{
+			bigTick.push_back(MakeEvent(i, (i % 2 == 0) ? InputEventType::KeyDown : InputEventType::KeyUp, static_cast<uint8_t>(i)));
+		}
+		const std::vector<std::vector<InputEvent>> ticks{ bigTick, { MakeEvent(0, InputEventType::KeyDown, 1) } };
+		{
+			TickInputSource source{ ticks };
+			RecordingInputSource recorder{ &source, path.Get(), WorldSeedConfig{} };
+			PollTick(recorder);
+			PollTick(recorder);
+			EXPECT_EQ(recorder.GetTickCount(), 2u);
+		}
+
+		ReplayInputSource replay;
+		ASSERT_TRUE(replay.Open(path.Get()));
+		EXPECT_EQ(replay.GetTickCount(), 2u);
+		ExpectSameEvents(PollTick(replay), ticks[0]);
+		ExpectSameEvents(PollTick(replay), ticks[1]);
+		EXPECT_TRUE(replay.IsFinished());
+	}
+
+	TEST(InputRecordingTests, ReplayReproducesTheRecordedStateHash)
+	{
+		const TemporaryPath path{ "HelloTriangleInputRecordingSession.rec" };
+		std::vector<std::vector<InputEvent>> ticks(120);
+		for (size_t tick = 0; (tick + 3) < ticks.size(); tick += 7)
+		{
+			const uint8_t key{ static_cast<uint8_t>('A' + (tick % 26)) };
+			ticks[tick].push_back(MakeEvent(static_cast<int64_t>(tick), InputEventType::KeyDown, key));
+			ticks[tick + 3].push_back(MakeEvent(static_cast<int64_t>(tick + 3), InputEventType::KeyUp, key));
+		}
+		const WorldSeedConfig worldSeed{ .entityCount = 500, .seed = 7 };
+
+		uint64_t recordedHash{ 0 };
+		{
+			TickInputSource source{ ticks };
+			RecordingInputSource recorder{ &source, path.Get(), worldSeed };
+			Simulation simulation{ &recorder };
+			SeedWorld(simulation.GetWorld(), worldSeed);
+			for (size_t tick = 0; tick < ticks.size(); ++tick)
+			{
+				simulation.Update(1.0f / 60.0f);
+			}
+			recordedHash = simulation.ComputeStateHash();
+		}
+
+		ReplayInputSource replay;
+		ASSERT_TRUE(replay.Open(path.Get()));
+		Simulation simulation{ &replay };
+		SeedWorld(simulation.GetWorld(), replay.GetWorldSeed());
+		while (!replay.IsFinished())
+		{
+			simulation.Update(1.0f / 60.0f);
+		}
+		EXPECT_EQ(replay.GetReplayedTickCount(), ticks.size());
+		EXPECT_EQ(simulation.ComputeStateHash(), recordedHash);
+	}
+
+	TEST(InputRecordingTests, RejectsFilesThatAreNotRecordings)
+	{
+		const TemporaryPath path{ "HelloTriangleInputRecordingGarbage.rec" };
+		{
+			std::ofstream file{ path.Get(), std::ios::binary };
+			file << "not an input recording at all";
+		}
+
+		ReplayInputSource replay;
+		EXPECT_FALSE(replay.Open(path.Get()));
+		EXPECT_FALSE(replay.Open(std::filesystem::temp_directory_path() / "HelloTriangleMissing.rec"));
+	}
+}
@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "JobSystem.h"
+#include "HeapAllocationCounter.h"
+
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t WORKER_COUNT{ 3 };
+	}
+
+	TEST(JobSystemTests, RunsJobsAfterTheirDependencies)
+	{
+		JobSystem jobSystem{ WORKER_COUNT };
+		std::atomic<int> step{ 0 };
+		const JobHandle first{ jobSystem.Schedule([&step]() { EXPECT_EQ(step.fetch_add(1), 0); }) };
+		const JobHandle second{ jobSystem.Schedule([&step]() { EXPECT_EQ(step.fetch_add(1), 1); }, { first }) };
+		const JobHandle third{ jobSystem.Schedule([&step]() { EXPECT_EQ(step.fetch_add(1), 2); }, { first, second }) };
+
+		jobSystem.Wait(third);
+		EXPECT_TRUE(first.IsDone());
+		EXPECT_TRUE(second.IsDone());
+		EXPECT_EQ(step.load(), 3);
+	}
+
+	TEST(JobSystemTests, WaitRethrowsWhatTheJobThrew)
+	{
+		for (uint32_t workerCount : { 0u, WORKER_COUNT })
+		{
+			SCOPED_TRACE(workerCount);
+			JobSystem jobSystem{ workerCount };
+			const JobHandle job{ jobSystem.Schedule([]() { throw std::runtime_error{ "job failed" }; }) };
+
+			EXPECT_THROW(jobSystem.Wait(job), std::runtime_error);
+			EXPECT_TRUE(job.IsDone());
+
+			// The workers survive to run more jobs
+			bool isRun{ false };
+			jobSystem.Wait(jobSystem.Schedule([&isRun]() { isRun = true; }));
+			EXPECT_TRUE(isRun);
+		}
+	}
+
+	TEST(JobSystemTests, DependentsOfAFailedJobFailWithoutRunning)
+	{
+		JobSystem jobSystem{ WORKER_COUNT };
+		std::atomic<bool> isDependentRun{ false };
+		const JobHandle failed{ jobSystem.Schedule([]() { throw std::runtime_error{ "job failed" }; }) };
+		const JobHandle dependent{ jobSystem.Schedule([&isDependentRun]() { isDependentRun = true; }, { failed }) };
+
+		EXPECT_THROW(jobSystem.Wait(dependent), std::runtime_error);
+		EXPECT_TRUE(dependent.IsDone());
+		EXPECT_FALSE(isDependentRun.load());
+	}
+
+	TEST(JobSystemTests, DependentsOfAnAlreadyFailedJobFailWithoutRunning)
+	{
+		JobSystem jobSystem{ WORKER_COUNT };
+		const JobHandle failed{ jobSystem.Schedule([]() { throw std::runtime_error{ "job failed" }; }) };
+		EXPECT_THROW(jobSystem.Wait(failed), std::runtime_error);
+
+		bool isDependentRun{ false };
+		const JobHandle dependent{ jobSystem.Schedule([&isDependentRun]() { isDependentRun = true; }, { failed }) };
+		EXPECT_THROW(jobSystem.Wait(dependent), std::runtime_error);
+		EXPECT_FALSE(isDependentRun);
+	}
+
+	TEST(JobSystemTests, ParallelForDoesNotAllocateOnceWarm)
+	{
+		JobSystem jobSystem{ WORKER_COUNT };
+		constexpr size_t COUNT{ 100'000 };
+		std::vector<uint32_t> values(COUNT, 0);
+		const auto increment = [&values](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				++values[i];
+			}
+		};
+
+		// The first runs grow the job pool and deques to their peak
+		for (int i = 0; i < 10; ++i)
+		{
+			jobSystem.ParallelFor(COUNT, 64, increment);
+		}
+		const uint64_t allocationStart{ GetHeapAllocationCount() };
+		for (int i = 0; i < 100; ++i)
+		{
+			jobSystem.ParallelFor(COUNT, 64, increment);
+		}
+		EXPECT_EQ(GetHeapAllocationCount() - allocationStart, 0u);
+		EXPECT_EQ(std::count(values.begin(), values.end(), 110u), static_cast<std::ptrdiff_t>(COUNT));
+	}
+
+	TEST(JobSystemTests, ParallelForFinishesEveryBatchBeforeRethrowing)
+	{
+		JobSystem jobSystem{ WORKER_COUNT };
+		constexpr size_t COUNT{ 10'000 };
+		std::vector<std::atomic<int>> visits(COUNT);
+
+		EXPECT_THROW(
+			jobSystem.ParallelFor(COUNT, 100, [&visits](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					visits[i].fetch_add(1);
+				}
+				if (begin == 0)
+				{
+					throw std::runtime_error{ "batch failed" };
+				}
+			}),
+			std::runtime_error);
+
+		for (size_t i = 0; i < COUNT; ++i)
+		{
+			ASSERT_EQ(visits[i].load(), 1) << "element " << i;
+		}
+	}
+
+	TEST(JobSystemTests, WaitBlocksUntilAJobOnAnotherThreadFinishes)
+	{
+		JobSystem jobSystem{ 1 };
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool isStarted{ false };
+		bool isReleased{ false };
+		const JobHandle job{ jobSystem.Schedule([&]()
+			{
+				std::unique_lock<std::mutex> lock{ mutex };
+				isStarted = true;
+				condition.notify_all();
+				condition.wait(lock, [&isReleased]() { return isReleased; });
+			}) };
+
+		// Once the worker holds the job, there's nothing left for Wait to help with
+		{
+			std::unique_lock<std::mutex> lock{ mutex };
+			condition.wait(lock, [&isStarted]() { return isStarted; });
+		}
+		std::thread releaser{ [&]()
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+				std::lock_guard<std::mutex> lock{ mutex };
+				isReleased = true;
+				condition.notify_all();
+			} };
+
+		jobSystem.Wait(job);
+		EXPECT_TRUE(job.IsDone());
+		releaser.join();
+	}
+}
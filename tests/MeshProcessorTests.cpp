@@ -0,0 +1,361 @@
+#include "pch.h"
+#include "AssetStreamer.h"
+#include "CompressedMeshFile.h"
+#include "MeshProcessor.h"
+#include "NullMeshUploadSink.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <random>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr float PI{ 3.14159265f };
+
+		/// <summary>
+		/// A file path in the temporary directory, deleted on destruction.
+		/// </summary>
+		class TemporaryPath
+		{
+		public:
+			explicit TemporaryPath(const char* name) :
+				m_path(std::filesystem::temp_directory_path() / name)
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			~TemporaryPath()
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			const std::filesystem::path& Get() const
+			{
+				return m_path;
+			}
+
+		private:
+			std::filesystem::path m_path;
+		};
+
+		// A UV sphere around center with triangles in random order, as an unoptimized
+		// import might have them. Some colors are out of range, to be clamped.
+		MeshData BuildShuffledSphereMesh(uint32_t rings, uint32_t segments, const float center[3], float radius)
+		{
+			MeshData mesh;
+			const uint32_t ringVertices{ segments + 1 };
+			for (uint32_t ring = 0; ring <= rings; ++ring)
+			{
+				const float theta{ PI * static_cast<float>(ring) / static_cast<float>(rings) };
+				for (uint32_t segment = 0; segment <= segments; ++segment)
+				{
+					const float phi{ 2.0f * PI * static_cast<float>(segment) / static_cast<float>(segments) };
+					const float x{ std::sin(theta) * std::cos(phi) };
+					const float y{ std::cos(theta) };
+					const float z{ std::sin(theta) * std::sin(phi) };
+					mesh.vertices.push_back(Vertex{
+						{ center[0] + (radius * x), center[1] + (radius * y), center[2] + (radius * z) },
+						{ 0.5f + (0.5f * x), 0.5f + (0.5f * y), 1.5f * z, 1.0f }
+					});
+				}
+			}
+
+			std::vector<std::array<uint16_t, 3>> triangles;
+			for (uint32_t ring = 0; ring < rings; ++ring)
+			{
+				for (uint32_t segment = 0; segment < segments; ++segment)
+				{
+					const uint16_t upperLeft{ static_cast<uint16_t>((ring * ringVertices) + segment) };
+					const uint16_t upperRight{ static_cast<uint16_t>(upperLeft + 1) };
+					const uint16_t lowerLeft{ static_cast<uint16_t>(upperLeft + ringVertices) };
+					const uint16_t lowerRight{ static_cast<uint16_t>(lowerLeft + 1) };
+					triangles.push_back({ upperLeft, upperRight, lowerLeft });
+					triangles.push_back({ lowerLeft, upperRight, lowerRight });
+				}
+			}
+
+			std::mt19937 random{ 1234 };
+			std::shuffle(triangles.begin(), triangles.end(), random);
+			for (const std::array<uint16_t, 3>& triangle : triangles)
+			{
+				mesh.indices.insert(mesh.indices.end(), triangle.begin(), triangle.end());
+			}
+			return mesh;
+		}
+
+		MeshData BuildShuffledSphereMesh()
+		{
+			const float center[3]{ 0.0f, 0.0f, 0.0f };
+			return BuildShuffledSphereMesh(16, 32, center, 1.0f);
+		}
+
+		std::vector<uint8_t> ReadFile(const std::filesystem::path& path)
+		{
+			std::ifstream file{ path, std::ios::binary };
+			return std::vector<uint8_t>{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+		}
+
+		template<typename T>
+		void WriteValue(std::vector<uint8_t>& bytes, size_t offset, T value)
+		{
+			memcpy(bytes.data() + offset, &value, sizeof(T));
+		}
+
+		MeshDecodeResult Decode(const std::vector<uint8_t>& bytes, CompressedMeshData& mesh)
+		{
+			return DecodeCompressedMesh(bytes.data(), bytes.size(), mesh);
+		}
+
+		void ExpectWithinBound(const VertexCompressionError& error, const VertexCompressionError& bound)
+		{
+			EXPECT_LE(error.position, bound.position);
+			EXPECT_LE(error.color, bound.color);
+		}
+	}
+
+	TEST(MeshProcessorTests, CompressedMeshFileRoundTrips)
+	{
+		const CompressedMeshData compressed{ CompressMesh(BuildShuffledSphereMesh()) };
+		const std::vector<uint8_t> bytes{ EncodeCompressedMesh(compressed) };
+		EXPECT_EQ(
+			bytes.size(),
+			CompressedMeshFileFormat::HEADER_SIZE +
+				(compressed.vertices.size() * sizeof(CompressedVertex)) +
+				EncodeIndexStream(compressed.indices).size());
+		EXPECT_TRUE(IsCompressedMesh(bytes.data(), bytes.size()));
+
+		CompressedMeshData decoded;
+		ASSERT_EQ(Decode(bytes, decoded), MeshDecodeResult::Success);
+		EXPECT_EQ(decoded.indices, compressed.indices);
+		ASSERT_EQ(decoded.vertices.size(), compressed.vertices.size());
+		EXPECT_EQ(
+			memcmp(decoded.vertices.data(), compressed.vertices.data(), compressed.vertices.size() * sizeof(CompressedVertex)),
+			0);
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			EXPECT_EQ(decoded.quantization.offset[axis], compressed.quantization.offset[axis]);
+			EXPECT_EQ(decoded.quantization.scale[axis], compressed.quantization.scale[axis]);
+		}
+	}
+
+	TEST(MeshProcessorTests, DecodeCompressedMeshRejectsBadFiles)
+	{
+		const CompressedMeshData compressed{ CompressMesh(BuildShuffledSphereMesh()) };
+		const std::vector<uint8_t> valid{ EncodeCompressedMesh(compressed) };
+		const size_t vertexCountOffset{ 8 };
+		const size_t indexCountOffset{ 12 };
+		const size_t indexStreamSizeOffset{ 16 };
+		const size_t firstOffsetOffset{ 20 };
+		const size_t firstScaleOffset{ 32 };
+		const size_t indexStreamSize{ EncodeIndexStream(compressed.indices).size() };
+
+		CompressedMeshData mesh;
+		const auto expectRejected{ [&mesh](const std::vector<uint8_t>& bytes, MeshDecodeResult expected)
+		{
+			EXPECT_EQ(Decode(bytes, mesh), expected);
+			EXPECT_TRUE(mesh.vertices.empty());
+			EXPECT_TRUE(mesh.indices.empty());
+		} };
+
+		expectRejected(std::vector<uint8_t>(valid.begin(), valid.begin() + 8), MeshDecodeResult::NotAMesh);
+		std::vector<uint8_t> bytes{ EncodeMesh(BuildShuffledSphereMesh()) };
+		expectRejected(bytes, MeshDecodeResult::NotAMesh);
+
+		bytes = valid;
+		WriteValue<uint32_t>(bytes, 4, CompressedMeshFileFormat::VERSION + 1);
+		expectRejected(bytes, MeshDecodeResult::UnsupportedVersion);
+
+		bytes = valid;
+		WriteValue<uint32_t>(bytes, vertexCountOffset, MeshFileFormat::MAX_VERTICES + 1);
+		expectRejected(bytes, MeshDecodeResult::TooLarge);
+
+		expectRejected(std::vector<uint8_t>(valid.begin(), valid.end() - 1), MeshDecodeResult::Truncated);
+
+		CompressedMeshData outOfRange{ compressed };
+		outOfRange.indices[0] = static_cast<uint16_t>(compressed.vertices.size());
+		expectRejected(EncodeCompressedMesh(outOfRange), MeshDecodeResult::InvalidIndices);
+
+		// An index stream with a byte to spare, or whose last varint runs off its end
+		bytes = valid;
+		bytes.push_back(0);
+		WriteValue<uint32_t>(bytes, indexStreamSizeOffset, static_cast<uint32_t>(indexStreamSize + 1));
+		expectRejected(bytes, MeshDecodeResult::InvalidIndices);
+
+		bytes = valid;
+		bytes.back() |= 0x80;
+		expectRejected(bytes, MeshDecodeResult::InvalidIndices);
+
+		// Not whole triangles
+		bytes = valid;
+		WriteValue<uint32_t>(bytes, indexCountOffset, static_cast<uint32_t>(compressed.indices.size() - 1));
+		expectRejected(bytes, MeshDecodeResult::InvalidIndices);
+
+		bytes = valid;
+		WriteValue<float>(bytes, firstScaleOffset, -1.0f);
+		expectRejected(bytes, MeshDecodeResult::InvalidQuantization);
+
+		bytes = valid;
+		WriteValue<float>(bytes, firstOffsetOffset, std::numeric_limits<float>::quiet_NaN());
+		expectRejected(bytes, MeshDecodeResult::InvalidQuantization);
+
+		bytes = valid;
+		WriteValue<float>(bytes, firstScaleOffset + 8, std::numeric_limits<float>::infinity());
+		expectRejected(bytes, MeshDecodeResult::InvalidQuantization);
+
+		ASSERT_EQ(Decode(valid, mesh), MeshDecodeResult::Success);
+	}
+
+	TEST(MeshProcessorTests, IndexStreamRoundTrips)
+	{
+		// Forward and backward jumps of every varint length, including the ends of
+		// the index range
+		const std::vector<uint16_t> indices{ 0, 1, 2, 2, 1, 3, 200, 4, 65535, 0, 65535, 100, 101, 65534, 5, 5 };
+		const std::vector<uint8_t> stream{ EncodeIndexStream(indices) };
+		std::vector<uint16_t> decoded;
+		ASSERT_TRUE(DecodeIndexStream(stream.data(), stream.size(), indices.size(), decoded));
+		EXPECT_EQ(decoded, indices);
+
+		// Vertices in first-use order take a byte each
+		const std::vector<uint16_t> sequential{ 0, 1, 2, 3, 4, 5 };
+		EXPECT_EQ(EncodeIndexStream(sequential).size(), sequential.size());
+
+		EXPECT_TRUE(EncodeIndexStream({}).empty());
+		EXPECT_TRUE(DecodeIndexStream(nullptr, 0, 0, decoded));
+		EXPECT_TRUE(decoded.empty());
+	}
+
+	TEST(MeshProcessorTests, DecodeIndexStreamRejectsBadStreams)
+	{
+		const std::vector<uint16_t> indices{ 0, 1, 2, 1000, 3, 4 };
+		const std::vector<uint8_t> stream{ EncodeIndexStream(indices) };
+		std::vector<uint16_t> decoded;
+
+		// Too few indices, too many, or a varint cut short
+		EXPECT_FALSE(DecodeIndexStream(stream.data(), stream.size(), indices.size() - 1, decoded));
+		EXPECT_TRUE(decoded.empty());
+		EXPECT_FALSE(DecodeIndexStream(stream.data(), stream.size(), indices.size() + 1, decoded));
+		EXPECT_TRUE(decoded.empty());
+		std::vector<uint8_t> bad{ stream };
+		bad.back() |= 0x80;
+		EXPECT_FALSE(DecodeIndexStream(bad.data(), bad.size(), indices.size(), decoded));
+
+		// Varints longer than a uint16 index needs, and indices past either end
+		bad = { 0xFF, 0xFF, 0xFF, 0x01 };
+		EXPECT_FALSE(DecodeIndexStream(bad.data(), bad.size(), 1, decoded));
+		bad = { 0x02 };
+		EXPECT_FALSE(DecodeIndexStream(bad.data(), bad.size(), 1, decoded));
+		bad = { 0x00, 0x81, 0x80, 0x08 };
+		EXPECT_FALSE(DecodeIndexStream(bad.data(), bad.size(), 2, decoded));
+		EXPECT_TRUE(decoded.empty());
+	}
+
+	TEST(MeshProcessorTests, ProcessMeshStaysWithinErrorBounds)
+	{
+		// A unit sphere, one far from the origin where float rounding matters, and a
+		// flat grid with a zero scale axis
+		const float nearCenter[3]{ 0.0f, 0.0f, 0.0f };
+		const float farCenter[3]{ 1000.0f, -2000.0f, 50.0f };
+		std::vector<MeshData> meshes{
+			BuildShuffledSphereMesh(16, 32, nearCenter, 1.0f),
+			BuildShuffledSphereMesh(24, 24, farCenter, 0.01f),
+		};
+		MeshData& flat{ meshes.emplace_back(BuildShuffledSphereMesh()) };
+		for (Vertex& vertex : flat.vertices)
+		{
+			vertex.position[2] = 3.0f;
+		}
+
+		for (MeshData& mesh : meshes)
+		{
+			const MeshData original{ mesh };
+			CompressedMeshData compressed;
+			MeshProcessorStats stats;
+			EXPECT_TRUE(ProcessMesh(mesh, compressed, stats));
+			EXPECT_LT(stats.cacheAfter.acmr, stats.cacheBefore.acmr);
+
+			// Vertices shrink from 28 bytes to 12, and the index stream to well under
+			// 2 bytes an index, for at least 2x overall
+			EXPECT_EQ(
+				compressed.GetByteSize(),
+				original.GetByteSize() - (original.vertices.size() * (sizeof(Vertex) - 12)));
+			EXPECT_EQ(
+				stats.compressedByteSize,
+				(compressed.vertices.size() * sizeof(CompressedVertex)) + stats.compressedIndexByteSize);
+			EXPECT_LT(stats.compressedIndexByteSize * 4, original.indices.size() * sizeof(uint16_t) * 3);
+			EXPECT_LE(stats.compressedByteSize * 2, stats.byteSize);
+			ExpectWithinBound(stats.compressionError, stats.compressionErrorBound);
+
+			// Optimizing only reorders: the same triangles, over the same vertices
+			ASSERT_EQ(mesh.vertices.size(), original.vertices.size());
+			ASSERT_EQ(mesh.indices.size(), original.indices.size());
+			ASSERT_EQ(compressed.indices, mesh.indices);
+
+			// Check the decoded positions directly, rather than through the processor's
+			// own measurement
+			for (size_t i = 0; i < mesh.vertices.size(); ++i)
+			{
+				const Vertex decoded{ DecompressVertex(compressed.vertices[i], compressed.quantization) };
+				double distanceSquared{ 0.0 };
+				for (size_t axis = 0; axis < 3; ++axis)
+				{
+					const double delta{ static_cast<double>(decoded.position[axis]) - mesh.vertices[i].position[axis] };
+					distanceSquared += delta * delta;
+				}
+				EXPECT_LE(std::sqrt(distanceSquared), stats.compressionErrorBound.position);
+			}
+		}
+
+		// The bound itself is tight: a unit sphere's positions land within a few
+		// hundred-thousandths
+		EXPECT_LT(GetVertexCompressionErrorBound(CompressMesh(BuildShuffledSphereMesh()).quantization).position, 1e-4f);
+	}
+
+	TEST(MeshProcessorTests, ProcessMeshFileWritesACompressedMeshTheStreamerLoads)
+	{
+		const TemporaryPath inputPath{ "HelloTriangleMeshProcessorTests.mesh" };
+		const TemporaryPath outputPath{ "HelloTriangleMeshProcessorTests.compressed.mesh" };
+		const MeshData input{ BuildShuffledSphereMesh() };
+		ASSERT_TRUE(WriteMeshFile(inputPath.Get(), input));
+		ASSERT_TRUE(ProcessMeshFile(inputPath.Get(), outputPath.Get()));
+
+		// The file holds exactly what ProcessMesh makes of the input
+		MeshData expectedMesh{ input };
+		CompressedMeshData expected;
+		MeshProcessorStats stats;
+		ASSERT_TRUE(ProcessMesh(expectedMesh, expected, stats));
+		const std::vector<uint8_t> written{ ReadFile(outputPath.Get()) };
+		EXPECT_EQ(written, EncodeCompressedMesh(expected));
+
+		CompressedMeshData decoded;
+		ASSERT_EQ(Decode(written, decoded), MeshDecodeResult::Success);
+		EXPECT_LE(MeasureVertexCompressionError(expectedMesh, decoded).position, stats.compressionErrorBound.position);
+
+		// The streamer tells the formats apart and uploads each as what it is
+		AssetStreamer streamer{ AssetStreamer::Config{} };
+		const AssetStreamer::AssetHandle plain{ streamer.RequestMesh(inputPath.Get()) };
+		const AssetStreamer::AssetHandle compressed{ streamer.RequestMesh(outputPath.Get()) };
+		NullMeshUploadSink sink;
+		streamer.Flush(sink);
+		EXPECT_EQ(streamer.GetState(plain), AssetState::Resident);
+		EXPECT_EQ(streamer.GetState(compressed), AssetState::Resident);
+		EXPECT_EQ(sink.GetMeshCount(), 2u);
+		EXPECT_EQ(sink.GetUploadedBytes(), input.GetByteSize() + expected.GetByteSize());
+	}
+
+	TEST(MeshProcessorTests, ProcessMeshFileRejectsBadInput)
+	{
+		const TemporaryPath inputPath{ "HelloTriangleMeshProcessorTests.bad.mesh" };
+		const TemporaryPath outputPath{ "HelloTriangleMeshProcessorTests.bad.compressed.mesh" };
+		EXPECT_FALSE(ProcessMeshFile(inputPath.Get(), outputPath.Get()));
+
+		// A compressed mesh is not valid input: the processor needs float vertices
+		ASSERT_TRUE(WriteCompressedMeshFile(inputPath.Get(), CompressMesh(BuildShuffledSphereMesh())));
+		EXPECT_FALSE(ProcessMeshFile(inputPath.Get(), outputPath.Get()));
+		EXPECT_FALSE(std::filesystem::exists(outputPath.Get()));
+	}
+}
@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "MessageTranslator.h"
+#include "IClock.h"
+#include "ScriptedInputSource.h"
+
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr std::chrono::nanoseconds TIMESTAMP{ 12345 };
+		constexpr uint8_t KEY_A{ 0x41 };
+
+		// Key message lParam bit 30 is set when the key was already down
+		constexpr int64_t PREVIOUS_KEY_STATE_BIT{ int64_t{ 1 } << 30 };
+
+		class FixedClock : public IClock
+		{
+		public:
+			// IClock
+			virtual std::chrono::nanoseconds Now()
+			{
+				return TIMESTAMP;
+			}
+		};
+	}
+
+	TEST(MessageTranslatorTests, TranslatesKeyMessages)
+	{
+		struct Case
+		{
+			uint32_t id;
+			InputEventType type;
+		};
+		const Case cases[]{
+			{ RawMessageId::KEY_DOWN, InputEventType::KeyDown },
+			{ RawMessageId::SYS_KEY_DOWN, InputEventType::KeyDown },
+			{ RawMessageId::KEY_UP, InputEventType::KeyUp },
+			{ RawMessageId::SYS_KEY_UP, InputEventType::KeyUp },
+		};
+
+		for (const Case& test : cases)
+		{
+			SCOPED_TRACE(test.id);
+			InputEvent event{};
+			ASSERT_TRUE(TranslateMessageToEvent(RawMessage{ test.id, KEY_A, 0 }, TIMESTAMP, event));
+			EXPECT_EQ(event.type, test.type);
+			EXPECT_EQ(event.key, KEY_A);
+			EXPECT_EQ(event.timestamp, TIMESTAMP);
+		}
+	}
+
+	TEST(MessageTranslatorTests, DropsAutoRepeatedKeyDowns)
+	{
+		InputEvent event{};
+		EXPECT_FALSE(TranslateMessageToEvent(
+			RawMessage{ RawMessageId::KEY_DOWN, KEY_A, PREVIOUS_KEY_STATE_BIT }, TIMESTAMP, event));
+		EXPECT_FALSE(TranslateMessageToEvent(
+			RawMessage{ RawMessageId::SYS_KEY_DOWN, KEY_A, PREVIOUS_KEY_STATE_BIT }, TIMESTAMP, event));
+
+		// Key ups always have the bit set
+		EXPECT_TRUE(TranslateMessageToEvent(
+			RawMessage{ RawMessageId::KEY_UP, KEY_A, PREVIOUS_KEY_STATE_BIT | (int64_t{ 1 } << 31) }, TIMESTAMP, event));
+	}
+
+	TEST(MessageTranslatorTests, IgnoresMessagesThatAreNotInput)
+	{
+		// WM_PAINT, WM_CHAR and WM_MOUSEMOVE
+		for (uint32_t id : { 0x000Fu, 0x0102u, 0x0200u })
+		{
+			SCOPED_TRACE(id);
+			InputEvent event{};
+			event.key = KEY_A;
+			EXPECT_FALSE(TranslateMessageToEvent(RawMessage{ id, 0x42, 0 }, TIMESTAMP, event));
+			EXPECT_EQ(event.key, KEY_A);
+		}
+	}
+
+	TEST(MessageTranslatorTests, KeepsOnlyTheVirtualKeyCode)
+	{
+		InputEvent event{};
+		ASSERT_TRUE(TranslateMessageToEvent(RawMessage{ RawMessageId::KEY_DOWN, 0x1'0000'0141, 0 }, TIMESTAMP, event));
+		EXPECT_EQ(event.key, KEY_A);
+	}
+
+	TEST(ScriptedInputSourceTests, QueuesTimestampedEventsAndCountsDrops)
+	{
+		FixedClock clock;
+		ScriptedInputSource source{ &clock };
+		ASSERT_TRUE(source.QueueKeyDown(KEY_A));
+		ASSERT_TRUE(source.QueueKeyUp(KEY_A));
+
+		InputEvent event{};
+		ASSERT_TRUE(source.PollEvent(event));
+		EXPECT_EQ(event.type, InputEventType::KeyDown);
+		EXPECT_EQ(event.timestamp, TIMESTAMP);
+		ASSERT_TRUE(source.PollEvent(event));
+		EXPECT_EQ(event.type, InputEventType::KeyUp);
+		EXPECT_FALSE(source.PollEvent(event));
+
+		for (size_t i = 0; i < INPUT_EVENT_CAPACITY; ++i)
+		{
+			ASSERT_TRUE(source.QueueKeyDown(KEY_A));
+		}
+		EXPECT_FALSE(source.QueueKeyDown(KEY_A));
+		EXPECT_EQ(source.GetDroppedEventCount(), 1u);
+	}
+}
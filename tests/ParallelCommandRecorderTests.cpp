@@ -0,0 +1,133 @@
+#include "pch.h"
+#include "ParallelCommandRecorder.h"
+#include "JobSystem.h"
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <numeric>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t MAX_CHUNKS{ 8 };
+		constexpr size_t MIN_ITEMS_PER_CHUNK{ 16 };
+
+		/// <summary>
+		/// FakeCommandListPool keeps one list of recorded items per chunk, standing
+		/// in for the chunks' command lists.
+		/// </summary>
+		class FakeCommandListPool : public ICommandListPool
+		{
+		public:
+			// ICommandListPool
+			virtual void BeginChunk(uint32_t chunk)
+			{
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				m_events.push_back({ chunk, true });
+			}
+
+			virtual void EndChunk(uint32_t chunk)
+			{
+				std::lock_guard<std::mutex> lock{ m_mutex };
+				m_events.push_back({ chunk, false });
+			}
+
+			void Record(uint32_t chunk, size_t item)
+			{
+				m_lists[chunk].push_back(item);
+			}
+
+			/// <summary>
+			/// Concatenates the chunks' items in index order, as submitting their
+			/// command lists in index order would execute them.
+			/// </summary>
+			std::vector<size_t> Submit(uint32_t chunkCount) const
+			{
+				std::vector<size_t> items;
+				for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+				{
+					items.insert(items.end(), m_lists[chunk].begin(), m_lists[chunk].end());
+				}
+				return items;
+			}
+
+			// Every chunk must be begun, then ended, exactly once
+			void ExpectChunksBracketed(uint32_t chunkCount) const
+			{
+				std::vector<int> state(chunkCount, 0);
+				for (const auto& [chunk, isBegin] : m_events)
+				{
+					ASSERT_LT(chunk, chunkCount);
+					EXPECT_EQ(state[chunk], isBegin ? 0 : 1) << "chunk " << chunk;
+					state[chunk] += 1;
+				}
+				for (uint32_t chunk = 0; chunk < chunkCount; ++chunk)
+				{
+					EXPECT_EQ(state[chunk], 2) << "chunk " << chunk;
+				}
+			}
+
+		private:
+			std::mutex m_mutex;
+			std::vector<std::pair<uint32_t, bool>> m_events;
+			std::array<std::vector<size_t>, MAX_CHUNKS> m_lists;
+		};
+	}
+
+	TEST(ParallelCommandRecorderTests, PartitionsIntoContiguousNearEqualRanges)
+	{
+		for (size_t itemCount : { 0u, 1u, 15u, 16u, 33u, 127u, 128u, 1000u })
+		{
+			SCOPED_TRACE(itemCount);
+			const std::pmr::vector<RecordRange> ranges{
+				ParallelCommandRecorder::Partition(itemCount, MAX_CHUNKS, MIN_ITEMS_PER_CHUNK)
+			};
+			ASSERT_LE(ranges.size(), MAX_CHUNKS);
+			EXPECT_EQ(ranges.empty(), itemCount == 0);
+
+			size_t next{ 0 };
+			for (const RecordRange& range : ranges)
+			{
+				EXPECT_EQ(range.begin, next);
+				EXPECT_GT(range.end, range.begin);
+				if (ranges.size() > 1)
+				{
+					EXPECT_GE(range.end - range.begin, MIN_ITEMS_PER_CHUNK);
+				}
+				EXPECT_LE((range.end - range.begin), (ranges[0].end - ranges[0].begin));
+				EXPECT_GE((range.end - range.begin) + 1, (ranges[0].end - ranges[0].begin));
+				next = range.end;
+			}
+			EXPECT_EQ(next, itemCount);
+		}
+	}
+
+	TEST(ParallelCommandRecorderTests, SubmittingChunksInOrderReplaysItemsInOrder)
+	{
+		for (uint32_t workerCount : { 0u, 3u })
+		{
+			SCOPED_TRACE(workerCount);
+			JobSystem jobSystem{ workerCount };
+			ParallelCommandRecorder recorder{ &jobSystem, MAX_CHUNKS, MIN_ITEMS_PER_CHUNK };
+			for (size_t itemCount : { 0u, 5u, 100u, 1001u })
+			{
+				SCOPED_TRACE(itemCount);
+				FakeCommandListPool pool;
+				const uint32_t chunkCount{ recorder.Record(pool, itemCount, [&pool](uint32_t chunk, size_t begin, size_t end)
+				{
+					for (size_t item = begin; item < end; ++item)
+					{
+						pool.Record(chunk, item);
+					}
+				}) };
+				ASSERT_LE(chunkCount, MAX_CHUNKS);
+
+				std::vector<size_t> expected(itemCount);
+				std::iota(expected.begin(), expected.end(), size_t{ 0 });
+				EXPECT_EQ(pool.Submit(chunkCount), expected);
+				pool.ExpectChunksBracketed(chunkCount);
+			}
+		}
+	}
+}
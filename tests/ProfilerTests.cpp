@@ -0,0 +1,216 @@
+#include "pch.h"
+#include "IClock.h"
+#include "Profiler.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		using namespace std::chrono_literals;
+
+		/// <summary>
+		/// SteppingClock moves forward by a fixed step every time it is read, and
+		/// when a test advances it. Reads from several threads are safe.
+		/// </summary>
+		class SteppingClock : public IClock
+		{
+		public:
+			explicit SteppingClock(std::chrono::nanoseconds step) :
+				m_step{ step.count() }
+			{ }
+
+			// IClock
+			virtual std::chrono::nanoseconds Now()
+			{
+				return std::chrono::nanoseconds{ m_now.fetch_add(m_step) };
+			}
+
+			void Advance(std::chrono::nanoseconds duration)
+			{
+				m_now.fetch_add(duration.count());
+			}
+
+		private:
+			const int64_t m_step;
+			std::atomic<int64_t> m_now{ 0 };
+		};
+
+		/// <summary>
+		/// A file path in the temporary directory, deleted on destruction.
+		/// </summary>
+		class TemporaryPath
+		{
+		public:
+			explicit TemporaryPath(const char* name) :
+				m_path(std::filesystem::temp_directory_path() / name)
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			~TemporaryPath()
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			const std::filesystem::path& Get() const
+			{
+				return m_path;
+			}
+
+		private:
+			std::filesystem::path m_path;
+		};
+
+		struct TraceEvent
+		{
+			std::string name;
+			uint32_t threadIndex;
+			double begin;
+			double end;
+		};
+
+		struct Trace
+		{
+			std::vector<TraceEvent> events;
+			uint64_t droppedZones{ UINT64_MAX };
+		};
+
+		/// <summary>
+		/// Reads back what WriteChromeTrace wrote: one event per line, then the
+		/// otherData object.
+		/// </summary>
+		Trace ReadTrace(const std::filesystem::path& path)
+		{
+			Trace trace;
+			std::ifstream file{ path };
+			std::string line;
+			while (std::getline(file, line))
+			{
+				char name[64]{};
+				uint32_t threadIndex{ 0 };
+				double begin{ 0.0 };
+				double duration{ 0.0 };
+				unsigned long long dropped{ 0 };
+				if (std::sscanf(
+					line.c_str(),
+					"{\"name\":\"%63[^\"]\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lf,\"dur\":%lf}",
+					name,
+					&threadIndex,
+					&begin,
+					&duration) == 4)
+				{
+					trace.events.push_back(TraceEvent{ name, threadIndex, begin, begin + duration });
+				}
+				else if (std::sscanf(line.c_str(), "],\"otherData\":{\"droppedZones\":%llu}}", &dropped) == 1)
+				{
+					trace.droppedZones = dropped;
+				}
+			}
+			return trace;
+		}
+	}
+
+	TEST(ProfilerTests, RecordsNestedZonesPerThread)
+	{
+		SteppingClock clock{ 1us };
+		Profiler profiler{ &clock };
+		Profiler::SetActive(&profiler);
+
+		auto recordNestedZones = []()
+		{
+			for (int i = 0; i < 3; ++i)
+			{
+				HELLOTRIANGLE_PROFILE_SCOPE("Outer");
+				{
+					HELLOTRIANGLE_PROFILE_SCOPE("Inner");
+				}
+			}
+		};
+		std::thread first{ recordNestedZones };
+		std::thread second{ recordNestedZones };
+		first.join();
+		second.join();
+		Profiler::SetActive(nullptr);
+
+		const TemporaryPath path{ "HelloTriangleProfilerTests.json" };
+		ASSERT_TRUE(profiler.WriteChromeTrace(path.Get()));
+		const Trace trace{ ReadTrace(path.Get()) };
+		EXPECT_EQ(trace.droppedZones, 0u);
+		ASSERT_EQ(trace.events.size(), 12u);
+
+		// Each thread has its own index, and inner zones finish first and sit
+		// inside their outer zone
+		for (size_t i = 0; i < trace.events.size(); i += 2)
+		{
+			SCOPED_TRACE(i);
+			const TraceEvent& inner{ trace.events[i] };
+			const TraceEvent& outer{ trace.events[i + 1] };
+			EXPECT_EQ(inner.name, "Inner");
+			EXPECT_EQ(outer.name, "Outer");
+			EXPECT_EQ(inner.threadIndex, (i < 6) ? 0u : 1u);
+			EXPECT_EQ(outer.threadIndex, inner.threadIndex);
+			EXPECT_LT(outer.begin, inner.begin);
+			EXPECT_LT(inner.end, outer.end);
+		}
+	}
+
+	TEST(ProfilerTests, OverwritesTheOldestZonesWhenFull)
+	{
+		SteppingClock clock{ 0ns };
+		Profiler profiler{ &clock };
+		constexpr uint64_t EXTRA_ZONES{ 10 };
+		for (uint64_t i = 0; i < (Profiler::ZONES_PER_THREAD + EXTRA_ZONES); ++i)
+		{
+			const std::chrono::nanoseconds begin{ std::chrono::microseconds{ i } };
+			profiler.RecordZone("Zone", begin, begin + 1us);
+		}
+		EXPECT_EQ(profiler.GetDroppedZoneCount(), EXTRA_ZONES);
+
+		const TemporaryPath path{ "HelloTriangleProfilerTests.json" };
+		ASSERT_TRUE(profiler.WriteChromeTrace(path.Get()));
+		const Trace trace{ ReadTrace(path.Get()) };
+		EXPECT_EQ(trace.droppedZones, EXTRA_ZONES);
+		ASSERT_EQ(trace.events.size(), Profiler::ZONES_PER_THREAD);
+		EXPECT_EQ(trace.events.front().begin, static_cast<double>(EXTRA_ZONES));
+		EXPECT_EQ(trace.events.back().begin, static_cast<double>(Profiler::ZONES_PER_THREAD + EXTRA_ZONES - 1));
+	}
+
+	TEST(ProfilerTests, ReportsFrameTimePercentiles)
+	{
+		SteppingClock clock{ 0ns };
+		Profiler profiler{ &clock };
+		EXPECT_EQ(profiler.GetFrameStats().frameCount, 0u);
+
+		// Frames of 1ms to 100ms, in an order that isn't sorted
+		for (int i = 0; i < 100; ++i)
+		{
+			clock.Advance(std::chrono::milliseconds{ ((i * 37) % 100) + 1 });
+			profiler.EndFrame();
+		}
+		const FrameTimeStats stats{ profiler.GetFrameStats() };
+		EXPECT_EQ(stats.frameCount, 100u);
+		EXPECT_DOUBLE_EQ(stats.p50Milliseconds, 51.0);
+		EXPECT_DOUBLE_EQ(stats.p99Milliseconds, 99.0);
+		EXPECT_DOUBLE_EQ(stats.maxMilliseconds, 100.0);
+
+		// Only the latest FRAME_HISTORY frames count: 45ms to 300ms here
+		for (int i = 1; i <= 300; ++i)
+		{
+			profiler.RecordGpuFrameTime(std::chrono::milliseconds{ i });
+		}
+		const FrameTimeStats gpuStats{ profiler.GetGpuFrameStats() };
+		EXPECT_EQ(gpuStats.frameCount, 300u);
+		EXPECT_DOUBLE_EQ(gpuStats.p50Milliseconds, 173.0);
+		EXPECT_DOUBLE_EQ(gpuStats.p99Milliseconds, 297.0);
+		EXPECT_DOUBLE_EQ(gpuStats.maxMilliseconds, 300.0);
+	}
+}
@@ -0,0 +1,94 @@
+#include "pch.h"
+#include "RadixSort.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		std::vector<RadixSortEntry> StableSorted(std::vector<RadixSortEntry> entries)
+		{
+			std::stable_sort(entries.begin(), entries.end(),
+				[](const RadixSortEntry& a, const RadixSortEntry& b)
+				{
+					return a.key < b.key;
+				});
+			return entries;
+		}
+
+		void ExpectSameOrder(const std::vector<RadixSortEntry>& actual, const std::vector<RadixSortEntry>& expected)
+		{
+			ASSERT_EQ(actual.size(), expected.size());
+			for (size_t i = 0; i < actual.size(); ++i)
+			{
+				EXPECT_EQ(actual[i].key, expected[i].key) << "at " << i;
+				EXPECT_EQ(actual[i].value, expected[i].value) << "at " << i;
+			}
+		}
+	}
+
+	TEST(RadixSortTests, MatchesStableSortOnKeysWithManyDuplicates)
+	{
+		// Few distinct keys spread over every byte, so each digit pass runs and
+		// the payloads show whether equal keys kept their order
+		std::mt19937_64 random{ 1234 };
+		std::vector<uint64_t> distinctKeys(32);
+		for (uint64_t& key : distinctKeys)
+		{
+			key = random();
+		}
+		std::uniform_int_distribution<size_t> pick{ 0, distinctKeys.size() - 1 };
+
+		std::vector<RadixSortEntry> entries(5000);
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			entries[i] = RadixSortEntry{ distinctKeys[pick(random)], static_cast<uint32_t>(i) };
+		}
+		const std::vector<RadixSortEntry> expected{ StableSorted(entries) };
+
+		std::vector<RadixSortEntry> scratch;
+		RadixSort(entries, scratch);
+		ExpectSameOrder(entries, expected);
+	}
+
+	TEST(RadixSortTests, SkipsDigitsEveryKeyShares)
+	{
+		// Only the second byte varies; every other pass takes the early out
+		std::mt19937 random{ 1234 };
+		std::uniform_int_distribution<uint64_t> digit{ 0, 7 };
+		std::vector<RadixSortEntry> entries(1000);
+		for (size_t i = 0; i < entries.size(); ++i)
+		{
+			entries[i] = RadixSortEntry{ 0xAB00'0000'0000'00CDull | (digit(random) << 8), static_cast<uint32_t>(i) };
+		}
+		const std::vector<RadixSortEntry> expected{ StableSorted(entries) };
+
+		std::vector<RadixSortEntry> scratch;
+		RadixSort(entries, scratch);
+		ExpectSameOrder(entries, expected);
+
+		// All keys equal: nothing moves
+		std::vector<RadixSortEntry> equal(100, RadixSortEntry{ 42, 0 });
+		for (size_t i = 0; i < equal.size(); ++i)
+		{
+			equal[i].value = static_cast<uint32_t>(i);
+		}
+		const std::vector<RadixSortEntry> unchanged{ equal };
+		RadixSort(equal, scratch);
+		ExpectSameOrder(equal, unchanged);
+	}
+
+	TEST(RadixSortTests, SortsTinyInputs)
+	{
+		std::vector<RadixSortEntry> scratch;
+		std::vector<RadixSortEntry> empty;
+		RadixSort(empty, scratch);
+		EXPECT_TRUE(empty.empty());
+
+		std::vector<RadixSortEntry> pair{ { 2, 0 }, { 1, 1 } };
+		RadixSort(pair, scratch);
+		ExpectSameOrder(pair, { { 1, 1 }, { 2, 0 } });
+	}
+}
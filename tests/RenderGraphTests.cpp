@@ -0,0 +1,208 @@
+#include "pch.h"
+#include "RenderGraph.h"
+#include "NullRenderBackend.h"
+#include "HeapAllocationCounter.h"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		/// <summary>
+		/// Builds a frame the way Renderer does, plus a transient and a pass that gets
+		/// culled so every stage of Compile() has work to do.
+		/// </summary>
+		void BuildFrame(RenderGraph& graph, uint32_t& executedCount)
+		{
+			graph.Reset();
+			const RenderResourceHandle backBuffer{ graph.ImportResource(
+				"BackBuffer",
+				ResourceState::Present,
+				ResourceState::Present) };
+			const RenderResourceHandle shadowMap{ graph.CreateTransient("ShadowMap", 4096, 256) };
+			const RenderResourceHandle unused{ graph.CreateTransient("Unused", 1024, 256) };
+
+			const uint32_t shadowPass{ graph.AddPass("Shadow", [&executedCount]() { ++executedCount; }) };
+			graph.Write(shadowPass, shadowMap, ResourceState::DepthWrite);
+
+			const uint32_t unusedPass{ graph.AddPass("Unused", [&executedCount]() { ++executedCount; }) };
+			graph.Write(unusedPass, unused, ResourceState::RenderTarget);
+
+			const uint32_t mainPass{ graph.AddPass("Main", [&executedCount]() { ++executedCount; }) };
+			graph.Read(mainPass, shadowMap, ResourceState::ShaderRead);
+			graph.Write(mainPass, backBuffer, ResourceState::RenderTarget);
+		}
+	}
+
+	TEST(RenderGraphTests, CullsAPassWhoseOutputNothingReads)
+	{
+		RenderGraph graph;
+		const RenderResourceHandle backBuffer{ graph.ImportResource(
+			"BackBuffer",
+			ResourceState::Present,
+			ResourceState::Present) };
+		const RenderResourceHandle unused{ graph.CreateTransient("Unused", 1024, 256) };
+
+		bool isUnusedRun{ false };
+		const uint32_t unusedPass{ graph.AddPass("Unused", [&isUnusedRun]() { isUnusedRun = true; }) };
+		graph.Write(unusedPass, unused, ResourceState::RenderTarget);
+		const uint32_t mainPass{ graph.AddPass("Main", []() {}) };
+		graph.Write(mainPass, backBuffer, ResourceState::RenderTarget);
+
+		NullRenderBackend backend;
+		graph.Compile();
+		graph.Execute(backend);
+
+		EXPECT_EQ(graph.GetStats().declaredPassCount, 2u);
+		EXPECT_EQ(graph.GetStats().culledPassCount, 1u);
+		EXPECT_EQ(backend.GetPassCount(), 1u);
+		EXPECT_FALSE(isUnusedRun);
+		for (const NullRenderBackend::Command& command : backend.GetCommands())
+		{
+			EXPECT_NE(command.passName, "Unused");
+		}
+	}
+
+	TEST(RenderGraphTests, KeepsAPassWithSideEffects)
+	{
+		RenderGraph graph;
+		const RenderResourceHandle readback{ graph.CreateTransient("Readback", 1024, 256) };
+		const uint32_t pass{ graph.AddPass("Readback", []() {}) };
+		graph.Write(pass, readback, ResourceState::CopyDest);
+		graph.SetSideEffects(pass);
+
+		graph.Compile();
+		EXPECT_EQ(graph.GetStats().culledPassCount, 0u);
+	}
+
+	TEST(RenderGraphTests, PlacesOneBarrierForAReadAfterWrite)
+	{
+		RenderGraph graph;
+		const RenderResourceHandle backBuffer{ graph.ImportResource(
+			"BackBuffer",
+			ResourceState::RenderTarget,
+			ResourceState::RenderTarget) };
+		const RenderResourceHandle shadowMap{ graph.CreateTransient("ShadowMap", 4096, 256) };
+
+		const uint32_t shadowPass{ graph.AddPass("Shadow", []() {}) };
+		graph.Write(shadowPass, shadowMap, ResourceState::DepthWrite);
+		const uint32_t mainPass{ graph.AddPass("Main", []() {}) };
+		graph.Read(mainPass, shadowMap, ResourceState::ShaderRead);
+		graph.Write(mainPass, backBuffer, ResourceState::RenderTarget);
+
+		NullRenderBackend backend;
+		graph.Compile();
+		graph.Execute(backend);
+
+		// The transient starts out undefined and the back buffer is already in
+		// the state it's written in, so the only transition is the read.
+		EXPECT_EQ(graph.GetStats().barrierCount, 1u);
+		ASSERT_EQ(backend.GetBarrierCount(), 1u);
+
+		const std::vector<NullRenderBackend::Command>& commands{ backend.GetCommands() };
+		const auto barrier{ std::find_if(commands.begin(), commands.end(),
+			[](const NullRenderBackend::Command& command)
+			{
+				return command.type == NullRenderBackend::CommandType::Barrier;
+			}) };
+		ASSERT_NE(barrier, commands.end());
+		EXPECT_EQ(barrier->resource, shadowMap);
+		EXPECT_EQ(barrier->before, ResourceState::DepthWrite);
+		EXPECT_EQ(barrier->after, ResourceState::ShaderRead);
+
+		// Within the reading pass, after it begins
+		ASSERT_NE(barrier, commands.begin());
+		const NullRenderBackend::Command& begin{ *(barrier - 1) };
+		EXPECT_EQ(begin.type, NullRenderBackend::CommandType::BeginPass);
+		EXPECT_EQ(begin.passName, "Main");
+	}
+
+	TEST(RenderGraphTests, TransitionsImportedResourcesBackToTheirFinalState)
+	{
+		RenderGraph graph;
+		const RenderResourceHandle backBuffer{ graph.ImportResource(
+			"BackBuffer",
+			ResourceState::Present,
+			ResourceState::Present) };
+		const uint32_t mainPass{ graph.AddPass("Main", []() {}) };
+		graph.Write(mainPass, backBuffer, ResourceState::RenderTarget);
+
+		NullRenderBackend backend;
+		graph.Execute(backend);
+
+		const std::vector<NullRenderBackend::Command>& commands{ backend.GetCommands() };
+		ASSERT_EQ(commands.size(), 4u);
+		EXPECT_EQ(commands[1].type, NullRenderBackend::CommandType::Barrier);
+		EXPECT_EQ(commands[1].before, ResourceState::Present);
+		EXPECT_EQ(commands[1].after, ResourceState::RenderTarget);
+		EXPECT_EQ(commands[3].type, NullRenderBackend::CommandType::Barrier);
+		EXPECT_EQ(commands[3].before, ResourceState::RenderTarget);
+		EXPECT_EQ(commands[3].after, ResourceState::Present);
+	}
+
+	TEST(RenderGraphTests, AliasesTransientsWithDisjointLifetimes)
+	{
+		// A -> B -> C -> back buffer: A is dead by the time C is written
+		RenderGraph graph;
+		const RenderResourceHandle backBuffer{ graph.ImportResource(
+			"BackBuffer",
+			ResourceState::Present,
+			ResourceState::Present) };
+		constexpr uint64_t SIZE{ 65536 };
+		const RenderResourceHandle a{ graph.CreateTransient("A", SIZE, SIZE) };
+		const RenderResourceHandle b{ graph.CreateTransient("B", SIZE, SIZE) };
+		const RenderResourceHandle c{ graph.CreateTransient("C", SIZE, SIZE) };
+
+		const uint32_t first{ graph.AddPass("First", []() {}) };
+		graph.Write(first, a, ResourceState::RenderTarget);
+		const uint32_t second{ graph.AddPass("Second", []() {}) };
+		graph.Read(second, a, ResourceState::ShaderRead);
+		graph.Write(second, b, ResourceState::RenderTarget);
+		const uint32_t third{ graph.AddPass("Third", []() {}) };
+		graph.Read(third, b, ResourceState::ShaderRead);
+		graph.Write(third, c, ResourceState::RenderTarget);
+		const uint32_t fourth{ graph.AddPass("Fourth", []() {}) };
+		graph.Read(fourth, c, ResourceState::ShaderRead);
+		graph.Write(fourth, backBuffer, ResourceState::RenderTarget);
+
+		graph.Compile();
+		const RenderGraphStats& stats{ graph.GetStats() };
+		EXPECT_EQ(stats.transientBytes, 3 * SIZE);
+		EXPECT_LT(stats.aliasedHeapBytes, stats.transientBytes);
+		EXPECT_EQ(stats.aliasedHeapBytes, 2 * SIZE);
+		EXPECT_EQ(graph.GetHeapOffset(a), graph.GetHeapOffset(c));
+
+		// Overlapping lifetimes never share memory
+		EXPECT_NE(graph.GetHeapOffset(a), graph.GetHeapOffset(b));
+		EXPECT_NE(graph.GetHeapOffset(b), graph.GetHeapOffset(c));
+		for (RenderResourceHandle resource : { a, b, c })
+		{
+			EXPECT_EQ(graph.GetHeapOffset(resource) % SIZE, 0u);
+		}
+	}
+
+	TEST(RenderGraphTests, RebuildingTheGraphEachFrameDoesNotAllocate)
+	{
+		RenderGraph graph;
+		NullRenderBackend backend;
+		uint32_t executedCount{ 0 };
+
+		// The first frame grows the pass slots, scratch and command list to size
+		BuildFrame(graph, executedCount);
+		graph.Compile();
+		graph.Execute(backend);
+
+		const uint64_t allocationStart{ GetHeapAllocationCount() };
+		for (int i = 0; i < 10; ++i)
+		{
+			backend.Clear();
+			BuildFrame(graph, executedCount);
+			graph.Compile();
+			graph.Execute(backend);
+		}
+		EXPECT_EQ(GetHeapAllocationCount() - allocationStart, 0u);
+		EXPECT_EQ(executedCount, 11u * 2u);
+	}
+}
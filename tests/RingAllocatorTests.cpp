@@ -0,0 +1,115 @@
+#include "pch.h"
+#include "RingAllocator.h"
+
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	TEST(RingAllocatorTests, AlignsSuballocations)
+	{
+		RingAllocator ring{ 1024 };
+		EXPECT_EQ(ring.Allocate(10, 1), 0u);
+		EXPECT_EQ(ring.Allocate(16, 256), 256u);
+		EXPECT_EQ(ring.Allocate(1, 64), 320u);
+		EXPECT_EQ(ring.Allocate(8, 0), 321u);
+
+		// Alignment padding is charged to the allocation that needed it
+		EXPECT_EQ(ring.GetUsedBytes(), 329u);
+		EXPECT_TRUE(ring.HasOpenAllocations());
+	}
+
+	TEST(RingAllocatorTests, ChargesTheTailToTheBatchOnWrap)
+	{
+		RingAllocator ring{ 100 };
+		EXPECT_EQ(ring.Allocate(60, 1), 0u);
+		ring.FinishBatch(1);
+		EXPECT_EQ(ring.Allocate(30, 1), 60u);
+		ring.FinishBatch(2);
+		ring.Retire(1);
+		EXPECT_EQ(ring.GetUsedBytes(), 30u);
+
+		// 20 bytes don't fit in [90, 100), so the allocation wraps to the front and
+		// the 10 bytes it skips belong to its batch
+		EXPECT_EQ(ring.Allocate(20, 1), 0u);
+		EXPECT_EQ(ring.GetUsedBytes(), 60u);
+		ring.FinishBatch(3);
+
+		ring.Retire(2);
+		EXPECT_EQ(ring.GetUsedBytes(), 30u);
+		EXPECT_EQ(ring.Allocate(70, 1), 20u);
+		EXPECT_EQ(ring.Allocate(1, 1), RingAllocator::INVALID_OFFSET);
+		ring.FinishBatch(4);
+
+		ring.Retire(4);
+		EXPECT_EQ(ring.GetUsedBytes(), 0u);
+	}
+
+	TEST(RingAllocatorTests, ReturnsInvalidOffsetWhenFull)
+	{
+		RingAllocator ring{ 64 };
+		EXPECT_EQ(ring.Allocate(0, 1), RingAllocator::INVALID_OFFSET);
+		EXPECT_EQ(ring.Allocate(65, 1), RingAllocator::INVALID_OFFSET);
+
+		EXPECT_EQ(ring.Allocate(40, 1), 0u);
+		ring.FinishBatch(1);
+
+		// Neither the end of the buffer nor the front has room until batch 1 retires
+		EXPECT_EQ(ring.Allocate(32, 1), RingAllocator::INVALID_OFFSET);
+		EXPECT_EQ(ring.Allocate(24, 16), RingAllocator::INVALID_OFFSET);
+		EXPECT_EQ(ring.Allocate(24, 1), 40u);
+		EXPECT_EQ(ring.Allocate(1, 1), RingAllocator::INVALID_OFFSET);
+		EXPECT_EQ(ring.GetUsedBytes(), 64u);
+		ring.FinishBatch(2);
+
+		ring.Retire(2);
+		EXPECT_EQ(ring.Allocate(64, 1), 0u);
+	}
+
+	TEST(RingAllocatorTests, RetiresOnlyCompletedBatches)
+	{
+		RingAllocator ring{ 1024 };
+		for (uint64_t fenceValue = 1; fenceValue <= 3; ++fenceValue)
+		{
+			EXPECT_NE(ring.Allocate(100, 1), RingAllocator::INVALID_OFFSET);
+			ring.FinishBatch(fenceValue);
+		}
+
+		// A batch with nothing in it isn't tracked
+		ring.FinishBatch(4);
+		EXPECT_FALSE(ring.HasOpenAllocations());
+
+		ring.Retire(0);
+		EXPECT_EQ(ring.GetUsedBytes(), 300u);
+		EXPECT_EQ(ring.GetOldestPendingFenceValue(), 1u);
+
+		ring.Retire(2);
+		EXPECT_EQ(ring.GetUsedBytes(), 100u);
+		EXPECT_EQ(ring.GetOldestPendingFenceValue(), 3u);
+
+		// Retiring an older fence value again frees nothing more
+		ring.Retire(1);
+		EXPECT_EQ(ring.GetUsedBytes(), 100u);
+
+		ring.Retire(3);
+		EXPECT_EQ(ring.GetUsedBytes(), 0u);
+		EXPECT_EQ(ring.GetOldestPendingFenceValue(), 0u);
+	}
+
+	TEST(RingAllocatorTests, RetiresInAllocationOrder)
+	{
+		// Batches can be tagged out of order, for example when two queues share a
+		// ring, but memory is only reclaimed from the oldest allocation forward
+		RingAllocator ring{ 1024 };
+		EXPECT_EQ(ring.Allocate(100, 1), 0u);
+		ring.FinishBatch(5);
+		EXPECT_EQ(ring.Allocate(100, 1), 100u);
+		ring.FinishBatch(3);
+
+		ring.Retire(3);
+		EXPECT_EQ(ring.GetUsedBytes(), 200u);
+		EXPECT_EQ(ring.GetOldestPendingFenceValue(), 5u);
+
+		ring.Retire(5);
+		EXPECT_EQ(ring.GetUsedBytes(), 0u);
+	}
+}
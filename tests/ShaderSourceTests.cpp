@@ -0,0 +1,126 @@
+#include "pch.h"
+#include "ShaderSource.h"
+
+#include <gtest/gtest.h>
+#include <fstream>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		/// <summary>
+		/// A directory of shader sources in the temporary directory, deleted on
+		/// destruction.
+		/// </summary>
+		class ShaderDirectory
+		{
+		public:
+			ShaderDirectory() :
+				m_path(std::filesystem::temp_directory_path() / "HelloTriangleShaderSourceTests")
+			{
+				std::filesystem::remove_all(m_path);
+				std::filesystem::create_directories(m_path / "common");
+			}
+
+			~ShaderDirectory()
+			{
+				std::filesystem::remove_all(m_path);
+			}
+
+			std::filesystem::path Write(const char* name, std::string_view contents) const
+			{
+				const std::filesystem::path path{ m_path / name };
+				std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+				file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+				return path;
+			}
+
+			uint64_t HashMain() const
+			{
+				const std::filesystem::path path{ m_path / "Main.hlsl" };
+				std::ifstream file{ path, std::ios::binary };
+				const std::string source{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+				return HashShaderSource(source, path);
+			}
+
+		private:
+			std::filesystem::path m_path;
+		};
+	}
+
+	TEST(ShaderSourceTests, FindsIncludeDirectivesOutsideComments)
+	{
+		const std::string_view source{
+			"#include \"First.hlsl\"\n"
+			"  #  include <Second.hlsl>\n"
+			"// #include \"Commented.hlsl\"\n"
+			"/* #include \"Block.hlsl\"\n"
+			"#include \"StillBlock.hlsl\" */ float4 x;\n"
+			"#define INCLUDE_LIKE \"#include \\\"NotADirective.hlsl\\\"\"\n"
+			"#include \"common/Third.hlsl\" // trailing comment\n"
+			"#include \"Unterminated.hlsl\n"
+		};
+
+		EXPECT_EQ(
+			FindShaderIncludes(source),
+			(std::vector<std::string>{ "First.hlsl", "Second.hlsl", "common/Third.hlsl" }));
+	}
+
+	TEST(ShaderSourceTests, HashChangesWithNestedIncludes)
+	{
+		const ShaderDirectory directory;
+		directory.Write("Main.hlsl", "#include \"common/Lighting.hlsl\"\nfloat4 main() : SV_Target { return Light(); }\n");
+		directory.Write("common/Lighting.hlsl", "#include \"Constants.hlsl\"\nfloat4 Light() { return SCALE; }\n");
+		directory.Write("common/Constants.hlsl", "#define SCALE 1.0f\n");
+		const uint64_t original{ directory.HashMain() };
+		EXPECT_EQ(directory.HashMain(), original);
+
+		// Included relative to Lighting.hlsl, two levels down from Main.hlsl
+		directory.Write("common/Constants.hlsl", "#define SCALE 2.0f\n");
+		const uint64_t edited{ directory.HashMain() };
+		EXPECT_NE(edited, original);
+
+		directory.Write("common/Constants.hlsl", "#define SCALE 1.0f\n");
+		EXPECT_EQ(directory.HashMain(), original);
+
+		// A file next to Main.hlsl with the same name isn't the one included
+		directory.Write("Constants.hlsl", "#define SCALE 3.0f\n");
+		EXPECT_EQ(directory.HashMain(), original);
+	}
+
+	TEST(ShaderSourceTests, HashCoversMissingAndRepeatedIncludes)
+	{
+		const ShaderDirectory directory;
+		directory.Write("Main.hlsl", "#include \"Guarded.hlsl\"\n#include \"Guarded.hlsl\"\n#include \"Missing.hlsl\"\n");
+		directory.Write("Guarded.hlsl", "#pragma once\n#include \"Main.hlsl\"\n");
+		const uint64_t missing{ directory.HashMain() };
+
+		directory.Write("Missing.hlsl", "");
+		EXPECT_NE(directory.HashMain(), missing);
+	}
+
+	TEST(ShaderSourceTests, KeyCoversEntryPointTargetAndFlagsButNotLocation)
+	{
+		const ShaderDirectory directory;
+		const std::string_view source{ "#include \"common/Constants.hlsl\"\n" };
+		directory.Write("common/Constants.hlsl", "#define SCALE 1.0f\n");
+		const std::filesystem::path path{ directory.Write("Main.hlsl", source) };
+		const uint64_t key{ ComputeShaderKey(source, path, VERTEX_SHADER, 0) };
+
+		EXPECT_NE(ComputeShaderKey(source, path, COMPRESSED_VERTEX_SHADER, 0), key);
+		EXPECT_NE(ComputeShaderKey(source, path, ShaderEntryPoint{ VERTEX_SHADER.name, "vs_5_1" }, 0), key);
+		EXPECT_NE(ComputeShaderKey(source, path, VERTEX_SHADER, 1), key);
+
+		// An archive built next to the build output still matches once installed
+		// elsewhere, as long as the includes come along
+		const std::filesystem::path installed{ std::filesystem::temp_directory_path() / "HelloTriangleShaderKeyTests" };
+		std::filesystem::remove_all(installed);
+		std::filesystem::create_directories(installed);
+		std::filesystem::copy(path.parent_path(), installed, std::filesystem::copy_options::recursive);
+		EXPECT_EQ(ComputeShaderKey(source, installed / "Main.hlsl", VERTEX_SHADER, 0), key);
+
+		std::filesystem::remove_all(installed / "common");
+		EXPECT_NE(ComputeShaderKey(source, installed / "Main.hlsl", VERTEX_SHADER, 0), key);
+		std::filesystem::remove_all(installed);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "pch.h"
+#include "SimdKernels.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t RANDOM_SEED{ 1234 };
+
+		// Empty, shorter than a vector, every tail length around the SSE2 and AVX2
+		// widths, and large enough for the main loops to run many times
+		constexpr size_t COUNTS[]{ 0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 1000, 1021 };
+
+		// Streams start this far into their buffers, so vector loads aren't aligned
+		constexpr size_t UNALIGNED_OFFSET{ 1 };
+
+		/// <summary>
+		/// Random float streams, each with room for the largest count at an
+		/// unaligned offset.
+		/// </summary>
+		class RandomStreams
+		{
+		public:
+			RandomStreams(size_t streamCount, size_t count, float min, float max) :
+				m_count(count),
+				m_data(streamCount * (count + UNALIGNED_OFFSET))
+			{
+				std::mt19937 random{ RANDOM_SEED + static_cast<uint32_t>(streamCount) };
+				std::uniform_real_distribution<float> value{ min, max };
+				for (float& element : m_data)
+				{
+					element = value(random);
+				}
+			}
+
+			float* operator[](size_t stream)
+			{
+				return m_data.data() + (stream * (m_count + UNALIGNED_OFFSET)) + UNALIGNED_OFFSET;
+			}
+
+		private:
+			size_t m_count;
+			std::vector<float> m_data;
+		};
+
+		std::vector<SimdLevel> GetSupportedLevels()
+		{
+			std::vector<SimdLevel> levels;
+			const SimdLevel bestLevel{ DetectSimdLevel() };
+			for (SimdLevel level : { SimdLevel::Sse2, SimdLevel::Avx2 })
+			{
+				if (static_cast<int>(level) <= static_cast<int>(bestLevel))
+				{
+					levels.push_back(level);
+				}
+			}
+			return levels;
+		}
+
+		// Kernels promise bitwise identical results, so compare representations
+		void ExpectStreamsEqual(const float* expected, const float* actual, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				ASSERT_EQ(std::memcmp(&expected[i], &actual[i], sizeof(float)), 0)
+					<< "element " << i << ": expected " << expected[i] << ", got " << actual[i];
+			}
+		}
+
+		// Six planes facing into a box, tilted at random so spheres straddle them
+		void BuildRandomPlanes(float planes[24])
+		{
+			std::mt19937 random{ RANDOM_SEED };
+			std::uniform_real_distribution<float> tilt{ -0.3f, 0.3f };
+			std::uniform_real_distribution<float> distance{ 0.2f, 0.8f };
+			for (size_t plane = 0; plane < 6; ++plane)
+			{
+				float normal[3]{ tilt(random), tilt(random), tilt(random) };
+				normal[plane / 2] = ((plane % 2) == 0) ? 1.0f : -1.0f;
+				const float length{ std::sqrt((normal[0] * normal[0]) + (normal[1] * normal[1]) + (normal[2] * normal[2])) };
+				planes[(plane * 4) + 0] = normal[0] / length;
+				planes[(plane * 4) + 1] = normal[1] / length;
+				planes[(plane * 4) + 2] = normal[2] / length;
+				planes[(plane * 4) + 3] = distance(random);
+			}
+		}
+	}
+
+	TEST(SimdKernelsTests, IntegratePositionsMatchesScalar)
+	{
+		const SimdKernels& scalar{ GetSimdKernels(SimdLevel::Scalar) };
+		for (SimdLevel level : GetSupportedLevels())
+		{
+			SCOPED_TRACE(GetSimdLevelName(level));
+			const SimdKernels& kernels{ GetSimdKernels(level) };
+			for (size_t count : COUNTS)
+			{
+				SCOPED_TRACE(count);
+				RandomStreams expected{ 6, count, -100.0f, 100.0f };
+				RandomStreams actual{ 6, count, -100.0f, 100.0f };
+				scalar.IntegratePositions(count, expected[0], expected[1], expected[2], expected[3], expected[4], expected[5], 1.0f / 60.0f);
+				kernels.IntegratePositions(count, actual[0], actual[1], actual[2], actual[3], actual[4], actual[5], 1.0f / 60.0f);
+				for (size_t stream = 0; stream < 3; ++stream)
+				{
+					ExpectStreamsEqual(expected[stream], actual[stream], count);
+				}
+			}
+		}
+	}
+
+	TEST(SimdKernelsTests, UpdateAabbsMatchesScalar)
+	{
+		const SimdKernels& scalar{ GetSimdKernels(SimdLevel::Scalar) };
+		for (SimdLevel level : GetSupportedLevels())
+		{
+			SCOPED_TRACE(GetSimdLevelName(level));
+			const SimdKernels& kernels{ GetSimdKernels(level) };
+			for (size_t count : COUNTS)
+			{
+				SCOPED_TRACE(count);
+				RandomStreams inputs{ 6, count, 0.0f, 10.0f };
+				RandomStreams expected{ 6, count, 0.0f, 0.0f };
+				RandomStreams actual{ 6, count, 0.0f, 0.0f };
+				float* const expectedBounds[6]{ expected[0], expected[1], expected[2], expected[3], expected[4], expected[5] };
+				float* const actualBounds[6]{ actual[0], actual[1], actual[2], actual[3], actual[4], actual[5] };
+				scalar.UpdateAabbs(count, inputs[0], inputs[1], inputs[2], inputs[3], inputs[4], inputs[5], expectedBounds);
+				kernels.UpdateAabbs(count, inputs[0], inputs[1], inputs[2], inputs[3], inputs[4], inputs[5], actualBounds);
+				for (size_t stream = 0; stream < 6; ++stream)
+				{
+					ExpectStreamsEqual(expected[stream], actual[stream], count);
+				}
+			}
+		}
+	}
+
+	TEST(SimdKernelsTests, TransformPointsMatchesScalar)
+	{
+		float matrix[16];
+		std::mt19937 random{ RANDOM_SEED };
+		std::uniform_real_distribution<float> element{ -2.0f, 2.0f };
+		for (float& value : matrix)
+		{
+			value = element(random);
+		}
+
+		const SimdKernels& scalar{ GetSimdKernels(SimdLevel::Scalar) };
+		for (SimdLevel level : GetSupportedLevels())
+		{
+			SCOPED_TRACE(GetSimdLevelName(level));
+			const SimdKernels& kernels{ GetSimdKernels(level) };
+			for (size_t count : COUNTS)
+			{
+				SCOPED_TRACE(count);
+				RandomStreams points{ 3, count, -100.0f, 100.0f };
+				RandomStreams expected{ 4, count, 0.0f, 0.0f };
+				RandomStreams actual{ 4, count, 0.0f, 0.0f };
+				float* const expectedOut[4]{ expected[0], expected[1], expected[2], expected[3] };
+				float* const actualOut[4]{ actual[0], actual[1], actual[2], actual[3] };
+				scalar.TransformPoints(count, matrix, points[0], points[1], points[2], expectedOut);
+				kernels.TransformPoints(count, matrix, points[0], points[1], points[2], actualOut);
+				for (size_t stream = 0; stream < 4; ++stream)
+				{
+					ExpectStreamsEqual(expected[stream], actual[stream], count);
+				}
+			}
+		}
+	}
+
+	TEST(SimdKernelsTests, CullSpheresMatchesScalar)
+	{
+		float planes[24];
+		BuildRandomPlanes(planes);
+		constexpr uint32_t FIRST_INDEX{ 100 };
+
+		const SimdKernels& scalar{ GetSimdKernels(SimdLevel::Scalar) };
+		for (SimdLevel level : GetSupportedLevels())
+		{
+			SCOPED_TRACE(GetSimdLevelName(level));
+			const SimdKernels& kernels{ GetSimdKernels(level) };
+			for (size_t count : COUNTS)
+			{
+				SCOPED_TRACE(count);
+				RandomStreams centers{ 3, count, -1.0f, 1.0f };
+				RandomStreams radii{ 1, count, 0.0f, 0.3f };
+				for (const float* radius : { static_cast<const float*>(radii[0]), static_cast<const float*>(nullptr) })
+				{
+					std::vector<uint32_t> expected(count);
+					std::vector<uint32_t> actual(count);
+					const size_t expectedCount{ scalar.CullSpheres(
+						count, planes, centers[0], centers[1], centers[2], radius, 0.1f, FIRST_INDEX, expected.data()) };
+					const size_t actualCount{ kernels.CullSpheres(
+						count, planes, centers[0], centers[1], centers[2], radius, 0.1f, FIRST_INDEX, actual.data()) };
+					ASSERT_EQ(actualCount, expectedCount);
+					expected.resize(expectedCount);
+					actual.resize(actualCount);
+					EXPECT_EQ(actual, expected);
+				}
+			}
+		}
+	}
+
+	TEST(SimdKernelsTests, CullSpheresKeepsStraddlingSpheres)
+	{
+		// A unit box; the first sphere is inside, the second straddles +x, the
+		// third is just outside it and the fourth is well outside
+		const float planes[24]{
+			1.0f, 0.0f, 0.0f, 1.0f,
+			-1.0f, 0.0f, 0.0f, 1.0f,
+			0.0f, 1.0f, 0.0f, 1.0f,
+			0.0f, -1.0f, 0.0f, 1.0f,
+			0.0f, 0.0f, 1.0f, 1.0f,
+			0.0f, 0.0f, -1.0f, 1.0f,
+		};
+		const float x[]{ 0.0f, 1.05f, 1.25f, 5.0f };
+		const float zero[]{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+		for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+		{
+			SCOPED_TRACE(GetSimdLevelName(level));
+			uint32_t visible[4]{};
+			const size_t visibleCount{
+				GetSimdKernels(level).CullSpheres(4, planes, x, zero, zero, nullptr, 0.2f, 0, visible)
+			};
+			ASSERT_EQ(visibleCount, 2u);
+			EXPECT_EQ(visible[0], 0u);
+			EXPECT_EQ(visible[1], 1u);
+		}
+	}
+}
@@ -0,0 +1,167 @@
+#include "pch.h"
+#include "Simulation.h"
+#include "SimulationSnapshot.h"
+#include "JobSystem.h"
+#include "WorldSeed.h"
+
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr float TICK_SECONDS{ 1.0f / 60.0f };
+		constexpr uint32_t RESIMULATED_TICKS{ 120 };
+
+		// Enough entities that ParallelFor splits integration across every worker
+		const WorldSeedConfig SEED_CONFIG{ .entityCount = 20'000 };
+
+		uint64_t SimulateAndHash(Simulation& simulation, uint32_t tickCount)
+		{
+			for (uint32_t tick = 0; tick < tickCount; ++tick)
+			{
+				simulation.Update(TICK_SECONDS);
+			}
+			return simulation.ComputeStateHash();
+		}
+	}
+
+	TEST(SimulationTests, KeepsPositionsFromBeforeTheLatestTick)
+	{
+		Simulation simulation{ nullptr };
+		World& world{ simulation.GetWorld() };
+		const Entity moving{ world.CreateEntity() };
+		world.SetPosition(moving, 1.0f, 2.0f, 3.0f);
+		world.SetVelocity(moving, 10.0f, 0.0f, -10.0f);
+		const Entity still{ world.CreateEntity() };
+		world.SetPosition(still, 5.0f, 5.0f, 5.0f);
+
+		EXPECT_EQ(simulation.GetPreviousPositions().count, 0u);
+
+		simulation.Update(0.5f);
+		simulation.Update(0.5f);
+		const PreviousPositionsView previous{ simulation.GetPreviousPositions() };
+		ASSERT_EQ(previous.count, 1u);
+		EXPECT_FLOAT_EQ(previous.x[0], 6.0f);
+		EXPECT_FLOAT_EQ(previous.y[0], 2.0f);
+		EXPECT_FLOAT_EQ(previous.z[0], -2.0f);
+
+		const auto& positions{ world.GetPositions() };
+		const uint32_t index{ positions.IndexOf(moving) };
+		ASSERT_EQ(index, 0u);
+		EXPECT_FLOAT_EQ(positions.Field(0)[index], 11.0f);
+		EXPECT_FLOAT_EQ(positions.Field(2)[index], -7.0f);
+	}
+
+	TEST(SimulationTests, RestoreForgetsPreviousPositions)
+	{
+		Simulation simulation{ nullptr };
+		World& world{ simulation.GetWorld() };
+		const Entity entity{ world.CreateEntity() };
+		world.SetPosition(entity, 0.0f, 0.0f, 0.0f);
+		world.SetVelocity(entity, 1.0f, 1.0f, 1.0f);
+
+		SimulationSnapshot snapshot;
+		simulation.SaveSnapshot(snapshot);
+		simulation.Update(1.0f);
+		ASSERT_EQ(simulation.GetPreviousPositions().count, 1u);
+
+		simulation.RestoreSnapshot(snapshot);
+		EXPECT_EQ(simulation.GetPreviousPositions().count, 0u);
+	}
+
+	TEST(SimulationTests, ResimulatingFromASnapshotReproducesTheStateHash)
+	{
+		Simulation simulation{ nullptr };
+		SeedWorld(simulation.GetWorld(), SEED_CONFIG);
+		SimulateAndHash(simulation, 10);
+
+		SimulationSnapshot snapshot;
+		simulation.SaveSnapshot(snapshot);
+		const uint64_t snapshotHash{ simulation.ComputeStateHash() };
+		const uint64_t expectedHash{ SimulateAndHash(simulation, RESIMULATED_TICKS) };
+		ASSERT_NE(expectedHash, snapshotHash);
+
+		simulation.RestoreSnapshot(snapshot);
+		EXPECT_EQ(simulation.GetTick(), snapshot.tick);
+		EXPECT_EQ(simulation.ComputeStateHash(), snapshotHash);
+		EXPECT_EQ(SimulateAndHash(simulation, RESIMULATED_TICKS), expectedHash);
+	}
+
+	TEST(SimulationTests, JobSystemRunsMatchSerialRuns)
+	{
+		JobSystem jobSystem{ 3 };
+		Simulation parallelSimulation{ nullptr, &jobSystem };
+		SeedWorld(parallelSimulation.GetWorld(), SEED_CONFIG);
+		Simulation serialSimulation{ nullptr };
+		SeedWorld(serialSimulation.GetWorld(), SEED_CONFIG);
+		ASSERT_EQ(parallelSimulation.ComputeStateHash(), serialSimulation.ComputeStateHash());
+
+		EXPECT_EQ(
+			SimulateAndHash(parallelSimulation, RESIMULATED_TICKS),
+			SimulateAndHash(serialSimulation, RESIMULATED_TICKS));
+
+		// A snapshot taken on the job system replays the same on one thread
+		SimulationSnapshot snapshot;
+		parallelSimulation.SaveSnapshot(snapshot);
+		serialSimulation.RestoreSnapshot(snapshot);
+		EXPECT_EQ(
+			SimulateAndHash(parallelSimulation, RESIMULATED_TICKS),
+			SimulateAndHash(serialSimulation, RESIMULATED_TICKS));
+	}
+
+	TEST(SimulationTests, SnapshotRingWrapsAroundKeepingTheLatestTicks)
+	{
+		constexpr size_t CAPACITY{ 4 };
+		Simulation simulation{ nullptr };
+		SeedWorld(simulation.GetWorld(), WorldSeedConfig{ .entityCount = 100 });
+		SnapshotRing ring{ CAPACITY, 100 };
+		EXPECT_EQ(ring.GetCapacity(), CAPACITY);
+
+		// Ticks 0 to 9 through a ring of 4, as the main loop captures them
+		std::vector<uint64_t> hashes;
+		for (uint32_t tick = 0; tick < 10; ++tick)
+		{
+			simulation.SaveSnapshot(ring.Acquire(simulation.GetTick()));
+			hashes.push_back(simulation.ComputeStateHash());
+			simulation.Update(TICK_SECONDS);
+		}
+
+		// The last four survive, each restoring the state it was taken in
+		for (uint64_t tick = 6; tick < 10; ++tick)
+		{
+			const SimulationSnapshot* snapshot{ ring.Find(tick) };
+			ASSERT_NE(snapshot, nullptr);
+			EXPECT_EQ(snapshot->tick, tick);
+			simulation.RestoreSnapshot(*snapshot);
+			EXPECT_EQ(simulation.ComputeStateHash(), hashes[tick]);
+		}
+
+		// Overwritten: tick 5 shared tick 9's slot and tick 2 tick 6's
+		EXPECT_EQ(ring.Find(5), nullptr);
+		EXPECT_EQ(ring.Find(2), nullptr);
+		EXPECT_EQ(ring.Find(0), nullptr);
+
+		// Never taken, including ticks that map onto occupied slots
+		EXPECT_EQ(ring.Find(10), nullptr);
+		EXPECT_EQ(ring.Find(13), nullptr);
+		EXPECT_EQ(ring.Find(SimulationSnapshot::INVALID_TICK), nullptr);
+	}
+
+	TEST(SimulationTests, SnapshotRingForgetsASlotOnceAcquired)
+	{
+		Simulation simulation{ nullptr };
+		SnapshotRing ring{ 2, 0 };
+		EXPECT_EQ(ring.Find(0), nullptr);
+
+		simulation.SaveSnapshot(ring.Acquire(0));
+		ASSERT_NE(ring.Find(0), nullptr);
+
+		// Acquiring tick 2 evicts tick 0 before anything is captured into it
+		SimulationSnapshot& slot{ ring.Acquire(2) };
+		EXPECT_EQ(ring.Find(0), nullptr);
+		EXPECT_EQ(ring.Find(2), nullptr);
+		slot.tick = 2;
+		EXPECT_EQ(ring.Find(2), &slot);
+	}
+}
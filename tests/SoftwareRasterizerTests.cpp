@@ -0,0 +1,226 @@
+#include "pch.h"
+#include "SoftwareRasterizer.h"
+#include "JobSystem.h"
+
+#include <gtest/gtest.h>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t RANDOM_SEED{ 1234 };
+		constexpr uint32_t WORKER_COUNT{ 3 };
+
+		// Several tiles in each direction, with a last tile column that isn't a
+		// multiple of the SSE2 width
+		constexpr uint32_t WIDTH{ 158 };
+		constexpr uint32_t HEIGHT{ 118 };
+
+		constexpr uint32_t CLEAR_BLACK{ 0xFF000000 };
+		constexpr uint32_t RED{ 0xFF0000FF };
+		constexpr uint32_t GREEN{ 0xFF00FF00 };
+		constexpr float NOT_A_NUMBER{ std::numeric_limits<float>::quiet_NaN() };
+
+		// The hello triangle, at a 4:3 aspect ratio
+		constexpr std::array<Vertex, 3> TRIANGLE_VERTICES
+		{ {
+			{ { 0.0f, 0.25f * (4.0f / 3.0f), 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+			{ { 0.25f, -0.25f * (4.0f / 3.0f), 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+			{ { -0.25f, -0.25f * (4.0f / 3.0f), 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+		} };
+
+		/// <summary>
+		/// A file path in the temporary directory, deleted on destruction.
+		/// </summary>
+		class TemporaryPath
+		{
+		public:
+			explicit TemporaryPath(const char* name) :
+				m_path(std::filesystem::temp_directory_path() / name)
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			~TemporaryPath()
+			{
+				std::filesystem::remove(m_path);
+			}
+
+			const std::filesystem::path& Get() const
+			{
+				return m_path;
+			}
+
+		private:
+			std::filesystem::path m_path;
+		};
+
+		uint32_t GetPixel(const SoftwareRasterizer& rasterizer, uint32_t x, uint32_t y)
+		{
+			return rasterizer.GetPixels()[(static_cast<size_t>(y) * rasterizer.GetWidth()) + x];
+		}
+
+		/// <summary>
+		/// A background triangle far larger than the screen, the hello triangle,
+		/// copies of it scattered over and past the screen edges with colors over
+		/// range, and triangles the rasterizer must handle the same way on every
+		/// path: a NaN color, a NaN position, zero area and back-facing.
+		/// </summary>
+		void DrawReferenceScene(SoftwareRasterizer& rasterizer)
+		{
+			const float clearColor[4]{ 0.0f, 0.0f, 0.0f, 1.0f };
+			rasterizer.Clear(clearColor);
+			std::array<Vertex, 3> huge{ TRIANGLE_VERTICES };
+			for (Vertex& vertex : huge)
+			{
+				vertex.position[0] *= 1.0e6f;
+				vertex.position[1] *= 1.0e6f;
+				vertex.color[3] = 0.5f;
+			}
+			rasterizer.Draw(huge.data(), static_cast<uint32_t>(huge.size()));
+			rasterizer.Draw(TRIANGLE_VERTICES.data(), static_cast<uint32_t>(TRIANGLE_VERTICES.size()));
+
+			std::vector<InstanceData> instances(64);
+			std::mt19937 random{ RANDOM_SEED };
+			std::uniform_real_distribution<float> position{ -1.2f, 1.2f };
+			std::uniform_real_distribution<float> scale{ 0.1f, 3.0f };
+			std::uniform_real_distribution<float> tint{ -0.5f, 2.0f };
+			for (InstanceData& instance : instances)
+			{
+				instance = InstanceData{
+					{ position(random), position(random), 0.0f, scale(random) },
+					{ tint(random), tint(random), tint(random), 1.0f }
+				};
+			}
+			rasterizer.DrawInstanced(
+				TRIANGLE_VERTICES.data(),
+				static_cast<uint32_t>(TRIANGLE_VERTICES.size()),
+				instances.data(),
+				static_cast<uint32_t>(instances.size()));
+
+			std::array<Vertex, 3> nanColor{ TRIANGLE_VERTICES };
+			nanColor[1].color[1] = NOT_A_NUMBER;
+			std::array<Vertex, 3> nanPosition{ TRIANGLE_VERTICES };
+			nanPosition[2].position[0] = NOT_A_NUMBER;
+			std::array<Vertex, 3> zeroArea{ TRIANGLE_VERTICES };
+			zeroArea[2] = zeroArea[1];
+			const std::array<Vertex, 3> backFacing{ TRIANGLE_VERTICES[0], TRIANGLE_VERTICES[2], TRIANGLE_VERTICES[1] };
+			const std::array<const std::array<Vertex, 3>*, 4> triangles{ &nanColor, &nanPosition, &zeroArea, &backFacing };
+			for (const std::array<Vertex, 3>* triangle : triangles)
+			{
+				rasterizer.Draw(triangle->data(), static_cast<uint32_t>(triangle->size()));
+			}
+			rasterizer.Flush();
+		}
+	}
+
+	TEST(SoftwareRasterizerTests, SimdScalarAndThreadedPathsMatch)
+	{
+		JobSystem jobSystem{ WORKER_COUNT };
+		SoftwareRasterizer reference{ WIDTH, HEIGHT, nullptr, false };
+		DrawReferenceScene(reference);
+
+		for (JobSystem* jobs : { static_cast<JobSystem*>(nullptr), &jobSystem })
+		{
+			for (bool useSimd : { false, true })
+			{
+				SCOPED_TRACE(testing::Message() << "threaded " << (jobs != nullptr) << ", SIMD " << useSimd);
+				SoftwareRasterizer rasterizer{ WIDTH, HEIGHT, jobs, useSimd };
+				DrawReferenceScene(rasterizer);
+
+				EXPECT_EQ(rasterizer.GetStats().trianglesSubmitted, reference.GetStats().trianglesSubmitted);
+				EXPECT_EQ(rasterizer.GetStats().trianglesCulled, reference.GetStats().trianglesCulled);
+				EXPECT_EQ(rasterizer.GetStats().pixelsShaded, reference.GetStats().pixelsShaded);
+				const std::vector<uint32_t> expected{ reference.GetPixels(), reference.GetPixels() + (WIDTH * HEIGHT) };
+				const std::vector<uint32_t> actual{ rasterizer.GetPixels(), rasterizer.GetPixels() + (WIDTH * HEIGHT) };
+				EXPECT_EQ(actual, expected);
+			}
+		}
+
+		// The NaN position, zero-area and back-facing triangles are culled
+		EXPECT_EQ(reference.GetStats().trianglesSubmitted, 70u);
+		EXPECT_EQ(reference.GetStats().trianglesCulled, 3u);
+	}
+
+	TEST(SoftwareRasterizerTests, ShadesTheHelloTriangle)
+	{
+		SoftwareRasterizer rasterizer{ WIDTH, HEIGHT };
+		const float clearColor[4]{ 0.0f, 0.0f, 0.0f, 1.0f };
+		rasterizer.Clear(clearColor);
+		rasterizer.Draw(TRIANGLE_VERTICES.data(), static_cast<uint32_t>(TRIANGLE_VERTICES.size()));
+		rasterizer.Flush();
+
+		EXPECT_EQ(GetPixel(rasterizer, 0, 0), CLEAR_BLACK);
+		EXPECT_EQ(GetPixel(rasterizer, WIDTH - 1, HEIGHT - 1), CLEAR_BLACK);
+
+		// Near each corner, that corner's color dominates
+		const uint32_t apex{ GetPixel(rasterizer, WIDTH / 2, 40) };
+		EXPECT_GT(apex & 0xFF, 200u);
+		EXPECT_EQ(apex >> 24, 0xFFu);
+		const uint32_t rightCorner{ GetPixel(rasterizer, 96, 77) };
+		EXPECT_GT((rightCorner >> 8) & 0xFF, 200u);
+		const uint32_t leftCorner{ GetPixel(rasterizer, 61, 77) };
+		EXPECT_GT((leftCorner >> 16) & 0xFF, 200u);
+	}
+
+	TEST(SoftwareRasterizerTests, FollowsTheTopLeftRule)
+	{
+		// A quad whose edges run through pixel centers, from (2.5, 2.5) to (6.5, 6.5)
+		// on an 8x8 target, split along the diagonal into a red and a green triangle
+		constexpr float LEFT{ -0.375f };
+		constexpr float RIGHT{ 0.625f };
+		constexpr float TOP{ 0.375f };
+		constexpr float BOTTOM{ -0.625f };
+		const Vertex quad[6]{
+			{ { LEFT, TOP, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+			{ { RIGHT, TOP, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+			{ { LEFT, BOTTOM, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+			{ { RIGHT, TOP, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+			{ { RIGHT, BOTTOM, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+			{ { LEFT, BOTTOM, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+		};
+
+		for (bool useSimd : { false, true })
+		{
+			SCOPED_TRACE(useSimd);
+			SoftwareRasterizer rasterizer{ 8, 8, nullptr, useSimd };
+			const float clearColor[4]{ 0.0f, 0.0f, 0.0f, 1.0f };
+			rasterizer.Clear(clearColor);
+			rasterizer.Draw(quad, 6);
+			rasterizer.Flush();
+
+			// Left and top edges are in, right and bottom edges are out, and the
+			// shared diagonal is shaded exactly once
+			EXPECT_EQ(rasterizer.GetStats().pixelsShaded, 16u);
+			for (uint32_t y = 0; y < 8; ++y)
+			{
+				for (uint32_t x = 0; x < 8; ++x)
+				{
+					SCOPED_TRACE(testing::Message() << x << ", " << y);
+					const bool covered{ (x >= 2) && (x <= 5) && (y >= 2) && (y <= 5) };
+					const uint32_t expected{ !covered ? CLEAR_BLACK : ((x + y) < 8) ? RED : GREEN };
+					EXPECT_EQ(GetPixel(rasterizer, x, y), expected);
+				}
+			}
+		}
+	}
+
+	TEST(SoftwareRasterizerTests, WritesThePixelsAsPpm)
+	{
+		const TemporaryPath path{ "HelloTriangleRasterizerTests.ppm" };
+		SoftwareRasterizer rasterizer{ 2, 1 };
+		const float clearColor[4]{ 1.0f, 0.0f, 0.0f, 1.0f };
+		rasterizer.Clear(clearColor);
+		ASSERT_TRUE(rasterizer.WriteImage(path.Get().string()));
+
+		std::ifstream file{ path.Get(), std::ios::binary };
+		const std::string contents{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+		EXPECT_EQ(contents, std::string("P6\n2 1\n255\n\xFF\x00\x00\xFF\x00\x00", 17));
+	}
+}
@@ -0,0 +1,260 @@
+#include "pch.h"
+#include "SpatialGrid.h"
+#include "Camera.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t RANDOM_SEED{ 1234 };
+		constexpr float CELL_SIZE{ 1.0f };
+		constexpr float EXTENT{ 10.0f };
+		constexpr float MAX_RADIUS{ 0.5f };
+
+		struct Sphere
+		{
+			bool isPresent{ false };
+			float x{ 0.0f };
+			float y{ 0.0f };
+			float z{ 0.0f };
+			float radius{ 0.0f };
+		};
+
+		std::vector<uint32_t> Sorted(std::vector<uint32_t> ids)
+		{
+			std::sort(ids.begin(), ids.end());
+			return ids;
+		}
+
+		Aabb MakeRandomBox(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> center{ -EXTENT, EXTENT };
+			std::uniform_real_distribution<float> halfExtent{ 0.0f, 4.0f };
+			Aabb box{};
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const float middle{ center(random) };
+				const float half{ halfExtent(random) };
+				box.min[axis] = middle - half;
+				box.max[axis] = middle + half;
+			}
+			return box;
+		}
+
+		Frustum MakeRandomFrustum(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> coordinate{ -EXTENT, EXTENT };
+			Camera camera;
+			camera.SetLookAt(
+				{ coordinate(random), coordinate(random), coordinate(random) },
+				{ coordinate(random), coordinate(random), coordinate(random) },
+				{ 0.0f, 1.0f, 0.0f });
+			camera.SetPerspective(1.0f, 4.0f / 3.0f, 0.1f, EXTENT);
+			return Frustum::FromViewProjection(camera.GetViewProjection().data());
+		}
+
+		/// <summary>
+		/// Checks the grid's contents and queries against a scan of every sphere.
+		/// </summary>
+		void ExpectMatchesBruteForce(const SpatialGrid& grid, const std::vector<Sphere>& spheres, std::mt19937& random)
+		{
+			size_t count{ 0 };
+			for (uint32_t id = 0; id < spheres.size(); ++id)
+			{
+				EXPECT_EQ(grid.Contains(id), spheres[id].isPresent);
+				count += spheres[id].isPresent ? 1 : 0;
+			}
+			EXPECT_EQ(grid.GetCount(), count);
+
+			for (int query = 0; query < 8; ++query)
+			{
+				const Aabb box{ MakeRandomBox(random) };
+				std::vector<uint32_t> expected;
+				for (uint32_t id = 0; id < spheres.size(); ++id)
+				{
+					const Sphere& sphere{ spheres[id] };
+					if (sphere.isPresent && SphereIntersectsAabb(sphere.x, sphere.y, sphere.z, sphere.radius, box))
+					{
+						expected.push_back(id);
+					}
+				}
+				std::vector<uint32_t> ids;
+				grid.QueryAabb(box, ids);
+				EXPECT_EQ(Sorted(ids), expected);
+			}
+
+			for (int query = 0; query < 4; ++query)
+			{
+				const Frustum frustum{ MakeRandomFrustum(random) };
+				std::vector<uint32_t> expected;
+				for (uint32_t id = 0; id < spheres.size(); ++id)
+				{
+					const Sphere& sphere{ spheres[id] };
+					if (sphere.isPresent && frustum.ContainsSphere(sphere.x, sphere.y, sphere.z, sphere.radius))
+					{
+						expected.push_back(id);
+					}
+				}
+				std::vector<uint32_t> ids;
+				grid.QueryFrustum(frustum, ids);
+				EXPECT_EQ(Sorted(ids), expected);
+			}
+		}
+	}
+
+	TEST(SpatialGridTests, MatchesBruteForceAfterRandomEdits)
+	{
+		constexpr uint32_t ID_COUNT{ 2000 };
+		std::mt19937 random{ RANDOM_SEED };
+		std::uniform_real_distribution<float> coordinate{ -EXTENT, EXTENT };
+		std::uniform_real_distribution<float> nudge{ -0.3f, 0.3f };
+		std::uniform_real_distribution<float> radius{ 0.0f, MAX_RADIUS };
+		std::uniform_int_distribution<uint32_t> pickId{ 0, ID_COUNT - 1 };
+		std::uniform_int_distribution<int> pickEdit{ 0, 9 };
+
+		SpatialGrid grid{ CELL_SIZE };
+		std::vector<Sphere> spheres(ID_COUNT);
+		for (int round = 0; round < 20; ++round)
+		{
+			SCOPED_TRACE(round);
+			for (int edit = 0; edit < 500; ++edit)
+			{
+				const uint32_t id{ pickId(random) };
+				Sphere& sphere{ spheres[id] };
+				const int kind{ pickEdit(random) };
+				if (sphere.isPresent && (kind < 5))
+				{
+					// Small moves mostly stay in their cell; some cross into the next
+					sphere.x += nudge(random);
+					sphere.y += nudge(random);
+					sphere.z += nudge(random);
+					grid.Update(id, sphere.x, sphere.y, sphere.z, sphere.radius);
+				}
+				else if (sphere.isPresent && (kind < 7))
+				{
+					sphere.isPresent = false;
+					grid.Remove(id);
+				}
+				else
+				{
+					// Insert, or teleport if already present
+					sphere = Sphere{ true, coordinate(random), coordinate(random), coordinate(random), radius(random) };
+					grid.Update(id, sphere.x, sphere.y, sphere.z, sphere.radius);
+				}
+			}
+			ExpectMatchesBruteForce(grid, spheres, random);
+		}
+
+		// Removing an id that isn't there does nothing
+		const size_t count{ grid.GetCount() };
+		grid.Remove(ID_COUNT + 10);
+		EXPECT_EQ(grid.GetCount(), count);
+	}
+
+	TEST(SpatialGridTests, FindsEveryCellWhileCellsAreErased)
+	{
+		// One sphere per cell, so every removal erases a cell from the lookup table;
+		// with hundreds of cells many share probe runs, so backward shifts must keep
+		// the rest reachable
+		constexpr int32_t CELLS_PER_AXIS{ 8 };
+		std::vector<Sphere> spheres;
+		SpatialGrid grid{ CELL_SIZE };
+		for (int32_t z = -CELLS_PER_AXIS; z < CELLS_PER_AXIS; ++z)
+		{
+			for (int32_t y = -CELLS_PER_AXIS; y < CELLS_PER_AXIS; ++y)
+			{
+				for (int32_t x = -CELLS_PER_AXIS; x < CELLS_PER_AXIS; ++x)
+				{
+					const Sphere sphere{
+						true,
+						(static_cast<float>(x) + 0.5f) * CELL_SIZE,
+						(static_cast<float>(y) + 0.5f) * CELL_SIZE,
+						(static_cast<float>(z) + 0.5f) * CELL_SIZE,
+						0.1f
+					};
+					grid.Update(static_cast<uint32_t>(spheres.size()), sphere.x, sphere.y, sphere.z, sphere.radius);
+					spheres.push_back(sphere);
+				}
+			}
+		}
+		ASSERT_EQ(grid.GetCellCount(), spheres.size());
+
+		std::vector<uint32_t> order(spheres.size());
+		std::iota(order.begin(), order.end(), 0u);
+		std::mt19937 random{ RANDOM_SEED };
+		std::shuffle(order.begin(), order.end(), random);
+		for (size_t removed = 0; removed < order.size(); ++removed)
+		{
+			grid.Remove(order[removed]);
+			spheres[order[removed]].isPresent = false;
+			ASSERT_EQ(grid.GetCellCount(), order.size() - removed - 1);
+
+			if ((removed % 64) == 0)
+			{
+				// A point query at each remaining center finds exactly that sphere
+				for (uint32_t id = 0; id < spheres.size(); ++id)
+				{
+					const Sphere& sphere{ spheres[id] };
+					if (!sphere.isPresent)
+					{
+						continue;
+					}
+					const Aabb point{ { sphere.x, sphere.y, sphere.z }, { sphere.x, sphere.y, sphere.z } };
+					std::vector<uint32_t> ids;
+					grid.QueryAabb(point, ids);
+					ASSERT_EQ(ids, std::vector<uint32_t>{ id });
+				}
+			}
+		}
+		EXPECT_EQ(grid.GetCount(), 0u);
+
+		// Cells freed above are reused
+		grid.Update(0, 0.5f, 0.5f, 0.5f, 0.1f);
+		EXPECT_EQ(grid.GetCellCount(), 1u);
+	}
+
+	TEST(SpatialGridTests, RemoveIfRemovesOnlyMatchingIds)
+	{
+		std::mt19937 random{ RANDOM_SEED };
+		std::uniform_real_distribution<float> coordinate{ -EXTENT, EXTENT };
+		SpatialGrid grid{ CELL_SIZE };
+		std::vector<Sphere> spheres(300);
+		for (uint32_t id = 0; id < spheres.size(); ++id)
+		{
+			// Leave a few gaps, which RemoveIf must skip
+			if ((id % 7) == 3)
+			{
+				continue;
+			}
+			spheres[id] = Sphere{ true, coordinate(random), coordinate(random), coordinate(random), 0.2f };
+			grid.Update(id, spheres[id].x, spheres[id].y, spheres[id].z, spheres[id].radius);
+		}
+
+		std::vector<uint32_t> visited;
+		grid.RemoveIf([&visited](uint32_t id)
+		{
+			visited.push_back(id);
+			return (id % 3) == 0;
+		});
+		for (uint32_t id = 0; id < spheres.size(); ++id)
+		{
+			if ((id % 3) == 0)
+			{
+				spheres[id].isPresent = false;
+			}
+		}
+
+		// The predicate only sees ids in the grid
+		for (uint32_t id : visited)
+		{
+			EXPECT_NE(id % 7, 3u);
+		}
+		ExpectMatchesBruteForce(grid, spheres, random);
+	}
+}
@@ -0,0 +1,219 @@
+#include "pch.h"
+#include "SpatialIndex.h"
+#include "Camera.h"
+#include "JobSystem.h"
+#include "World.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t RANDOM_SEED{ 1234 };
+		constexpr float EXTENT{ 10.0f };
+		constexpr SpatialIndex::Config CONFIG{ 1.0f, 0.2f, true };
+
+		std::vector<uint32_t> Sorted(std::vector<uint32_t> ids)
+		{
+			std::sort(ids.begin(), ids.end());
+			return ids;
+		}
+
+		Aabb MakeRandomBox(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> center{ -EXTENT, EXTENT };
+			std::uniform_real_distribution<float> halfExtent{ 0.0f, 4.0f };
+			Aabb box{};
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const float middle{ center(random) };
+				const float half{ halfExtent(random) };
+				box.min[axis] = middle - half;
+				box.max[axis] = middle + half;
+			}
+			return box;
+		}
+
+		/// <summary>
+		/// Checks the index's queries against a scan of every positioned entity.
+		/// </summary>
+		void ExpectMatchesBruteForce(const SpatialIndex& index, const World& world, std::mt19937& random)
+		{
+			const ComponentPool<World::POSITION_FIELDS>& positions{ world.GetPositions() };
+			auto scan = [&positions](auto&& isHit)
+			{
+				std::vector<uint32_t> entityIndices;
+				for (size_t i = 0; i < positions.Size(); ++i)
+				{
+					if (isHit(positions.Field(0)[i], positions.Field(1)[i], positions.Field(2)[i]))
+					{
+						entityIndices.push_back(positions.Entities()[i].index);
+					}
+				}
+				return Sorted(std::move(entityIndices));
+			};
+
+			std::vector<Aabb> boxes;
+			for (int query = 0; query < 8; ++query)
+			{
+				boxes.push_back(MakeRandomBox(random));
+				const Aabb& box{ boxes.back() };
+				std::vector<uint32_t> entityIndices;
+				index.QueryAabb(box, entityIndices);
+				EXPECT_EQ(Sorted(entityIndices), scan([&box](float x, float y, float z)
+				{
+					return SphereIntersectsAabb(x, y, z, CONFIG.entityRadius, box);
+				}));
+			}
+
+			// Batched queries, on the job system, give the same answers in the same order
+			JobSystem jobSystem{ 2 };
+			SpatialQueryResults results;
+			index.QueryAabbs(boxes.data(), boxes.size(), results, &jobSystem);
+			for (size_t query = 0; query < boxes.size(); ++query)
+			{
+				std::vector<uint32_t> entityIndices;
+				index.QueryAabb(boxes[query], entityIndices);
+				const std::vector<uint32_t> batched{
+					results.entityIndices.begin() + results.offsets[query],
+					results.entityIndices.begin() + results.offsets[query + 1]
+				};
+				EXPECT_EQ(batched, entityIndices);
+			}
+
+			std::uniform_real_distribution<float> coordinate{ -EXTENT, EXTENT };
+			for (int query = 0; query < 4; ++query)
+			{
+				Camera camera;
+				camera.SetLookAt(
+					{ coordinate(random), coordinate(random), coordinate(random) },
+					{ coordinate(random), coordinate(random), coordinate(random) },
+					{ 0.0f, 1.0f, 0.0f });
+				camera.SetPerspective(1.0f, 4.0f / 3.0f, 0.1f, 2.0f * EXTENT);
+				const Frustum frustum{ Frustum::FromViewProjection(camera.GetViewProjection().data()) };
+				std::vector<uint32_t> entityIndices;
+				index.QueryFrustum(frustum, entityIndices);
+				EXPECT_EQ(Sorted(entityIndices), scan([&frustum](float x, float y, float z)
+				{
+					return frustum.ContainsSphere(x, y, z, CONFIG.entityRadius);
+				}));
+			}
+		}
+	}
+
+	TEST(SpatialIndexTests, MatchesBruteForceAsTheWorldChanges)
+	{
+		for (bool useStaticBvh : { true, false })
+		{
+			SCOPED_TRACE(useStaticBvh);
+			std::mt19937 random{ RANDOM_SEED };
+			std::uniform_real_distribution<float> coordinate{ -EXTENT, EXTENT };
+			std::uniform_real_distribution<float> nudge{ -0.5f, 0.5f };
+			std::uniform_int_distribution<int> pickEdit{ 0, 9 };
+
+			World world;
+			std::vector<Entity> entities;
+			SpatialIndex index{ SpatialIndex::Config{ CONFIG.cellSize, CONFIG.entityRadius, useStaticBvh } };
+			for (int round = 0; round < 20; ++round)
+			{
+				SCOPED_TRACE(round);
+				for (int edit = 0; edit < 200; ++edit)
+				{
+					const int kind{ pickEdit(random) };
+					if (entities.empty() || (kind < 3))
+					{
+						// New entities, some moving, some static, and a few with no
+						// position at all, which the index ignores
+						const Entity entity{ world.CreateEntity() };
+						entities.push_back(entity);
+						if (kind != 0)
+						{
+							world.SetPosition(entity, coordinate(random), coordinate(random), coordinate(random));
+							if ((kind % 2) == 1)
+							{
+								world.SetVelocity(entity, 1.0f, 0.0f, 0.0f);
+							}
+						}
+						continue;
+					}
+
+					const size_t pick{ std::uniform_int_distribution<size_t>{ 0, entities.size() - 1 }(random) };
+					const Entity entity{ entities[pick] };
+					if (!world.GetPositions().Contains(entity))
+					{
+						continue;
+					}
+					const size_t slot{ world.GetPositions().IndexOf(entity) };
+					if (kind < 7)
+					{
+						world.SetPosition(
+							entity,
+							world.GetPositions().Field(0)[slot] + nudge(random),
+							world.GetPositions().Field(1)[slot] + nudge(random),
+							world.GetPositions().Field(2)[slot] + nudge(random));
+					}
+					else if (kind == 7)
+					{
+						world.DestroyEntity(entity);
+						entities[pick] = entities.back();
+						entities.pop_back();
+					}
+					else if (kind == 8)
+					{
+						// Stops moving, so it leaves the grid for the BVH
+						world.RemoveVelocity(entity);
+					}
+					else
+					{
+						world.SetVelocity(entity, 0.0f, 1.0f, 0.0f);
+					}
+				}
+
+				index.Sync(world);
+				ExpectMatchesBruteForce(index, world, random);
+
+				const SpatialIndex::Stats stats{ index.GetStats() };
+				const size_t movingCount{ world.GetMovingCount() };
+				const size_t positionedCount{ world.GetPositions().Size() };
+				EXPECT_EQ(stats.dynamicCount, useStaticBvh ? movingCount : positionedCount);
+				EXPECT_EQ(stats.staticCount, useStaticBvh ? (positionedCount - movingCount) : 0u);
+			}
+
+			// A full rebuild gives the same answers
+			index.Invalidate();
+			index.Sync(world);
+			ExpectMatchesBruteForce(index, world, random);
+		}
+	}
+
+	TEST(SpatialIndexTests, RebuildsTheBvhOnlyWhenStaticsChange)
+	{
+		World world;
+		const Entity moving{ world.CreateEntity() };
+		world.SetPosition(moving, 0.0f, 0.0f, 0.0f);
+		world.SetVelocity(moving, 1.0f, 0.0f, 0.0f);
+		const Entity still{ world.CreateEntity() };
+		world.SetPosition(still, 5.0f, 0.0f, 0.0f);
+
+		SpatialIndex index{ CONFIG };
+		index.Sync(world);
+		EXPECT_EQ(index.GetStats().bvhBuildCount, 1u);
+
+		// Moving entities don't touch the BVH
+		world.SetPosition(moving, 1.0f, 0.0f, 0.0f);
+		index.Sync(world);
+		EXPECT_EQ(index.GetStats().bvhBuildCount, 1u);
+
+		world.SetPosition(still, 6.0f, 0.0f, 0.0f);
+		index.Sync(world);
+		EXPECT_EQ(index.GetStats().bvhBuildCount, 2u);
+
+		std::vector<uint32_t> entityIndices;
+		index.QueryAabb(Aabb{ { 5.9f, -0.1f, -0.1f }, { 6.1f, 0.1f, 0.1f } }, entityIndices);
+		EXPECT_EQ(entityIndices, std::vector<uint32_t>{ still.index });
+	}
+}
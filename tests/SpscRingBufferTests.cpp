@@ -0,0 +1,91 @@
+#include "pch.h"
+#include "SpscRingBuffer.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace HelloTriangle
+{
+	TEST(SpscRingBufferTests, RejectsPushesWhenFullAndPopsWhenEmpty)
+	{
+		SpscRingBuffer<uint32_t, 4> buffer;
+		uint32_t item{ 0 };
+		EXPECT_FALSE(buffer.TryPop(item));
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			EXPECT_TRUE(buffer.TryPush(i));
+		}
+		EXPECT_FALSE(buffer.TryPush(4));
+		EXPECT_EQ(buffer.Size(), 4u);
+
+		for (uint32_t i = 0; i < 4; ++i)
+		{
+			ASSERT_TRUE(buffer.TryPop(item));
+			EXPECT_EQ(item, i);
+		}
+		EXPECT_FALSE(buffer.TryPop(item));
+		EXPECT_EQ(buffer.Size(), 0u);
+	}
+
+	TEST(SpscRingBufferTests, KeepsOrderAcrossWraparound)
+	{
+		SpscRingBuffer<uint32_t, 8> buffer;
+		uint32_t next{ 0 };
+		uint32_t expected{ 0 };
+
+		// Uneven pushes and pops walk the indices around the buffer many times
+		for (uint32_t round = 0; round < 100; ++round)
+		{
+			for (uint32_t i = 0; i < (round % 7) + 1; ++i)
+			{
+				if (buffer.TryPush(next))
+				{
+					++next;
+				}
+			}
+			uint32_t item{ 0 };
+			for (uint32_t i = 0; (i < (round % 5) + 1) && buffer.TryPop(item); ++i)
+			{
+				ASSERT_EQ(item, expected);
+				++expected;
+			}
+		}
+		EXPECT_EQ(buffer.Size(), static_cast<size_t>(next - expected));
+	}
+
+	TEST(SpscRingBufferTests, DeliversEveryItemInOrderBetweenThreads)
+	{
+		constexpr uint64_t ITEM_COUNT{ 1'000'000 };
+		SpscRingBuffer<uint64_t, 64> buffer;
+
+		std::thread producer{ [&buffer]()
+			{
+				for (uint64_t i = 0; i < ITEM_COUNT; ++i)
+				{
+					while (!buffer.TryPush(i))
+					{
+						std::this_thread::yield();
+					}
+				}
+			} };
+
+		uint64_t expected{ 0 };
+		uint64_t outOfOrderCount{ 0 };
+		while (expected < ITEM_COUNT)
+		{
+			uint64_t item{ 0 };
+			if (!buffer.TryPop(item))
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			outOfOrderCount += (item != expected) ? 1 : 0;
+			++expected;
+		}
+		producer.join();
+
+		EXPECT_EQ(outOfOrderCount, 0u);
+		EXPECT_EQ(buffer.Size(), 0u);
+	}
+}
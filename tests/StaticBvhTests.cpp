@@ -0,0 +1,152 @@
+#include "pch.h"
+#include "StaticBvh.h"
+#include "Camera.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		constexpr uint32_t RANDOM_SEED{ 1234 };
+		constexpr float EXTENT{ 10.0f };
+
+		/// <summary>
+		/// SoA spheres with ids that aren't their positions, as the BVH gets them.
+		/// </summary>
+		struct Spheres
+		{
+			std::vector<uint32_t> ids;
+			std::vector<float> x;
+			std::vector<float> y;
+			std::vector<float> z;
+			std::vector<float> radius;
+
+			Spheres(size_t count, std::mt19937& random)
+			{
+				std::uniform_real_distribution<float> coordinate{ -EXTENT, EXTENT };
+				std::uniform_real_distribution<float> size{ 0.0f, 1.0f };
+				for (size_t i = 0; i < count; ++i)
+				{
+					ids.push_back(static_cast<uint32_t>((i * 7) + 3));
+					x.push_back(coordinate(random));
+					y.push_back(coordinate(random));
+					z.push_back(coordinate(random));
+					radius.push_back(size(random));
+				}
+			}
+		};
+
+		std::vector<uint32_t> Sorted(std::vector<uint32_t> ids)
+		{
+			std::sort(ids.begin(), ids.end());
+			return ids;
+		}
+
+		Aabb MakeRandomBox(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> center{ -EXTENT, EXTENT };
+			std::uniform_real_distribution<float> halfExtent{ 0.0f, 5.0f };
+			Aabb box{};
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				const float middle{ center(random) };
+				const float half{ halfExtent(random) };
+				box.min[axis] = middle - half;
+				box.max[axis] = middle + half;
+			}
+			return box;
+		}
+
+		Frustum MakeRandomFrustum(std::mt19937& random)
+		{
+			std::uniform_real_distribution<float> coordinate{ -EXTENT, EXTENT };
+			Camera camera;
+			camera.SetLookAt(
+				{ coordinate(random), coordinate(random), coordinate(random) },
+				{ coordinate(random), coordinate(random), coordinate(random) },
+				{ 0.0f, 1.0f, 0.0f });
+			camera.SetPerspective(1.0f, 4.0f / 3.0f, 0.1f, 2.0f * EXTENT);
+			return Frustum::FromViewProjection(camera.GetViewProjection().data());
+		}
+
+		void ExpectMatchesBruteForce(
+			const StaticBvh& bvh,
+			const Spheres& spheres,
+			const std::vector<float>& radius,
+			std::mt19937& random)
+		{
+			EXPECT_EQ(bvh.GetCount(), spheres.ids.size());
+			for (int query = 0; query < 16; ++query)
+			{
+				const Aabb box{ MakeRandomBox(random) };
+				const Frustum frustum{ MakeRandomFrustum(random) };
+				std::vector<uint32_t> expectedInBox;
+				std::vector<uint32_t> expectedInFrustum;
+				for (size_t i = 0; i < spheres.ids.size(); ++i)
+				{
+					if (SphereIntersectsAabb(spheres.x[i], spheres.y[i], spheres.z[i], radius[i], box))
+					{
+						expectedInBox.push_back(spheres.ids[i]);
+					}
+					if (frustum.ContainsSphere(spheres.x[i], spheres.y[i], spheres.z[i], radius[i]))
+					{
+						expectedInFrustum.push_back(spheres.ids[i]);
+					}
+				}
+
+				std::vector<uint32_t> ids;
+				bvh.QueryAabb(box, ids);
+				EXPECT_EQ(Sorted(ids), Sorted(expectedInBox));
+				ids.clear();
+				bvh.QueryFrustum(frustum, ids);
+				EXPECT_EQ(Sorted(ids), Sorted(expectedInFrustum));
+			}
+		}
+	}
+
+	TEST(StaticBvhTests, MatchesBruteForce)
+	{
+		std::mt19937 random{ RANDOM_SEED };
+
+		// Empty, a single leaf, either side of a split, and many levels deep
+		for (size_t count : { 0u, 1u, 7u, 8u, 9u, 100u, 5000u })
+		{
+			SCOPED_TRACE(count);
+			const Spheres spheres{ count, random };
+			StaticBvh bvh;
+			bvh.Build(count, spheres.ids.data(), spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data());
+			ExpectMatchesBruteForce(bvh, spheres, spheres.radius, random);
+
+			// Without radii every sphere gets the default, and a rebuild replaces
+			// the previous contents
+			constexpr float DEFAULT_RADIUS{ 0.25f };
+			bvh.Build(count, spheres.ids.data(), spheres.x.data(), spheres.y.data(), spheres.z.data(), nullptr, DEFAULT_RADIUS);
+			ExpectMatchesBruteForce(bvh, spheres, std::vector<float>(count, DEFAULT_RADIUS), random);
+		}
+	}
+
+	TEST(StaticBvhTests, HandlesCoincidentCenters)
+	{
+		// Every center equal gives the median split nothing to separate
+		constexpr size_t COUNT{ 100 };
+		std::mt19937 random{ RANDOM_SEED };
+		Spheres spheres{ COUNT, random };
+		std::fill(spheres.x.begin(), spheres.x.end(), 1.0f);
+		std::fill(spheres.y.begin(), spheres.y.end(), 2.0f);
+		std::fill(spheres.z.begin(), spheres.z.end(), 3.0f);
+
+		StaticBvh bvh;
+		bvh.Build(COUNT, spheres.ids.data(), spheres.x.data(), spheres.y.data(), spheres.z.data(), spheres.radius.data());
+		ExpectMatchesBruteForce(bvh, spheres, spheres.radius, random);
+
+		bvh.Clear();
+		EXPECT_EQ(bvh.GetCount(), 0u);
+		std::vector<uint32_t> ids;
+		bvh.QueryAabb(Aabb{ { -EXTENT, -EXTENT, -EXTENT }, { EXTENT, EXTENT, EXTENT } }, ids);
+		EXPECT_TRUE(ids.empty());
+	}
+}
@@ -0,0 +1,117 @@
+#include "pch.h"
+#include "VisibilityCuller.h"
+#include "Camera.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace HelloTriangle
+{
+	namespace
+	{
+		/// <summary>
+		/// Spheres in front of a camera at z = -10 looking down +z, with a wall
+		/// between the camera and the origin.
+		/// </summary>
+		struct Scene
+		{
+			// 0 is clear of the wall, 1 is behind the camera, 2 is behind the wall,
+			// 3 is in front of the wall and 4 is far off to the side
+			static constexpr size_t COUNT{ 5 };
+			const float x[COUNT]{ 4.0f, 0.0f, 0.0f, 0.0f, 30.0f };
+			const float y[COUNT]{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+			const float z[COUNT]{ 0.0f, -20.0f, 0.0f, -7.0f, 0.0f };
+			const float radius[COUNT]{ 0.5f, 0.5f, 0.3f, 0.2f, 0.5f };
+
+			// A unit quad on the z = 0 plane, placed 2 x 2 at z = -5, which hides
+			// everything within 2 of the z axis at the origin
+			MeshData wall{
+				{
+					Vertex{ { -0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+					Vertex{ { 0.5f, -0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+					Vertex{ { -0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+					Vertex{ { 0.5f, 0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+				},
+				{ 0, 2, 1, 1, 2, 3 }
+			};
+			const InstanceData wallInstance{ { 0.0f, 0.0f, -5.0f, 4.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } };
+			Camera camera;
+
+			Scene()
+			{
+				camera.SetLookAt({ 0.0f, 0.0f, -10.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+				camera.SetPerspective(0.8f, 4.0f / 3.0f, 0.1f, 50.0f);
+			}
+		};
+
+		std::vector<SimdLevel> GetSupportedLevels()
+		{
+			std::vector<SimdLevel> levels;
+			const SimdLevel bestLevel{ DetectSimdLevel() };
+			for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse2, SimdLevel::Avx2 })
+			{
+				if (static_cast<int>(level) <= static_cast<int>(bestLevel))
+				{
+					levels.push_back(level);
+				}
+			}
+			return levels;
+		}
+	}
+
+	TEST(VisibilityCullerTests, CullsOutsideTheFrustum)
+	{
+		Scene scene;
+		for (SimdLevel level : GetSupportedLevels())
+		{
+			SCOPED_TRACE(GetSimdLevelName(level));
+			VisibilityCuller culler{ VisibilityCuller::Config{ false, 0, 0, level } };
+			EXPECT_FALSE(culler.IsOcclusionEnabled());
+			culler.BeginFrame(scene.camera.GetViewProjection().data());
+
+			// Occluders are ignored with occlusion off
+			culler.AddOccluder(scene.wall, scene.wallInstance);
+			std::vector<uint32_t> visible;
+			culler.Cull(Scene::COUNT, scene.x, scene.y, scene.z, scene.radius, 0.0f, visible);
+			EXPECT_EQ(visible, (std::vector<uint32_t>{ 0, 2, 3 }));
+
+			const VisibilityCuller::Stats& stats{ culler.GetStats() };
+			EXPECT_EQ(stats.tested, Scene::COUNT);
+			EXPECT_EQ(stats.frustumCulled, 2u);
+			EXPECT_EQ(stats.occlusionCulled, 0u);
+			EXPECT_EQ(stats.visible, 3u);
+		}
+	}
+
+	TEST(VisibilityCullerTests, CullsBehindOccluders)
+	{
+		Scene scene;
+		VisibilityCuller culler{ VisibilityCuller::Config{ true } };
+		ASSERT_TRUE(culler.IsOcclusionEnabled());
+		culler.BeginFrame(scene.camera.GetViewProjection().data());
+		culler.AddOccluder(scene.wall, scene.wallInstance);
+
+		// Results are appended after whatever the list already holds
+		std::vector<uint32_t> visible{ 99 };
+		culler.Cull(Scene::COUNT, scene.x, scene.y, scene.z, scene.radius, 0.0f, visible);
+		EXPECT_EQ(visible, (std::vector<uint32_t>{ 99, 0, 3 }));
+
+		const VisibilityCuller::Stats& stats{ culler.GetStats() };
+		EXPECT_EQ(stats.tested, Scene::COUNT);
+		EXPECT_EQ(stats.frustumCulled, 2u);
+		EXPECT_EQ(stats.occlusionCulled, 1u);
+		EXPECT_EQ(stats.visible, 2u);
+
+		// A new frame drops the wall, and stats add up until reset
+		culler.BeginFrame(scene.camera.GetViewProjection().data());
+		visible.clear();
+		culler.Cull(Scene::COUNT, scene.x, scene.y, scene.z, nullptr, 0.3f, visible);
+		EXPECT_EQ(visible, (std::vector<uint32_t>{ 0, 2, 3 }));
+		EXPECT_EQ(stats.tested, 2 * Scene::COUNT);
+		EXPECT_EQ(stats.occlusionCulled, 1u);
+		EXPECT_EQ(stats.visible, 5u);
+
+		culler.ResetStats();
+		EXPECT_EQ(culler.GetStats().tested, 0u);
+	}
+}
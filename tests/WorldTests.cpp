@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "World.h"
+#include "WorldSeed.h"
+
+#include <gtest/gtest.h>
+
+namespace HelloTriangle
+{
+	TEST(WorldTests, StaleHandlesHaveNoComponents)
+	{
+		World world;
+		const Entity stale{ world.CreateEntity() };
+		world.SetPosition(stale, 1.0f, 2.0f, 3.0f);
+		world.DestroyEntity(stale);
+
+		// The new entity reuses the destroyed one's slot
+		const Entity entity{ world.CreateEntity() };
+		ASSERT_EQ(entity.index, stale.index);
+		world.SetPosition(entity, 4.0f, 5.0f, 6.0f);
+
+		const auto& positions{ world.GetPositions() };
+		EXPECT_EQ(positions.IndexOf(stale), ComponentPool<World::POSITION_FIELDS>::INVALID_INDEX);
+		EXPECT_FALSE(positions.Contains(stale));
+		EXPECT_EQ(positions.IndexOf(entity), 0u);
+		EXPECT_EQ(positions.IndexOfSlot(stale.index), 0u);
+	}
+
+	TEST(WorldTests, RemoveVelocityIgnoresStaleHandles)
+	{
+		World world;
+		const Entity stale{ world.CreateEntity() };
+		world.DestroyEntity(stale);
+
+		const Entity entity{ world.CreateEntity() };
+		world.SetPosition(entity, 0.0f, 0.0f, 0.0f);
+		world.SetVelocity(entity, 1.0f, 0.0f, 0.0f);
+		ASSERT_EQ(world.GetMovingCount(), 1u);
+
+		world.RemoveVelocity(stale);
+		EXPECT_EQ(world.GetMovingCount(), 1u);
+		EXPECT_TRUE(world.GetVelocities().Contains(entity));
+
+		world.RemoveVelocity(entity);
+		EXPECT_EQ(world.GetMovingCount(), 0u);
+		EXPECT_FALSE(world.GetVelocities().Contains(entity));
+	}
+
+	TEST(WorldTests, SeedingIsReproducible)
+	{
+		const WorldSeedConfig config{ .entityCount = 1000, .seed = 42 };
+		World first;
+		World second;
+		SeedWorld(first, config);
+		SeedWorld(second, config);
+
+		EXPECT_EQ(first.GetEntityCount(), config.entityCount);
+		EXPECT_EQ(first.ComputeHash(), second.ComputeHash());
+
+		// Every staticInterval-th entity stays put
+		EXPECT_EQ(first.GetMovingCount(), config.entityCount - (config.entityCount / config.staticInterval));
+
+		World other;
+		SeedWorld(other, WorldSeedConfig{ .entityCount = 1000, .seed = 43 });
+		EXPECT_NE(first.ComputeHash(), other.ComputeHash());
+}
+
+	TEST(WorldTests, ByteSizeCountsEveryLiveStream)
+	{
+		World world;
+		EXPECT_EQ(world.GetByteSize(), 0u);
+
+		const Entity entity{ world.CreateEntity() };
+		world.SetPosition(entity, 0.0f, 0.0f, 0.0f);
+		world.SetVelocity(entity, 1.0f, 0.0f, 0.0f);
+		world.SetColor(entity, 1.0f, 1.0f, 1.0f, 1.0f);
+
+		// Generation, then per pool a sparse slot, a dense entity and the fields
+		const size_t poolOverhead{ sizeof(uint32_t) + sizeof(Entity) };
+		EXPECT_EQ(
+			world.GetByteSize(),
+			sizeof(uint32_t) +
+			(3 * poolOverhead) +
+			((World::POSITION_FIELDS + World::VELOCITY_FIELDS + World::COLOR_FIELDS) * sizeof(float)));
+	}
+}
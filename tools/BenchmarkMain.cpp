@@ -0,0 +1,66 @@
+#include "pch.h"
+#include "Benchmarks.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+namespace
+{
+	// Parses "<prefix><number>" arguments, such as --entities=1000
+	bool ParseUnsignedArgument(std::string_view argument, std::string_view prefix, uint32_t& value)
+	{
+		if (argument.substr(0, prefix.size()) != prefix)
+		{
+			return false;
+		}
+		value = static_cast<uint32_t>(std::strtoul(std::string{ argument.substr(prefix.size()) }.c_str(), nullptr, 10));
+		return true;
+	}
+}
+
+// Runs the headless benchmark scenarios off Windows, like the Windows executable's
+// --benchmark mode, and writes their results as JSON.
+// Usage: HelloTriangleBenchmarks [--entities=N] [--draws=M] [--frames=K] [--input-events=L] [--output=path] [--raster-out=frame.ppm]
+int main(int argc, char* argv[])
+{
+	HelloTriangle::BenchmarkConfig config{};
+	std::filesystem::path outputPath{ "Benchmark.json" };
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument{ argv[i] };
+		if (ParseUnsignedArgument(argument, "--entities=", config.entityCount) ||
+			ParseUnsignedArgument(argument, "--draws=", config.drawCount) ||
+			ParseUnsignedArgument(argument, "--frames=", config.frameCount) ||
+			ParseUnsignedArgument(argument, "--input-events=", config.inputEventCount))
+		{
+			continue;
+		}
+		if (argument.substr(0, 9) == "--output=")
+		{
+			outputPath = argument.substr(9);
+		}
+		else if (argument.substr(0, 13) == "--raster-out=")
+		{
+			config.rasterImagePath = argument.substr(13);
+		}
+	}
+
+	std::vector<HelloTriangle::BenchmarkResult> results;
+	const bool passed{ HelloTriangle::RunBenchmarks(config, results) };
+	std::ofstream file{ outputPath, std::ios::trunc };
+	if (!file)
+	{
+		spdlog::error("Main: Couldn't open {} for writing.", outputPath.string());
+		return 1;
+	}
+	HelloTriangle::WriteBenchmarkResults(file, config, results);
+	spdlog::info("Main: Wrote {} benchmark results to {}.", results.size(), outputPath.string());
+	if (!passed)
+	{
+		spdlog::error("Main: Benchmark correctness checks failed.");
+		return 1;
+	}
+	return 0;
+}
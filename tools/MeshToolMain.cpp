@@ -0,0 +1,37 @@
+#include "pch.h"
+#include "MeshProcessor.h"
+
+#include <filesystem>
+#include <string_view>
+
+// Optimizes and compresses a mesh file off Windows, like the Windows executable's
+// --optimize-mesh mode, and writes the result as a compressed mesh file.
+// Usage: HelloTriangleMeshTool input.mesh [--output=path]
+int main(int argc, char* argv[])
+{
+	std::filesystem::path inputPath;
+	std::filesystem::path outputPath;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument{ argv[i] };
+		if (argument.substr(0, 9) == "--output=")
+		{
+			outputPath = argument.substr(9);
+		}
+		else
+		{
+			inputPath = argument;
+		}
+	}
+
+	if (inputPath.empty())
+	{
+		spdlog::error("Main: Usage: HelloTriangleMeshTool input.mesh [--output=path]");
+		return 1;
+	}
+	if (outputPath.empty())
+	{
+		outputPath = std::filesystem::path{ inputPath }.replace_extension(".compressed.mesh");
+	}
+	return HelloTriangle::ProcessMeshFile(inputPath, outputPath) ? 0 : 1;
+}